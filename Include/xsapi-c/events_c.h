@@ -74,6 +74,238 @@ STDAPI XblEventsSetMaxFileSize(
     uint64_t maxFileSizeInByes
 ) XBL_NOEXCEPT;
 
+/// <summary>
+/// Set the maximum number of event uploads that can be in progress at once for each Xbox Live context.
+/// </summary>
+/// <param name="maxUploadsInFlight">The maximum number of concurrent uploads. Must be at least 1.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Note that this is a global setting and will apply to all Xbox Live contexts.  
+/// The default value is 2.
+/// </remarks>
+STDAPI XblEventsSetMaxUploadsInFlight(
+    uint32_t maxUploadsInFlight
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Enables gzip compression of event uploads.
+/// </summary>
+/// <param name="enabled">True to compress uploads, false to send them uncompressed.</param>
+/// <param name="thresholdInBytes">Uploads smaller than this are sent uncompressed.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Note that this is a global setting and will apply to all Xbox Live contexts.  
+/// Compression is disabled by default. The default threshold is 1KB.
+/// </remarks>
+STDAPI XblEventsSetUploadCompression(
+    bool enabled,
+    uint64_t thresholdInBytes
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Set the maximum size of the events sent in a single upload.
+/// </summary>
+/// <param name="maxPayloadSizeInBytes">The maximum serialized size (in bytes) of the events in an upload.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Events are batched into uploads until adding another event would exceed this size. An event larger than
+/// this size is uploaded on its own.  
+/// Note that this is a global setting and will apply to all Xbox Live contexts.  
+/// The default value is 256KB.
+/// </remarks>
+STDAPI XblEventsSetMaxPayloadSize(
+    uint64_t maxPayloadSizeInBytes
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Counters describing the event uploads of an Xbox Live context.
+/// </summary>
+typedef struct XblEventsUploadStats
+{
+    /// <summary>
+    /// Number of batches of events held in memory waiting to be uploaded, including batches waiting to be retried.
+    /// </summary>
+    uint64_t queuedPayloadCount;
+
+    /// <summary>
+    /// Approximate serialized size (in bytes) of the events in those batches.
+    /// </summary>
+    uint64_t queuedPayloadBytes;
+
+    /// <summary>
+    /// Number of uploads in progress.
+    /// </summary>
+    uint64_t uploadsInFlight;
+
+    /// <summary>
+    /// Number of uploads that have completed. Uploads rejected by the service as malformed are included
+    /// because they are not retried.
+    /// </summary>
+    uint64_t completedUploadCount;
+
+    /// <summary>
+    /// Number of upload attempts that failed and were scheduled to be retried.
+    /// </summary>
+    uint64_t failedUploadCount;
+
+    /// <summary>
+    /// Average time (in milliseconds) taken by upload attempts.
+    /// </summary>
+    uint64_t averageUploadLatencyInMs;
+
+    /// <summary>
+    /// Longest time (in milliseconds) taken by an upload attempt.
+    /// </summary>
+    uint64_t maxUploadLatencyInMs;
+} XblEventsUploadStats;
+
+/// <summary>
+/// Gets the event upload counters for an Xbox Live context.
+/// </summary>
+/// <param name="xboxLiveContext">Xbox Live context handle.</param>
+/// <param name="stats">Passes back the upload counters.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblEventsGetUploadStats(
+    _In_ XblContextHandle xboxLiveContext,
+    _Out_ XblEventsUploadStats* stats
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Identifies whether an in-game event field is a dimension or a measurement.
+/// </summary>
+enum class XblEventFieldKind : uint32_t
+{
+    /// <summary>
+    /// Field is a dimension.
+    /// </summary>
+    Dimension,
+
+    /// <summary>
+    /// Field is a measurement.
+    /// </summary>
+    Measurement
+};
+
+/// <summary>
+/// The value type of an in-game event field.
+/// </summary>
+enum class XblEventFieldType : uint32_t
+{
+    /// <summary>
+    /// UTF-8 string value.
+    /// </summary>
+    String,
+
+    /// <summary>
+    /// Signed 64-bit integer value.
+    /// </summary>
+    Int64,
+
+    /// <summary>
+    /// Finite double value.
+    /// </summary>
+    Double,
+
+    /// <summary>
+    /// Boolean value.
+    /// </summary>
+    Bool
+};
+
+/// <summary>
+/// Describes a single field of a registered in-game event.
+/// </summary>
+typedef struct XblEventFieldDescriptor
+{
+    /// <summary>
+    /// Name of the field. Must start with a letter and contain only alphanumeric characters and underscores.
+    /// </summary>
+    _Field_z_ const char* name;
+
+    /// <summary>
+    /// Whether the field is a dimension or a measurement.
+    /// </summary>
+    XblEventFieldKind kind;
+
+    /// <summary>
+    /// Type of the field's value.
+    /// </summary>
+    XblEventFieldType type;
+} XblEventFieldDescriptor;
+
+/// <summary>
+/// Value for a single field of a registered in-game event.
+/// </summary>
+typedef struct XblEventFieldValue
+{
+    /// <summary>
+    /// Type of the value. Must match the type the field was registered with.
+    /// Only the member corresponding to the type is read.
+    /// </summary>
+    XblEventFieldType type;
+
+    /// <summary>
+    /// Value when type is XblEventFieldType::String. Must not be null.
+    /// </summary>
+    _Field_z_ const char* stringValue;
+
+    /// <summary>
+    /// Value when type is XblEventFieldType::Int64.
+    /// </summary>
+    int64_t int64Value;
+
+    /// <summary>
+    /// Value when type is XblEventFieldType::Double.
+    /// </summary>
+    double doubleValue;
+
+    /// <summary>
+    /// Value when type is XblEventFieldType::Bool.
+    /// </summary>
+    bool boolValue;
+} XblEventFieldValue;
+
+/// <summary>
+/// Registers the dimension and measurement fields of an in-game event so that it can be written with
+/// XblEventsWriteRegisteredInGameEvent.
+/// </summary>
+/// <param name="xboxLiveContext">Xbox Live context handle.</param>
+/// <param name="eventName">Event name. Must start with a letter and contain only alphanumeric characters and underscores.</param>
+/// <param name="fields">Fields of the event, in the order their values will be passed when the event is written.</param>
+/// <param name="fieldsCount">Number of fields.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Event and field names are case insensitive, and field names must be unique within the event.
+/// Registering an event that is already registered replaces its schema.
+/// The names must match those declared in the title's service configuration, as with XblEventsWriteInGameEvent.
+/// </remarks>
+STDAPI XblEventsRegisterInGameEventSchema(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_z_ const char* eventName,
+    _In_reads_opt_(fieldsCount) const XblEventFieldDescriptor* fields,
+    _In_ size_t fieldsCount
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Write an in-game event previously registered with XblEventsRegisterInGameEventSchema.
+/// </summary>
+/// <param name="xboxLiveContext">Xbox Live context handle.</param>
+/// <param name="eventName">Name of the registered event.</param>
+/// <param name="values">Field values, in the order the fields were registered.</param>
+/// <param name="valuesCount">Number of values. Must equal the number of registered fields.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Produces the same event as XblEventsWriteInGameEvent with equivalent dimensions and measurements JSON,
+/// but writes the values directly into the upload payload without parsing JSON.
+/// Returns E_INVALIDARG if the event is not registered or the values don't match the registered fields.
+/// </remarks>
+STDAPI XblEventsWriteRegisteredInGameEvent(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_z_ const char* eventName,
+    _In_reads_opt_(valuesCount) const XblEventFieldValue* values,
+    _In_ size_t valuesCount
+) XBL_NOEXCEPT;
+
 #endif // XSAPI_INTERNAL_EVENTS_SERVICE
 }
 
@@ -408,4 +408,101 @@ STDAPI XblHttpCallGetHeaderAtIndex(
     _Out_ const char** headerName,
     _Out_ const char** headerValue
     ) XBL_NOEXCEPT;
+
+/// <summary>
+/// The number of calls a user can make to a service endpoint.
+/// </summary>
+/// <remarks>
+/// These mirror the burst and sustained limits Xbox Live applies to each user and endpoint, 
+/// see https://docs.microsoft.com/gaming/xbox-live/using-xbox-live/best-practices/fine-grained-rate-limiting.
+/// </remarks>
+typedef struct XblHttpCallBudget
+{
+    /// <summary>
+    /// The number of calls allowed in each burst period.
+    /// </summary>
+    uint32_t burstCallCount;
+
+    /// <summary>
+    /// The length of the burst period.
+    /// </summary>
+    uint32_t burstPeriodInSeconds;
+
+    /// <summary>
+    /// The number of calls allowed in each sustained period.
+    /// </summary>
+    uint32_t sustainedCallCount;
+
+    /// <summary>
+    /// The length of the sustained period.
+    /// </summary>
+    uint32_t sustainedPeriodInSeconds;
+} XblHttpCallBudget;
+
+/// <summary>
+/// The remaining budget of a user for a service endpoint.
+/// </summary>
+typedef struct XblHttpCallBudgetHeadroom
+{
+    /// <summary>
+    /// True if a budget applies to the endpoint. The call counts below are only meaningful if it does.
+    /// </summary>
+    bool isLimited;
+
+    /// <summary>
+    /// The number of calls that can be made now without exceeding the burst limit.
+    /// </summary>
+    uint32_t burstCallsRemaining;
+
+    /// <summary>
+    /// The number of calls that can be made now without exceeding the sustained limit.
+    /// </summary>
+    uint32_t sustainedCallsRemaining;
+
+    /// <summary>
+    /// The number of times a call was held back to stay within the budget.
+    /// </summary>
+    uint64_t deferredCallCount;
+
+    /// <summary>
+    /// The number of calls the service throttled with a 429 response.
+    /// </summary>
+    uint64_t throttledCallCount;
+} XblHttpCallBudgetHeadroom;
+
+/// <summary>
+/// Sets the budget that Xbox Live service calls to a host are held to.
+/// </summary>
+/// <param name="host">UTF-8 encoded host name, e.g. "userpresence.xboxlive.com".  
+/// Pass nullptr or an empty string to set the budget for hosts without one of their own.</param>
+/// <param name="budget">The budget for each user calling the host. Pass nullptr to remove the budget.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Calls that would exceed the budget wait until it allows them instead of being sent and throttled 
+/// by the service. Background calls, such as event uploads and Social Manager refreshes, leave a quarter 
+/// of the budget for other calls.  
+/// After a 429 response, calls to the host wait for the period in its Retry-After header 
+/// whether or not a budget is set.  
+/// No budgets are set by default.
+/// </remarks>
+STDAPI XblHttpCallSetBudget(
+    _In_opt_z_ const char* host,
+    _In_opt_ const XblHttpCallBudget* budget
+    ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the remaining budget of a user for a host.
+/// </summary>
+/// <param name="xboxUserId">The Xbox User ID of the user making the calls.</param>
+/// <param name="host">UTF-8 encoded host name, e.g. "userpresence.xboxlive.com".</param>
+/// <param name="headroom">Passes back the remaining budget.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// The call counts start over once the user hasn't called the host for an hour.
+/// </remarks>
+STDAPI XblHttpCallGetBudgetHeadroom(
+    _In_ uint64_t xboxUserId,
+    _In_z_ const char* host,
+    _Out_ XblHttpCallBudgetHeadroom* headroom
+    ) XBL_NOEXCEPT;
 }
\ No newline at end of file
@@ -194,6 +194,24 @@ STDAPI XblLocalStorageSetHandlers(
     _In_opt_ void* context
 ) XBL_NOEXCEPT;
 
+/// <summary>
+/// Sets how many local storage operations XSAPI may hand to the storage handlers at once.
+/// </summary>
+/// <param name="maxConcurrentOperations">The maximum number of operations in progress at once, each on a different key.
+/// Pass 0 to restore the default.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Must be called before XblInitialize.  
+/// By default, handlers set with XblLocalStorageSetHandlers are invoked for one operation at a time, in the order
+/// XSAPI requested them. Setting a limit greater than 1 opts in to operations on different keys being in progress at the
+/// same time, so the handlers must support being invoked concurrently. Appends requested while an earlier write to the same
+/// key is waiting to start may then also be combined into that write. Operations on the same key are always performed one at
+/// a time and in order.
+/// </remarks>
+STDAPI XblLocalStorageSetMaxConcurrentOperations(
+    _In_ uint32_t maxConcurrentOperations
+) XBL_NOEXCEPT;
+
 #endif
 
 }
\ No newline at end of file
@@ -14,6 +14,8 @@ extern "C"
 #define XBL_TITLE_STORAGE_DEFAULT_UPLOAD_BLOCK_SIZE (256 * 1024)
 #define XBL_TITLE_STORAGE_MIN_DOWNLOAD_BLOCK_SIZE 1024
 #define XBL_TITLE_STORAGE_DEFAULT_DOWNLOAD_BLOCK_SIZE (1024 * 1024)
+#define XBL_TITLE_STORAGE_DEFAULT_DOWNLOAD_PARALLELISM 4
+#define XBL_TITLE_STORAGE_MAX_DOWNLOAD_PARALLELISM 16
 
 #define XBL_TITLE_STORAGE_BLOB_PATH_MAX_LENGTH (257 * 3)
 #define XBL_TITLE_STORAGE_BLOB_DISPLAY_NAME_MAX_LENGTH (129 * 3)
@@ -378,6 +380,90 @@ STDAPI XblTitleStorageDownloadBlobResult(
     _In_ XAsyncBlock* async,
     _Out_ XblTitleStorageBlobMetadata* blobMetadata
 ) XBL_NOEXCEPT;
+
+/// <summary>
+/// Sets how many blocks of a binary blob are downloaded at the same time.
+/// </summary>
+/// <param name="xboxLiveContext">An xbox live context handle created with XblContextCreateHandle.</param>
+/// <param name="maxConcurrentBlocks">The maximum number of block requests in flight for a single download.  
+/// Pass 1 to download one block at a time.  
+/// Values above XBL_TITLE_STORAGE_MAX_DOWNLOAD_PARALLELISM are clamped to it.  
+/// The default is XBL_TITLE_STORAGE_DEFAULT_DOWNLOAD_PARALLELISM.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// The first block of a binary blob is always downloaded on its own to learn the blob's length and ETag.  
+/// The remaining blocks are then requested with If-Match set to that ETag, so every block comes from the same version of the blob.  
+/// Applies to downloads started after this call.
+/// </remarks>
+STDAPI XblTitleStorageSetDownloadParallelism(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_ uint32_t maxConcurrentBlocks
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Counters for the title storage disk cache.
+/// </summary>
+typedef struct XblTitleStorageCacheStats
+{
+    /// <summary>
+    /// The number of downloads served from the cache after the service confirmed they were unchanged with a 304 response.
+    /// </summary>
+    uint64_t hits;
+
+    /// <summary>
+    /// The number of downloads that weren't in the cache.
+    /// </summary>
+    uint64_t misses;
+
+    /// <summary>
+    /// The number of cached entries replaced by a newer version from the service.
+    /// </summary>
+    uint64_t updates;
+
+    /// <summary>
+    /// The number of entries removed to stay within the budget.
+    /// </summary>
+    uint64_t evictions;
+
+    /// <summary>
+    /// The number of bytes that were served from the cache without being downloaded.
+    /// </summary>
+    uint64_t bytesSaved;
+
+    /// <summary>
+    /// The number of bytes the cache currently holds.
+    /// </summary>
+    uint64_t bytesStored;
+} XblTitleStorageCacheStats;
+
+/// <summary>
+/// Enables a persistent cache of downloaded blobs and blob metadata.
+/// </summary>
+/// <param name="budgetInBytes">The most storage the cached data of each user may use.  
+/// The least recently used entries are evicted first. Pass 0 to disable the cache.  
+/// The cache is disabled by default. While it is disabled, what it holds for a user, including anything an earlier launch 
+/// left, is deleted the next time title storage is used with that user.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// The cache is kept with XblLocalStorage, so it persists between launches of the title.  
+/// A cached entry is never used without checking with the service: the request is sent with If-None-Match set to
+/// the entry's ETag, and the entry is only used if the service responds with 304 Not Modified.  
+/// Blob downloads are only cached when etagMatchCondition is XblTitleStorageETagMatchCondition::NotUsed.  
+/// The cache is shared by all Xbox live contexts of a user. Each user's entries are kept and deleted through 
+/// XblLocalStorage with that user.
+/// </remarks>
+STDAPI XblTitleStorageSetCacheBudget(
+    _In_ size_t budgetInBytes
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the counters for the title storage disk cache.
+/// </summary>
+/// <param name="stats">Passes back the cache counters, counted since XblInitialize.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblTitleStorageGetCacheStats(
+    _Out_ XblTitleStorageCacheStats* stats
+) XBL_NOEXCEPT;
     
 /// <summary>
 /// Uploads blob data to title storage.
@@ -196,4 +196,107 @@ STDAPI XblContextSettingsSetUseCrossPlatformQosServers(
     _In_ bool value
 ) XBL_NOEXCEPT;
 
+/// <summary>
+/// Gets the minimum request body size that is compressed when sending to a host on the compression allow list.
+/// </summary>
+/// <param name="context">Xbox live context that the settings are associated with.</param>
+/// <param name="thresholdInBytes">Passes back the compression threshold in bytes. Default is 1024 bytes.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblContextSettingsGetRequestCompressionThreshold(
+    _In_ XblContextHandle context,
+    _Out_ size_t* thresholdInBytes
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Enables gzip compression of request bodies sent to the given hosts.
+/// </summary>
+/// <param name="context">Xbox live context that the settings are associated with.</param>
+/// <param name="thresholdInBytes">Request bodies smaller than this are sent uncompressed. Default is 1024 bytes.</param>
+/// <param name="hosts">Host names that accept compressed requests, e.g. "userpresence.xboxlive.com".  
+/// Each entry also matches its subdomains.</param>
+/// <param name="hostsCount">The number of hosts. Pass 0 to disable compression, which is the default.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Compressed requests are sent with a "Content-Encoding: gzip" header and are only used when they are
+/// smaller than the original body. Calls to allowed hosts also accept gzip and deflate compressed responses,
+/// which are decompressed before being returned to the caller.  
+/// Only add hosts that are known to accept compressed request bodies.
+/// </remarks>
+STDAPI XblContextSettingsSetRequestCompression(
+    _In_ XblContextHandle context,
+    _In_ size_t thresholdInBytes,
+    _In_reads_(hostsCount) const char** hosts,
+    _In_ size_t hostsCount
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Counters for the HTTP response cache of an Xbox live context.
+/// </summary>
+typedef struct XblHttpResponseCacheStats
+{
+    /// <summary>
+    /// The number of requests served from the cache without contacting the service.
+    /// </summary>
+    uint64_t hits;
+
+    /// <summary>
+    /// The number of requests for responses that weren't in the cache.
+    /// </summary>
+    uint64_t misses;
+
+    /// <summary>
+    /// The number of cached responses the service confirmed were unchanged with a 304 response.
+    /// </summary>
+    uint64_t revalidations;
+
+    /// <summary>
+    /// The number of requests that waited on an identical request that was already in flight.
+    /// </summary>
+    uint64_t coalescedRequests;
+
+    /// <summary>
+    /// The number of response body bytes that were served without being downloaded.
+    /// </summary>
+    uint64_t bytesSaved;
+
+    /// <summary>
+    /// The number of bytes the cache currently holds.
+    /// </summary>
+    uint64_t bytesStored;
+} XblHttpResponseCacheStats;
+
+/// <summary>
+/// Enables caching of GET responses from the given hosts.
+/// </summary>
+/// <param name="context">Xbox live context that the settings are associated with.</param>
+/// <param name="budgetInBytes">The most memory cached responses may use.  
+/// The least recently used responses are evicted first. Default is 1 MB.</param>
+/// <param name="hosts">Host names whose responses are cached, e.g. "privacy.xboxlive.com".  
+/// Each entry also matches its subdomains.</param>
+/// <param name="hostsCount">The number of hosts. Pass 0 to disable the cache, which is the default.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Responses are cached according to their ETag and Cache-Control headers. A response is served from the cache
+/// until its max-age passes, after which it is revalidated with an If-None-Match request. Identical GET requests
+/// made while one is already in flight wait for that request rather than making their own.  
+/// The cache is shared by all calls made with this context.
+/// </remarks>
+STDAPI XblContextSettingsSetHttpResponseCache(
+    _In_ XblContextHandle context,
+    _In_ size_t budgetInBytes,
+    _In_reads_(hostsCount) const char** hosts,
+    _In_ size_t hostsCount
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the counters for the HTTP response cache.
+/// </summary>
+/// <param name="context">Xbox live context that the settings are associated with.</param>
+/// <param name="stats">Passes back the cache counters. They are all zero if the cache is disabled.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblContextSettingsGetHttpResponseCacheStats(
+    _In_ XblContextHandle context,
+    _Out_ XblHttpResponseCacheStats* stats
+) XBL_NOEXCEPT;
+
 }
\ No newline at end of file
@@ -108,6 +108,115 @@ STDAPI XblMemGetFunctions(
     _Out_ XblMemFreeFunction* memFreeFunc
 ) XBL_NOEXCEPT;
 
+/// <summary>
+/// Identifies an XSAPI subsystem whose allocations can be routed through a dedicated arena.
+/// </summary>
+enum class XblMemSubsystem : uint32_t
+{
+    /// <summary>
+    /// Social manager graph and user group state.
+    /// </summary>
+    SocialManager,
+
+    /// <summary>
+    /// Multiplayer manager client and pending request state.
+    /// </summary>
+    MultiplayerManager,
+
+    /// <summary>
+    /// Real time activity connection and subscription state.
+    /// </summary>
+    RealTimeActivity,
+
+    /// <summary>
+    /// Events upload queue state.
+    /// </summary>
+    Events
+};
+
+/// <summary>
+/// Defines how allocations for a subsystem are serviced.
+/// </summary>
+enum class XblMemArenaPolicy : uint32_t
+{
+    /// <summary>
+    /// Every allocation is forwarded directly to the memory hooks.
+    /// </summary>
+    Default,
+
+    /// <summary>
+    /// Small allocations (container nodes, shared_ptr control blocks, etc.) are served from
+    /// size-class pools. Pool slabs are allocated with the memory hooks and are returned to them
+    /// during XblCleanupAsync. Larger allocations are forwarded directly to the memory hooks.
+    /// </summary>
+    SizeClassPool
+};
+
+/// <summary>
+/// Allocation counters for a single subsystem.
+/// </summary>
+typedef struct XblMemSubsystemStats
+{
+    /// <summary>
+    /// Number of bytes currently allocated by the subsystem.
+    /// </summary>
+    uint64_t bytesInUse;
+
+    /// <summary>
+    /// High water mark of bytesInUse.
+    /// </summary>
+    uint64_t peakBytesInUse;
+
+    /// <summary>
+    /// Number of bytes currently reserved from the memory hooks for the subsystem's size-class pools.
+    /// </summary>
+    uint64_t bytesReserved;
+
+    /// <summary>
+    /// Total number of allocations made by the subsystem. Sample this periodically to compute an allocation rate.
+    /// </summary>
+    uint64_t allocationCount;
+
+    /// <summary>
+    /// Total number of frees made by the subsystem.
+    /// </summary>
+    uint64_t freeCount;
+
+    /// <summary>
+    /// Number of allocations that were served from a size-class pool rather than the memory hooks.
+    /// </summary>
+    uint64_t pooledAllocationCount;
+} XblMemSubsystemStats;
+
+/// <summary>
+/// Sets the arena policy used for a subsystem's allocations.
+/// </summary>
+/// <param name="subsystem">The subsystem to configure.</param>
+/// <param name="policy">The policy to use for the subsystem.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// This must be called before XblInitialize() and can not be called again until XblCleanup().
+/// Regardless of policy, all memory is ultimately allocated with the functions set by XblMemSetFunctions().
+/// </remarks>
+STDAPI XblMemSetArenaPolicy(
+    _In_ XblMemSubsystem subsystem,
+    _In_ XblMemArenaPolicy policy
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets the allocation counters for a subsystem.
+/// </summary>
+/// <param name="subsystem">The subsystem to query.</param>
+/// <param name="stats">Passes back the current counters for the subsystem.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Counters are maintained for every subsystem regardless of the configured XblMemArenaPolicy.
+/// </remarks>
+STDAPI XblMemGetSubsystemStats(
+    _In_ XblMemSubsystem subsystem,
+    _Out_ XblMemSubsystemStats* stats
+) XBL_NOEXCEPT;
+
 /////////////////////////////////////////////////////////////////////////////////////////
 // Global APIs
 //
@@ -366,6 +475,117 @@ STDAPI_(void) XblRemoveServiceCallRoutedHandler(
     _In_ XblFunctionContext token
 ) XBL_NOEXCEPT;
 
+/////////////////////////////////////////////////////////////////////////////////////////
+// Profiling APIs
+//
+
+/// <summary>
+/// Identifies an instrumented XSAPI code path.
+/// </summary>
+enum class XblProfileArea : uint32_t
+{
+    /// <summary>
+    /// Time from starting an HTTP request with libHttpClient until its response is received.
+    /// </summary>
+    HttpPerform,
+
+    /// <summary>
+    /// Time to fetch an auth token and signature for a service call.
+    /// </summary>
+    TokenFetch,
+
+    /// <summary>
+    /// Time to parse a service response body.
+    /// </summary>
+    JsonParse,
+
+    /// <summary>
+    /// Time to handle an incoming real time activity message and dispatch it to subscriptions.
+    /// </summary>
+    RtaMessageDispatch,
+
+    /// <summary>
+    /// Time spent in XblSocialManagerDoWork.
+    /// </summary>
+    SocialManagerDoWork,
+
+    /// <summary>
+    /// Time spent in XblMultiplayerManagerDoWork.
+    /// </summary>
+    MultiplayerManagerDoWork,
+
+    /// <summary>
+    /// Time spent in XblAchievementsManagerDoWork.
+    /// </summary>
+    AchievementsManagerDoWork
+};
+
+/// <summary>
+/// Latency statistics for a single XblProfileArea. Percentiles are approximated from a fixed-bucket
+/// histogram and are accurate to within 25%.
+/// </summary>
+typedef struct XblProfileAreaStats
+{
+    /// <summary>
+    /// Number of samples recorded since the profiler was last reset.
+    /// </summary>
+    uint64_t count;
+
+    /// <summary>
+    /// Sum of all recorded samples in microseconds.
+    /// </summary>
+    uint64_t totalMicroseconds;
+
+    /// <summary>
+    /// Median latency in microseconds.
+    /// </summary>
+    uint64_t p50Microseconds;
+
+    /// <summary>
+    /// 99th percentile latency in microseconds.
+    /// </summary>
+    uint64_t p99Microseconds;
+
+    /// <summary>
+    /// Largest recorded sample in microseconds.
+    /// </summary>
+    uint64_t maxMicroseconds;
+} XblProfileAreaStats;
+
+/// <summary>
+/// Enables or disables collection of profiling samples.
+/// </summary>
+/// <param name="enabled">True to start recording samples, false to stop.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Profiling is disabled by default. While disabled the instrumented code paths do not read the clock.
+/// Previously recorded samples are kept until XblProfilerReset is called.
+/// </remarks>
+STDAPI XblProfilerSetEnabled(
+    _In_ bool enabled
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Gets a snapshot of the latency statistics for an area.
+/// </summary>
+/// <param name="area">The area to query.</param>
+/// <param name="stats">Passes back the statistics for the area.</param>
+/// <returns>HRESULT return code for this API operation.</returns>
+/// <remarks>
+/// Samples are recorded concurrently, so a snapshot taken while instrumented code is running
+/// may not include samples that are being recorded at that moment.
+/// </remarks>
+STDAPI XblProfilerGetStats(
+    _In_ XblProfileArea area,
+    _Out_ XblProfileAreaStats* stats
+) XBL_NOEXCEPT;
+
+/// <summary>
+/// Clears the recorded samples for all areas.
+/// </summary>
+/// <returns>HRESULT return code for this API operation.</returns>
+STDAPI XblProfilerReset() XBL_NOEXCEPT;
+
 /// <summary>
 /// Internal use only.
 /// </summary>
@@ -172,7 +172,7 @@ try
                 return achievement.Hresult();
             }
 
-            std::shared_ptr<XblAchievementsManagerResult> resultHandle = MakeShared<XblAchievementsManagerResult>(achievement.ExtractPayload());//resultData);
+            std::shared_ptr<XblAchievementsManagerResult> resultHandle = achievement.ExtractPayload();
             *achievementResult = resultHandle.get(); 
             resultHandle->AddRef();
             return S_OK;    
@@ -214,19 +214,20 @@ try
             RETURN_HR_INVALIDARGUMENT_IF(achievementsResult == nullptr);
             *achievementsResult = nullptr;
 
-            auto achievements = achievementsManager.GetAchievements(xboxUserId);
+            AchievementsManagerSortFilterSettings sortOptions{ sortField, sortOrder, AchievementsManagerFilterType::All };
+            auto achievements = achievementsManager.GetAchievements(xboxUserId, sortOptions);
             if (Failed(achievements))
             {
                 LOGS_ERROR << achievements.ErrorMessage();
                 return achievements.Hresult();
             }
             
-            if (achievements.Payload().second == 0)
+            if (achievements.Payload()->Achievements().empty())
             {
                 return E_UNEXPECTED;
             }
             
-            std::shared_ptr<XblAchievementsManagerResult> resultHandle = MakeShared<XblAchievementsManagerResult>(achievements.Payload().first, achievements.Payload().second, true);
+            std::shared_ptr<XblAchievementsManagerResult> resultHandle = achievements.ExtractPayload();
             *achievementsResult = resultHandle.get();
             resultHandle->AddRef();
             
@@ -291,7 +292,7 @@ try
             // don't need to return an error for getting an empty vector, as it means there
             // were no elements that matched made it through the filter.
 
-            std::shared_ptr<XblAchievementsManagerResult> resultHandle = MakeShared<XblAchievementsManagerResult>(achievements.Payload());
+            std::shared_ptr<XblAchievementsManagerResult> resultHandle = achievements.ExtractPayload();
             *achievementsResult = resultHandle.get();
             resultHandle->AddRef();
             return S_OK;
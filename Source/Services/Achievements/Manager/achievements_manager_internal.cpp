@@ -8,27 +8,12 @@
 
 using namespace xbox::services;
 
-XblAchievementsManagerResult::XblAchievementsManagerResult(_In_ const XblAchievement & achievement)
-    : m_achievements({ achievement }),
-    m_achievementsData(nullptr),
-    m_achievementsCount(),
-    m_explicitCleanup(false)
-{
-}
-
-XblAchievementsManagerResult::XblAchievementsManagerResult(_In_ Vector<XblAchievement>& achievements, _In_ bool explicitCleanup)
+XblAchievementsManagerResult::XblAchievementsManagerResult(
+    _In_ Vector<XblAchievement>&& achievements,
+    _In_ std::shared_ptr<const achievements::manager::AchievementsCache> cache
+)
     : m_achievements(std::move(achievements)),
-    m_achievementsData(m_achievements.data()),
-    m_achievementsCount(m_achievements.size()),
-    m_explicitCleanup(explicitCleanup)
-{
-}
-
-XblAchievementsManagerResult::XblAchievementsManagerResult(_In_ XblAchievement* achievements, _In_ size_t achievementCount, _In_ bool explicitCleanup)
-    : m_achievements(achievements, achievements + achievementCount),
-    m_achievementsData(achievements),
-    m_achievementsCount(achievementCount),
-    m_explicitCleanup(explicitCleanup)
+    m_cache(std::move(cache))
 {
 }
 
@@ -38,12 +23,6 @@ XblAchievementsManagerResult::~XblAchievementsManagerResult()
     {
         achievements::manager::AchievementsManager::CleanUpAchievementCopyForResult(achievement);
     }
-    if (m_explicitCleanup)
-    {
-        DeleteArray<XblAchievement>(m_achievementsData, m_achievementsCount);
-    }
-    m_achievementsData = nullptr;
-    m_achievementsCount = 0;
     m_achievements.clear();
 }
 
@@ -59,10 +38,146 @@ std::shared_ptr<xbox::services::RefCounter> XblAchievementsManagerResult::GetSha
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_MANAGER_CPP_BEGIN
 
+AchievementsCache::AchievementsCache(
+    _In_ Vector<XblAchievement>&& achievements
+) noexcept :
+    m_achievements{ std::move(achievements) }
+{
+    // Store achievements in id order, which is also the default order they are returned in
+    std::sort(m_achievements.begin(), m_achievements.end(), [](const XblAchievement& a, const XblAchievement& b)
+    {
+        return strcmp(a.id, b.id) < 0;
+    });
+
+    m_indexById.reserve(m_achievements.size());
+    for (uint32_t index = 0; index < m_achievements.size(); ++index)
+    {
+        m_indexById[m_achievements[index].id] = index;
+        for (size_t filter = 0; filter < FilterCount; ++filter)
+        {
+            if (MatchesFilter(m_achievements[index], static_cast<AchievementsManagerFilterType>(filter)))
+            {
+                m_views[filter].byId.push_back(index);
+                m_views[filter].byUnlockTime.push_back(index);
+            }
+        }
+    }
+
+    for (auto& view : m_views)
+    {
+        std::sort(view.byUnlockTime.begin(), view.byUnlockTime.end(), [this](uint32_t lhs, uint32_t rhs)
+        {
+            return UnlockTimeLess(lhs, rhs);
+        });
+    }
+}
+
+AchievementsCache::~AchievementsCache() noexcept
+{
+    for (auto& achievement : m_achievements)
+    {
+        AchievementsManager::CleanUpDeepCopyAchievement(achievement);
+    }
+}
+
+size_t AchievementsCache::Size() const noexcept
+{
+    return m_achievements.size();
+}
+
+const XblAchievement& AchievementsCache::operator[](_In_ uint32_t index) const noexcept
+{
+    return m_achievements[index];
+}
+
+XblAchievement* AchievementsCache::Find(_In_ const String& id) noexcept
+{
+    auto iter{ m_indexById.find(id) };
+    return iter == m_indexById.end() ? nullptr : &m_achievements[iter->second];
+}
+
+void AchievementsCache::AchievementUpdated(_In_ const XblAchievement& achievement) noexcept
+{
+    assert(&achievement >= m_achievements.data() && &achievement < m_achievements.data() + m_achievements.size());
+    auto index{ static_cast<uint32_t>(&achievement - m_achievements.data()) };
+
+    RemoveFromViews(index);
+    AddToViews(index);
+}
+
+const Vector<uint32_t>& AchievementsCache::View(
+    _In_ AchievementsManagerFilterType filter,
+    _In_ bool byUnlockTime
+) const noexcept
+{
+    auto& view{ m_views[static_cast<size_t>(filter)] };
+    return byUnlockTime ? view.byUnlockTime : view.byId;
+}
+
+bool AchievementsCache::MatchesFilter(
+    const XblAchievement& achievement,
+    AchievementsManagerFilterType filter
+) noexcept
+{
+    switch (filter)
+    {
+    case AchievementsManagerFilterType::Unlocked:
+        return achievement.progressState == XblAchievementProgressState::Achieved;
+    case AchievementsManagerFilterType::InProgress:
+        return achievement.progressState == XblAchievementProgressState::InProgress;
+    case AchievementsManagerFilterType::NotStarted:
+        return achievement.progressState == XblAchievementProgressState::NotStarted;
+    default:
+        return true;
+    }
+}
+
+bool AchievementsCache::UnlockTimeLess(uint32_t lhs, uint32_t rhs) const noexcept
+{
+    // Break ties by id order so that views have a well defined order
+    auto lhsTime{ m_achievements[lhs].progression.timeUnlocked };
+    auto rhsTime{ m_achievements[rhs].progression.timeUnlocked };
+    return lhsTime < rhsTime || (lhsTime == rhsTime && lhs < rhs);
+}
+
+void AchievementsCache::AddToViews(uint32_t index) noexcept
+{
+    for (size_t filter = 0; filter < FilterCount; ++filter)
+    {
+        if (MatchesFilter(m_achievements[index], static_cast<AchievementsManagerFilterType>(filter)))
+        {
+            auto& view{ m_views[filter] };
+            view.byId.insert(std::lower_bound(view.byId.begin(), view.byId.end(), index), index);
+            view.byUnlockTime.insert(std::upper_bound(view.byUnlockTime.begin(), view.byUnlockTime.end(), index, [this](uint32_t lhs, uint32_t rhs)
+            {
+                return UnlockTimeLess(lhs, rhs);
+            }), index);
+        }
+    }
+}
+
+void AchievementsCache::RemoveFromViews(uint32_t index) noexcept
+{
+    for (auto& view : m_views)
+    {
+        auto idIter{ std::lower_bound(view.byId.begin(), view.byId.end(), index) };
+        if (idIter != view.byId.end() && *idIter == index)
+        {
+            view.byId.erase(idIter);
+
+            // The unlock time may have changed, so the old position can't be found with a binary search
+            auto timeIter{ std::find(view.byUnlockTime.begin(), view.byUnlockTime.end(), index) };
+            assert(timeIter != view.byUnlockTime.end());
+            view.byUnlockTime.erase(timeIter);
+        }
+    }
+}
+
 AchievementsManagerUser::AchievementsManagerUser(
     _In_ User&& localUser,
     _In_ const TaskQueue& queue
 ) noexcept :
+    m_achievements{ MakeShared<AchievementsCache>() },
     m_xuid{ localUser.Xuid() },
     m_rtaManager{ GlobalState::Get()->RTAManager() },
     m_queue{ queue.DeriveWorkerQueue() }
@@ -93,12 +208,6 @@ AchievementsManagerUser::~AchievementsManagerUser()
     }
 
     m_rtaManager->Deactivate(m_xblContext->User());
-
-    for (auto& pair : m_userAchievements)
-    {
-        AchievementsManager::CleanUpDeepCopyAchievement(*pair.second);
-    }
-    DeleteArray(m_achievementCache, m_userAchievements.size());
 }
 
 Result<void> AchievementsManagerUser::Initialize(
@@ -116,14 +225,21 @@ Result<void> AchievementsManagerUser::Initialize(
             auto sharedThis{ weakThis.lock() };
             if (sharedThis)
             {
+                std::shared_ptr<AchievementsCache> cache;
+                {
+                    std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                    cache = sharedThis->m_achievements;
+                }
+
                 // convert to manager event
                 for (uint32_t entryIndex = 0; entryIndex < args.entryCount; ++entryIndex)
                 {
                     // In rare cases, we may get a notification for an achievement that we don't have
                     //  cached. We'll log but otherwise ignore the RTA notification in those cases
                     auto achievementId = args.updatedAchievementEntries[entryIndex].achievementId;
+                    auto cachedAchievement = cache->Find(achievementId);
 
-                    if (sharedThis->m_userAchievements.find(achievementId) == sharedThis->m_userAchievements.end())
+                    if (cachedAchievement == nullptr)
                     {
                         LOGS_WARN << "Ignoring unexpected Achievement Progress RTA event for achievement not in the AchievementManager local cache.";
                         continue;
@@ -149,7 +265,6 @@ Result<void> AchievementsManagerUser::Initialize(
                         auto& requirement = progression.requirements[i];
                         if (requirement.targetProgressValue == nullptr)
                         {
-                            auto& cachedAchievement = sharedThis->m_userAchievements[achievementEvent.progressInfo.achievementId];
                             auto& cachedProgression = cachedAchievement->progression;
 
                             auto matchedRequirement = std::find_if(cachedProgression.requirements, cachedProgression.requirements +cachedProgression.requirementsCount,
@@ -281,94 +396,76 @@ uint64_t AchievementsManagerUser::Xuid() const
     return m_xuid;
 }
 
-Result<XblAchievement> AchievementsManagerUser::GetAchievement(_In_ const String & id)
+Result<std::shared_ptr<XblAchievementsManagerResult>> AchievementsManagerUser::GetAchievement(_In_ const String & id)
 {
-    if (m_userAchievements.find(id) == m_userAchievements.end())
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto achievement{ m_achievements->Find(id) };
+    if (achievement == nullptr)
     {
         char errorMsg[1024];
         SPRINTF(errorMsg, 1024, "Cannot find achievement with ID %s for user with ID %llu.", id.c_str(), static_cast<unsigned long long>(m_xuid));
         return { E_BOUNDS, errorMsg };
     }
 
-    std::lock_guard<std::mutex> lock{ m_mutex };
-    return AchievementsManager::CopyAchievementForResult(*m_userAchievements[id]);
+    Vector<XblAchievement> achievements{ AchievementsManager::CopyAchievementForResult(*achievement) };
+    return MakeShared<XblAchievementsManagerResult>(std::move(achievements), m_achievements);
 }
 
-XblAchievement* AchievementsManagerUser::GetAchievements() 
-{
-    std::lock_guard<std::mutex> lock{ m_mutex };
-    return AchievementsManager::DeepCopyAchievements(m_achievementCache, m_userAchievements.size());
-}
-
-Vector<XblAchievement> AchievementsManagerUser::GetAchievements(
+std::shared_ptr<XblAchievementsManagerResult> AchievementsManagerUser::GetAchievements(
     _In_ AchievementsManagerSortFilterSettings sortFilterSettings
 )
 {
-    Vector<XblAchievement> filteredAchievements;
-    
+    // We only sort on UnlockTime, since we don't offer achievements from multiple
+    //  titles. This would need to change if we ever give more options for values to
+    //  sort on.
+    bool byUnlockTime = sortFilterSettings.sortBy == XblAchievementOrderBy::UnlockTime &&
+        sortFilterSettings.sortOrder != XblAchievementsManagerSortOrder::Unsorted;
+    auto sortOrder = byUnlockTime ? sortFilterSettings.sortOrder : XblAchievementsManagerSortOrder::Unsorted;
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    // Snapshots are immutable, so if nothing has changed since the last request for this
+    //  view, the same snapshot can be handed out again.
+    auto& snapshot = m_snapshots[static_cast<size_t>(sortFilterSettings.stateFilter)][static_cast<size_t>(sortOrder)];
+    if (!snapshot)
     {
-        std::lock_guard<std::mutex> lock{ m_mutex };
-        for (const auto& pair : m_userAchievements)
+        const Vector<uint32_t>& view = m_achievements->View(sortFilterSettings.stateFilter, byUnlockTime);
+
+        Vector<XblAchievement> achievements;
+        achievements.reserve(view.size());
+        if (sortOrder == XblAchievementsManagerSortOrder::Descending)
         {
-            const XblAchievement& achievement = *pair.second;
-            bool isIncluded = true;
-            
-            // Does this achievement match the state requested?
-            switch (sortFilterSettings.stateFilter)
+            for (auto iter = view.rbegin(); iter != view.rend(); ++iter)
             {
-            case AchievementsManagerFilterType::Unlocked:
-                isIncluded &= achievement.progressState == XblAchievementProgressState::Achieved;
-                break;
-            case AchievementsManagerFilterType::InProgress:
-                isIncluded &= achievement.progressState == XblAchievementProgressState::InProgress;
-                break;
-            case AchievementsManagerFilterType::NotStarted:
-                isIncluded &= achievement.progressState == XblAchievementProgressState::NotStarted;
-                break; 
-            default:
-                break; // Don't need to &= true here, it's just a wasted op.
+                achievements.push_back(AchievementsManager::CopyAchievementForResult((*m_achievements)[*iter]));
             }
-
-            if (isIncluded)
+        }
+        else
+        {
+            for (auto index : view)
             {
-                // Pushing back a shallow copy here, in case we need to truncate
-                //  the list before we return it.
-                filteredAchievements.push_back(achievement);
+                achievements.push_back(AchievementsManager::CopyAchievementForResult((*m_achievements)[index]));
             }
         }
+        snapshot = MakeShared<XblAchievementsManagerResult>(std::move(achievements), m_achievements);
     }
-    
-    // We only sort on UnlockTime, since we don't offer achievements from multiple
-    //  titles. This would need to change if we ever give more options for values to
-    //  sort on.
-    if (sortFilterSettings.sortBy == XblAchievementOrderBy::UnlockTime)
+    return snapshot;
+}
+
+void AchievementsManagerUser::ResetSnapshots() noexcept
+{
+    for (auto& filterSnapshots : m_snapshots)
     {
-        // call sort function
-        if (sortFilterSettings.sortOrder == XblAchievementsManagerSortOrder::Ascending)
-        {
-            std::sort(filteredAchievements.begin(), filteredAchievements.end(), 
-                [](const XblAchievement& a, const XblAchievement& b) -> bool
-                {
-                    return a.progression.timeUnlocked < b.progression.timeUnlocked;
-                }
-            );
-        }
-        else if (sortFilterSettings.sortOrder == XblAchievementsManagerSortOrder::Descending)
+        for (auto& snapshot : filterSnapshots)
         {
-            std::sort(filteredAchievements.begin(), filteredAchievements.end(),
-                [](const XblAchievement& a, const XblAchievement& b) -> bool
-                {
-                    return a.progression.timeUnlocked > b.progression.timeUnlocked;
-                }
-            );
+            snapshot.reset();
         }
     }
-    return AchievementsManager::DeepCopyAchievements(filteredAchievements);
 }
 
 uint64_t AchievementsManagerUser::GetAchievementCount() const
 {
-    return m_userAchievements.size();
+    return m_achievements->Size();
 }
 
 Result<void> AchievementsManagerUser::CanUpdateAchievement(_In_ const String & achievementId, _In_ uint8_t progress)
@@ -379,26 +476,28 @@ Result<void> AchievementsManagerUser::CanUpdateAchievement(_In_ const String & a
         return S_OK;
     }
 
-    if (m_userAchievements.find(achievementId) == m_userAchievements.end())
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto achievement = m_achievements->Find(achievementId);
+    if (achievement == nullptr)
     {
         char errorMsg[1024];
         SPRINTF(errorMsg, 1024, "Requested achievement with ID %s doesn't exist.", achievementId.c_str());
         return { E_BOUNDS, errorMsg };
     }
-    if (m_userAchievements[achievementId]->progressState == XblAchievementProgressState::Achieved)
+    if (achievement->progressState == XblAchievementProgressState::Achieved)
     {
         char errorMsg[1024];
         SPRINTF(errorMsg, 1024, "Requested achievement with ID %s already achieved.", achievementId.c_str());
         return{ E_UNEXPECTED, errorMsg };
     }
-    if (m_userAchievements[achievementId]->progression.requirementsCount > 1)
+    if (achievement->progression.requirementsCount > 1)
     {
         char errorMsg[1024];
         SPRINTF(errorMsg, 1024, "Requested achievement with ID %s is an event based achievement and can't be updated through AchievementManager. Use the Stats API instead.", achievementId.c_str());
         return { E_NOT_SUPPORTED, errorMsg };
     }
 
-    uint32_t targetValue = xbox::services::utils::internal_string_to_uint32(m_userAchievements[achievementId]->progression.requirements[0].targetProgressValue);
+    uint32_t targetValue = xbox::services::utils::internal_string_to_uint32(achievement->progression.requirements[0].targetProgressValue);
     if (targetValue != 100)
     {
         char errorMsg[1024];
@@ -406,7 +505,7 @@ Result<void> AchievementsManagerUser::CanUpdateAchievement(_In_ const String & a
         return { E_NOT_SUPPORTED, errorMsg };
     }
 
-    uint32_t currentValue = xbox::services::utils::internal_string_to_uint32(m_userAchievements[achievementId]->progression.requirements[0].currentProgressValue);
+    uint32_t currentValue = xbox::services::utils::internal_string_to_uint32(achievement->progression.requirements[0].currentProgressValue);
     if (currentValue >= progress)
     {
         char errorMsg[1024];
@@ -609,13 +708,13 @@ bool ShouldUpdateProgress(const char* eventProgressValue, const char* cachedProg
 
 Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
 {
-    Vector<XblAchievementsManagerEvent> eventsToApply;
-    {
-        std::lock_guard<std::mutex> lock{ m_mutex };
-        eventsToApply = std::move(m_eventsToProcess);
-        eventsToApply.insert(eventsToApply.end(), m_generatedEvents.begin(), m_generatedEvents.end());
-        m_generatedEvents.clear();
-    }
+    // Hold the lock while applying events so that snapshots aren't created from a partially updated cache
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    Vector<XblAchievementsManagerEvent> eventsToApply = std::move(m_eventsToProcess);
+    eventsToApply.insert(eventsToApply.end(), m_generatedEvents.begin(), m_generatedEvents.end());
+    m_generatedEvents.clear();
+    bool cacheChanged = false;
 
     // Using a regular for-loop here since we are modifying the contents of the 
     //  vector while iterating over it. Using a range-based for loop or using
@@ -630,18 +729,25 @@ Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
         {
             bool createUnlockEvent = false;
 
+            XblAchievement* cachedAchievement = m_achievements->Find(achievementEvent.progressInfo.achievementId);
+            if (cachedAchievement == nullptr)
+            {
+                LOGS_WARN << "Ignoring progress event for achievement not in the AchievementManager local cache.";
+                break;
+            }
+
             const XblAchievementProgression& eventProgression = achievementEvent.progressInfo.progression;
-            XblAchievementProgression& cachedProgression = m_userAchievements[achievementEvent.progressInfo.achievementId]->progression;
+            XblAchievementProgression& cachedProgression = cachedAchievement->progression;
             
             // Explicitly not setting unlock time here, since if this is just getting achieved, we'll have an
             //  unlock event to handle that.
 
             // Only set the state of the achievement if the event makes the state "InProgress", and the 
             //  achievement wasn't already completed.
-            if (m_userAchievements[achievementEvent.progressInfo.achievementId]->progressState != XblAchievementProgressState::Achieved
+            if (cachedAchievement->progressState != XblAchievementProgressState::Achieved
                 && achievementEvent.progressInfo.progressState == XblAchievementProgressState::InProgress)
             {
-                m_userAchievements[achievementEvent.progressInfo.achievementId]->progressState = achievementEvent.progressInfo.progressState;
+                cachedAchievement->progressState = achievementEvent.progressInfo.progressState;
             }
 
             // Shortcut for if there is only one requirement in each to avoid the logic for the loop.            
@@ -705,6 +811,9 @@ Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
                 createUnlockEvent = (allRequirementsComplete || achievementEvent.progressInfo.progressState == XblAchievementProgressState::Achieved);
             }
 
+            m_achievements->AchievementUpdated(*cachedAchievement);
+            cacheChanged = true;
+
             if (createUnlockEvent)
             {
                 XblAchievementsManagerEvent unlockEvent;
@@ -724,7 +833,14 @@ Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
         case XblAchievementsManagerEventType::AchievementUnlocked:
         {
             auto achievementId = achievementEvent.progressInfo.achievementId;
-            XblAchievement& cachedAchievement = *m_userAchievements[achievementId];
+            XblAchievement* cachedAchievementPtr = m_achievements->Find(achievementId);
+            if (cachedAchievementPtr == nullptr)
+            {
+                LOGS_WARN << "Ignoring unlock event for achievement not in the AchievementManager local cache.";
+                break;
+            }
+
+            XblAchievement& cachedAchievement = *cachedAchievementPtr;
             if (cachedAchievement.progression.requirementsCount != achievementEvent.progressInfo.progression.requirementsCount)
             {
                 LOGS_ERROR << "Achievement event for achievement with ID " << achievementId << " has a different number of requirements than the cached version of the achievement.";
@@ -741,6 +857,9 @@ Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
                 Delete(cachedAchievement.progression.requirements[requirementIndex].currentProgressValue);
                 cachedAchievement.progression.requirements[requirementIndex].currentProgressValue = Make("100");
             }
+
+            m_achievements->AchievementUpdated(cachedAchievement);
+            cacheChanged = true;
             break;
         }
         default:
@@ -748,6 +867,11 @@ Vector<XblAchievementsManagerEvent> AchievementsManagerUser::ProcessEvents()
         }
     }
 
+    if (cacheChanged)
+    {
+        ResetSnapshots();
+    }
+
     return eventsToApply;
 }
 
@@ -871,7 +995,8 @@ HRESULT AchievementsManagerUser::HandleAchievementsResults(
                     // In rare cases we'll get back a notification that isn't in our local cache. If that happens
                     //  we'll simply ignore the new achievement until the title restarts or the user is removed
                     //  and re-added to achievements manager
-                    if (m_userAchievements.find(achievement.id) == m_userAchievements.end())
+                    auto cachedAchievement = m_achievements->Find(achievement.id);
+                    if (cachedAchievement == nullptr)
                     {
                         LOGS_WARN << "Fetch achievements returned new achievement that wasn't present in local achievement cache.";
                         continue;
@@ -880,7 +1005,7 @@ HRESULT AchievementsManagerUser::HandleAchievementsResults(
                     // We only want to have this function generate unlock events if we're expecting 
                     //  RTA notifications. Otherwise it will be produced from the progress change
                     //  event.
-                    auto generatedEvents = GenerateEventFromAchievementDiff(m_xuid, *m_userAchievements[achievement.id], achievement);
+                    auto generatedEvents = GenerateEventFromAchievementDiff(m_xuid, *cachedAchievement, achievement);
                     if (generatedEvents.size() > 0)
                     {
                         for (auto generatedEvent : generatedEvents)
@@ -975,13 +1100,9 @@ HRESULT AchievementsManagerUser::HandleAchievementsResults(
         {
             if (!m_isInitialized)
             {
-                size_t achievementCount = fetchedAchievements.size();
-                m_achievementCache = MakeArray<XblAchievement>(achievementCount);
-                for (size_t index = 0; index < achievementCount; ++index)
-                {
-                    m_achievementCache[index] = fetchedAchievements[index];
-                    m_userAchievements[m_achievementCache[index].id] = m_achievementCache + index;
-                }
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_achievements = MakeShared<AchievementsCache>(std::move(fetchedAchievements));
+                ResetSnapshots();
             }
             async.Complete(result.Hresult());
         }
@@ -1152,40 +1273,6 @@ XblAchievement AchievementsManager::DeepCopyAchievement(_In_ const XblAchievemen
     return copy;
 }
 
-XblAchievement* AchievementsManager::DeepCopyAchievements(XblAchievement* cache, size_t size)
-{
-    XblAchievement* copiedArray = MakeArray<XblAchievement>(cache, size);
-    memcpy(copiedArray, cache, sizeof(XblAchievement)*size);
-    
-    for (size_t index = 0; index < size; ++index)
-    {
-        // Need to do a deep copy of progression so that, if progress values change
-        //  while the title is still using a result from a prior frame, we do not
-        //  invalidate the memory that the requirement is using. 
-        copiedArray[index].progression.requirements = MakeArray<XblAchievementRequirement>(copiedArray[index].progression.requirementsCount);
-        XblAchievementRequirement* sourceRequirements = cache[index].progression.requirements;
-        for (uint64_t i = 0; i < copiedArray[index].progression.requirementsCount; ++i)
-        {
-            copiedArray[index].progression.requirements[i] = XblAchievementRequirement{
-                sourceRequirements[i].id,
-                Make(sourceRequirements[i].currentProgressValue),
-                sourceRequirements[i].targetProgressValue
-            };
-        }
-    }
-    return copiedArray;
-}
-
-Vector<XblAchievement> AchievementsManager::DeepCopyAchievements(const Vector<XblAchievement>& achievements)
-{
-    Vector<XblAchievement> achievementsCopy;
-    for (const auto& source : achievements)
-    {
-        achievementsCopy.push_back(CopyAchievementForResult(source));
-    }
-    return achievementsCopy;
-}
-
 HRESULT AchievementsManager::CleanUpDeepCopyAchievement(_In_ XblAchievement& achievement)
 {
     Delete(achievement.id);
@@ -1320,6 +1407,7 @@ HRESULT AchievementsManager::RemoveLocalUser(
 
 const Vector<XblAchievementsManagerEvent>& AchievementsManager::DoWork() XBL_NOEXCEPT
 {
+    XSAPI_PROFILE_SCOPE(XblProfileArea::AchievementsManagerDoWork);
     std::lock_guard<std::mutex> lock{ m_mutex };
 
     // Clean up the allocations made when doing the copy of the progress entry
@@ -1342,7 +1430,7 @@ const Vector<XblAchievementsManagerEvent>& AchievementsManager::DoWork() XBL_NOE
     return m_publishedEvents;
 }
 
-Result<XblAchievement> AchievementsManager::GetAchievement(
+Result<std::shared_ptr<XblAchievementsManagerResult>> AchievementsManager::GetAchievement(
     _In_ uint64_t xuid,
     _In_ const String achievementId
 )
@@ -1363,25 +1451,7 @@ Result<XblAchievement> AchievementsManager::GetAchievement(
     return m_localUsers[xuid]->GetAchievement(achievementId);
 }
 
-Result<std::pair<XblAchievement*, size_t>> AchievementsManager::GetAchievements(_In_ uint64_t xuid)
-{
-    if (m_localUsers.find(xuid) == m_localUsers.end())
-    {
-        char errorMsg[1024];
-        SPRINTF(errorMsg, 1024, "User with ID %llu not yet registered with AchievementsManager.", static_cast<unsigned long long>(xuid));
-        return { E_BOUNDS, errorMsg };
-    }
-    if (!m_localUsers[xuid]->IsInitialized())
-    {
-        char errorMsg[1024];
-        SPRINTF(errorMsg, 1024, "User with ID %llu not yet initialized.", static_cast<unsigned long long>(xuid));
-        return { E_UNEXPECTED, errorMsg };
-    }
-    
-    return std::pair<XblAchievement*, size_t>({ m_localUsers[xuid]->GetAchievements() , m_localUsers[xuid]->GetAchievementCount() });
-}
-
-Result<Vector<XblAchievement>> AchievementsManager::GetAchievements(
+Result<std::shared_ptr<XblAchievementsManagerResult>> AchievementsManager::GetAchievements(
     _In_ uint64_t xuid,
     _In_ AchievementsManagerSortFilterSettings requestConfig
 )
@@ -12,18 +12,23 @@ namespace achievements {
 namespace manager {
 
 class AchievementsManager;
+class AchievementsCache;
 
 }
 }
 }
 }
 
+// Immutable snapshot of some of a user's cached achievements. The achievements are copies made with
+// AchievementsManager::CopyAchievementForResult, which reference the static parts of the cached achievements,
+// so the snapshot keeps the cache alive. Snapshots are shared between API callers until the cache changes.
 struct XblAchievementsManagerResult : public xbox::services::RefCounter, public std::enable_shared_from_this<XblAchievementsManagerResult>
 {
 public: 
-    XblAchievementsManagerResult(_In_ const XblAchievement& achievement);
-    XblAchievementsManagerResult(_In_ Vector<XblAchievement>& achievements, _In_ bool explicitCleanup = false);
-    XblAchievementsManagerResult(_In_ XblAchievement* achievements, _In_ size_t achievementCount, _In_ bool explicitCleanup = false);
+    XblAchievementsManagerResult(
+        _In_ Vector<XblAchievement>&& achievements,
+        _In_ std::shared_ptr<const xbox::services::achievements::manager::AchievementsCache> cache
+    );
     virtual ~XblAchievementsManagerResult();
 
     const Vector<XblAchievement>& Achievements() const;
@@ -37,9 +42,7 @@ private:
     XblAchievementsManagerResult& operator=(XblAchievementsManagerResult other) = delete;
 
     Vector<XblAchievement> m_achievements;
-    XblAchievement* m_achievementsData;
-    size_t m_achievementsCount;
-    bool m_explicitCleanup;
+    std::shared_ptr<const xbox::services::achievements::manager::AchievementsCache> m_cache;
 };
 
 /// <summary>
@@ -96,6 +99,52 @@ struct AchievementsManagerSortFilterSettings
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_ACHIEVEMENTS_MANAGER_CPP_BEGIN
 
+// Contiguous store of a user's achievements, sorted by id. The achievements are deep copies owned by the cache.
+// For each AchievementsManagerFilterType the cache maintains the indexes of the matching achievements in both id
+// and unlock time order, so queries don't need to filter and sort the whole cache.
+class AchievementsCache
+{
+public:
+    AchievementsCache() = default;
+    AchievementsCache(_In_ Vector<XblAchievement>&& achievements) noexcept;
+    AchievementsCache(const AchievementsCache&) = delete;
+    AchievementsCache& operator=(const AchievementsCache&) = delete;
+    ~AchievementsCache() noexcept;
+
+    size_t Size() const noexcept;
+    const XblAchievement& operator[](_In_ uint32_t index) const noexcept;
+
+    // Returns nullptr if there is no cached achievement with the id
+    XblAchievement* Find(_In_ const String& id) noexcept;
+
+    // Updates the filtered views. Must be called after the progressState or timeUnlocked of
+    // a cached achievement is changed.
+    void AchievementUpdated(_In_ const XblAchievement& achievement) noexcept;
+
+    // Indexes of the achievements matching a filter, in id order or ascending unlock time order
+    const Vector<uint32_t>& View(
+        _In_ AchievementsManagerFilterType filter,
+        _In_ bool byUnlockTime
+    ) const noexcept;
+
+private:
+    static bool MatchesFilter(const XblAchievement& achievement, AchievementsManagerFilterType filter) noexcept;
+    bool UnlockTimeLess(uint32_t lhs, uint32_t rhs) const noexcept;
+    void AddToViews(uint32_t index) noexcept;
+    void RemoveFromViews(uint32_t index) noexcept;
+
+    static constexpr size_t FilterCount{ static_cast<size_t>(AchievementsManagerFilterType::InProgress) + 1 };
+    struct FilteredView
+    {
+        Vector<uint32_t> byId;
+        Vector<uint32_t> byUnlockTime;
+    };
+
+    Vector<XblAchievement> m_achievements;
+    UnorderedMap<String, uint32_t> m_indexById;
+    FilteredView m_views[FilterCount];
+};
+
 class AchievementsManagerUser : public std::enable_shared_from_this<AchievementsManagerUser>
 {
 public:
@@ -115,12 +164,12 @@ public:
 
     Vector<XblAchievementsManagerEvent> ProcessEvents();
 
-    Result<XblAchievement> GetAchievement(
+    Result<std::shared_ptr<XblAchievementsManagerResult>> GetAchievement(
         _In_ const String& id
     );
     
-    XblAchievement* GetAchievements();
-    Vector<XblAchievement> GetAchievements(
+    // Returns the snapshot for the requested view, creating it if the cache has changed since it was last requested
+    std::shared_ptr<XblAchievementsManagerResult> GetAchievements(
         _In_ AchievementsManagerSortFilterSettings sortFilterSettings
     );
     
@@ -147,13 +196,19 @@ private:
         _In_ Vector<XblAchievement> fetchedAchievements = Vector<XblAchievement>()
     );
 
+    // Drops result snapshots after the cache changes. Callers must hold m_mutex
+    void ResetSnapshots() noexcept;
+
     std::mutex m_mutex;
     bool m_isInitialized = false;
     bool m_isFetchingAchievements = true;
 
-    Map<String, XblAchievement*> m_userAchievements;
-    XblAchievement* m_achievementCache{ nullptr };
+    std::shared_ptr<AchievementsCache> m_achievements;
     uint64_t m_xuid{ 0 };
+
+    // Result snapshots indexed by AchievementsManagerFilterType and XblAchievementsManagerSortOrder. Reset when
+    // any cached achievement changes
+    std::shared_ptr<XblAchievementsManagerResult> m_snapshots[4][3];
    
     Vector<XblAchievementsManagerEvent> m_eventsToProcess;
     Vector<XblAchievementsManagerEvent> m_generatedEvents;
@@ -185,8 +240,6 @@ public:
     //  detatched from the original object. Requires parts of the object to be 
     //  manually deallocated.
     static XblAchievement DeepCopyAchievement(_In_ const XblAchievement& other);
-    static Vector<XblAchievement> DeepCopyAchievements(const Vector<XblAchievement>& achievements);
-    static XblAchievement* DeepCopyAchievements(XblAchievement* cache, size_t size);
 
     // Helper function that aids in freeing the dynamically allocated memory used 
     //  when creating a deep copy of an achievement. 
@@ -203,16 +256,12 @@ public:
 
     const Vector<XblAchievementsManagerEvent>& DoWork() XBL_NOEXCEPT;
 
-    Result<XblAchievement> GetAchievement(
+    Result<std::shared_ptr<XblAchievementsManagerResult>> GetAchievement(
         _In_ uint64_t xuid, 
         _In_ const String achievementId
     );
 
-    Result<std::pair<XblAchievement*, size_t>> GetAchievements(
-        _In_ uint64_t xuid
-    );
-
-    Result<Vector<XblAchievement>> GetAchievements(
+    Result<std::shared_ptr<XblAchievementsManagerResult>> GetAchievements(
         _In_ uint64_t xuid,
         _In_ AchievementsManagerSortFilterSettings requestConfig
     );
@@ -69,6 +69,7 @@
 #include <list>
 #include <assert.h>
 #include <array>
+#include <random>
 #if HC_PLATFORM_IS_MICROSOFT
 #include <objbase.h>
 #endif
@@ -111,6 +112,8 @@
 #include "ref_counter.h"
 #include "internal_errors.h"
 #include "Logger/log.h"
+#include "async_coroutine.h"
+#include "profiler.h"
 #include "xbox_live_app_config_internal.h"
 #include "user.h"
 #include "http_call_wrapper_internal.h"
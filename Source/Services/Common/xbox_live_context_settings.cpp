@@ -13,6 +13,36 @@ using namespace xbox::services;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+namespace
+{
+
+// Entries are lowercase host names and also match their subdomains
+bool IsHostListed(
+    _In_ const xsapi_internal_string& url,
+    _In_ const xsapi_internal_vector<xsapi_internal_string>& hosts
+)
+{
+    if (hosts.empty())
+    {
+        return false;
+    }
+
+    xsapi_internal_string host{ utils::HostFromUrl(url) };
+
+    for (const auto& endpoint : hosts)
+    {
+        if (host == endpoint ||
+            (host.size() > endpoint.size() && host[host.size() - endpoint.size() - 1] == '.' &&
+             host.compare(host.size() - endpoint.size(), endpoint.size(), endpoint) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
 #if __cplusplus_winrt
 Windows::UI::Core::CoreDispatcher^ XboxLiveContextSettings::_s_dispatcher;
 #endif
@@ -89,6 +119,80 @@ void XboxLiveContextSettings::SetUseCrossplatformQosServers(_In_ bool value)
     m_useXplatQosServer = value;
 }
 
+size_t XboxLiveContextSettings::RequestCompressionThreshold() const
+{
+    return m_requestCompressionThreshold;
+}
+
+void XboxLiveContextSettings::SetRequestCompressionThreshold(_In_ size_t thresholdInBytes)
+{
+    m_requestCompressionThreshold = thresholdInBytes;
+}
+
+bool XboxLiveContextSettings::IsCompressionAllowed(_In_ const xsapi_internal_string& url) const
+{
+    std::lock_guard<std::mutex> lock{ m_compressionEndpointsMutex };
+    return IsHostListed(url, m_compressionEndpoints);
+}
+
+void XboxLiveContextSettings::SetRequestCompressionEndpoints(_In_ xsapi_internal_vector<xsapi_internal_string> hosts)
+{
+    for (auto& host : hosts)
+    {
+        host = utils::ToLower(std::move(host));
+    }
+
+    std::lock_guard<std::mutex> lock{ m_compressionEndpointsMutex };
+    m_compressionEndpoints = std::move(hosts);
+}
+
+std::shared_ptr<HttpResponseCache> XboxLiveContextSettings::ResponseCache(_In_ const xsapi_internal_string& url) const
+{
+    std::lock_guard<std::mutex> lock{ m_responseCacheMutex };
+    return IsHostListed(url, m_responseCacheEndpoints) ? m_responseCache : nullptr;
+}
+
+size_t XboxLiveContextSettings::HttpResponseCacheBudget() const
+{
+    std::lock_guard<std::mutex> lock{ m_responseCacheMutex };
+    return m_responseCacheBudget;
+}
+
+HttpResponseCache::Stats XboxLiveContextSettings::HttpResponseCacheStats() const
+{
+    std::lock_guard<std::mutex> lock{ m_responseCacheMutex };
+    return m_responseCache ? m_responseCache->GetStats() : HttpResponseCache::Stats{};
+}
+
+void XboxLiveContextSettings::SetHttpResponseCache(
+    _In_ size_t budgetInBytes,
+    _In_ xsapi_internal_vector<xsapi_internal_string> hosts
+)
+{
+    for (auto& host : hosts)
+    {
+        host = utils::ToLower(std::move(host));
+    }
+
+    std::lock_guard<std::mutex> lock{ m_responseCacheMutex };
+    m_responseCacheBudget = budgetInBytes;
+    m_responseCacheEndpoints = std::move(hosts);
+
+    if (m_responseCacheEndpoints.empty() || budgetInBytes == 0)
+    {
+        // Calls already holding the cache keep using it until they complete
+        m_responseCache.reset();
+    }
+    else if (m_responseCache)
+    {
+        m_responseCache->SetBudget(budgetInBytes);
+    }
+    else
+    {
+        m_responseCache = MakeShared<HttpResponseCache>(budgetInBytes);
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
 
 STDAPI XblContextSettingsGetLongHttpTimeout(
@@ -236,3 +340,81 @@ try
     return S_OK;
 }
 CATCH_RETURN()
+
+STDAPI XblContextSettingsGetRequestCompressionThreshold(
+    _In_ XblContextHandle context,
+    _Out_ size_t* thresholdInBytes
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(context == nullptr || thresholdInBytes == nullptr);
+    *thresholdInBytes = context->Settings()->RequestCompressionThreshold();
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblContextSettingsSetRequestCompression(
+    _In_ XblContextHandle context,
+    _In_ size_t thresholdInBytes,
+    _In_reads_(hostsCount) const char** hosts,
+    _In_ size_t hostsCount
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF_NULL(context);
+    RETURN_HR_INVALIDARGUMENT_IF(hosts == nullptr && hostsCount > 0);
+
+    xsapi_internal_vector<xsapi_internal_string> compressionHosts;
+    for (size_t i = 0; i < hostsCount; ++i)
+    {
+        RETURN_HR_INVALIDARGUMENT_IF(hosts[i] == nullptr || hosts[i][0] == 0);
+        compressionHosts.emplace_back(hosts[i]);
+    }
+
+    context->Settings()->SetRequestCompressionThreshold(thresholdInBytes);
+    context->Settings()->SetRequestCompressionEndpoints(std::move(compressionHosts));
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblContextSettingsSetHttpResponseCache(
+    _In_ XblContextHandle context,
+    _In_ size_t budgetInBytes,
+    _In_reads_(hostsCount) const char** hosts,
+    _In_ size_t hostsCount
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF_NULL(context);
+    RETURN_HR_INVALIDARGUMENT_IF(hosts == nullptr && hostsCount > 0);
+
+    xsapi_internal_vector<xsapi_internal_string> cacheHosts;
+    for (size_t i = 0; i < hostsCount; ++i)
+    {
+        RETURN_HR_INVALIDARGUMENT_IF(hosts[i] == nullptr || hosts[i][0] == 0);
+        cacheHosts.emplace_back(hosts[i]);
+    }
+
+    context->Settings()->SetHttpResponseCache(budgetInBytes, std::move(cacheHosts));
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblContextSettingsGetHttpResponseCacheStats(
+    _In_ XblContextHandle context,
+    _Out_ XblHttpResponseCacheStats* stats
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(context == nullptr || stats == nullptr);
+
+    auto cacheStats{ context->Settings()->HttpResponseCacheStats() };
+    stats->hits = cacheStats.hits;
+    stats->misses = cacheStats.misses;
+    stats->revalidations = cacheStats.revalidations;
+    stats->coalescedRequests = cacheStats.joinedRequests;
+    stats->bytesSaved = cacheStats.bytesSaved;
+    stats->bytesStored = cacheStats.bytesStored;
+    return S_OK;
+}
+CATCH_RETURN()
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <unordered_map>
 #include "xsapi-c/xbox_live_context_settings_c.h"
+#include "http_response_cache.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
@@ -26,6 +27,8 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 #define DEFAULT_HTTP_RETRY_WINDOW_SECONDS (20)
 #define DEFAULT_RETRY_DELAY_SECONDS (2)
 #define MIN_RETRY_DELAY_SECONDS (2)
+#define DEFAULT_REQUEST_COMPRESSION_THRESHOLD_BYTES (1024)
+#define DEFAULT_HTTP_RESPONSE_CACHE_BUDGET_BYTES (1024 * 1024)
 
 enum class HttpCallAgent : uint32_t
 {
@@ -65,6 +68,24 @@ public:
     bool UseCrossplatformQosServers() const;
     void SetUseCrossplatformQosServers(_In_ bool value);
 
+    // Request bodies of at least RequestCompressionThreshold bytes are gzip compressed when sent to a host on the
+    // compression allow list. Responses from those hosts may also be compressed. The list is empty by default, so
+    // compression is opt-in per endpoint.
+    size_t RequestCompressionThreshold() const;
+    void SetRequestCompressionThreshold(_In_ size_t thresholdInBytes);
+
+    // Entries are host names, e.g. "userpresence.xboxlive.com", and also match their subdomains
+    bool IsCompressionAllowed(_In_ const xsapi_internal_string& url) const;
+    void SetRequestCompressionEndpoints(_In_ xsapi_internal_vector<xsapi_internal_string> hosts);
+
+    // GET responses from hosts on the response cache allow list are cached, within a budget of
+    // HttpResponseCacheBudget bytes, and shared by all the calls made with these settings. Like compression, the
+    // list is empty by default. Returns null if responses from the URL's host aren't cached.
+    std::shared_ptr<HttpResponseCache> ResponseCache(_In_ const xsapi_internal_string& url) const;
+    size_t HttpResponseCacheBudget() const;
+    HttpResponseCache::Stats HttpResponseCacheStats() const;
+    void SetHttpResponseCache(_In_ size_t budgetInBytes, _In_ xsapi_internal_vector<xsapi_internal_string> hosts);
+
 public:
 
 #if __cplusplus_winrt
@@ -82,6 +103,13 @@ private:
     bool m_useCoreDispatcherForEventRouting{ false };
 #endif
     bool m_useXplatQosServer{ HC_PLATFORM == HC_PLATFORM_XDK };
+    size_t m_requestCompressionThreshold{ DEFAULT_REQUEST_COMPRESSION_THRESHOLD_BYTES };
+    mutable std::mutex m_compressionEndpointsMutex;
+    xsapi_internal_vector<xsapi_internal_string> m_compressionEndpoints;
+    mutable std::mutex m_responseCacheMutex;
+    xsapi_internal_vector<xsapi_internal_string> m_responseCacheEndpoints;
+    size_t m_responseCacheBudget{ DEFAULT_HTTP_RESPONSE_CACHE_BUDGET_BYTES };
+    std::shared_ptr<HttpResponseCache> m_responseCache;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
\ No newline at end of file
@@ -64,6 +64,59 @@ try
 }
 CATCH_RETURN()
 
+STDAPI XblMemSetArenaPolicy(
+    _In_ XblMemSubsystem subsystem,
+    _In_ XblMemArenaPolicy policy
+) XBL_NOEXCEPT
+try
+{
+    if (GlobalState::Get())
+    {
+        return E_XBL_ALREADY_INITIALIZED;
+    }
+
+    return ArenaSetPolicy(subsystem, policy);
+}
+CATCH_RETURN()
+
+STDAPI XblMemGetSubsystemStats(
+    _In_ XblMemSubsystem subsystem,
+    _Out_ XblMemSubsystemStats* stats
+) XBL_NOEXCEPT
+try
+{
+    return ArenaGetStats(subsystem, stats);
+}
+CATCH_RETURN()
+
+STDAPI XblProfilerSetEnabled(
+    _In_ bool enabled
+) XBL_NOEXCEPT
+try
+{
+    Profiler::SetEnabled(enabled);
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblProfilerGetStats(
+    _In_ XblProfileArea area,
+    _Out_ XblProfileAreaStats* stats
+) XBL_NOEXCEPT
+try
+{
+    return Profiler::GetStats(area, stats);
+}
+CATCH_RETURN()
+
+STDAPI XblProfilerReset() XBL_NOEXCEPT
+try
+{
+    Profiler::Reset();
+    return S_OK;
+}
+CATCH_RETURN()
+
 STDAPI XblInitialize(
     _In_ const XblInitArgs* args
 ) XBL_NOEXCEPT
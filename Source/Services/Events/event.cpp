@@ -6,6 +6,7 @@
 #include "xbox_live_app_config_internal.h"
 #include "cll/BasicJsonWriter.h"
 #include "cll/ConversionHelpers.h"
+#include "journal.h"
 
 using namespace xbox::services;
 
@@ -13,6 +14,69 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
 
 #define EVENT_NAME_PREFIX "Microsoft.XboxLive.T"
 
+namespace
+{
+
+void AppendUInt64(xsapi_internal_vector<uint8_t>& data, uint64_t value)
+{
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void AppendString(xsapi_internal_vector<uint8_t>& data, const xsapi_internal_string& value)
+{
+    auto length{ static_cast<uint32_t>(value.size()) };
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        data.push_back(static_cast<uint8_t>(length >> (8 * i)));
+    }
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+bool ReadUInt64(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+{
+    if (static_cast<size_t>(end - data) < sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    data += sizeof(uint64_t);
+    return true;
+}
+
+bool ReadString(const uint8_t*& data, const uint8_t* end, xsapi_internal_string& value)
+{
+    if (static_cast<size_t>(end - data) < sizeof(uint32_t))
+    {
+        return false;
+    }
+
+    size_t length{ 0 };
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        length |= static_cast<size_t>(data[i]) << (8 * i);
+    }
+    data += sizeof(uint32_t);
+
+    if (static_cast<size_t>(end - data) < length)
+    {
+        return false;
+    }
+
+    value.assign(reinterpret_cast<const char*>(data), length);
+    data += length;
+    return true;
+}
+
+}
+
 Event::Event(
     _In_ uint64_t xuid,
     _In_ const xsapi_internal_string& eventName,
@@ -23,22 +87,12 @@ Event::Event(
     m_xuid{ xuid },
     m_eventName{ eventName },
     m_fullEventName{ EVENT_NAME_PREFIX + std::to_string(AppConfig::Instance()->TitleId()) + "." + m_eventName.data() },
+    m_dimensions{ JsonUtils::SerializeJson(dimensions) },
+    m_measurements{ JsonUtils::SerializeJson(measurements) },
     m_timestamp{ std::move(timestamp) }
 {
-
-    JsonUtils::CopyFrom(m_dimensions, dimensions);
-    JsonUtils::CopyFrom(m_measurements, measurements);
-
     bool state;
-
-    cll::BasicJsonWriter::StartObject(m_data, state);
-    cll::BasicJsonWriter::WriteField(m_data, state, "baseType", "Microsoft.XboxLive.InGame");
-    cll::BasicJsonWriter::StartStruct(m_data, state, "baseData");
-
-    cll::BasicJsonWriter::WriteField(m_data, state, "name", eventName.data());
-    cll::BasicJsonWriter::WriteField(m_data, state, "serviceConfigId", AppConfig::Instance()->Scid().data());
-    cll::BasicJsonWriter::WriteField(m_data, state, "titleId", std::to_string(AppConfig::Instance()->TitleId()));
-    cll::BasicJsonWriter::WriteField(m_data, state, "userId", utils::uint64_to_internal_string(xuid).data());
+    WriteDataHeader(state);
 
     if (dimensions.IsObject())
     {
@@ -73,15 +127,104 @@ Event::Event(
     cll::BasicJsonWriter::EndObject(m_data, state);
 }
 
-Event::Event(const Event& other)
+Event::Event(
+    _In_ uint64_t xuid,
+    _In_ const EventSchema& schema,
+    _In_reads_(schema.fieldCount) const XblEventFieldValue* values,
+    _In_ xbox::services::datetime timestamp
+) :
+    m_xuid{ xuid },
+    m_eventName{ schema.eventName },
+    m_fullEventName{ EVENT_NAME_PREFIX + std::to_string(AppConfig::Instance()->TitleId()) + "." + m_eventName.data() },
+    m_timestamp{ std::move(timestamp) }
+{
+    bool state;
+    WriteDataHeader(state);
+    WriteFields(state, "properties", schema.dimensions, values, m_dimensions);
+    WriteFields(state, "measurements", schema.measurements, values, m_measurements);
+    cll::BasicJsonWriter::EndStruct(m_data, state); // baseData
+    cll::BasicJsonWriter::EndObject(m_data, state);
+}
+
+void Event::WriteDataHeader(
+    _Inout_ bool& state
+)
+{
+    cll::BasicJsonWriter::StartObject(m_data, state);
+    cll::BasicJsonWriter::WriteField(m_data, state, "baseType", "Microsoft.XboxLive.InGame");
+    cll::BasicJsonWriter::StartStruct(m_data, state, "baseData");
+
+    cll::BasicJsonWriter::WriteField(m_data, state, "name", m_eventName.data());
+    cll::BasicJsonWriter::WriteField(m_data, state, "serviceConfigId", AppConfig::Instance()->Scid().data());
+    cll::BasicJsonWriter::WriteField(m_data, state, "titleId", std::to_string(AppConfig::Instance()->TitleId()));
+    cll::BasicJsonWriter::WriteField(m_data, state, "userId", utils::uint64_to_internal_string(m_xuid).data());
+}
+
+void Event::WriteFields(
+    _Inout_ bool& state,
+    _In_z_ const char* structName,
+    _In_ const xsapi_internal_vector<EventSchema::Field>& fields,
+    _In_ const XblEventFieldValue* values,
+    _Out_ xsapi_internal_string& fieldsJson
+)
 {
-    m_xuid = other.m_xuid;
-    m_eventName = other.m_eventName;
-    m_fullEventName = other.m_fullEventName;
-    JsonUtils::CopyFrom(m_dimensions, other.m_dimensions);
-    JsonUtils::CopyFrom(m_measurements, other.m_measurements);
-    m_timestamp = other.m_timestamp;
-    m_data = other.m_data;
+    // Field names were validated as identifiers at registration, so they can be written without escaping.
+    // Each value is serialized once and used for both the upload data and the persisted JSON.
+    rapidjson::StringBuffer valueBuffer;
+    fieldsJson = "{";
+
+    cll::BasicJsonWriter::StartStruct(m_data, state, structName);
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+        const auto& field{ fields[i] };
+        const auto& value{ values[field.valueIndex] };
+
+        valueBuffer.Clear();
+        rapidjson::Writer<rapidjson::StringBuffer> writer{ valueBuffer };
+        switch (field.type)
+        {
+        case XblEventFieldType::String:
+        {
+            writer.String(value.stringValue);
+            break;
+        }
+        case XblEventFieldType::Int64:
+        {
+            writer.Int64(value.int64Value);
+            break;
+        }
+        case XblEventFieldType::Double:
+        {
+            writer.Double(value.doubleValue);
+            break;
+        }
+        case XblEventFieldType::Bool:
+        {
+            writer.Bool(value.boolValue);
+            break;
+        }
+        default:
+        {
+            assert(false);
+            writer.Null();
+            break;
+        }
+        }
+
+        cll::BasicJsonWriter::WriteSerializedStruct(m_data, state, field.name.data(), valueBuffer.GetString());
+
+        if (i > 0)
+        {
+            fieldsJson += ',';
+        }
+        fieldsJson += '"';
+        fieldsJson += field.name;
+        fieldsJson += "\":";
+        fieldsJson += valueBuffer.GetString();
+    }
+    cll::BasicJsonWriter::EndStruct(m_data, state);
+
+    fieldsJson += '}';
 }
 
 Result<Event> Event::Deserialize(
@@ -115,6 +258,43 @@ Result<Event> Event::Deserialize(
     return Result<Event>(Event{ xuid, eventName, dimensionsJson, measurementsJson, timestamp });
 }
 
+Result<Event> Event::DeserializeRecord(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+)
+{
+    // xuid(uint64) | timestamp interval(uint64) | event name | dimensions json | measurements json
+    // Strings are prefixed with their uint32 length. All integers are little endian.
+
+    const uint8_t* end{ data + size };
+    uint64_t xuid{ 0 };
+    uint64_t timestampInterval{ 0 };
+    xsapi_internal_string eventName;
+    xsapi_internal_string dimensions;
+    xsapi_internal_string measurements;
+
+    if (!ReadUInt64(data, end, xuid) ||
+        !ReadUInt64(data, end, timestampInterval) ||
+        !ReadString(data, end, eventName) ||
+        !ReadString(data, end, dimensions) ||
+        !ReadString(data, end, measurements))
+    {
+        return Result<Event>{ Event{}, E_FAIL };
+    }
+
+    JsonDocument dimensionsJson;
+    dimensionsJson.Parse(dimensions.data());
+    JsonDocument measurementsJson;
+    measurementsJson.Parse(measurements.data());
+
+    if (dimensionsJson.HasParseError() || measurementsJson.HasParseError())
+    {
+        return Result<Event>{ Event{}, E_FAIL };
+    }
+
+    return Result<Event>(Event{ xuid, eventName, dimensionsJson, measurementsJson, xbox::services::datetime{} + timestampInterval });
+}
+
 const std::string& Event::Data() const
 {
     return m_data;
@@ -159,10 +339,24 @@ xsapi_internal_string Event::Serialize() const
     ss << m_xuid << seperator;
     ss << m_eventName << seperator;
     ss << m_timestamp.to_string(xbox::services::datetime::ISO_8601) << seperator;
-    ss << JsonUtils::SerializeJson(m_dimensions) << seperator;
-    ss << JsonUtils::SerializeJson(m_measurements);
+    ss << m_dimensions << seperator;
+    ss << m_measurements;
 
     return ss.str();
 }
 
+void Event::AppendRecord(
+    _Inout_ xsapi_internal_vector<uint8_t>& journalData
+) const
+{
+    // See DeserializeRecord for the record layout
+    size_t recordOffset{ system::Journal::BeginRecord(journalData) };
+    AppendUInt64(journalData, m_xuid);
+    AppendUInt64(journalData, m_timestamp.to_interval());
+    AppendString(journalData, m_eventName);
+    AppendString(journalData, m_dimensions);
+    AppendString(journalData, m_measurements);
+    system::Journal::EndRecord(journalData, recordOffset);
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_END
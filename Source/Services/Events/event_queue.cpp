@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "events_service_xsapi.h"
 #include "local_storage.h"
+#include "journal.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
 
@@ -18,39 +19,42 @@ EventQueue::EventQueue(
     assert(state);
     m_localStorage = state->LocalStorage();
 
-    Stringstream ss;
-    ss << m_filenamePrefix << m_user.Xuid() << ".dir";
-    m_directoryFilename = ss.str();
+    Stringstream headFilename;
+    headFilename << m_filenamePrefix << m_user.Xuid() << ".head";
+    m_headFilename = headFilename.str();
+
+    Stringstream legacyDirectoryFilename;
+    legacyDirectoryFilename << m_filenamePrefix << m_user.Xuid() << ".dir";
+    m_legacyDirectoryFilename = legacyDirectoryFilename.str();
 }
 
 void EventQueue::Initialize()
 {
-    // Initialize in memory directory. Treat as write through cache, don't read from directory file on disk after this.
-    m_localStorage->ReadAsync(m_user, m_directoryFilename,
+    // Find the first segment from the head file, then probe forward until a segment is missing. After this the
+    // in memory segment metadata is treated as a write through cache.
+    m_localStorage->ReadAsync(m_user, m_headFilename,
         [
             weakThis = std::weak_ptr<EventQueue>{ shared_from_this() }
         ]
     (Result<xsapi_internal_vector<uint8_t>> result)
     {
         auto sharedThis{ weakThis.lock() };
-        if (sharedThis && Succeeded(result))
+        if (sharedThis)
         {
-            auto& bytes = result.Payload();
-            auto fileMetadata = utils::string_split_internal(xsapi_internal_string{ bytes.begin(), bytes.end() }, '\n');
-
-            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
-            for (auto& metadata : fileMetadata)
+            uint64_t headSegment{ 0 };
+            if (Succeeded(result))
             {
-                xsapi_internal_stringstream ss{ metadata };
-                xsapi_internal_string filename;
-                uint64_t fileSize{ 0 };
-                ss >> filename >> fileSize;
+                auto& bytes = result.Payload();
+                headSegment = utils::internal_string_to_uint64(xsapi_internal_string{ bytes.begin(), bytes.end() });
+            }
 
-                sharedThis->m_fileMetadata[filename] = fileSize;
-                sharedThis->m_totalFilesSize += fileSize;
+            {
+                std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                sharedThis->m_headSegment = headSegment;
             }
 
-            sharedThis->Populate();
+            sharedThis->RecoverSegment(headSegment);
+            sharedThis->MigrateLegacyFiles();
         }
     });
 }
@@ -62,11 +66,12 @@ void EventQueue::Cleanup()
     // to the queue.
     std::lock_guard<std::mutex> lock{ m_mutex };
 
-    // Make sure the failed payload gets flushed as well
-    if (m_failedPayload)
+    // Make sure the failed payloads get flushed as well
+    for (auto& failedPayload : m_failedPayloads)
     {
-        m_queue.push_back(std::move(m_failedPayload));
+        m_queue.push_back(std::move(failedPayload.payload));
     }
+    m_failedPayloads.clear();
     Flush();
 }
 
@@ -84,7 +89,7 @@ HRESULT EventQueue::AddEvents(xsapi_internal_vector<Event>&& events)
     {
         auto copyUserResult = m_user.Copy();
         RETURN_HR_IF_FAILED(copyUserResult.Hresult());
-        payload = MakeShared<EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
+        payload = ArenaMakeShared<XblMemSubsystem::Events, EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
         m_queue.push_back(payload);
     }
     else
@@ -99,7 +104,7 @@ HRESULT EventQueue::AddEvents(xsapi_internal_vector<Event>&& events)
         {
             auto copyUserResult = m_user.Copy();
             RETURN_HR_IF_FAILED(copyUserResult.Hresult());
-            payload = MakeShared<EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
+            payload = ArenaMakeShared<XblMemSubsystem::Events, EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
             m_queue.push_back(payload);
             hr = payload->AddEvent(event);
             RETURN_HR_IF_FAILED(hr);
@@ -120,11 +125,18 @@ std::shared_ptr<EventUploadPayload> EventQueue::GetNextPayload(size_t minimumEve
 
     std::shared_ptr<EventUploadPayload> nextPayload{ nullptr };
 
-    if (m_failedPayload)
+    auto now{ chrono_clock_t::now() };
+    for (auto iter = m_failedPayloads.begin(); iter != m_failedPayloads.end(); ++iter)
     {
-        std::swap(m_failedPayload, nextPayload);
+        if (iter->retryTime <= now)
+        {
+            nextPayload = std::move(iter->payload);
+            m_failedPayloads.erase(iter);
+            return nextPayload;
+        }
     }
-    else if (!m_queue.empty() && m_queue.front()->EventCount() >= minimumEventCount)
+
+    if (!m_queue.empty() && m_queue.front()->EventCount() >= minimumEventCount)
     {
         nextPayload = m_queue.front();
         m_queue.pop_front();
@@ -147,7 +159,6 @@ void EventQueue::SetMode(Mode mode)
     {
         case Mode::Offline:
         {
-            assert(m_failedPayload);
             Flush();
             break;
         }
@@ -159,62 +170,339 @@ void EventQueue::SetMode(Mode mode)
     }
 }
 
-void EventQueue::RequeueFailedPayload(std::shared_ptr<EventUploadPayload> failedPayload)
+void EventQueue::RequeueFailedPayload(
+    std::shared_ptr<EventUploadPayload> failedPayload,
+    chrono_clock_t::time_point retryTime
+)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_failedPayloads.push_back(FailedPayload{ std::move(failedPayload), retryTime });
+}
+
+EventQueue::PendingStats EventQueue::GetPendingStats()
 {
     std::lock_guard<std::mutex> lock{ m_mutex };
-    m_failedPayload = std::move(failedPayload);
+
+    PendingStats stats{};
+    for (const auto& payload : m_queue)
+    {
+        ++stats.payloadCount;
+        stats.sizeInBytes += payload->SizeInBytes();
+    }
+    for (const auto& failedPayload : m_failedPayloads)
+    {
+        ++stats.payloadCount;
+        stats.sizeInBytes += failedPayload.payload->SizeInBytes();
+    }
+    return stats;
+}
+
+String EventQueue::SegmentFilename(uint64_t sequence) const
+{
+    Stringstream ss;
+    ss << m_filenamePrefix << m_user.Xuid() << "." << std::hex << std::uppercase << sequence << ".seg";
+    return ss.str();
+}
+
+void EventQueue::ReplaySegment(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _Inout_ xsapi_internal_vector<Event>& events
+)
+{
+    size_t validSize = system::Journal::Replay(data, size, [&events](const uint8_t* record, size_t recordSize)
+    {
+        auto deserializationResult = Event::DeserializeRecord(record, recordSize);
+        if (Succeeded(deserializationResult))
+        {
+            events.push_back(deserializationResult.ExtractPayload());
+        }
+    });
+
+    if (validSize < size)
+    {
+        // Only the tail of a segment that was being written when the title exited can be lost
+        LOGS_WARN << "Offline events journal segment is torn or corrupt, discarding the last " << size - validSize << " bytes";
+    }
+}
+
+HRESULT EventQueue::RecoverSegment(uint64_t sequence)
+{
+    // Events are replayed into the queue during recovery unless we are offline, in which case the segment is left
+    // on disk and replayed by Populate once we are back online.
+    auto events = MakeShared<xsapi_internal_vector<Event>>();
+    auto segmentSize = MakeShared<uint64_t>(0);
+    auto replayed = MakeShared<bool>(false);
+
+    return m_localStorage->ReadInPlaceAsync(
+        m_user,
+        SegmentFilename(sequence),
+        [
+            weakThis = std::weak_ptr<EventQueue>{ shared_from_this() },
+            events,
+            segmentSize,
+            replayed
+        ]
+    (const uint8_t* data, size_t size)
+    {
+        auto sharedThis{ weakThis.lock() };
+        if (!sharedThis)
+        {
+            return E_ABORT;
+        }
+
+        *segmentSize = size;
+        if (sharedThis->m_mode == Mode::Normal)
+        {
+            ReplaySegment(data, size, *events);
+            *replayed = true;
+        }
+        return S_OK;
+    },
+        [
+            weakThis = std::weak_ptr<EventQueue>{ shared_from_this() },
+            sequence,
+            events,
+            segmentSize,
+            replayed
+        ]
+    (HRESULT hr)
+    {
+        auto sharedThis{ weakThis.lock() };
+        if (!sharedThis)
+        {
+            return;
+        }
+
+        // The first missing segment marks the end of the journal. Custom storage handlers report missing keys
+        // as success with no data, and an existing segment always has at least a header.
+        if (FAILED(hr) || *segmentSize == 0)
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+            sharedThis->m_nextSegment = sequence;
+            sharedThis->m_journalRecovered = true;
+            sharedThis->AdvanceHead();
+            sharedThis->Flush();
+            return;
+        }
+
+        if (*replayed)
+        {
+            if (!events->empty())
+            {
+                sharedThis->AddEvents(std::move(*events));
+            }
+
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+            sharedThis->m_consumedSegments.insert(sequence);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+            sharedThis->m_segments[sequence] = SegmentInfo{ *segmentSize, false };
+            sharedThis->m_totalFilesSize += *segmentSize;
+        }
+
+        sharedThis->RecoverSegment(sequence + 1);
+    });
+}
+
+HRESULT EventQueue::MigrateLegacyFiles()
+{
+    // Events files written before the journal format are read back into the queue. If we are offline, they are
+    // written to the journal by the next Flush.
+    return m_localStorage->ReadAsync(m_user, m_legacyDirectoryFilename,
+        [
+            weakThis = std::weak_ptr<EventQueue>{ shared_from_this() }
+        ]
+    (Result<xsapi_internal_vector<uint8_t>> result)
+    {
+        auto sharedThis{ weakThis.lock() };
+        if (!sharedThis || Failed(result))
+        {
+            return;
+        }
+
+        auto& bytes = result.Payload();
+        auto fileMetadata = utils::string_split_internal(xsapi_internal_string{ bytes.begin(), bytes.end() }, '\n');
+
+        for (auto& metadata : fileMetadata)
+        {
+            xsapi_internal_stringstream ss{ metadata };
+            xsapi_internal_string filename;
+            ss >> filename;
+
+            sharedThis->m_localStorage->ReadAsync(sharedThis->m_user, filename,
+                [
+                    weakThis,
+                    filename
+                ]
+            (Result<Vector<uint8_t>> readResult)
+            {
+                auto sharedThis{ weakThis.lock() };
+                if (sharedThis && Succeeded(readResult))
+                {
+                    auto& bytes = readResult.Payload();
+                    auto serializedEvents = utils::string_split_internal(xsapi_internal_string{ bytes.begin(), bytes.end() }, '\n');
+
+                    xsapi_internal_vector<Event> events;
+                    for (const auto& serializedEvent : serializedEvents)
+                    {
+                        auto deserializationResult = Event::Deserialize(serializedEvent);
+                        if (Succeeded(deserializationResult))
+                        {
+                            events.push_back(deserializationResult.ExtractPayload());
+                        }
+                    }
+                    if (!events.empty())
+                    {
+                        sharedThis->AddEvents(std::move(events));
+                    }
+
+                    sharedThis->m_localStorage->ClearAsync(sharedThis->m_user, filename, nullptr);
+                }
+            });
+        }
+
+        sharedThis->m_localStorage->ClearAsync(sharedThis->m_user, sharedThis->m_legacyDirectoryFilename, nullptr);
+    });
+}
+
+void EventQueue::AdvanceHead()
+{
+    // Ensure that m_mutex is locked when calling this helper function
+
+    if (!m_journalRecovered)
+    {
+        // The end of the journal isn't known yet
+        return;
+    }
+
+    uint64_t headSegment{ m_segments.empty() ? m_nextSegment : m_segments.begin()->first };
+    if (headSegment == m_headSegment)
+    {
+        return;
+    }
+    m_headSegment = headSegment;
+
+    // Consumed segments are only cleared once the head file no longer points at them, so that a crash can't leave
+    // a gap in the journal that would hide the segments after it.
+    xsapi_internal_vector<uint64_t> segmentsToClear;
+    while (!m_consumedSegments.empty() && *m_consumedSegments.begin() < headSegment)
+    {
+        segmentsToClear.push_back(*m_consumedSegments.begin());
+        m_consumedSegments.erase(m_consumedSegments.begin());
+    }
+
+    auto headString{ utils::uint64_to_internal_string(headSegment) };
+
+    auto holdCleanup{ GlobalState::Get() };
+    assert(holdCleanup);
+
+    m_localStorage->WriteAsync(
+        m_user,
+        XblLocalStorageWriteMode::Truncate,
+        m_headFilename,
+        xsapi_internal_vector<uint8_t>(headString.begin(), headString.end()),
+        [
+            sharedThis{ shared_from_this() },
+            segmentsToClear,
+            holdCleanup
+        ]
+    (Result<size_t> result)
+    {
+        if (Failed(result))
+        {
+            LOGS_ERROR << "Failed to write events journal head file. Offline event data may be lost!";
+            return;
+        }
+
+        for (auto sequence : segmentsToClear)
+        {
+            auto clearAsyncHR = sharedThis->m_localStorage->ClearAsync(sharedThis->m_user, sharedThis->SegmentFilename(sequence), nullptr);
+            if (FAILED(clearAsyncHR))
+            {
+                LOGS_WARN << "Failed to clear events journal segment due to user being unavailable. HR = " << clearAsyncHR;
+            }
+        }
+    });
 }
 
 HRESULT EventQueue::Populate()
 {
     // Ensure that m_mutex is locked when calling this helper function
 
-    for (auto& metadata : m_fileMetadata)
+    for (auto& segment : m_segments)
     {
-        HRESULT hr = m_localStorage->ReadAsync(
+        if (segment.second.replaying)
+        {
+            continue;
+        }
+        segment.second.replaying = true;
+
+        auto events = MakeShared<xsapi_internal_vector<Event>>();
+        uint64_t sequence{ segment.first };
+
+        HRESULT hr = m_localStorage->ReadInPlaceAsync(
             m_user,
-            metadata.first,
+            SegmentFilename(sequence),
+            [
+                events
+            ]
+        (const uint8_t* data, size_t size)
+        {
+            ReplaySegment(data, size, *events);
+            return S_OK;
+        },
             [
-                metadata = std::pair<xsapi_internal_string, uint64_t>{ metadata },
-                weakThis = std::weak_ptr<EventQueue>{ shared_from_this() }
+                weakThis = std::weak_ptr<EventQueue>{ shared_from_this() },
+                sequence,
+                events
             ]
-        (Result<Vector<uint8_t>> readResult)
+        (HRESULT hr)
         {
             auto sharedThis{ weakThis.lock() };
-            if (sharedThis && Succeeded(readResult) && sharedThis->m_mode == Mode::Normal)
+            if (!sharedThis)
             {
-                auto& bytes = readResult.Payload();
-                auto serializedEvents = utils::string_split_internal(xsapi_internal_string{ bytes.begin(), bytes.end() }, '\n');
+                return;
+            }
 
-                for (const auto& serializedEvent : serializedEvents)
-                {
-                    auto deserializationResult = Event::Deserialize(serializedEvent);
-                    if (Succeeded(deserializationResult))
-                    {
-                        sharedThis->AddEvent(deserializationResult.ExtractPayload());
-                    }
-                }
+            if (FAILED(hr))
+            {
+                LOGS_WARN << "Failed to read events journal segment. HR = " << hr;
 
+                std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                auto iter{ sharedThis->m_segments.find(sequence) };
+                if (iter != sharedThis->m_segments.end())
                 {
-                    std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
-                    sharedThis->m_totalFilesSize -= metadata.second;
-                    sharedThis->m_fileMetadata.erase(metadata.first);
-                    sharedThis->WriteDirectoryFile();
+                    iter->second.replaying = false;
                 }
+                return;
+            }
 
-                auto clearAsyncHR = sharedThis->m_localStorage->ClearAsync(sharedThis->m_user, metadata.first, nullptr);
-                if (FAILED(clearAsyncHR))
+            if (!events->empty())
+            {
+                sharedThis->AddEvents(std::move(*events));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                auto iter{ sharedThis->m_segments.find(sequence) };
+                if (iter != sharedThis->m_segments.end())
                 {
-                    // Log failure but don't let when failure prevent populating the rest of the files.
-                    LOGS_WARN << "Failed to read events file due to user being available. HR = " << clearAsyncHR;
+                    sharedThis->m_totalFilesSize -= iter->second.size;
+                    sharedThis->m_segments.erase(iter);
                 }
+                sharedThis->m_consumedSegments.insert(sequence);
+                sharedThis->AdvanceHead();
             }
         });
 
         if (FAILED(hr))
         {
             // Log failure but don't let when failure prevent populating the rest of the files.
-            LOGS_WARN << "Failed to read events file " << metadata.first << " that appeared in " << m_directoryFilename;
+            LOGS_WARN << "Failed to read events journal segment " << SegmentFilename(sequence);
+            segment.second.replaying = false;
         }
     }
 
@@ -225,51 +513,53 @@ HRESULT EventQueue::Flush()
 {
     // Ensure that m_mutex is locked when calling this helper function
 
-    if (m_flushInProgress)
+    if (m_flushInProgress || !m_journalRecovered)
     {
         return S_OK;
     }
 
-    // If there is an existing non-full file, continue writing to that
-    std::pair<String, uint64_t> fileMetadata{ "", 0 };
-    if (!m_fileMetadata.empty() && m_fileMetadata.rbegin()->second < m_maxFileSize)
+    // If the last segment isn't full and isn't being replayed, continue appending to it
+    uint64_t sequence{ m_nextSegment };
+    uint64_t segmentSize{ 0 };
+    if (!m_segments.empty())
     {
-        fileMetadata = *m_fileMetadata.rbegin();
+        auto& lastSegment{ *m_segments.rbegin() };
+        if (lastSegment.first + 1 == m_nextSegment && lastSegment.second.size < m_maxFileSize && !lastSegment.second.replaying)
+        {
+            sequence = lastSegment.first;
+            segmentSize = lastSegment.second.size;
+        }
     }
+    bool newSegment{ sequence == m_nextSegment };
 
-    xsapi_internal_vector<uint8_t> flushData;
-    auto targetDataSize = static_cast<size_t>(m_maxFileSize - fileMetadata.second);
-    flushData.reserve(targetDataSize + static_cast<size_t>(m_tenantSettings->getMaxEventSizeInBytes()));
-    xbox::services::datetime earliestTimestamp{ xbox::services::datetime::utc_now() };
+    xsapi_internal_vector<uint8_t> journalData;
+    auto targetDataSize = static_cast<size_t>(m_maxFileSize - segmentSize);
+    journalData.reserve(targetDataSize + static_cast<size_t>(m_tenantSettings->getMaxEventSizeInBytes()));
+    if (newSegment)
+    {
+        system::Journal::AppendSegmentHeader(journalData);
+    }
+    size_t headerSize{ journalData.size() };
 
+    auto extractedEvents{ MakeShared<xsapi_internal_vector<Event>>() };
     for (auto iter = m_queue.begin(); iter != m_queue.end(); iter = m_queue.erase(iter))
     {
         auto payload{ *iter };
-        auto eventsRemainingInPayload = payload->ExtractEventsAndSerialize(flushData, targetDataSize, earliestTimestamp);
+        auto eventsRemainingInPayload = payload->ExtractEventRecords(journalData, targetDataSize, *extractedEvents);
 
         if (eventsRemainingInPayload)
         {
-            // The only reason events can be remaining after ExtractEventsAndSerialize is if the flushData was full.
+            // The only reason events can be remaining after ExtractEventRecords is if the journalData was full.
             // Break early so the partial payload doesn't get erased from queue.
             break;
         }
     }
 
-    if (flushData.empty())
+    if (journalData.size() == headerSize)
     {
         return S_OK;
     }
 
-    // Construct filename if we don't already have one
-    if (fileMetadata.first.empty())
-    {
-        Stringstream ss;
-        ss << m_filenamePrefix << std::hex << std::uppercase << earliestTimestamp.to_interval() << ".json";
-        fileMetadata.first = ss.str();
-
-        assert(m_fileMetadata.empty() || fileMetadata.first > m_fileMetadata.rend()->first);
-    }
-
     m_flushInProgress = true;
 
     // To avoid client event data from being lost, we never want to cleanup before
@@ -277,14 +567,18 @@ HRESULT EventQueue::Flush()
     auto holdCleanup{ GlobalState::Get() };
     assert(holdCleanup);
 
+    // Records are only ever appended to a segment. A new segment is truncated in case an orphaned file
+    // with the same name was left behind.
     HRESULT hr = m_localStorage->WriteAsync(
         m_user,
-        XblLocalStorageWriteMode::Append,
-        fileMetadata.first,
-        std::move(flushData),
+        newSegment ? XblLocalStorageWriteMode::Truncate : XblLocalStorageWriteMode::Append,
+        SegmentFilename(sequence),
+        std::move(journalData),
         [
             sharedThis{ shared_from_this() },
-            filename{ fileMetadata.first },
+            sequence,
+            newSegment,
+            extractedEvents,
             holdCleanup
         ]
     (Result<size_t> result)
@@ -293,74 +587,96 @@ HRESULT EventQueue::Flush()
         assert(sharedThis->m_flushInProgress);
         sharedThis->m_flushInProgress = false;
 
-        if (Succeeded(result))
+        if (Failed(result))
         {
-            auto previousFileSize{ sharedThis->m_fileMetadata[filename] };
+            // The segment's sequence is only used once a write to it succeeds, so a failed write doesn't leave a
+            // gap that would hide later segments from recovery
+            LOGS_WARN << "Failed to write events journal segment " << sharedThis->SegmentFilename(sequence) << ", hr=" << result.Hresult();
+            sharedThis->RequeueEvents(std::move(*extractedEvents));
+        }
+        else
+        {
+            if (newSegment)
+            {
+                sharedThis->m_nextSegment = sequence + 1;
+            }
+
             auto newFileSize{ result.ExtractPayload() };
-            sharedThis->m_totalFilesSize += (newFileSize - previousFileSize);
-            sharedThis->m_fileMetadata[filename] = newFileSize;
+            auto iter{ sharedThis->m_segments.find(sequence) };
+            if (iter != sharedThis->m_segments.end())
+            {
+                sharedThis->m_totalFilesSize += (newFileSize - iter->second.size);
+                iter->second.size = newFileSize;
+            }
+            else if (newSegment)
+            {
+                sharedThis->m_totalFilesSize += newFileSize;
+                sharedThis->m_segments[sequence] = SegmentInfo{ newFileSize, false };
+            }
+            // Otherwise the segment was replayed and cleared while the write was in progress
 
             while (sharedThis->m_totalFilesSize > sharedThis->m_storageAllotment)
             {
+                auto segmentToDelete{ sharedThis->m_segments.begin() };
+                if (segmentToDelete == sharedThis->m_segments.end() || segmentToDelete->second.replaying)
+                {
+                    break;
+                }
+
                 LOGS_INFO << "Offline events files have exceeded the configured storage allotment.";
                 LOGS_INFO << "The oldest events file will be deleted and offline event data will be permanently lost.";
 
-                auto metadataToDelete{ sharedThis->m_fileMetadata.begin() };
-                sharedThis->m_totalFilesSize -= metadataToDelete->second;
-                
-                auto clearAsyncHR = sharedThis->m_localStorage->ClearAsync(sharedThis->m_user, metadataToDelete->first, nullptr);
-                if (SUCCEEDED(clearAsyncHR))
-                {
-                    sharedThis->m_fileMetadata.erase(metadataToDelete);
-                }
-                else 
-                {
-                    LOGS_INFO << "The user is currently unavailable. Failed to clear oldest event.";
-                    return; //todo: What's the proper handling here?
-                }
+                sharedThis->m_totalFilesSize -= segmentToDelete->second.size;
+                sharedThis->m_consumedSegments.insert(segmentToDelete->first);
+                sharedThis->m_segments.erase(segmentToDelete);
             }
 
-            sharedThis->WriteDirectoryFile();
+            sharedThis->AdvanceHead();
             sharedThis->Flush();
         }
     });
 
+    if (FAILED(hr))
+    {
+        LOGS_WARN << "Failed to write events journal segment " << SegmentFilename(sequence) << ", hr=" << hr;
+        m_flushInProgress = false;
+        RequeueEvents(std::move(*extractedEvents));
+    }
+
     return hr;
 }
 
-HRESULT EventQueue::WriteDirectoryFile()
+void EventQueue::RequeueEvents(xsapi_internal_vector<Event>&& events)
 {
     // Ensure that m_mutex is locked when calling this helper function
 
-    xsapi_internal_vector<uint8_t> data;
-    for (auto& metadata : m_fileMetadata)
+    // The events go back to the front of the queue, ahead of any added since they were extracted. They are written
+    // by the next flush, which the next event added in offline mode or cleanup starts.
+    auto copyUserResult = m_user.Copy();
+    if (Failed(copyUserResult))
     {
-        data.insert(data.end(), metadata.first.begin(), metadata.first.end());
-        data.push_back('\t');
-
-        auto sizeString{ utils::uint64_to_internal_string(metadata.second) };
-        data.insert(data.end(), sizeString.begin(), sizeString.end());
-        data.push_back('\n');
+        LOGS_ERROR << "Failed to requeue " << events.size() << " events, they will be lost";
+        return;
     }
 
-    auto holdCleanup{ GlobalState::Get() };
-    assert(holdCleanup);
-
-    return m_localStorage->WriteAsync(
-        m_user,
-        XblLocalStorageWriteMode::Truncate,
-        m_directoryFilename,
-        std::move(data),
-        [
-            holdCleanup
-        ]
-    (Result<size_t> result)
+    auto payload = ArenaMakeShared<XblMemSubsystem::Events, EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
+    auto insertPosition{ m_queue.begin() };
+    for (auto& event : events)
     {
-        if (Failed(result))
+        if (FAILED(payload->AddEvent(event)))
         {
-            LOGS_ERROR << "Failed to write events directory file. Offline event data may be lost!";
+            m_queue.insert(insertPosition, payload);
+            copyUserResult = m_user.Copy();
+            if (Failed(copyUserResult))
+            {
+                LOGS_ERROR << "Failed to requeue events, some will be lost";
+                return;
+            }
+            payload = ArenaMakeShared<XblMemSubsystem::Events, EventUploadPayload>(copyUserResult.ExtractPayload(), m_tenantSettings);
+            payload->AddEvent(event);
         }
-    });
+    }
+    m_queue.insert(insertPosition, payload);
 }
 
 HRESULT EventQueue::SetMaxFileSize(uint64_t fileSizeInBytes)
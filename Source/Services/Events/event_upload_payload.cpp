@@ -23,13 +23,18 @@ EventUploadPayload::EventUploadPayload(
 
 HRESULT EventUploadPayload::AddEvent(_In_ const Event& event)
 {
-    if (m_events.size() >= static_cast<size_t>(m_tenantSettings->getMaxEventsPerPost()))
+    // Payloads are sized by their serialized events. The service's per post event limit is still respected, and
+    // an event larger than the size limit is sent on its own.
+    size_t eventSize{ EventSizeInBytes(event) };
+    if (m_events.size() >= static_cast<size_t>(m_tenantSettings->getMaxEventsPerPost()) ||
+        (!m_events.empty() && m_sizeInBytes + eventSize > m_maxSizeInBytes))
     {
         LOGS_DEBUG << "Cannot add more events to payload.";
         return E_FAIL;
     }
 
     m_events.push_back(event);
+    m_sizeInBytes += eventSize;
     return S_OK;
 }
 
@@ -38,6 +43,35 @@ size_t EventUploadPayload::EventCount() const
     return m_events.size();
 }
 
+size_t EventUploadPayload::SizeInBytes() const
+{
+    return m_sizeInBytes;
+}
+
+uint32_t EventUploadPayload::OnUploadFailed()
+{
+    return ++m_failedUploadCount;
+}
+
+size_t EventUploadPayload::EventSizeInBytes(_In_ const Event& event)
+{
+    return event.Data().size() + event.FullEventName().size();
+}
+
+HRESULT EventUploadPayload::SetMaxSizeInBytes(uint64_t sizeInBytes)
+{
+    if (sizeInBytes < 1024)
+    {
+        LOGS_ERROR << "Max payload size must be at least 1kb";
+        return E_INVALIDARG;
+    }
+
+    m_maxSizeInBytes = sizeInBytes;
+    return S_OK;
+}
+
+std::atomic<uint64_t> EventUploadPayload::m_maxSizeInBytes{ 256000 }; // default payload size of 256k
+
 HRESULT EventUploadPayload::GetRequestData(
     _In_ AsyncContext<Result<const RequestData&>> async
 )
@@ -90,24 +124,17 @@ HRESULT EventUploadPayload::GetRequestData(
     });
 }
 
-size_t EventUploadPayload::ExtractEventsAndSerialize(
-    _Inout_ xsapi_internal_vector<uint8_t>& serializedData,
+size_t EventUploadPayload::ExtractEventRecords(
+    _Inout_ xsapi_internal_vector<uint8_t>& journalData,
     _In_ size_t targetDataSize,
-    _Inout_ xbox::services::datetime& timestamp
+    _Inout_ xsapi_internal_vector<Event>& extractedEvents
 )
 {
-    for (auto iter = m_events.begin(); iter != m_events.end() && serializedData.size() < targetDataSize; iter = m_events.erase(iter))
+    for (auto iter = m_events.begin(); iter != m_events.end() && journalData.size() < targetDataSize; iter = m_events.erase(iter))
     {
-        auto& event{ *iter };
-
-        auto serializedEvent = event.Serialize();
-        serializedData.insert(serializedData.end(), serializedEvent.begin(), serializedEvent.end());
-        serializedData.push_back('\n');
-
-        if (event.Timestamp() < timestamp)
-        {
-            timestamp = event.Timestamp();
-        }
+        iter->AppendRecord(journalData);
+        m_sizeInBytes -= EventSizeInBytes(*iter);
+        extractedEvents.push_back(std::move(*iter));
     }
 
     return m_events.size();
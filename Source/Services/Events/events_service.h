@@ -5,6 +5,127 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
 
+// Validates event and field names. Equivalent to matching "[A-Za-z]+[A-Za-z0-9_]*" without the cost of
+// constructing a std::regex for every event.
+inline bool IsValidEventName(_In_opt_z_ const char* name) noexcept
+{
+    auto isAlpha = [](char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'); };
+
+    if (name == nullptr || !isAlpha(*name))
+    {
+        return false;
+    }
+
+    for (++name; *name; ++name)
+    {
+        if (!isAlpha(*name) && !(*name >= '0' && *name <= '9') && *name != '_')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Schemas registered for in-game events, looked up case insensitively by event name. Registering a schema
+// for a name that already has one replaces it. Both operations allocate the lowercase key, so allocation
+// failures propagate to the API entry point's CATCH_RETURN.
+template<typename Schema>
+class EventSchemaRegistry
+{
+public:
+    void Register(
+        _In_z_ const char* eventName,
+        _In_ std::shared_ptr<const Schema> schema
+    )
+    {
+        auto key{ utils::ToLower(eventName) };
+
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_schemas[std::move(key)] = std::move(schema);
+    }
+
+    std::shared_ptr<const Schema> Find(
+        _In_z_ const char* eventName
+    ) const
+    {
+        auto key{ utils::ToLower(eventName) };
+
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        auto iter{ m_schemas.find(key) };
+        return iter == m_schemas.end() ? nullptr : iter->second;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    UnorderedMap<String, std::shared_ptr<const Schema>> m_schemas;
+};
+
+// Limits the number of event uploads in flight and picks when failed uploads are retried. Retries back off
+// exponentially from the minimum upload interval, with up to 50% jitter so that payloads which failed together
+// aren't retried together.
+class EventUploadScheduler
+{
+public:
+    explicit EventUploadScheduler(
+        uint64_t minimumUploadIntervalInMs,
+        uint32_t seed = std::random_device{}()
+    ) noexcept :
+        m_minimumUploadIntervalInMs{ minimumUploadIntervalInMs },
+        m_random{ seed }
+    {
+    }
+
+    // Claims an upload slot if fewer than maxUploadsInFlight uploads are running. Every successful call must be
+    // matched by a call to EndUpload.
+    bool TryBeginUpload(uint32_t maxUploadsInFlight) noexcept
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_uploadsInFlight >= maxUploadsInFlight)
+        {
+            return false;
+        }
+        ++m_uploadsInFlight;
+        return true;
+    }
+
+    void EndUpload() noexcept
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        assert(m_uploadsInFlight > 0);
+        if (m_uploadsInFlight > 0)
+        {
+            --m_uploadsInFlight;
+        }
+    }
+
+    uint32_t UploadsInFlight() const noexcept
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        return m_uploadsInFlight;
+    }
+
+    uint64_t RetryDelayInMs(uint32_t failedUploadCount) noexcept
+    {
+        // The backoff is capped at 600 times the minimum upload interval
+        uint64_t backoff{ 600 * m_minimumUploadIntervalInMs };
+        if (failedUploadCount < 10)
+        {
+            backoff = std::min(backoff, (uint64_t{ 1 } << failedUploadCount) * m_minimumUploadIntervalInMs);
+        }
+
+        std::uniform_int_distribution<uint64_t> jitter{ 0, backoff / 2 };
+
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        return backoff - backoff / 2 + jitter(m_random);
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    const uint64_t m_minimumUploadIntervalInMs;
+    uint32_t m_uploadsInFlight{ 0 };
+    std::mt19937 m_random;
+};
+
 class IEventsService
 {
 public:
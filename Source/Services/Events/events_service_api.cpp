@@ -42,4 +42,82 @@ try
 }
 CATCH_RETURN()
 
+STDAPI XblEventsSetMaxUploadsInFlight(
+    uint32_t maxUploadsInFlight
+) XBL_NOEXCEPT
+try
+{
+    return events::EventsService::SetMaxUploadsInFlight(maxUploadsInFlight);
+}
+CATCH_RETURN()
+
+STDAPI XblEventsSetUploadCompression(
+    bool enabled,
+    uint64_t thresholdInBytes
+) XBL_NOEXCEPT
+try
+{
+    events::EventsService::SetUploadCompression(enabled, static_cast<size_t>(thresholdInBytes));
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblEventsSetMaxPayloadSize(
+    uint64_t maxPayloadSizeInBytes
+) XBL_NOEXCEPT
+try
+{
+    return events::EventUploadPayload::SetMaxSizeInBytes(maxPayloadSizeInBytes);
+}
+CATCH_RETURN()
+
+STDAPI XblEventsGetUploadStats(
+    _In_ XblContextHandle xboxLiveContext,
+    _Out_ XblEventsUploadStats* stats
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(xboxLiveContext == nullptr || stats == nullptr);
+    VERIFY_XBL_INITIALIZED();
+
+    auto eventsService{ std::static_pointer_cast<events::EventsService>(xboxLiveContext->EventsService()) };
+    *stats = eventsService->GetUploadStats();
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblEventsRegisterInGameEventSchema(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_z_ const char* eventName,
+    _In_reads_opt_(fieldsCount) const XblEventFieldDescriptor* fields,
+    _In_ size_t fieldsCount
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(xboxLiveContext == nullptr || eventName == nullptr);
+    RETURN_HR_INVALIDARGUMENT_IF(fields == nullptr && fieldsCount > 0);
+    VERIFY_XBL_INITIALIZED();
+
+    auto eventsService{ std::static_pointer_cast<events::EventsService>(xboxLiveContext->EventsService()) };
+    return eventsService->RegisterInGameEventSchema(eventName, fields, fieldsCount);
+}
+CATCH_RETURN()
+
+STDAPI XblEventsWriteRegisteredInGameEvent(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_z_ const char* eventName,
+    _In_reads_opt_(valuesCount) const XblEventFieldValue* values,
+    _In_ size_t valuesCount
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(xboxLiveContext == nullptr || eventName == nullptr);
+    RETURN_HR_INVALIDARGUMENT_IF(values == nullptr && valuesCount > 0);
+    VERIFY_XBL_INITIALIZED();
+
+    auto eventsService{ std::static_pointer_cast<events::EventsService>(xboxLiveContext->EventsService()) };
+    return eventsService->WriteInGameEvent(eventName, values, valuesCount);
+}
+CATCH_RETURN()
+
 #endif // !XSAPI_ETW_EVENTS_SERVICE
\ No newline at end of file
@@ -123,9 +123,7 @@ HRESULT EventsService::WriteInGameEvent(
     JsonDocument dimensionsJson;
     JsonDocument measurementsJson;
 
-    std::regex regex("[A-Za-z]+[A-Za-z0-9_]*");
-    bool matchFound = std::regex_match(eventName, regex);
-    if (!matchFound)
+    if (!IsValidEventName(eventName))
     {
         LOG_DEBUG("Invalid event name");
         return E_INVALIDARG;
@@ -45,9 +45,7 @@ HRESULT EventsService::WriteInGameEvent(
     JsonDocument dimensionsJson;
     JsonDocument measurementsJson;
 
-    std::regex regex("[A-Za-z]+[A-Za-z0-9_]*");
-    bool matchFound = std::regex_match(eventName, regex);
-    if (!matchFound)
+    if (!IsValidEventName(eventName))
     {
         LOG_DEBUG("Invalid event name");
         return E_INVALIDARG;
@@ -80,6 +78,101 @@ HRESULT EventsService::WriteInGameEventHelper(
     return m_eventQueue->AddEvent(Event{ m_user.Xuid(), eventName, dimensions, measurements });
 }
 
+HRESULT EventsService::RegisterInGameEventSchema(
+    _In_z_ const char* eventName,
+    _In_reads_opt_(fieldsCount) const XblEventFieldDescriptor* fields,
+    _In_ size_t fieldsCount
+)
+{
+    if (!IsValidEventName(eventName) || (fields == nullptr && fieldsCount > 0))
+    {
+        LOG_DEBUG("Invalid event name");
+        return E_INVALIDARG;
+    }
+
+    auto schema = MakeShared<EventSchema>();
+    schema->eventName = eventName;
+    schema->fieldCount = fieldsCount;
+
+    for (size_t i = 0; i < fieldsCount; ++i)
+    {
+        const auto& field{ fields[i] };
+        if (!IsValidEventName(field.name) || field.type > XblEventFieldType::Bool)
+        {
+            LOG_DEBUG("Invalid event field");
+            return E_INVALIDARG;
+        }
+
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (utils::str_icmp(fields[j].name, field.name) == 0)
+            {
+                LOG_DEBUG("Duplicate event field");
+                return E_INVALIDARG;
+            }
+        }
+
+        switch (field.kind)
+        {
+        case XblEventFieldKind::Dimension:
+        {
+            schema->dimensions.push_back(EventSchema::Field{ field.name, field.type, i });
+            break;
+        }
+        case XblEventFieldKind::Measurement:
+        {
+            schema->measurements.push_back(EventSchema::Field{ field.name, field.type, i });
+            break;
+        }
+        default:
+        {
+            LOG_DEBUG("Invalid event field");
+            return E_INVALIDARG;
+        }
+        }
+    }
+
+    m_schemas.Register(eventName, std::move(schema));
+    return S_OK;
+}
+
+HRESULT EventsService::WriteInGameEvent(
+    _In_z_ const char* eventName,
+    _In_reads_opt_(valuesCount) const XblEventFieldValue* values,
+    _In_ size_t valuesCount
+)
+{
+    auto schema{ m_schemas.Find(eventName) };
+    if (!schema)
+    {
+        LOG_DEBUG("Event schema not registered");
+        return E_INVALIDARG;
+    }
+
+    if (valuesCount != schema->fieldCount || (values == nullptr && valuesCount > 0))
+    {
+        LOG_DEBUG("Event values don't match registered schema");
+        return E_INVALIDARG;
+    }
+
+    for (const auto& fields : { &schema->dimensions, &schema->measurements })
+    {
+        for (const auto& field : *fields)
+        {
+            const auto& value{ values[field.valueIndex] };
+            if (value.type != field.type ||
+                (value.type == XblEventFieldType::String && value.stringValue == nullptr) ||
+                (value.type == XblEventFieldType::Double && !std::isfinite(value.doubleValue)))
+            {
+                LOG_DEBUG("Event values don't match registered schema");
+                return E_INVALIDARG;
+            }
+        }
+    }
+
+    return m_eventQueue->AddEvent(Event{ m_user.Xuid(), *schema, values });
+}
+
 const std::string& EventsService::IKey()
 {
     static std::string iKey;
@@ -113,7 +206,7 @@ HRESULT EventsService::ScheduleUpload() noexcept
                     });
             }
         },
-        __min(std::pow(2, m_numRetryAttempts), 600) * m_minimumUploadIntervalInMs
+        m_minimumUploadIntervalInMs
     );
 
     if (FAILED(hr))
@@ -129,55 +222,140 @@ void EventsService::UploadAsync(
     AsyncContext<> async
 ) noexcept
 {
-    // If more than m_maximumUploadIntervalInMs has passed since the last upload, begin an upload
-    // with whatever events are pending. Otherwise, wait until we have at least m_payloadMinimumEventCount
-    // events and return immediately.
+    // If more than m_maximumUploadIntervalInMs has passed since the last upload, begin uploads
+    // with whatever events are pending. Otherwise, only upload payloads with at least m_payloadMinimumEventCount
+    // events. Start as many uploads as there are free slots and return without waiting for them; each upload
+    // holds the service and GlobalState until it completes so that no client data is lost.
     uint64_t timeSinceLastUpload = std::chrono::duration_cast<std::chrono::milliseconds> (chrono_clock_t::now() - m_lastUploadAttempt).count();
     size_t payloadMinumumEventCount = timeSinceLastUpload > m_maximumUploadIntervalInMs ? 1 : m_payloadMinimumEventCount;
 
-    std::shared_ptr<EventUploadPayload> payload = m_eventQueue->GetNextPayload(payloadMinumumEventCount);
-    if (!payload)
+    auto state{ GlobalState::Get() };
+
+    while (m_uploadScheduler.TryBeginUpload(m_maxUploadsInFlight))
     {
-        return async.Complete();
-    }
+        std::shared_ptr<EventUploadPayload> payload = m_eventQueue->GetNextPayload(payloadMinumumEventCount);
+        if (!payload)
+        {
+            m_uploadScheduler.EndUpload();
+            break;
+        }
 
-    HRESULT hr = UploadEventPayload(payload, AsyncContext<HRESULT>{ TaskQueue(),
-        [
-            sharedThis{ shared_from_this() },
-            payload,
-            async
-        ]
-    (HRESULT hr)
+        auto startTime{ chrono_clock_t::now() };
+        HRESULT hr = UploadEventPayload(payload, AsyncContext<HRESULT>{ TaskQueue(),
+            [
+                sharedThis{ shared_from_this() },
+                state,
+                payload,
+                startTime
+            ]
+        (HRESULT hr)
         {
-            // Super naive implementation for now - on every failed upload switch to offline mode, on every successful upload
-            // switch to normal mode. This will incur a lot of disk I/O so this needs to be tuned long term.
-            switch (hr)
-            {
-            //Intentional fallthrough here for certain failure http statuses.
-            //Failures that shouldn't be retried are functionally the same as successes,
-            //in that we want to reset the backoff process and not requeue the payload.
-            case HTTP_E_STATUS_BAD_REQUEST:
-                //Retrying a 400 likely won't resolve the issue. Drop the request.
-                //TODO: [natiskan] Write telemetry to keep track of failed 400s.
-            case S_OK:
-                sharedThis->m_numRetryAttempts = 0;
-                sharedThis->m_eventQueue->SetMode(Mode::Normal);
-                break;
-            default:
-                sharedThis->OnFailedPayload(payload);
-                sharedThis->m_eventQueue->SetMode(Mode::Offline);
-                break;
-            }
+            sharedThis->OnUploadComplete(payload, hr, startTime);
+        }
+        });
 
-            async.Complete();
+        if (FAILED(hr))
+        {
+            OnUploadComplete(payload, hr, startTime);
+            break;
         }
-    });
+    }
 
-    if (FAILED(hr))
+    async.Complete();
+}
+
+void EventsService::OnUploadComplete(
+    std::shared_ptr<EventUploadPayload> payload,
+    HRESULT result,
+    chrono_clock_t::time_point startTime
+)
+{
+    auto latency{ std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - startTime) };
+    bool goOffline{ false };
+
+    m_uploadScheduler.EndUpload();
     {
-        OnFailedPayload(payload);
-        return async.Complete();
+        std::lock_guard<std::mutex> lock{ m_uploadMutex };
+        m_totalUploadLatency += latency;
+        m_maxUploadLatency = std::max(m_maxUploadLatency, latency);
+
+        switch (result)
+        {
+        //Intentional fallthrough here for certain failure http statuses.
+        //Failures that shouldn't be retried are functionally the same as successes,
+        //in that we want to reset the backoff process and not requeue the payload.
+        case HTTP_E_STATUS_BAD_REQUEST:
+            //Retrying a 400 likely won't resolve the issue. Drop the request.
+            //TODO: [natiskan] Write telemetry to keep track of failed 400s.
+        case S_OK:
+            ++m_completedUploadCount;
+            m_consecutiveFailedUploads = 0;
+            break;
+        default:
+            ++m_failedUploadCount;
+            ++m_consecutiveFailedUploads;
+            goOffline = m_consecutiveFailedUploads >= OfflineFailureThreshold;
+            break;
+        }
     }
+
+    if (result == S_OK || result == HTTP_E_STATUS_BAD_REQUEST)
+    {
+        m_eventQueue->SetMode(Mode::Normal);
+        return;
+    }
+
+    // Only the failed payload is retried, after its own backoff. Other uploads carry on, and events only start
+    // being written to disk once uploads have failed repeatedly.
+    auto retryDelay{ m_uploadScheduler.RetryDelayInMs(payload->OnUploadFailed()) };
+    m_eventQueue->RequeueFailedPayload(std::move(payload), chrono_clock_t::now() + std::chrono::milliseconds(retryDelay));
+
+    if (goOffline)
+    {
+        m_eventQueue->SetMode(Mode::Offline);
+    }
+}
+
+XblEventsUploadStats EventsService::GetUploadStats()
+{
+    auto pendingStats{ m_eventQueue->GetPendingStats() };
+
+    std::lock_guard<std::mutex> lock{ m_uploadMutex };
+
+    XblEventsUploadStats stats{};
+    stats.queuedPayloadCount = pendingStats.payloadCount;
+    stats.queuedPayloadBytes = pendingStats.sizeInBytes;
+    stats.uploadsInFlight = m_uploadScheduler.UploadsInFlight();
+    stats.completedUploadCount = m_completedUploadCount;
+    stats.failedUploadCount = m_failedUploadCount;
+
+    uint64_t attemptCount{ m_completedUploadCount + m_failedUploadCount };
+    if (attemptCount > 0)
+    {
+        stats.averageUploadLatencyInMs = static_cast<uint64_t>(m_totalUploadLatency.count()) / attemptCount;
+    }
+    stats.maxUploadLatencyInMs = static_cast<uint64_t>(m_maxUploadLatency.count());
+
+    return stats;
+}
+
+HRESULT EventsService::SetMaxUploadsInFlight(uint32_t maxUploadsInFlight)
+{
+    if (maxUploadsInFlight == 0)
+    {
+        LOGS_ERROR << "Max uploads in flight must be at least 1";
+        return E_INVALIDARG;
+    }
+
+    m_maxUploadsInFlight = maxUploadsInFlight;
+    return S_OK;
+}
+
+void EventsService::SetUploadCompression(bool enabled, size_t thresholdInBytes)
+{
+    // Uploads read the threshold after checking the flag, so store it first
+    m_uploadCompressionThreshold = thresholdInBytes;
+    m_uploadCompressionEnabled = enabled;
 }
 
 HRESULT EventsService::UploadEventPayload(
@@ -187,6 +365,9 @@ HRESULT EventsService::UploadEventPayload(
 {
     m_lastUploadAttempt = chrono_clock_t::now();
 
+#if XSAPI_COROUTINES
+    return UploadEventPayloadCoroutine(shared_from_this(), std::move(payload), std::move(async)).Hresult();
+#else
     return payload->GetRequestData({ async.Queue(),
         [
             weakThis = std::weak_ptr<EventsService>{ shared_from_this() },
@@ -195,64 +376,132 @@ HRESULT EventsService::UploadEventPayload(
     (Result<const EventUploadPayload::RequestData&> result)
     {
         auto sharedThis{ weakThis.lock() };
-        if (sharedThis && Succeeded(result))
+        if (!sharedThis)
         {
+            return async.Complete(E_ABORT);
+        }
+        else if (Failed(result))
+        {
+            // Uploads are counted until they complete, so every path has to complete async
+            return async.Complete(result.Hresult());
+        }
 
-            Result<User> userResult = sharedThis->m_user.Copy();
-            if (FAILED(userResult.Hresult()))
-            {
-                return async.Complete(userResult.Hresult());
-            }
+        auto httpCallResult = sharedThis->MakeUploadHttpCall(result.Payload());
+        if (Failed(httpCallResult))
+        {
+            return async.Complete(httpCallResult.Hresult());
+        }
 
-            auto httpCall = MakeShared<XblHttpCall>(userResult.ExtractPayload());
-            auto hr = httpCall->Init(MakeShared<XboxLiveContextSettings>(), "POST", sharedThis->m_eventUploadUrl, xbox_live_api::events_upload);
-            if (FAILED(hr))
-            {
-                return async.Complete(hr);
-            }
+        httpCallResult.Payload()->Perform(AsyncContext<HttpResult>{
+            async.Queue().GetHandle(),
+            [
+                async
+            ]
+        (HttpResult result)
+        {
+            async.Complete(UploadResultToHresult(result));
+        }
+        });
+    }
+    });
+#endif
+}
 
-            // Don't allow retries. We want to fail as fast as possible and the payload will
-            // be retried by the EventsService later anyways.
-            httpCall->SetRetryAllowed(false);
-            //Explicitly allow retry of 401s with an updated token, as this can only retry once at most
-            httpCall->SetAuthRetryAllowed(true);
-            httpCall->SetTimeout(sharedThis->m_uploadTimeoutInSeconds);
+#if XSAPI_COROUTINES
+AsyncCoroutine EventsService::UploadEventPayloadCoroutine(
+    std::weak_ptr<EventsService> weakThis,
+    std::shared_ptr<EventUploadPayload> payload,
+    AsyncContext<HRESULT> async
+) noexcept
+{
+    auto requestDataResult = co_await AsyncAwait<Result<const EventUploadPayload::RequestData&>>(async.Queue(),
+        [&payload](AsyncContext<Result<const EventUploadPayload::RequestData&>> requestDataAsync)
+    {
+        return payload->GetRequestData(std::move(requestDataAsync));
+    });
 
-            for (auto& header : result.Payload().headers)
-            {
-                httpCall->SetHeader(header.first, header.second);
-            }
+    if (Failed(requestDataResult))
+    {
+        async.Complete(requestDataResult.Hresult());
+        co_return;
+    }
 
-            httpCall->SetRequestBody(result.Payload().requestBody);
+    Result<std::shared_ptr<XblHttpCall>> httpCallResult{ E_ABORT };
+    if (auto sharedThis{ weakThis.lock() })
+    {
+        httpCallResult = sharedThis->MakeUploadHttpCall(requestDataResult.Payload());
+    }
 
-            httpCall->Perform(AsyncContext<HttpResult>{
-                async.Queue().GetHandle(),
-                [
-                    async
-                ]
-            (HttpResult result)
-            {
-                HRESULT hr = result.Hresult();
-                if (SUCCEEDED(hr))
-                {
-                    hr = result.Payload()->Result();
-                    if (FAILED(hr))
-                    {
-                        HC_TRACE_INFORMATION(XSAPI, "Event upload failed with HTTP status %u", result.Payload()->HttpStatus());
-                    }
-                }
-                async.Complete(hr);
-            }
-            });
-        }
+    if (Failed(httpCallResult))
+    {
+        async.Complete(httpCallResult.Hresult());
+        co_return;
     }
+
+    auto httpCall{ httpCallResult.ExtractPayload() };
+    auto uploadResult = co_await AsyncAwait<HttpResult>(async.Queue(),
+        [&httpCall](AsyncContext<HttpResult> httpAsync)
+    {
+        return httpCall->Perform(std::move(httpAsync));
     });
+
+    async.Complete(UploadResultToHresult(uploadResult));
+}
+#endif
+
+Result<std::shared_ptr<XblHttpCall>> EventsService::MakeUploadHttpCall(
+    const EventUploadPayload::RequestData& requestData
+) const noexcept
+{
+    Result<User> userResult = m_user.Copy();
+    RETURN_HR_IF_FAILED(userResult.Hresult());
+
+    auto settings = MakeShared<XboxLiveContextSettings>();
+    if (m_uploadCompressionEnabled)
+    {
+        settings->SetRequestCompressionThreshold(m_uploadCompressionThreshold);
+        settings->SetRequestCompressionEndpoints({ m_eventUploadHost });
+    }
+
+    auto httpCall = MakeShared<XblHttpCall>(userResult.ExtractPayload());
+    RETURN_HR_IF_FAILED(httpCall->Init(settings, "POST", m_eventUploadUrl, xbox_live_api::events_upload));
+
+    // Don't allow retries. We want to fail as fast as possible and the payload will
+    // be retried by the EventsService later anyways.
+    httpCall->SetRetryAllowed(false);
+    //Explicitly allow retry of 401s with an updated token, as this can only retry once at most
+    httpCall->SetAuthRetryAllowed(true);
+    httpCall->SetTimeout(m_uploadTimeoutInSeconds);
+
+    for (auto& header : requestData.headers)
+    {
+        httpCall->SetHeader(header.first, header.second);
+    }
+
+    httpCall->SetRequestBody(requestData.requestBody);
+
+    return httpCall;
 }
 
-void xbox::services::events::EventsService::OnFailedPayload(std::shared_ptr<EventUploadPayload> failedPayload)
+HRESULT EventsService::UploadResultToHresult(
+    const HttpResult& result
+) noexcept
 {
-    m_eventQueue->RequeueFailedPayload(failedPayload);
-    m_numRetryAttempts++;
+    HRESULT hr = result.Hresult();
+    if (SUCCEEDED(hr))
+    {
+        hr = result.Payload()->Result();
+        if (FAILED(hr))
+        {
+            HC_TRACE_INFORMATION(XSAPI, "Event upload failed with HTTP status %u", result.Payload()->HttpStatus());
+        }
+    }
+    return hr;
 }
 
+std::atomic<uint32_t> EventsService::m_maxUploadsInFlight{ 2 };
+std::atomic<bool> EventsService::m_uploadCompressionEnabled{ false };
+std::atomic<size_t> EventsService::m_uploadCompressionThreshold{ DEFAULT_REQUEST_COMPRESSION_THRESHOLD_BYTES };
+constexpr uint32_t EventsService::OfflineFailureThreshold;
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_END
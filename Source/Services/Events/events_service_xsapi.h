@@ -5,10 +5,28 @@
 
 #include <cll/CllPartA.h>
 #include <cll/CllTenantSettings.h>
+#include "xsapi-c/events_c.h"
 #include "events_service.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_BEGIN
 
+// Fields of an in-game event registered with XblEventsRegisterInGameEventSchema. Dimensions and measurements
+// are kept separately, each recording the position of its value in the XblEventFieldValue array.
+struct EventSchema
+{
+    struct Field
+    {
+        xsapi_internal_string name;
+        XblEventFieldType type;
+        size_t valueIndex;
+    };
+
+    xsapi_internal_string eventName;
+    xsapi_internal_vector<Field> dimensions;
+    xsapi_internal_vector<Field> measurements;
+    size_t fieldCount{ 0 };
+};
+
 class Event
 {
 public:
@@ -20,18 +38,38 @@ public:
         _In_ xbox::services::datetime timestamp = xbox::services::datetime::utc_now()
     );
 
-    Event(const Event& other);
+    // Builds an event from values already validated against schema, writing them straight into the
+    // event data without an intermediate JsonDocument
+    Event(
+        _In_ uint64_t xuid,
+        _In_ const EventSchema& schema,
+        _In_reads_(schema.fieldCount) const XblEventFieldValue* values,
+        _In_ xbox::services::datetime timestamp = xbox::services::datetime::utc_now()
+    );
 
+    Event(const Event& other) = default;
+    Event(Event&& other) = default;
+
+    // Parses an event from the text format used by offline events files before the journal was introduced
     static Result<Event> Deserialize(
         _In_ const xsapi_internal_string& inputData
     );
 
+    // Parses an event from a record written by AppendRecord
+    static Result<Event> DeserializeRecord(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    );
+
     const std::string& Data() const;
     const std::string& FullEventName() const;
     const xbox::services::datetime& Timestamp() const;
 
     xsapi_internal_string Serialize() const;
 
+    // Appends the event to an offline events journal segment as a single record
+    void AppendRecord(_Inout_ xsapi_internal_vector<uint8_t>& journalData) const;
+
 private:
     Event() = default;
 
@@ -39,11 +77,22 @@ private:
         _In_ const JsonValue& value
     );
 
+    void WriteDataHeader(_Inout_ bool& state);
+
+    void WriteFields(
+        _Inout_ bool& state,
+        _In_z_ const char* structName,
+        _In_ const xsapi_internal_vector<EventSchema::Field>& fields,
+        _In_ const XblEventFieldValue* values,
+        _Out_ xsapi_internal_string& fieldsJson
+    );
+
     uint64_t m_xuid{ 0 };
     xsapi_internal_string m_eventName;
     std::string m_fullEventName;
-    JsonDocument m_dimensions;
-    JsonDocument m_measurements;
+    // Serialized dimensions and measurements, used when persisting the event to disk
+    xsapi_internal_string m_dimensions;
+    xsapi_internal_string m_measurements;
     xbox::services::datetime m_timestamp;
     std::string m_data;
 };
@@ -58,6 +107,13 @@ public:
 
     HRESULT AddEvent(_In_ const Event& event);
     size_t EventCount() const;
+    // Approximate size of the events once serialized into the request body
+    size_t SizeInBytes() const;
+
+    // Records a failed upload attempt and returns the number of attempts that have failed
+    uint32_t OnUploadFailed();
+
+    static HRESULT SetMaxSizeInBytes(uint64_t sizeInBytes);
 
     struct RequestData
     {
@@ -67,10 +123,12 @@ public:
 
     HRESULT GetRequestData(_In_ AsyncContext<Result<const RequestData&>> async);
 
-    size_t ExtractEventsAndSerialize(
-        _Inout_ xsapi_internal_vector<uint8_t>& serializedData,
+    // Moves events into journalData as records until it reaches targetDataSize, and into extractedEvents so they
+    // can be requeued if the records aren't written. Returns the number of events remaining in the payload.
+    size_t ExtractEventRecords(
+        _Inout_ xsapi_internal_vector<uint8_t>& journalData,
         _In_ size_t targetDataSize,
-        _Inout_ xbox::services::datetime& timestamp
+        _Inout_ xsapi_internal_vector<Event>& extractedEvents
     );
 
 private:
@@ -78,11 +136,17 @@ private:
         _In_ AsyncContext<Result<std::vector<cll::TicketData>>> async
     );
 
+    static size_t EventSizeInBytes(_In_ const Event& event);
+
     User m_user;
     std::shared_ptr<cll::CllTenantSettings> m_tenantSettings;
     cll::CllUploadRequestData m_cllRequestData;
     RequestData m_requestData;
-    xsapi_internal_list<Event> m_events;
+    ArenaList<XblMemSubsystem::Events, Event> m_events;
+    size_t m_sizeInBytes{ 0 };
+    uint32_t m_failedUploadCount{ 0 };
+
+    static std::atomic<uint64_t> m_maxSizeInBytes;
 };
 
 enum class Mode
@@ -91,7 +155,9 @@ enum class Mode
     Offline
 };
 
-// Class to manage pending events
+// Class to manage pending events. While offline, events are persisted to an append-only journal of segment files
+// (see system::Journal). A small head file records the oldest segment that may still hold events and is only rewritten
+// when that changes; segments after the head are discovered by probing consecutive sequence numbers.
 class EventQueue : public std::enable_shared_from_this<EventQueue>
 {
 public:
@@ -107,15 +173,36 @@ public:
     HRESULT AddEvents(xsapi_internal_vector<Event>&& events);
     std::shared_ptr<EventUploadPayload> GetNextPayload(size_t minimumEventCount = 1);
     void SetMode(Mode mode);
-    void RequeueFailedPayload(std::shared_ptr<EventUploadPayload> failedPayload);
+    // Holds a payload whose upload failed until retryTime, after which GetNextPayload returns it ahead of new payloads
+    void RequeueFailedPayload(std::shared_ptr<EventUploadPayload> failedPayload, chrono_clock_t::time_point retryTime);
+
+    // Payloads held in memory, including those waiting to be retried. Events flushed to disk aren't counted.
+    struct PendingStats
+    {
+        size_t payloadCount{ 0 };
+        uint64_t sizeInBytes{ 0 };
+    };
+    PendingStats GetPendingStats();
 
     static HRESULT SetMaxFileSize(uint64_t fileSizeInBytes);
     static HRESULT SetStorageAllotment(uint64_t storageAllotmentInBytes);
 
 private:
-    HRESULT WriteDirectoryFile();
     HRESULT Populate();
     HRESULT Flush();
+    void RequeueEvents(xsapi_internal_vector<Event>&& events);
+
+    String SegmentFilename(uint64_t sequence) const;
+    HRESULT RecoverSegment(uint64_t sequence);
+    HRESULT MigrateLegacyFiles();
+    void AdvanceHead();
+
+    // Appends the events in a segment to events. Replay stops at a torn or corrupt tail.
+    static void ReplaySegment(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _Inout_ xsapi_internal_vector<Event>& events
+    );
 
     std::mutex m_mutex;
     std::atomic<Mode> m_mode{ Mode::Normal };
@@ -124,13 +211,34 @@ private:
     std::shared_ptr<cll::CllTenantSettings> m_tenantSettings;
 
     xsapi_internal_string const m_filenamePrefix{ "XblEvents" };
-    xsapi_internal_string m_directoryFilename;
+    xsapi_internal_string m_headFilename;
+    // Directory file used by the newline-delimited format, read once to migrate its events
+    xsapi_internal_string m_legacyDirectoryFilename;
 
-    xsapi_internal_list<std::shared_ptr<EventUploadPayload>> m_queue;
-    std::shared_ptr<EventUploadPayload> m_failedPayload;
+    struct FailedPayload
+    {
+        std::shared_ptr<EventUploadPayload> payload;
+        chrono_clock_t::time_point retryTime;
+    };
+
+    ArenaList<XblMemSubsystem::Events, std::shared_ptr<EventUploadPayload>> m_queue;
+    ArenaList<XblMemSubsystem::Events, FailedPayload> m_failedPayloads;
+
+    // journal metadata
+    struct SegmentInfo
+    {
+        uint64_t size;
+        // Set while the segment is being read back into the queue. It won't be appended to or deleted.
+        bool replaying;
+    };
 
-    // flush metadata
-    Map<String, uint64_t> m_fileMetadata;
+    Map<uint64_t, SegmentInfo> m_segments;
+    // Segments that were replayed or dropped but are still on disk, waiting for the head to move past them
+    Set<uint64_t> m_consumedSegments;
+    uint64_t m_headSegment{ 0 };
+    uint64_t m_nextSegment{ 0 };
+    // Flushing waits until the existing segments have been found so that sequence numbers aren't reused
+    bool m_journalRecovered{ false };
     uint64_t m_totalFilesSize{ 0 };
     bool m_flushInProgress{ false };
 
@@ -157,8 +265,25 @@ public:
         _In_opt_z_ const char* measurements
     );
 
+    HRESULT RegisterInGameEventSchema(
+        _In_z_ const char* eventName,
+        _In_reads_opt_(fieldsCount) const XblEventFieldDescriptor* fields,
+        _In_ size_t fieldsCount
+    );
+
+    HRESULT WriteInGameEvent(
+        _In_z_ const char* eventName,
+        _In_reads_opt_(valuesCount) const XblEventFieldValue* values,
+        _In_ size_t valuesCount
+    );
+
     static const std::string& IKey();
 
+    XblEventsUploadStats GetUploadStats();
+
+    static HRESULT SetMaxUploadsInFlight(uint32_t maxUploadsInFlight);
+    static void SetUploadCompression(bool enabled, size_t thresholdInBytes);
+
 private:
     HRESULT WriteInGameEventHelper(
         _In_ const xsapi_internal_string& eventName,
@@ -179,13 +304,46 @@ private:
         AsyncContext<HRESULT> async
     );
 
-    void OnFailedPayload(std::shared_ptr<EventUploadPayload> failedPayload);
+#if XSAPI_COROUTINES
+    // Fetches the payload's request data and uploads it from a single coroutine frame
+    static AsyncCoroutine UploadEventPayloadCoroutine(
+        std::weak_ptr<EventsService> weakThis,
+        std::shared_ptr<EventUploadPayload> payload,
+        AsyncContext<HRESULT> async
+    ) noexcept;
+#endif
+
+    Result<std::shared_ptr<XblHttpCall>> MakeUploadHttpCall(
+        const EventUploadPayload::RequestData& requestData
+    ) const noexcept;
+
+    static HRESULT UploadResultToHresult(const HttpResult& result) noexcept;
+
+    void OnUploadComplete(
+        std::shared_ptr<EventUploadPayload> payload,
+        HRESULT result,
+        chrono_clock_t::time_point startTime
+    );
 
     uint64_t m_minimumUploadIntervalInMs{ 1000 };
     uint64_t m_maximumUploadIntervalInMs{ 5000 };
     size_t m_payloadMinimumEventCount{ 1 };
-    uint32_t m_numRetryAttempts{ 0 };
-    xsapi_internal_string m_eventUploadUrl{ "https://vortex.data.microsoft.com/collect/v1" };
+
+    // Uploads that fail in a row before new events are written to disk instead of being held in memory
+    static constexpr uint32_t OfflineFailureThreshold{ 3 };
+    static std::atomic<uint32_t> m_maxUploadsInFlight;
+    static std::atomic<bool> m_uploadCompressionEnabled;
+    static std::atomic<size_t> m_uploadCompressionThreshold;
+
+    EventUploadScheduler m_uploadScheduler{ m_minimumUploadIntervalInMs };
+    std::mutex m_uploadMutex;
+    uint32_t m_consecutiveFailedUploads{ 0 };
+    uint64_t m_completedUploadCount{ 0 };
+    uint64_t m_failedUploadCount{ 0 };
+    std::chrono::milliseconds m_totalUploadLatency{ 0 };
+    std::chrono::milliseconds m_maxUploadLatency{ 0 };
+    xsapi_internal_string m_eventUploadHost{ "vortex.data.microsoft.com" };
+    xsapi_internal_string m_eventUploadUrl{ "https://" + m_eventUploadHost + "/collect/v1" };
     uint32_t m_uploadTimeoutInSeconds{ 5 };
 
     chrono_clock_t::time_point m_lastUploadAttempt{ chrono_clock_t::now() };
@@ -193,6 +351,8 @@ private:
     std::shared_ptr<EventQueue> m_eventQueue;
 
     std::shared_ptr<cll::CllTenantSettings> m_tenantSettings;
+
+    EventSchemaRegistry<EventSchema> m_schemas;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_EVENTS_CPP_END
@@ -73,65 +73,19 @@ private:
     legacy::leaderboard_stat_type m_statType;
 };
 
-class LeaderboardRow
-{
-public:
-    LeaderboardRow();
-
-    LeaderboardRow(
-        _In_ xsapi_internal_string gamertag,
-        _In_ xsapi_internal_string modernGamertag,
-        _In_ xsapi_internal_string modernGamertagSuffix,
-        _In_ xsapi_internal_string uniqueModernGamertag,
-        _In_ uint64_t xboxUserId,
-        _In_ double percentile,
-        _In_ uint32_t rank,
-        _In_ uint32_t globalRank,
-        _In_ xsapi_internal_vector<xsapi_internal_string> columnValues,
-        _In_ xsapi_internal_string metadata
-    );
-
-    LeaderboardRow(const LeaderboardRow& other);
-    
-    LeaderboardRow& operator =(const LeaderboardRow& other);
-
-    static Result<LeaderboardRow> Deserialize(
-        _In_ const JsonValue& json
-    );
-    size_t SizeOf();
-    char* Serialize(XblLeaderboardRow* row, char* buffer);
-
-    const xsapi_internal_string& Gamertag() const;
-    const xsapi_internal_string& ModernGamertag() const;
-    const xsapi_internal_string& ModernGamertagSuffix() const;
-    const xsapi_internal_string& UniqueGamertagSuffix() const;
-    uint64_t XboxUserId() const;
-    double Percentile() const;
-    uint32_t Rank() const;
-    uint32_t GlobalRank() const;
-    const xsapi_internal_vector<xsapi_internal_string>& ColumnValues() const;
-
-private:
-    xsapi_internal_string m_gamertag;
-    xsapi_internal_string m_modernGamertag;
-    xsapi_internal_string m_modernGamertagSuffix;
-    xsapi_internal_string m_uniqueModernGamertag;
-    uint64_t m_xuid{ 0 };
-    double m_percentile{ 0.0 };
-    uint32_t m_rank{ 0 };
-    uint32_t m_globalRank{ 0 };
-    xsapi_internal_vector<xsapi_internal_string> m_columnValues;
-    xsapi_internal_vector<const char*> m_columnValuesC;
-    JsonDocument m_metadata;
-
-    friend LeaderboardResult;
-};
-
+// Leaderboard pages are stored in the layout the C API hands back rather than as an object per row. Each row is
+// deserialized straight into an XblLeaderboardRow, and every column value is appended to one shared string block,
+// so a page costs a handful of allocations however many rows it has and is copied out with a few memcpys.
 class LeaderboardResult
 {
 public:
     LeaderboardResult() = default;
-    static Result<LeaderboardResult> Deserialize(_In_ const JsonValue& json);
+
+    // Values for additionalColumnNames are read from each row's valuemetadata and follow the row's own values
+    static Result<LeaderboardResult> Deserialize(
+        _In_ const JsonValue& json,
+        _In_ const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames = {}
+    );
 
     size_t SizeOfQuery();
     char* SerializeQuery(XblLeaderboardQuery* query, char* buffer);
@@ -141,25 +95,44 @@ public:
 
     uint32_t TotalRowCount() const;
     const xsapi_internal_vector<LeaderboardColumn>& Columns() const;
-    const xsapi_internal_vector<LeaderboardRow>& Rows() const;
+    size_t RowCount() const;
     bool HasNext() const;
     
     void SetNextQuery(std::shared_ptr<LeaderboardGlobalQuery> query);
     void SetNextQuery(std::shared_ptr<LeaderboardSocialQuery> query);
-    void ParseAdditionalColumns(const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames);
 
 private:
-    LeaderboardResult(
-        _In_ uint32_t totalRowCount,
-        _In_ String continuationToken,
-        _In_ Vector<LeaderboardColumn> columns,
-        _In_ Vector<LeaderboardRow> rows
+    HRESULT DeserializeRow(
+        _In_ const JsonValue& json,
+        _In_ const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames,
+        _Inout_ xsapi_internal_vector<legacy::leaderboard_stat_type>& additionalColumnTypes
+    );
+
+    // Appends a value to the string block and returns its offset
+    size_t AppendString(
+        _In_reads_(length) const char* value,
+        _In_ size_t length
+    );
+
+    static HRESULT ExtractRowString(
+        _In_ const JsonValue& json,
+        _In_z_ const char* name,
+        _Out_writes_z_(size) char* value,
+        _In_ size_t size
     );
 
     uint32_t m_totalRowCount{};
     String m_continuationToken;
     Vector<LeaderboardColumn> m_columns;
-    Vector<LeaderboardRow> m_rows;
+
+    // columnValues is only set when the rows are serialized. Until then the values for row i start at
+    // m_valueOffsets[m_rowValueStarts[i]].
+    Vector<XblLeaderboardRow> m_rows;
+    Vector<size_t> m_rowValueStarts;
+    // The offset of every column value in m_strings, grouped by row
+    Vector<size_t> m_valueOffsets;
+    // Null terminated column values
+    Vector<char> m_strings;
 
     std::shared_ptr<LeaderboardGlobalQuery> m_globalQuery;
     xsapi_internal_vector<const char*> m_additionalColumnleaderboardNamesC;
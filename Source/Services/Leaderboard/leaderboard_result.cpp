@@ -7,19 +7,6 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_LEADERBOARD_CPP_BEGIN
 
-LeaderboardResult::LeaderboardResult(
-    _In_ uint32_t totalRowCount,
-    _In_ String continuationToken,
-    _In_ Vector<LeaderboardColumn> columns,
-    _In_ Vector<LeaderboardRow> rows
-) :
-    m_totalRowCount{ totalRowCount },
-    m_continuationToken{ std::move(continuationToken) },
-    m_columns{ std::move(columns) },
-    m_rows{ std::move(rows) }
-{
-}
-
 uint32_t 
 LeaderboardResult::TotalRowCount() const
 {
@@ -32,10 +19,10 @@ LeaderboardResult::Columns() const
     return m_columns;
 }
 
-const xsapi_internal_vector<LeaderboardRow>& 
-LeaderboardResult::Rows() const
+size_t
+LeaderboardResult::RowCount() const
 {
-    return m_rows;
+    return m_rows.size();
 }
 
 void 
@@ -50,89 +37,31 @@ LeaderboardResult::SetNextQuery(std::shared_ptr<LeaderboardSocialQuery> query)
     m_socialQuery = std::move(query);
 }
 
-void 
-LeaderboardResult::ParseAdditionalColumns(const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames)
-{
-    xsapi_internal_vector<LeaderboardColumn> columns;
-    if (m_columns.size() == 0)
-    {
-        return;
-    }
-    columns.push_back(m_columns[0]);
-
-    std::unordered_map<xsapi_internal_string, legacy::leaderboard_stat_type> stats;
-
-    for (auto& row : m_rows)
-    {
-        for (uint32_t i = 0; i < additionalColumnNames.size(); ++i)
-        {
-            const xsapi_internal_string& columnName = additionalColumnNames[i];
-            auto stat = stats.find(columnName);
-            if (row.m_metadata.IsObject() && row.m_metadata.HasMember(columnName.data()))
-            {
-                const JsonValue& val = row.m_metadata[columnName.c_str()];
-                if (stat == stats.end() || stat->second == legacy::leaderboard_stat_type::stat_other)
-                {
-                    if (val.IsBool())
-                    {
-                        stats[columnName] = legacy::leaderboard_stat_type::stat_boolean;
-                    }
-                    else if (val.IsNumber())
-                    {
-                        stats[columnName] = legacy::leaderboard_stat_type::stat_double;
-                    }
-                    else if (val.IsString())
-                    {
-                        stats[columnName] = legacy::leaderboard_stat_type::stat_string;
-                    }
-                    else
-                    {
-                        stats[columnName] = legacy::leaderboard_stat_type::stat_other;
-                    }
-
-                }
-
-                auto columnValues = JsonUtils::SerializeJson(val);
-                if (i >= row.m_columnValues.size() - 1)
-                {
-                    row.m_columnValues.push_back(columnValues);
-                }
-                else
-                {
-                    row.m_columnValues[i] = columnValues;
-                }
-            }
-        }
-    }
-
-    for (const auto& columnName : additionalColumnNames)
-    {
-        columns.push_back(LeaderboardColumn(columnName, stats[columnName]));
-    }
-    m_columns = columns;
-}
-
 bool 
 LeaderboardResult::HasNext() const
 {
     return !m_continuationToken.empty();
 }
 
-Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& json)
+Result<LeaderboardResult> LeaderboardResult::Deserialize(
+    _In_ const JsonValue& json,
+    _In_ const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames
+)
 {
     if (!json.IsObject())
     {
         return WEB_E_INVALID_JSON_STRING;
     }
 
+    LeaderboardResult result;
+
     // Paging info
-    String continuationToken;
     if (json.HasMember("pagingInfo"))
     {
         const JsonValue& pagingInfo = json["pagingInfo"];
         if (!pagingInfo.IsNull())
         {
-            RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonString(pagingInfo, "continuationToken", continuationToken, false));
+            RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonString(pagingInfo, "continuationToken", result.m_continuationToken, false));
         }
     }
     else
@@ -141,8 +70,6 @@ Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& j
     }
 
     // Leaderboard metadata
-    uint32_t totalCount{ 0 };
-    Vector<LeaderboardColumn> columns;
     if (json.HasMember("leaderboardInfo"))
     {
         const auto& leaderboardInfoJson{ json["leaderboardInfo"] };
@@ -151,14 +78,14 @@ Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& j
             return WEB_E_INVALID_JSON_STRING;
         }
 
-        RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonInt(leaderboardInfoJson, "totalCount", totalCount));
+        RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonInt(leaderboardInfoJson, "totalCount", result.m_totalRowCount));
 
         if (leaderboardInfoJson.HasMember("columnDefinition"))
         {
             // This response schema is used by Global event based stat backed leaderboard queries
             auto columnResult = LeaderboardColumn::Deserialize(leaderboardInfoJson["columnDefinition"]);
             RETURN_HR_IF_FAILED(columnResult.Hresult());
-            columns.push_back(columnResult.ExtractPayload());
+            result.m_columns.push_back(columnResult.ExtractPayload());
         }
         else if (leaderboardInfoJson.HasMember("columns") && leaderboardInfoJson["columns"].IsArray())
         {
@@ -167,7 +94,7 @@ Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& j
             {
                 auto columnResult = LeaderboardColumn::Deserialize(columnJson);
                 RETURN_HR_IF_FAILED(columnResult.Hresult());
-                columns.push_back(columnResult.ExtractPayload());
+                result.m_columns.push_back(columnResult.ExtractPayload());
             }
         }
         else
@@ -180,15 +107,23 @@ Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& j
         return WEB_E_INVALID_JSON_STRING;
     }
 
-    Vector<LeaderboardRow> rows;
+    // Additional columns that never appear in a row's metadata are reported as stat_uint64
+    xsapi_internal_vector<legacy::leaderboard_stat_type> additionalColumnTypes(additionalColumnNames.size(), legacy::leaderboard_stat_type::stat_uint64);
+
     if (json.HasMember("userList") && json["userList"].IsArray())
     {
         const auto& jsonRows = json["userList"].GetArray();
+
+        // Sized for the common case of short values, so most pages never reallocate
+        size_t valuesPerRow{ 1 + additionalColumnNames.size() };
+        result.m_rows.reserve(jsonRows.Size());
+        result.m_rowValueStarts.reserve(jsonRows.Size());
+        result.m_valueOffsets.reserve(jsonRows.Size() * valuesPerRow);
+        result.m_strings.reserve(jsonRows.Size() * valuesPerRow * 16);
+
         for (const auto& row : jsonRows)
         {
-            auto rowResult = LeaderboardRow::Deserialize(row);
-            RETURN_HR_IF_FAILED(rowResult.Hresult());
-            rows.push_back(rowResult.ExtractPayload());
+            RETURN_HR_IF_FAILED(result.DeserializeRow(row, additionalColumnNames, additionalColumnTypes));
         }
     }
     else if (json.HasMember("leaderboard"))
@@ -200,7 +135,166 @@ Result<LeaderboardResult> LeaderboardResult::Deserialize(_In_ const JsonValue& j
         return WEB_E_INVALID_JSON_STRING;
     }
 
-    return LeaderboardResult{ totalCount, continuationToken, std::move(columns), std::move(rows) };
+    if (!additionalColumnNames.empty() && !result.m_columns.empty())
+    {
+        result.m_columns.resize(1);
+        for (size_t i = 0; i < additionalColumnNames.size(); ++i)
+        {
+            result.m_columns.push_back(LeaderboardColumn(additionalColumnNames[i], additionalColumnTypes[i]));
+        }
+    }
+
+    return Result<LeaderboardResult>{ std::move(result) };
+}
+
+HRESULT LeaderboardResult::DeserializeRow(
+    _In_ const JsonValue& json,
+    _In_ const xsapi_internal_vector<xsapi_internal_string>& additionalColumnNames,
+    _Inout_ xsapi_internal_vector<legacy::leaderboard_stat_type>& additionalColumnTypes
+)
+{
+    XblLeaderboardRow row{};
+    RETURN_HR_IF_FAILED(ExtractRowString(json, "gamertag", row.gamertag, sizeof(row.gamertag)));
+    RETURN_HR_IF_FAILED(ExtractRowString(json, "moderngamertag", row.modernGamertag, sizeof(row.modernGamertag)));
+    RETURN_HR_IF_FAILED(ExtractRowString(json, "moderngamertagsuffix", row.modernGamertagSuffix, sizeof(row.modernGamertagSuffix)));
+    RETURN_HR_IF_FAILED(ExtractRowString(json, "uniquemoderngamertag", row.uniqueModernGamertag, sizeof(row.uniqueModernGamertag)));
+    RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonXuid(json, "xuid", row.xboxUserId, true));
+    RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonDouble(json, "percentile", row.percentile, true));
+    int rank = 0;
+    int globalRank = 0;
+    RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonInt(json, "rank", rank, true));
+    if (json.HasMember("globalrank") && !json["globalrank"].IsNull())
+    {
+        RETURN_HR_IF_FAILED(JsonUtils::ExtractJsonInt(json, "globalrank", globalRank, false));
+    }
+    row.rank = rank;
+    row.globalRank = globalRank;
+
+    size_t valueStart{ m_valueOffsets.size() };
+    if (json.HasMember("value") && !json["value"].IsNull())
+    {
+        const JsonValue& value = json["value"];
+        m_valueOffsets.push_back(value.IsString() ? AppendString(value.GetString(), value.GetStringLength()) : AppendString("", 0));
+    }
+    else if (json.HasMember("values") && json["values"].IsArray())
+    {
+        for (const auto& value : json["values"].GetArray())
+        {
+            if (!value.IsString())
+            {
+                return WEB_E_INVALID_JSON_STRING;
+            }
+            m_valueOffsets.push_back(AppendString(value.GetString(), value.GetStringLength()));
+        }
+    }
+    else
+    {
+        return WEB_E_INVALID_JSON_STRING;
+    }
+
+    const char* metadataString{ nullptr };
+    if (json.HasMember("valuemetadata"))
+    {
+        const JsonValue& metadataJson = json["valuemetadata"];
+        if (metadataJson.IsString())
+        {
+            metadataString = metadataJson.GetString();
+        }
+        else if (!metadataJson.IsNull())
+        {
+            return WEB_E_INVALID_JSON_STRING;
+        }
+    }
+
+    // The metadata is only parsed when additional columns were requested from it
+    if (!additionalColumnNames.empty() && metadataString && metadataString[0] != 0)
+    {
+        JsonDocument metadata;
+        metadata.Parse(metadataString);
+
+        for (size_t i = 0; i < additionalColumnNames.size() && metadata.IsObject(); ++i)
+        {
+            const xsapi_internal_string& columnName = additionalColumnNames[i];
+            if (!metadata.HasMember(columnName.c_str()))
+            {
+                continue;
+            }
+
+            const JsonValue& val = metadata[columnName.c_str()];
+            auto& statType = additionalColumnTypes[i];
+            if (statType == legacy::leaderboard_stat_type::stat_other || statType == legacy::leaderboard_stat_type::stat_uint64)
+            {
+                if (val.IsBool())
+                {
+                    statType = legacy::leaderboard_stat_type::stat_boolean;
+                }
+                else if (val.IsNumber())
+                {
+                    statType = legacy::leaderboard_stat_type::stat_double;
+                }
+                else if (val.IsString())
+                {
+                    statType = legacy::leaderboard_stat_type::stat_string;
+                }
+                else
+                {
+                    statType = legacy::leaderboard_stat_type::stat_other;
+                }
+            }
+
+            auto columnValue = JsonUtils::SerializeJson(val);
+            size_t offset = AppendString(columnValue.data(), columnValue.size());
+            size_t rowValueCount{ m_valueOffsets.size() - valueStart };
+            if (rowValueCount == 0 || i >= rowValueCount - 1)
+            {
+                m_valueOffsets.push_back(offset);
+            }
+            else
+            {
+                m_valueOffsets[valueStart + i] = offset;
+            }
+        }
+    }
+
+    row.columnValuesCount = m_valueOffsets.size() - valueStart;
+    m_rows.push_back(row);
+    m_rowValueStarts.push_back(valueStart);
+    return S_OK;
+}
+
+size_t LeaderboardResult::AppendString(
+    _In_reads_(length) const char* value,
+    _In_ size_t length
+)
+{
+    size_t offset{ m_strings.size() };
+    m_strings.insert(m_strings.end(), value, value + length);
+    m_strings.push_back('\0');
+    return offset;
+}
+
+HRESULT LeaderboardResult::ExtractRowString(
+    _In_ const JsonValue& json,
+    _In_z_ const char* name,
+    _Out_writes_z_(size) char* value,
+    _In_ size_t size
+)
+{
+    if (!json.IsObject() || !json.HasMember(name))
+    {
+        return WEB_E_INVALID_JSON_STRING;
+    }
+
+    const JsonValue& field = json[name];
+    if (field.IsString())
+    {
+        utils::strcpy(value, size, field.GetString());
+    }
+    else if (!field.IsNull())
+    {
+        return WEB_E_INVALID_JSON_STRING;
+    }
+    return S_OK;
 }
 
 size_t
@@ -301,15 +395,18 @@ size_t
 LeaderboardResult::SizeOf()
 {
     size_t size = sizeof(XblLeaderboardResult);
-    for (auto column : m_columns)
+    for (auto& column : m_columns)
     {
         size += column.SizeOf();
     }
-    for (auto row : m_rows)
-    {
-        size += row.SizeOf();
-    }
-    
+
+    size += sizeof(XblLeaderboardRow) * m_rows.size();
+
+    // The column value pointers for every row are followed by the string block, padded so whatever follows stays
+    // word aligned
+    size_t valuesSize = sizeof(char*) * m_valueOffsets.size() + m_strings.size();
+    size += static_cast<size_t>((valuesSize + XBL_ALIGN_SIZE - 1) / XBL_ALIGN_SIZE) * XBL_ALIGN_SIZE;
+
     size += SizeOfQuery();
 
     return size;
@@ -332,12 +429,39 @@ LeaderboardResult::Serialize(char* buffer)
         buffer = m_columns[i].Serialize(&result->columns[i], buffer);
     }
 
+    // The rows are already in their final layout, so only their columnValues pointers need to be filled in
     result->rowsCount = m_rows.size();
     result->rows = reinterpret_cast<XblLeaderboardRow*>(buffer);
+    if (!m_rows.empty())
+    {
+        memcpy(result->rows, m_rows.data(), sizeof(XblLeaderboardRow) * m_rows.size());
+    }
     buffer += sizeof(XblLeaderboardRow) * m_rows.size();
+
+    const char** columnValues = reinterpret_cast<const char**>(buffer);
+    buffer += sizeof(char*) * m_valueOffsets.size();
+
+    char* strings = buffer;
+    if (!m_strings.empty())
+    {
+        memcpy(strings, m_strings.data(), m_strings.size());
+    }
+    buffer += m_strings.size();
+
+    for (size_t i = 0; i < m_valueOffsets.size(); i++)
+    {
+        columnValues[i] = strings + m_valueOffsets[i];
+    }
     for (size_t i = 0; i < m_rows.size(); i++)
     {
-        buffer = m_rows[i].Serialize(&result->rows[i], buffer);
+        result->rows[i].columnValues = columnValues + m_rowValueStarts[i];
+    }
+
+    size_t s = sizeof(char*) * m_valueOffsets.size() + m_strings.size();
+    if ((s % XBL_ALIGN_SIZE) != 0)
+    {
+        // calculate how much padding is needed
+        buffer += (static_cast<size_t>((s + XBL_ALIGN_SIZE - 1) / XBL_ALIGN_SIZE) * XBL_ALIGN_SIZE) - s;
     }
 
     return SerializeQuery(&result->nextQuery, buffer);
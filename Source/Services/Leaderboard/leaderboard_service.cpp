@@ -210,16 +210,12 @@ LeaderboardService::GetLeaderboard(
                         if (SUCCEEDED(hr))
                         {
                             auto xblResult = LeaderboardResult::Deserialize(
-                                httpResult.Payload()->GetResponseBodyJson()
+                                httpResult.Payload()->GetResponseBodyJson(),
+                                additionalColumnNames
                             );
-                            result = xblResult.Payload();
-                            result.SetNextQuery(query);
-                            if (additionalColumnNames.size() > 0)
-                            {
-                                result.ParseAdditionalColumns(additionalColumnNames);
-                            }
-
                             hr = xblResult.Hresult();
+                            result = xblResult.ExtractPayload();
+                            result.SetNextQuery(query);
                         }
                     }
                     XAsyncComplete(data->async, hr, result.SizeOf());
@@ -400,10 +396,9 @@ LeaderboardService::GetLeaderboardForSocialGroup(
                             auto xblResult = LeaderboardResult::Deserialize(
                                 httpResult.Payload()->GetResponseBodyJson()
                             );
-                            result = xblResult.Payload();
-                            result.SetNextQuery(query);
-
                             hr = xblResult.Hresult();
+                            result = xblResult.ExtractPayload();
+                            result.SetNextQuery(query);
                         }
                     }
                     XAsyncComplete(data->async, hr, result.SizeOf());
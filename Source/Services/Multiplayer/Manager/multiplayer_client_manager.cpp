@@ -156,7 +156,7 @@ MultiplayerClientManager::SetProperties(
 
     std::lock_guard<std::mutex> guard(m_clientRequestLock);
     auto latestPending = LatestPendingRead();
-    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap().size() == 0, E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
+    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap()->empty(), E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
 
     latestPending->SetProperties(sessionRef, name, valueJson, context);
     return S_OK;
@@ -170,7 +170,7 @@ MultiplayerClientManager::SetJoinability(
 {
     std::lock_guard<std::mutex> guard(m_clientRequestLock);
     auto latestPending = LatestPendingRead();
-    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap().size() == 0, E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
+    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap()->empty(), E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
 
     return latestPending->LobbyClient()->SetJoinability(value, context);
 }
@@ -187,7 +187,7 @@ MultiplayerClientManager::SetSynchronizedHost(
 
     std::lock_guard<std::mutex> guard(m_clientRequestLock);
     auto latestPending = LatestPendingRead();
-    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap().size() == 0, E_UNEXPECTED, "Call add_local_user() before writing host properties.");
+    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap()->empty(), E_UNEXPECTED, "Call add_local_user() before writing host properties.");
 
     return latestPending->SetSynchronizedHost(sessionRef, hostDeviceToken, context);
 }
@@ -205,7 +205,7 @@ MultiplayerClientManager::SetSynchronizedProperties(
 
     std::lock_guard<std::mutex> guard(m_clientRequestLock);
     auto latestPending = LatestPendingRead();
-    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap().size() == 0, E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
+    RETURN_HR_IF_LOG_DEBUG(latestPending == nullptr || GetXboxLiveContextMap()->empty(), E_UNEXPECTED, "Call add_local_user() before writing lobby properties.");
 
     return latestPending->SetSynchronizedProperties(sessionRef, name, valueJson, context);
 }
@@ -709,7 +709,7 @@ MultiplayerClientManager::IsUpdateAvailable()
         return true;
     }
 
-    if (GetXboxLiveContextMap().size() == 0 && IsRequestInProgress())
+    if (GetXboxLiveContextMap()->empty() && IsRequestInProgress())
     {
         return true;
     }
@@ -737,10 +737,10 @@ MultiplayerClientManager::DoWork()
     ProcessEvents(m_latestPendingRead->GameClient()->Session(), m_lastPendingRead->GameClient()->Session(), XblMultiplayerSessionType::GameSession);
     ProcessEvents(m_latestPendingRead->MatchClient()->Session(), m_lastPendingRead->MatchClient()->Session(), XblMultiplayerSessionType::MatchSession);
 
-    m_lastPendingRead->deep_copy_if_updated(*m_latestPendingRead);
+    m_lastPendingRead->SnapshotIfUpdated(*m_latestPendingRead);
     auto eventQueue = m_lastPendingRead->EventQueue();
 
-    if (GetXboxLiveContextMap().size() == 0 && !IsRequestInProgress())
+    if (GetXboxLiveContextMap()->empty() && !IsRequestInProgress())
     {
         if (!m_subscriptionsLostFired)
         {
@@ -761,7 +761,7 @@ MultiplayerClientManager::DoWork()
     return eventQueue;
 }
 
-xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>>
+std::shared_ptr<const LocalUserMap>
 MultiplayerClientManager::GetXboxLiveContextMap()
 {
     return m_multiplayerLocalUserManager->GetLocalUserMap();
@@ -783,7 +783,7 @@ MultiplayerClientManager::OnMultiplayerConnectionIdChanged()
     if (lobbySession && lobbyClientSessionSafe.CurrentUser() && lobbyClientSessionSafe.CurrentUser()->Status == XblMultiplayerSessionMemberStatus::Active)
     {
         MultiplayerSessionMember::Get(lobbyClientSessionSafe.CurrentUser())->SetStatus(lobbyClientSessionSafe.CurrentUser()->Status);
-        auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+        auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
         lobbyClient->AddToPendingQueue(pendingRequest);
     }
 
@@ -793,7 +793,7 @@ MultiplayerClientManager::OnMultiplayerConnectionIdChanged()
     if (gameSession && gameClientSessionSafe.CurrentUser() && gameClientSessionSafe.CurrentUser()->Status == XblMultiplayerSessionMemberStatus::Active)
     {
         MultiplayerSessionMember::Get(gameClientSessionSafe.CurrentUser())->SetStatus(gameClientSessionSafe.CurrentUser()->Status);
-        auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+        auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
         gameClient->AddToPendingQueue(pendingRequest);
     }
 }
@@ -1097,11 +1097,11 @@ MultiplayerClientManager::HandleMemberPropertiesChanged(
     if (memberPropertiesChanged.size() > 0)
     {
         xsapi_internal_vector<std::shared_ptr<MultiplayerMember>> gameMembers;
-        const auto& localUsersMap = m_multiplayerLocalUserManager->GetLocalUserMap();
+        auto localUsersMap = m_multiplayerLocalUserManager->GetLocalUserMap();
         for (auto member : memberPropertiesChanged)
         {
-            auto iter = localUsersMap.find(member->Xuid);
-            if (iter != localUsersMap.end())
+            auto iter = localUsersMap->find(member->Xuid);
+            if (iter != localUsersMap->end())
             {
                 // Don't trigger member property changed events for local users.
                 continue;
@@ -9,7 +9,7 @@ using namespace xbox::services::multiplayer;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_MULTIPLAYER_MANAGER_CPP_BEGIN
 
-void MultiplayerClientPendingReader::deep_copy_if_updated(
+void MultiplayerClientPendingReader::SnapshotIfUpdated(
     _In_ const MultiplayerClientPendingReader& other
     )
 {
@@ -22,7 +22,7 @@ void MultiplayerClientPendingReader::deep_copy_if_updated(
     }
     else
     {
-        m_lobbyClient->deep_copy_if_updated(*other.m_lobbyClient);
+        m_lobbyClient->SnapshotIfUpdated(*other.m_lobbyClient);
     }
 
     if (other.m_gameClient == nullptr)
@@ -31,7 +31,7 @@ void MultiplayerClientPendingReader::deep_copy_if_updated(
     }
     else
     {
-        m_gameClient->deep_copy_if_updated(*other.m_gameClient);
+        m_gameClient->SnapshotIfUpdated(*other.m_gameClient);
     }
 
     if (other.m_matchClient == nullptr)
@@ -40,7 +40,7 @@ void MultiplayerClientPendingReader::deep_copy_if_updated(
     }
     else
     {
-        m_matchClient->deep_copy_if_updated(*other.m_matchClient);
+        m_matchClient->SnapshotIfUpdated(*other.m_matchClient);
     }
 }
 
@@ -294,7 +294,7 @@ MultiplayerClientPendingReader::SetProperties(
     _In_opt_ context_t context
     )
 {
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetSessionProperties(name, valueJson, context);
     AddToPendingQueue(sessionRef, pendingRequest);
     return S_OK;
@@ -307,7 +307,7 @@ MultiplayerClientPendingReader::SetSynchronizedHost(
     _In_opt_ context_t context
     )
 {
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetSynchronizedHostDeviceToken(hostDeviceToken, context);
     AddToPendingQueue(sessionRef, pendingRequest);
     return S_OK;
@@ -321,7 +321,7 @@ MultiplayerClientPendingReader::SetSynchronizedProperties(
     _In_opt_ context_t context
     )
 {
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetSynchronizedSessionProperties(name, valueJson, context);
     AddToPendingQueue(sessionRef, pendingRequest);
     return S_OK;
@@ -370,7 +370,7 @@ MultiplayerClientPendingReader::ConvertToGameMember(
         member,
         m_lobbyClient->Session(),
         m_gameClient->Session(),
-        m_multiplayerLocalUserManager->GetLocalUserMap()
+        *m_multiplayerLocalUserManager->GetLocalUserMap()
         );
 }
 
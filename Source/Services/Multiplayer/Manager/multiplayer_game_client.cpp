@@ -75,7 +75,7 @@ MultiplayerGameClient::SetGameSessionTemplate(
 }
 
 void
-MultiplayerGameClient::deep_copy_if_updated(
+MultiplayerGameClient::SnapshotIfUpdated(
     _In_ const MultiplayerGameClient& other
     )
 {
@@ -94,12 +94,14 @@ MultiplayerGameClient::deep_copy_if_updated(
             other.m_sessionWriter->Session()->SessionInfo().ChangeNumber > m_sessionWriter->Session()->SessionInfo().ChangeNumber ||
             other.m_sessionWriter->Session()->ETag() > m_sessionWriter->Session()->ETag())
     {
-        m_sessionWriter->UpdateSession(MakeShared<XblMultiplayerSession>(*other.m_sessionWriter->Session()));
-        m_multiplayerGame = MakeShared<MultiplayerGameSession>(*other.m_multiplayerGame);
+        m_sessionWriter->UpdateSession(other.m_sessionWriter->Session());
+        m_multiplayerGame = other.m_multiplayerGame;
+        m_updateNumber = other.m_updateNumber;
     }
     else if (m_updateNumber != other.m_updateNumber)
     {
-        m_multiplayerGame = MakeShared<MultiplayerGameSession>(*other.m_multiplayerGame);
+        m_multiplayerGame = other.m_multiplayerGame;
+        m_updateNumber = other.m_updateNumber;
     }
 }
 
@@ -185,6 +187,7 @@ MultiplayerGameClient::ConvertToMultiplayerGame(
 
     std::shared_ptr<MultiplayerMember> hostMember = nullptr;
     xsapi_internal_vector<std::shared_ptr<MultiplayerMember>> gameMembers;
+    auto localUserMap = m_multiplayerLocalUserManager->GetLocalUserMap();
     XblMultiplayerSessionReadLockGuard sessionToConvertSafe(sessionToConvert);
     for (const auto& member : sessionToConvertSafe.Members())
     {
@@ -192,7 +195,7 @@ MultiplayerGameClient::ConvertToMultiplayerGame(
             &member,
             lobbySession,
             sessionToConvert,
-            m_multiplayerLocalUserManager->GetLocalUserMap()
+            *localUserMap
             );
         if (member.DeviceToken.Value[0] != 0 && utils::str_icmp(member.DeviceToken.Value, sessionToConvertSafe.SessionProperties().HostDeviceToken.Value) == 0)
         {
@@ -332,13 +335,14 @@ MultiplayerGameClient::DoWork()
                 };
 
                 // TODO we should have a way to configure the queue here
-                if (applySynchronizedChanges)
-                {
-                    m_sessionWriter->CommitPendingSynchronizedChanges(processingQueue, XblMultiplayerSessionType::GameSession, callback);
-                }
-                else
-                {
+                HRESULT hr = applySynchronizedChanges ?
+                    m_sessionWriter->CommitPendingSynchronizedChanges(processingQueue, XblMultiplayerSessionType::GameSession, callback) :
                     m_sessionWriter->CommitPendingChanges(processingQueue, XblMultiplayerSessionType::GameSession, false, callback);
+
+                // The callback isn't called if the commit fails to start
+                if (FAILED(hr))
+                {
+                    callback(Result<MultiplayerEventQueue>{ hr });
                 }
             }
             else
@@ -490,7 +494,7 @@ MultiplayerGameClient::RemoveStaleUsersFromRemoteSession()
     }
 
     auto xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
-    for (auto xboxLiveContext : xboxLiveContextMap)
+    for (auto xboxLiveContext : *xboxLiveContextMap)
     {
         auto localUser = xboxLiveContext.second;
         if (localUser != nullptr && localUser->LobbyState() == MultiplayerLocalUserLobbyState::Remove)
@@ -662,7 +666,7 @@ HRESULT MultiplayerGameClient::JoinGameForAllLocalMembers(
             m_sessionRefToJoin{ sessionRefToJoin },
             m_handleIdToJoin{ std::move(handleIdToJoin) },
             m_createGameIfFailedToJoin{ createGameIfFailedToJoin },
-            m_localUsers{ m_gameClient->m_multiplayerLocalUserManager->GetLocalUserMap() },
+            m_localUsers{ *m_gameClient->m_multiplayerLocalUserManager->GetLocalUserMap() },
             m_callback{ std::move(callback) }
         {
         }
@@ -814,7 +818,7 @@ void MultiplayerGameClient::LeaveRemoteSession(
     _In_ bool triggerCompletionEvent
 ) noexcept
 {
-    auto processingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto processingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     m_processingQueue.push_back(processingRequest);
 
     m_sessionWriter->LeaveRemoteSession(session,
@@ -58,7 +58,7 @@ MultiplayerLobbyClient::Initialize()
     });
 }
 
-void MultiplayerLobbyClient::deep_copy_if_updated(
+void MultiplayerLobbyClient::SnapshotIfUpdated(
     _In_ const MultiplayerLobbyClient& other
     )
 {
@@ -78,12 +78,14 @@ void MultiplayerLobbyClient::deep_copy_if_updated(
             other.m_sessionWriter->Session()->SessionInfo().ChangeNumber > m_sessionWriter->Session()->SessionInfo().ChangeNumber ||
             other.m_sessionWriter->Session()->ETag() > m_sessionWriter->Session()->ETag())
     {
-        m_sessionWriter->UpdateSession(MakeShared<XblMultiplayerSession>(*other.m_sessionWriter->Session()));
-        m_multiplayerLobby = MakeShared<MultiplayerLobbySession>(*other.m_multiplayerLobby);
+        m_sessionWriter->UpdateSession(other.m_sessionWriter->Session());
+        m_multiplayerLobby = other.m_multiplayerLobby;
+        m_updateNumber = other.m_updateNumber;
     }
     else if (m_updateNumber != other.m_updateNumber)
     {
-        m_multiplayerLobby = MakeShared<MultiplayerLobbySession>(*other.m_multiplayerLobby);
+        m_multiplayerLobby = other.m_multiplayerLobby;
+        m_updateNumber = other.m_updateNumber;
     }
 }
 
@@ -193,7 +195,7 @@ MultiplayerLobbyClient::UpdateLocalLobbyMembers(
     auto localLobbyGameMembers = xsapi_internal_vector<std::shared_ptr<MultiplayerMember>>();
 
     auto xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
-    for(auto xboxLiveContext : xboxLiveContextMap)
+    for(auto xboxLiveContext : *xboxLiveContextMap)
     {
         auto localUser =  xboxLiveContext.second;
         if (localUser != nullptr)
@@ -223,6 +225,7 @@ MultiplayerLobbyClient::ConvertToMultiplayerLobby(
 
     std::shared_ptr<MultiplayerMember> hostMember = nullptr;
     xsapi_internal_vector<std::shared_ptr<MultiplayerMember>> gameMembers;
+    auto localUserMap = m_multiplayerLocalUserManager->GetLocalUserMap();
     XblMultiplayerSessionReadLockGuard sessionToConvertSafe(sessionToConvert);
     for (const auto& member : sessionToConvertSafe.Members())
     {
@@ -230,7 +233,7 @@ MultiplayerLobbyClient::ConvertToMultiplayerLobby(
             &member, 
             sessionToConvert,
             gameSession,
-            m_multiplayerLocalUserManager->GetLocalUserMap()
+            *localUserMap
             );
         if (member.DeviceToken.Value[0] != 0 && utils::str_icmp(member.DeviceToken.Value, sessionToConvertSafe.SessionProperties().HostDeviceToken.Value) == 0)
         {
@@ -333,7 +336,7 @@ MultiplayerLobbyClient::AddLocalUser(
         localUser = localUserResult.ExtractPayload();
     }
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetLocalUser(localUser);
     pendingRequest->SetLobbyState(userState);
     if (userState == MultiplayerLocalUserLobbyState::Join)
@@ -383,7 +386,7 @@ MultiplayerLobbyClient::RemoveLocalUser(
     auto localUser = m_multiplayerLocalUserManager->GetLocalUserHelper(user);
     RETURN_HR_IF_LOG_DEBUG(localUser == nullptr || localUser->Context() == nullptr, E_UNEXPECTED, "Call add_local_user() first.");
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetLocalUser(localUser);
     pendingRequest->SetLobbyState(MultiplayerLocalUserLobbyState::Leave);
     AddToPendingQueue(pendingRequest);
@@ -398,13 +401,13 @@ MultiplayerLobbyClient::RemoveAllLocalUsers()
 
     if (m_multiplayerLocalUserManager != nullptr)
     {
-        const auto& xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
-        for (auto xboxLiveContext : xboxLiveContextMap)
+        auto xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
+        for (auto xboxLiveContext : *xboxLiveContextMap)
         {
             const auto& localUser = xboxLiveContext.second;
             if (localUser != nullptr)
             {
-                auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+                auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
                 pendingRequest->SetLocalUser(localUser);
                 pendingRequest->SetLobbyState(MultiplayerLocalUserLobbyState::Leave);
                 AddToPendingQueue(pendingRequest);
@@ -427,7 +430,7 @@ MultiplayerLobbyClient::SetLocalMemberProperties(
     auto localUser = m_multiplayerLocalUserManager->GetLocalUserHelper(user);
     RETURN_HR_IF_LOG_DEBUG(localUser == nullptr || localUser->Context() == nullptr, E_UNEXPECTED, "Call add_local_user() before setting local member properties.");
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetLocalUserProperties(localUser, name, valueJson, context);
     AddToPendingQueue(pendingRequest);
 
@@ -447,7 +450,7 @@ MultiplayerLobbyClient::DeleteLocalMemberProperties(
     auto localUser = m_multiplayerLocalUserManager->GetLocalUserHelper(user);
     RETURN_HR_IF_LOG_DEBUG(localUser == nullptr || localUser->Context() == nullptr, E_UNEXPECTED, "Call add_local_user() before deleting local member properties.");
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetLocalUserProperties(localUser, name, JsonValue(), context);
     AddToPendingQueue(pendingRequest);
 
@@ -467,7 +470,7 @@ MultiplayerLobbyClient::SetLocalMemberConnectionAddress(
     auto localUser = m_multiplayerLocalUserManager->GetLocalUserHelper(user);
     RETURN_HR_IF_LOG_DEBUG(localUser == nullptr || localUser->Context() == nullptr, E_UNEXPECTED, "Call add_local_user() before setting local member connection address.");
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetLocalUserConnectionAddress(localUser, address, context);
     AddToPendingQueue(pendingRequest);
 
@@ -481,7 +484,7 @@ HRESULT MultiplayerLobbyClient::SetJoinability(
 {
     RETURN_HR_INVALIDARGUMENT_IF(value < XblMultiplayerJoinability::JoinableByFriends || value > XblMultiplayerJoinability::Closed);
 
-    auto pendingRequest = MakeShared<MultiplayerClientPendingRequest>();
+    auto pendingRequest = ArenaMakeShared<XblMemSubsystem::MultiplayerManager, MultiplayerClientPendingRequest>();
     pendingRequest->SetJoinability(value, context);
     AddToPendingQueue(pendingRequest);
 
@@ -589,9 +592,10 @@ MultiplayerLobbyClient::DoWork()
                     }
                 };
 
+                HRESULT hr = S_OK;
                 if (applySynchronizedChanges)
                 {
-                    m_sessionWriter->CommitPendingSynchronizedChanges(processingQueue, XblMultiplayerSessionType::LobbySession, callback);
+                    hr = m_sessionWriter->CommitPendingSynchronizedChanges(processingQueue, XblMultiplayerSessionType::LobbySession, callback);
                 }
                 else
                 {
@@ -613,7 +617,13 @@ MultiplayerLobbyClient::DoWork()
                         }
                     }
 
-                    CommitPendingLobbyChanges(xuidsInOrder, joinByHandleId, teamSessionRef, callback);
+                    hr = CommitPendingLobbyChanges(xuidsInOrder, joinByHandleId, teamSessionRef, callback);
+                }
+
+                // The callback isn't called if the commit fails to start
+                if (FAILED(hr))
+                {
+                    callback(Result<MultiplayerEventQueue>{ hr });
                 }
 
 
@@ -671,8 +681,8 @@ MultiplayerLobbyClient::IsRequestInProgress()
 bool
 MultiplayerLobbyClient::IsPendingLobbyLocalUserChanges()
 {
-    const auto& xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
-    for (auto xboxLiveContext : xboxLiveContextMap)
+    auto xboxLiveContextMap = m_multiplayerLocalUserManager->GetLocalUserMap();
+    for (auto xboxLiveContext : *xboxLiveContextMap)
     {
         const auto& localUser = xboxLiveContext.second;
         if (localUser != nullptr && localUser->WriteChangesToService())
@@ -758,7 +768,8 @@ HRESULT MultiplayerLobbyClient::CommitLobbyChanges(
             m_lobbySessionToCommit{ std::move(lobbySessionToCommit) },
             m_callback{ std::move(callback) }
         {
-            auto& localUsers{ m_lobbyClient->GetLocalUserMap() };
+            auto localUsersSnapshot{ m_lobbyClient->GetLocalUserMap() };
+            const auto& localUsers{ *localUsersSnapshot };
             if (xuidsInOrder.empty())
             {
                 for (auto pair : localUsers)
@@ -1003,9 +1014,11 @@ HRESULT MultiplayerLobbyClient::CommitLobbyChanges(
 
         void UpdateHostDeviceToken(
             std::shared_ptr<MultiplayerLocalUser> user,
-            std::shared_ptr<XblMultiplayerSession> session
+            std::shared_ptr<XblMultiplayerSession> updatedSession
         ) noexcept
         {
+            // updatedSession has already been published to the lobby client, so change a copy of it
+            auto session = MakeShared<XblMultiplayerSession>(*updatedSession);
             XblMultiplayerSessionReadLockGuard sessionSafe{ session };
             session->SetHostDeviceToken(sessionSafe.CurrentUser()->DeviceToken);
 
@@ -1109,7 +1122,7 @@ MultiplayerLobbyClient::RemoveStaleXboxLiveContextFromMap()
     m_multiplayerLocalUserManager->RemoveStaleLocalUsersFromMap();
 }
 
-const xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>>&
+std::shared_ptr<const LocalUserMap>
 MultiplayerLobbyClient::GetLocalUserMap()
 {
     return m_multiplayerLocalUserManager->GetLocalUserMap();
@@ -1333,7 +1346,7 @@ void MultiplayerLobbyClient::AdvertiseGameSession() noexcept
             auto lobbySession{ m_lobbyClient->Session() };
             if (!lobbySession)
             {
-                if (m_lobbyClient->m_multiplayerLocalUserManager->GetLocalUserMap().empty())
+                if (m_lobbyClient->m_multiplayerLocalUserManager->GetLocalUserMap()->empty())
                 {
                     // There are no remaining local users. Complete the operation
                     return Complete(S_OK);
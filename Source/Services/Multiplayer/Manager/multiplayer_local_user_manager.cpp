@@ -21,11 +21,20 @@ MultiplayerLocalUserManager::~MultiplayerLocalUserManager()
     m_rtaResyncEventHandler.clear();
 }
 
-const xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>>&
+std::shared_ptr<const LocalUserMap>
 MultiplayerLocalUserManager::GetLocalUserMap()
 {
-    std::lock_guard<std::mutex> lock(m_lock);
-    return m_localUserRequestMap;
+    std::lock_guard<std::mutex> lock(m_localUserMapLock);
+    return m_localUserMap;
+}
+
+void
+MultiplayerLocalUserManager::PublishLocalUserMap()
+{
+    std::shared_ptr<const LocalUserMap> localUserMap = MakeShared<LocalUserMap>(m_localUserRequestMap);
+
+    std::lock_guard<std::mutex> lock(m_localUserMapLock);
+    m_localUserMap = std::move(localUserMap);
 }
 
 std::shared_ptr<XblContext>
@@ -190,6 +199,7 @@ MultiplayerLocalUserManager::AddUserToXboxLiveContextToMap(
         {
             m_primaryXboxLiveContext = localUser->Context();
         }
+        PublishLocalUserMap();
 
         // Activate events only for all users
         ActivateMultiplayerEvents(localUser);
@@ -204,6 +214,7 @@ MultiplayerLocalUserManager::RemoveStaleLocalUsersFromMap()
     std::lock_guard<std::mutex> lock(m_lock);
 
     bool swtichPrimaryXboxLiveContext = false;
+    bool removedUser = false;
     for(auto iter = m_localUserRequestMap.begin(); iter != m_localUserRequestMap.end(); )
     {
         const auto& localUser =  iter->second;
@@ -214,6 +225,7 @@ MultiplayerLocalUserManager::RemoveStaleLocalUsersFromMap()
 
             swtichPrimaryXboxLiveContext = localUser->IsPrimaryXboxLiveContext();
             m_localUserRequestMap.erase(iter++);
+            removedUser = true;
         }
         else
         {
@@ -221,6 +233,11 @@ MultiplayerLocalUserManager::RemoveStaleLocalUsersFromMap()
         }
     }
 
+    if (removedUser)
+    {
+        PublishLocalUserMap();
+    }
+
     if (m_localUserRequestMap.size() == 0)
     {
         m_primaryXboxLiveContext = nullptr;
@@ -64,6 +64,7 @@ bool MultiplayerManager::IsDirty()
 
 const MultiplayerEventQueue& MultiplayerManager::DoWork()
 {
+    XSAPI_PROFILE_SCOPE(XblProfileArea::MultiplayerManagerDoWork);
     std::lock_guard<std::mutex> guard(m_lock);
     m_eventQueue.Clear();
 
@@ -138,8 +139,13 @@ MultiplayerManager::SetMultiplayerGameSession(
     }
     else
     {
+        // Snapshots are shared with the pending reads and with titles still holding the previous DoWork's
+        // result, so only stamp the client manager on one that hasn't been published yet.
+        if (gameSession->ClientManager() != m_multiplayerClientManager)
+        {
+            gameSession->SetMultiplayerClientManager(m_multiplayerClientManager);
+        }
         m_multiplayerGameSession = gameSession;
-        m_multiplayerGameSession->SetMultiplayerClientManager(m_multiplayerClientManager);
     }
 }
 
@@ -162,8 +168,12 @@ MultiplayerManager::SetMultiplayerLobbySession(
     }
     else
     {
+        // See SetMultiplayerGameSession
+        if (multiplayerLobby->ClientManager() != m_multiplayerClientManager)
+        {
+            multiplayerLobby->SetMultiplayerClientManager(m_multiplayerClientManager);
+        }
         m_multiplayerLobbySession = multiplayerLobby;
-        m_multiplayerLobbySession->SetMultiplayerClientManager(m_multiplayerClientManager);
     }
 }
 
@@ -31,6 +31,8 @@ class MultiplayerLobbyClient;
 class MultiplayerGameClient;
 class MultiplayerLocalUser;
 
+typedef xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>> LocalUserMap;
+
 enum class MultiplayerLocalUserLobbyState
 {
     Unknown,
@@ -204,6 +206,7 @@ public:
 
     uint64_t ChangeNumber() const;
 
+    std::shared_ptr<MultiplayerClientManager> ClientManager() const { return m_multiplayerClientManager; }
     void SetMultiplayerClientManager(
         _In_ std::shared_ptr<MultiplayerClientManager> clientManager
         );
@@ -355,6 +358,7 @@ public:
         _In_opt_ context_t context = nullptr
         );
     uint64_t ChangeNumber() const;
+    std::shared_ptr<MultiplayerClientManager> ClientManager() const { return m_multiplayerClientManager; }
     void SetMultiplayerClientManager(
         _In_ std::shared_ptr<MultiplayerClientManager> clientManager
         );
@@ -724,6 +728,8 @@ public:
 
     uint64_t Id() const;
 
+    // Sessions are published as snapshots that DoWork and the title share without copying. A published session
+    // must not be modified; copy it and publish the copy instead.
     const std::shared_ptr<XblMultiplayerSession>& Session() const;
     void UpdateSession(_In_ const std::shared_ptr<XblMultiplayerSession>& updatedSession);
 
@@ -799,9 +805,45 @@ public:
         );
 
 private:
+    // A batch of pending requests waiting for the session writes in flight to complete
+    struct PendingCommit
+    {
+        Vector<std::shared_ptr<MultiplayerClientPendingRequest>> processingQueue;
+        XblMultiplayerSessionType sessionType;
+        XblMultiplayerSessionWriteMode mode;
+        bool isGameInProgress;
+        MultiplayerEventQueueCallback callback;
+        uint64_t id{ 0 };
+    };
+
     void Destroy();
     void Resync();
 
+    // Defers the commit if a write is in flight, otherwise writes it immediately. Each commit's callback is called
+    // exactly once with the result of the write it was part of, unless this returns a failure, in which case the
+    // callback isn't called.
+    HRESULT CommitPending(_In_ PendingCommit&& commit) noexcept;
+
+    // Applies the pending changes from each commit to a single copy of the latest session and writes it. If the write
+    // can't be started, every commit other than callerCommitId's is failed through its callback.
+    HRESULT WritePendingCommits(
+        _In_ Vector<PendingCommit> commits,
+        _In_ uint64_t callerCommitId
+    ) noexcept;
+
+    // Writes the oldest deferred commits sharing a write mode as a single write, moving on to the next run if a write
+    // can't be started. Returns the failure for callerCommitId's commit, if its write couldn't be started.
+    HRESULT FlushDeferredCommits(
+        _In_ std::unique_lock<std::mutex>& deferredCommitsLock,
+        _In_ uint64_t callerCommitId
+    ) noexcept;
+
+    // Completes the commits' callbacks with error on the writer's queue
+    void FailCommits(
+        _In_ Vector<PendingCommit>&& commits,
+        _In_ Result<void> error
+    ) noexcept;
+
     // Synchronize write session result with any changes that happened in the interim.
     void HandleWriteSessionResult(
         _In_ Result<std::shared_ptr<XblMultiplayerSession>> writeSessionResult,
@@ -830,7 +872,10 @@ private:
     std::mutex m_synchronizeWriteWithTapLock;
     uint64_t m_tapChangeNumber{ 0 };
     bool m_isTapReceived{ false };
-    uint64_t m_numOfWritesInProgress{ 0 };
+    std::atomic<uint64_t> m_numOfWritesInProgress{ 0 };
+    std::mutex m_deferredCommitsLock;
+    Vector<PendingCommit> m_deferredCommits;
+    uint64_t m_lastCommitId{ 0 };
     std::shared_ptr<XblMultiplayerSession> m_session;
     std::shared_ptr<MultiplayerLocalUserManager> m_multiplayerLocalUserManager;
 
@@ -846,8 +891,9 @@ public:
     ) noexcept;
     ~MultiplayerGameClient();
 
-    // TODO
-    void deep_copy_if_updated(_In_ const MultiplayerGameClient& other);
+    // Shares the other client's published session snapshots. Published sessions are never modified, so nothing
+    // is copied.
+    void SnapshotIfUpdated(_In_ const MultiplayerGameClient& other);
     void Initialize();
     void SetGameSessionTemplate(_In_ const xsapi_internal_string& sessionTemplateName);
     std::shared_ptr<MultiplayerSessionWriter> SessionWriter() const;
@@ -943,7 +989,7 @@ private:
     MultiplayerEventQueue m_multiplayerEventQueue;
     std::shared_ptr<MultiplayerGameSession> m_multiplayerGame;
     std::shared_ptr<MultiplayerLocalUserManager> m_multiplayerLocalUserManager;
-    Queue<std::shared_ptr<MultiplayerClientPendingRequest>> m_pendingRequestQueue;
+    ArenaQueue<XblMemSubsystem::MultiplayerManager, std::shared_ptr<MultiplayerClientPendingRequest>> m_pendingRequestQueue;
     Vector<std::shared_ptr<MultiplayerClientPendingRequest>> m_processingQueue;
 };
 
@@ -961,8 +1007,9 @@ public:
     ) noexcept;
     ~MultiplayerLobbyClient() noexcept;
 
-    // TODO
-    void deep_copy_if_updated(_In_ const MultiplayerLobbyClient& other);
+    // Shares the other client's published session snapshots. Published sessions are never modified, so nothing
+    // is copied.
+    void SnapshotIfUpdated(_In_ const MultiplayerLobbyClient& other);
     void Initialize();
     const std::shared_ptr<MultiplayerSessionWriter>& SessionWriter() const;
     const std::shared_ptr<MultiplayerLobbySession>& Lobby() const;
@@ -1046,7 +1093,7 @@ public:
     xsapi_internal_string GetTransferHandle();
 
     void RemoveStaleXboxLiveContextFromMap();
-    const xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>>& GetLocalUserMap();
+    std::shared_ptr<const LocalUserMap> GetLocalUserMap();
     std::shared_ptr<XblContext> GetPrimaryContext();
 
 private:
@@ -1121,7 +1168,7 @@ private:
     uint64_t m_updateNumber{ 0 };
     XblMultiplayerJoinability m_joinability{ XblMultiplayerJoinability::None };
     mutable std::mutex m_clientRequestLock;
-    Queue<std::shared_ptr<MultiplayerClientPendingRequest>> m_pendingRequestQueue;
+    ArenaQueue<XblMemSubsystem::MultiplayerManager, std::shared_ptr<MultiplayerClientPendingRequest>> m_pendingRequestQueue;
     MultiplayerEventQueue m_multiplayerEventQueue;
     std::shared_ptr<MultiplayerSessionWriter> m_sessionWriter;
     std::shared_ptr<MultiplayerLobbySession> m_multiplayerLobby;
@@ -1141,8 +1188,7 @@ public:
         _In_ std::shared_ptr<MultiplayerLocalUserManager> localUserManager
         );
 
-    // TODO
-    void deep_copy_if_updated(_In_ const MultiplayerClientPendingReader& other);
+    void SnapshotIfUpdated(_In_ const MultiplayerClientPendingReader& other);
     bool IsUpdateAvailable(_In_ const MultiplayerClientPendingReader& other);
 
     void DoWork();
@@ -1289,7 +1335,8 @@ public:
     void ChangeAllLocalUserGameState(_In_ MultiplayerLocalUserGameState state);
     bool IsLocalUserGameState(_In_ MultiplayerLocalUserGameState state);
 
-    const xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>>& GetLocalUserMap();
+    // Returns the current local users. The map is never modified; adding or removing a user publishes a new one.
+    std::shared_ptr<const LocalUserMap> GetLocalUserMap();
     std::shared_ptr<XblContext> GetContext(_In_ uint64_t xuid);
 
     std::shared_ptr<MultiplayerLocalUser> GetLocalUser(_In_ uint64_t xuid);
@@ -1327,6 +1374,7 @@ public:
 private:
     std::mutex m_lock;
 
+    void PublishLocalUserMap();
     void OnConnectionIdChanged();
 
     void OnSubscriptionsLost(_In_ uint64_t xuid);
@@ -1352,7 +1400,9 @@ private:
     xsapi_internal_unordered_map<uint32_t, Function<void()>> m_multiplayerSubscriptionLostEventHandler;
     xsapi_internal_unordered_map<uint32_t, Function<void()>> m_rtaResyncEventHandler;
 
-    xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>> m_localUserRequestMap;
+    LocalUserMap m_localUserRequestMap;
+    std::mutex m_localUserMapLock;
+    std::shared_ptr<const LocalUserMap> m_localUserMap{ MakeShared<LocalUserMap>() };
     std::shared_ptr<XblContext> m_primaryXboxLiveContext;
     TaskQueue m_queue;
 };
@@ -1483,7 +1533,7 @@ private:
         _In_ xbox_live_user_t user
         );
 
-    xsapi_internal_map<uint64_t, std::shared_ptr<MultiplayerLocalUser>> GetXboxLiveContextMap();
+    std::shared_ptr<const LocalUserMap> GetXboxLiveContextMap();
 
     void OnResyncMessageReceived();
 
@@ -1574,8 +1624,7 @@ public:
 
     MultiplayerEventQueue DoWork();
     const MultiplayerEventQueue& EventQueue();
-    // TODO remove in favor of assignment operator
-    void deep_copy_if_updated(_In_ const MultiplayerMatchClient& other);
+    void SnapshotIfUpdated(_In_ const MultiplayerMatchClient& other);
 
     XblMultiplayerMatchStatus MatchStatus() const;
     void SetMatchStatus(_In_ XblMultiplayerMatchStatus status);
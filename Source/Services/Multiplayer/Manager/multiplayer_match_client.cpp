@@ -26,7 +26,7 @@ MultiplayerMatchClient::MultiplayerMatchClient(
 {
 }
 
-void MultiplayerMatchClient::deep_copy_if_updated(
+void MultiplayerMatchClient::SnapshotIfUpdated(
     _In_ const MultiplayerMatchClient& other
 )
 {
@@ -37,7 +37,7 @@ void MultiplayerMatchClient::deep_copy_if_updated(
     }
     else if (m_matchSession == nullptr || other.m_matchSession->SessionInfo().ChangeNumber > m_matchSession->SessionInfo().ChangeNumber)
     {
-        m_matchSession = MakeShared<XblMultiplayerSession>(*other.m_matchSession);
+        m_matchSession = other.m_matchSession;
     }
 }
 
@@ -617,7 +617,7 @@ HRESULT MultiplayerMatchClient::JoinSession(
             m_latestSession{ std::move(session) },
             m_callback{ std::move(callback) }
         {
-            for (auto& pair : m_matchClient->m_multiplayerLocalUserManager->GetLocalUserMap())
+            for (auto& pair : *m_matchClient->m_multiplayerLocalUserManager->GetLocalUserMap())
             {
                 m_users.push_back(pair.second);
             }
@@ -755,7 +755,7 @@ void MultiplayerMatchClient::SetQosMeasurements(
             m_matchSessionRef{ matchSessionRef }
         {
             JsonUtils::CopyFrom(m_measurements, measurements);
-            for (auto& pair : m_matchClient->m_multiplayerLocalUserManager->GetLocalUserMap())
+            for (auto& pair : *m_matchClient->m_multiplayerLocalUserManager->GetLocalUserMap())
             {
                 m_users.push_back(pair.second);
             }
@@ -39,6 +39,41 @@ MultiplayerSessionWriter::Destroy()
     m_isTapReceived = false;
     m_numOfWritesInProgress = 0;
     m_tapChangeNumber = 0;
+
+    // Commits deferred behind a write to the old session fail. Complete them asynchronously since
+    // the session may be reset while the owning client holds its own locks.
+    std::unique_lock<std::mutex> lock{ m_deferredCommitsLock };
+    if (!m_deferredCommits.empty())
+    {
+        FailCommits(std::move(m_deferredCommits), { E_FAIL, "Session writer has been reset" });
+        m_deferredCommits.clear();
+    }
+}
+
+void MultiplayerSessionWriter::FailCommits(
+    _In_ Vector<PendingCommit>&& commits,
+    _In_ Result<void> error
+) noexcept
+{
+    if (commits.empty())
+    {
+        return;
+    }
+
+    m_queue.RunWork([weakThis = std::weak_ptr<MultiplayerSessionWriter>{ shared_from_this() }, commits = std::move(commits), error]()
+    {
+        auto sharedThis{ weakThis.lock() };
+        for (auto& commit : commits)
+        {
+            MultiplayerEventQueue eventQueue;
+            if (sharedThis)
+            {
+                std::lock_guard<std::mutex> lock(sharedThis->m_stateLock);
+                eventQueue = sharedThis->HandleEvents(commit.processingQueue, error, commit.sessionType);
+            }
+            commit.callback(Result<MultiplayerEventQueue>(eventQueue, error.Hresult(), error.ErrorMessage()));
+        }
+    });
 }
 
 std::shared_ptr<XblContext>
@@ -153,7 +188,12 @@ MultiplayerSessionWriter::SetWriteInProgress(
     }
     else
     {
-        m_numOfWritesInProgress--;
+        // Destroy() resets the count, so a write whose result resets the session (such as a leave returning
+        // no session) has nothing left to release when it completes.
+        auto count = m_numOfWritesInProgress.load();
+        while (count > 0 && !m_numOfWritesInProgress.compare_exchange_weak(count, count - 1))
+        {
+        }
     }
 }
 
@@ -192,83 +232,121 @@ HRESULT MultiplayerSessionWriter::CommitPendingSynchronizedChanges(
     _In_ MultiplayerEventQueueCallback callback
 ) noexcept
 {
-    if (m_session == nullptr)
+    return CommitPending({ std::move(processingQueue), sessionType, XblMultiplayerSessionWriteMode::SynchronizedUpdate, false, std::move(callback) });
+}
+
+HRESULT MultiplayerSessionWriter::CommitPendingChanges(
+    _In_ Vector<std::shared_ptr<MultiplayerClientPendingRequest>> processingQueue,
+    _In_ XblMultiplayerSessionType sessionType,
+    _In_ bool isGameInProgress,
+    _In_ MultiplayerEventQueueCallback callback
+) noexcept
+{
+    return CommitPending({ std::move(processingQueue), sessionType, XblMultiplayerSessionWriteMode::UpdateExisting, isGameInProgress, std::move(callback) });
+}
+
+HRESULT MultiplayerSessionWriter::CommitPending(
+    _In_ PendingCommit&& commit
+) noexcept
+{
+    std::unique_lock<std::mutex> lock{ m_deferredCommitsLock };
+    commit.id = ++m_lastCommitId;
+    auto commitId = commit.id;
+    m_deferredCommits.push_back(std::move(commit));
+
+    // While another write to the session is in flight, hold the changes back rather than racing it. Everything
+    // that queues up in the meantime is written together once it completes.
+    if (IsWriteInProgress())
     {
-        auto eventQueue = HandleEvents(processingQueue, { E_FAIL, "Session null" }, sessionType);
-        // TODO this may need to be invoked on another thread
-        callback(Result<MultiplayerEventQueue>(eventQueue, xbl_error_code::generic_error));
         return S_OK;
     }
+    return FlushDeferredCommits(lock, commitId);
+}
 
-    auto sessionToCommitCopy = MakeShared<XblMultiplayerSession>(*m_session);
+HRESULT MultiplayerSessionWriter::FlushDeferredCommits(
+    _In_ std::unique_lock<std::mutex>& deferredCommitsLock,
+    _In_ uint64_t callerCommitId
+) noexcept
+{
+    HRESULT callerHr = S_OK;
 
-    // Update any pending local user or lobby session properties.
-    for (auto& request : processingQueue)
+    // Commits with different write modes can't share a write, so only take the oldest run with a matching mode.
+    // Anything left is flushed when this write completes, or right away if it couldn't be started.
+    while (!m_deferredCommits.empty() && !IsWriteInProgress())
     {
-        request->AppendPendingChanges(sessionToCommitCopy, nullptr);
-    }
+        auto mode = m_deferredCommits.front().mode;
+        auto end = std::find_if(m_deferredCommits.begin(), m_deferredCommits.end(), [mode](const PendingCommit& c) { return c.mode != mode; });
 
-    return WriteSession(GetPrimaryContext(), sessionToCommitCopy, XblMultiplayerSessionWriteMode::SynchronizedUpdate, true,
-        [
-            weakThis = std::weak_ptr<MultiplayerSessionWriter>{ shared_from_this() },
-            processingQueue,
-            sessionType,
-            callback
-        ]
-    (Result<std::shared_ptr<XblMultiplayerSession>> sessionResult)
-    {
-        MultiplayerEventQueue eventQueue;
-        auto sharedThis{ weakThis.lock() };
-        if (sharedThis)
+        Vector<PendingCommit> commits(std::make_move_iterator(m_deferredCommits.begin()), std::make_move_iterator(end));
+        m_deferredCommits.erase(m_deferredCommits.begin(), end);
+        deferredCommitsLock.unlock();
+
+        bool hasCallerCommit = std::any_of(commits.begin(), commits.end(), [callerCommitId](const PendingCommit& c) { return c.id == callerCommitId; });
+        HRESULT hr = WritePendingCommits(std::move(commits), callerCommitId);
+        if (FAILED(hr) && hasCallerCommit)
         {
-            std::lock_guard<std::mutex> lock(sharedThis->m_stateLock);
-            eventQueue = sharedThis->HandleEvents(processingQueue, sessionResult, sessionType);
+            callerHr = hr;
         }
-        callback(Result<MultiplayerEventQueue>(eventQueue, sessionResult.Hresult()));
-    });
+
+        deferredCommitsLock.lock();
+    }
+
+    return callerHr;
 }
 
-HRESULT MultiplayerSessionWriter::CommitPendingChanges(
-    _In_ Vector<std::shared_ptr<MultiplayerClientPendingRequest>> processingQueue,
-    _In_ XblMultiplayerSessionType sessionType,
-    _In_ bool isGameInProgress,
-    _In_ MultiplayerEventQueueCallback callback
+HRESULT MultiplayerSessionWriter::WritePendingCommits(
+    _In_ Vector<PendingCommit> commits,
+    _In_ uint64_t callerCommitId
 ) noexcept
 {
-    if (m_session == nullptr)
+    auto session = m_session;
+    if (session == nullptr)
     {
-        auto eventQueue = HandleEvents(processingQueue, { E_FAIL, "Session is null" }, sessionType);
-        // TODO this may need to be invoked on another thread
-        callback(Result<MultiplayerEventQueue>(eventQueue, xbl_error_code::generic_error, "Session is null"));
+        FailCommits(std::move(commits), { E_FAIL, "Session is null" });
         return S_OK;
     }
 
-    std::shared_ptr<XblMultiplayerSession> sessionToCommitCopy = MakeShared<XblMultiplayerSession>(*m_session);
+    std::shared_ptr<XblMultiplayerSession> sessionToCommitCopy = MakeShared<XblMultiplayerSession>(*session);
 
-    // Update any pending local user or lobby session properties.
-    for (auto& request : processingQueue)
+    // Update any pending local user or lobby session properties. The session copy only serializes the fields
+    // (and custom property names) these requests touch, so the write carries just the changed subtree.
+    for (auto& commit : commits)
     {
-        request->AppendPendingChanges(sessionToCommitCopy, nullptr, isGameInProgress);
+        for (auto& request : commit.processingQueue)
+        {
+            request->AppendPendingChanges(sessionToCommitCopy, nullptr, commit.isGameInProgress);
+        }
     }
 
-    return WriteSession(m_multiplayerLocalUserManager->GetPrimaryContext(), sessionToCommitCopy, XblMultiplayerSessionWriteMode::UpdateExisting, true,
+    auto mode = commits.front().mode;
+    auto hr = WriteSession(m_multiplayerLocalUserManager->GetPrimaryContext(), sessionToCommitCopy, mode, true,
         [
             weakThis = std::weak_ptr<MultiplayerSessionWriter>{ shared_from_this() },
-            processingQueue,
-            sessionType,
-            callback
+            commits
         ]
     (Result<std::shared_ptr<XblMultiplayerSession>> sessionResult)
     {
-        MultiplayerEventQueue eventQueue;
         auto sharedThis{ weakThis.lock() };
-        if (sharedThis)
+        for (auto& commit : commits)
         {
-            std::lock_guard<std::mutex> lock(sharedThis->m_stateLock);
-            eventQueue = sharedThis->HandleEvents(processingQueue, sessionResult, sessionType);
+            MultiplayerEventQueue eventQueue;
+            if (sharedThis)
+            {
+                std::lock_guard<std::mutex> lock(sharedThis->m_stateLock);
+                eventQueue = sharedThis->HandleEvents(commit.processingQueue, sessionResult, commit.sessionType);
+            }
+            commit.callback(Result<MultiplayerEventQueue>(eventQueue, sessionResult.Hresult(), sessionResult.ErrorMessage()));
         }
-        callback(Result<MultiplayerEventQueue>(eventQueue, sessionResult.Hresult(), sessionResult.ErrorMessage()));
     });
+
+    if (FAILED(hr))
+    {
+        // The caller learns of its own commit failing from the returned HRESULT, so only the commits deferred
+        // from earlier calls are completed through their callbacks
+        commits.erase(std::remove_if(commits.begin(), commits.end(), [callerCommitId](const PendingCommit& c) { return c.id == callerCommitId; }), commits.end());
+        FailCommits(std::move(commits), { hr, "Failed to write session" });
+    }
+    return hr;
 }
 
 HRESULT MultiplayerSessionWriter::WriteSession(
@@ -401,6 +479,9 @@ void MultiplayerSessionWriter::HandleWriteSessionResult(
     {
         callback(writeSessionResult);
     }
+
+    std::unique_lock<std::mutex> lock{ m_deferredCommitsLock };
+    FlushDeferredCommits(lock, 0);
 }
 
 void MultiplayerSessionWriter::OnSessionChanged(
@@ -513,7 +594,7 @@ HRESULT MultiplayerSessionWriter::LeaveRemoteSession(
             m_sessionWriter{ std::move(sessionWriter) },
             m_sessionToLeaveRef{ sessionRefToLeave },
             m_queue{ queue },
-            m_localUsers{ m_sessionWriter->m_multiplayerLocalUserManager->GetLocalUserMap() },
+            m_localUsers{ *m_sessionWriter->m_multiplayerLocalUserManager->GetLocalUserMap() },
             m_callback{ std::move(callback) }
         {
         }
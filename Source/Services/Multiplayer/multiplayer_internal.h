@@ -77,6 +77,13 @@ public:
     const xsapi_internal_vector<const char*>& EncountersUnSafe() const;
     const JsonValue& CustomPropertiesJsonUnsafe() const;
 
+    // Hash of the member's serialized custom properties, refreshed whenever they change
+    uint64_t CustomPropertiesHash() const;
+
+    // Case insensitive comparison of the serialized custom properties. Differing hashes settle it without
+    // touching the strings; equal hashes are confirmed with a full comparison.
+    bool CustomPropertiesEqual(_In_ const MultiplayerSessionMember& other) const;
+
     void SetSecureDeviceBaseAddress64(_In_ const xsapi_internal_string& deviceBaseAddress);
     void SetRoles(_In_ const xsapi_internal_vector<XblMultiplayerSessionMemberRole>& roles);
     void SetGroups(_In_reads_(groupsCount) const char** groups, _In_ size_t groupsCount);
@@ -107,6 +114,7 @@ private:
     xsapi_internal_string m_customConstantsJson;
     xsapi_internal_string m_customPropertiesString;
     JsonDocument m_customPropertiesJson{ rapidjson::Type::kObjectType };
+    uint64_t m_customPropertiesHash{ utils::str_ihash("{}") };
     xsapi_internal_string m_secureDeviceAddressBase64;
     xsapi_internal_vector<XblMultiplayerSessionMemberRole> m_roles;
     JsonDocument m_resultsJson;
@@ -139,6 +147,8 @@ private:
     bool m_writeSubscribedChangeTypes{ false };
     bool m_writeResults{ false };
     bool m_writeCustomPropertiesJson{ false };
+    // Names of the custom properties changed locally. Only these are written, MPSD merges them into the existing object.
+    xsapi_internal_set<xsapi_internal_string> m_dirtyCustomProperties;
 
     // needs to be recursive mutex since CompareMultiplayerSessions will lock both currentMember and olderSessionMember which might be same 
     mutable std::recursive_mutex m_lockMember; 
@@ -824,6 +834,9 @@ private:
     HRESULT DeserializeSessionProperties(_In_ const JsonValue& json);
     HRESULT DeserializeSessionConstants(_In_ const JsonValue& json);
 
+    // Rebuilds m_memberIndex. Must be called whenever m_members is modified.
+    void IndexMembers();
+
     // Serialization helpers
     void SerializeSessionProperties(_Out_ JsonValue& json, _In_ JsonDocument::AllocatorType& allocator);
     void SerializeSessionConstants(_Out_ JsonValue& json, _In_ JsonDocument::AllocatorType& allocator);
@@ -856,12 +869,14 @@ private:
     xsapi_internal_string m_matchmakingServerConnectionString;
     xsapi_internal_string m_matchmakingTargetSessionConstantsJson;
     xsapi_internal_string m_sessionCustomPropertiesJson;
+    uint64_t m_sessionCustomPropertiesHash{ 0 };
 
     // Roles
     xbox::services::multiplayer::RoleTypes m_roleTypes;
 
     // Member info
     xsapi_internal_vector<XblMultiplayerSessionMember> m_members;
+    xsapi_internal_unordered_map<uint64_t, size_t> m_memberIndex; // Xuid -> position in m_members
     XblMultiplayerSessionMember* m_memberCurrentUser{ nullptr };
     uint32_t m_membersAccepted{ 0 };
 
@@ -901,6 +916,8 @@ private:
     bool m_writeServersJson{ false };
     bool m_writeMatchmakingTargetSessionConstants{ false };
     bool m_writeSessionCustomPropertiesJson{ false };
+    // Names of the session custom properties changed locally. Only these are written, MPSD merges them into the existing object.
+    xsapi_internal_set<xsapi_internal_string> m_dirtySessionCustomProperties;
     bool m_writeConstants{ false };
 
     mutable std::recursive_mutex m_lockSession;
@@ -149,8 +149,10 @@ XblMultiplayerSession::XblMultiplayerSession(const XblMultiplayerSession& other)
     m_matchmakingServerConnectionString(other.m_matchmakingServerConnectionString),
     m_matchmakingTargetSessionConstantsJson(other.m_matchmakingTargetSessionConstantsJson),
     m_sessionCustomPropertiesJson(other.m_sessionCustomPropertiesJson),
+    m_sessionCustomPropertiesHash(other.m_sessionCustomPropertiesHash),
     m_roleTypes(other.m_roleTypes),
     m_members(other.m_members),
+    m_memberIndex(other.m_memberIndex),
     m_membersAccepted(other.m_membersAccepted),
     m_serversJson(other.m_serversJson),
     m_matchmakingStatusDetails(other.m_matchmakingStatusDetails),
@@ -183,6 +185,7 @@ XblMultiplayerSession::XblMultiplayerSession(const XblMultiplayerSession& other)
     m_writeServersJson(other.m_writeServersJson),
     m_writeMatchmakingTargetSessionConstants(other.m_writeMatchmakingTargetSessionConstants),
     m_writeSessionCustomPropertiesJson(other.m_writeSessionCustomPropertiesJson),
+    m_dirtySessionCustomProperties(other.m_dirtySessionCustomProperties),
     m_writeConstants(other.m_writeConstants),
     m_memberRequestIndex(other.m_memberRequestIndex)
 {
@@ -266,6 +269,7 @@ void XblMultiplayerSession::Initialize()
     m_sessionSubscriptionGuid = utils::create_guid(true);
 
     m_sessionCustomPropertiesJson = "{}";
+    m_sessionCustomPropertiesHash = utils::str_ihash(m_sessionCustomPropertiesJson.data());
     m_sessionProperties.SessionCustomPropertiesJson = m_sessionCustomPropertiesJson.data();
 
     m_constantsCustomJson = "";
@@ -471,6 +475,7 @@ HRESULT XblMultiplayerSession::AddMemberReservation(
 
     m_members.push_back(MultiplayerSessionMember::Construct(false, memberId.str(), xuid, memberCustomConstantsJson, initializeRequested));
     MultiplayerSessionMember::SetExternalMemberPointer(m_members.back());
+    IndexMembers();
 
     return S_OK;
 }
@@ -500,6 +505,7 @@ HRESULT XblMultiplayerSession::Join(
     m_members.push_back(MultiplayerSessionMember::Construct(true, "me", m_xuid, memberCustomConstantsJson, initializeRequested));
     m_memberCurrentUser = &m_members.back();
     MultiplayerSessionMember::SetExternalMemberPointer(m_members.back());
+    IndexMembers();
 
     if (joinWithActiveStatus)
     {
@@ -824,6 +830,7 @@ XblMultiplayerSession::Leave()
             Delete(static_cast<MultiplayerSessionMember*>(iter->Internal));
             m_members.erase(iter);
             m_memberCurrentUser = nullptr;
+            IndexMembers();
             break;
         }
     }
@@ -1048,8 +1055,10 @@ XblMultiplayerSession::SetSessionCustomPropertyJson(
     if (SUCCEEDED(hr))
     {
         m_sessionCustomPropertiesJson = JsonUtils::SerializeJson(customProperties);
+        m_sessionCustomPropertiesHash = utils::str_ihash(m_sessionCustomPropertiesJson.data());
         m_sessionProperties.SessionCustomPropertiesJson = m_sessionCustomPropertiesJson.data();
         m_writeSessionCustomPropertiesJson = true;
+        m_dirtySessionCustomProperties.insert(name);
     }
 
     return hr;
@@ -1345,38 +1354,33 @@ XblMultiplayerSession::CompareMultiplayerSessions(
     bool memberStatusChanged = false;
     bool memberCustomPropertyChanged = false;
 
+    XblMultiplayerSessionReadLockGuard otherSafe(other);
     if (m_members.size() != other->m_members.size())
     {
         hasMemberChanged = true;
     }
 
+    // Both sessions index their members by xuid and hash member custom properties as they are deserialized
+    // or updated, so each member is matched in constant time and compared without re-serializing anything.
     for (const auto& currentMember : m_members)
     {
-        bool isMemberFound = false;
-        for (const auto& olderSessionMember : other->m_members)
+        auto olderSessionMemberIter = other->m_memberIndex.find(currentMember.Xuid);
+        if (olderSessionMemberIter == other->m_memberIndex.end())
+        {
+            hasMemberChanged = true;
+        }
+        else
         {
-            if (currentMember.Xuid == olderSessionMember.Xuid)
+            const auto& olderSessionMember = other->m_members[olderSessionMemberIter->second];
+            if (currentMember.Status != olderSessionMember.Status)
             {
-                isMemberFound = true;
-
-                if (currentMember.Status != olderSessionMember.Status)
-                {
-                    memberStatusChanged = true;
-                }
-
-                MultiplayerSessionMemberReadLockGuard memberSafe(MultiplayerSessionMember::Get(&currentMember));
-                MultiplayerSessionMemberReadLockGuard olderSessionMemberSafe(MultiplayerSessionMember::Get(&olderSessionMember));
-                if (utils::str_icmp(JsonUtils::SerializeJson(memberSafe.CustomPropertiesJson()).c_str(),
-                    JsonUtils::SerializeJson(olderSessionMemberSafe.CustomPropertiesJson()).c_str()) != 0)
-                {
-                    memberCustomPropertyChanged = true;
-                }
+                memberStatusChanged = true;
             }
-        }
 
-        if (!isMemberFound)
-        {
-            hasMemberChanged = true;
+            if (!MultiplayerSessionMember::Get(&currentMember)->CustomPropertiesEqual(*MultiplayerSessionMember::Get(&olderSessionMember)))
+            {
+                memberCustomPropertyChanged = true;
+            }
         }
 
         if (memberStatusChanged && hasMemberChanged && memberCustomPropertyChanged)
@@ -1400,7 +1404,6 @@ XblMultiplayerSession::CompareMultiplayerSessions(
         currentType |= XblMultiplayerSessionChangeTypes::MemberCustomPropertyChange;
     }
 
-    XblMultiplayerSessionReadLockGuard otherSafe(other);
     if (m_sessionProperties.Closed != other->m_sessionProperties.Closed ||
         m_sessionProperties.Locked != other->m_sessionProperties.Locked ||
         m_sessionProperties.JoinRestriction != other->m_sessionProperties.JoinRestriction ||
@@ -1411,7 +1414,9 @@ XblMultiplayerSession::CompareMultiplayerSessions(
         currentType |= XblMultiplayerSessionChangeTypes::SessionJoinabilityChange;
     }
 
-    if (utils::str_icmp_internal(m_sessionCustomPropertiesJson, other->m_sessionCustomPropertiesJson) != 0)
+    // Equal hashes are confirmed with a full comparison, since distinct documents can collide
+    if (m_sessionCustomPropertiesHash != other->m_sessionCustomPropertiesHash ||
+        utils::str_icmp_internal(m_sessionCustomPropertiesJson, other->m_sessionCustomPropertiesJson) != 0)
     {
         currentType |= XblMultiplayerSessionChangeTypes::CustomPropertyChange;
     }
@@ -1419,6 +1424,15 @@ XblMultiplayerSession::CompareMultiplayerSessions(
     return static_cast<XblMultiplayerSessionChangeTypes>(currentType);
 }
 
+void XblMultiplayerSession::IndexMembers()
+{
+    m_memberIndex.clear();
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        m_memberIndex.emplace(m_members[i].Xuid, i);
+    }
+}
+
 HRESULT XblMultiplayerSession::Deserialize(
     _In_ const JsonValue& json
 )
@@ -1476,6 +1490,7 @@ HRESULT XblMultiplayerSession::Deserialize(
     }
 
     DeserializeMembers(json);
+    IndexMembers();
 
     if (json.IsObject() && json.HasMember("properties"))
     {
@@ -1616,8 +1631,19 @@ void XblMultiplayerSession::SerializeSessionProperties(_Out_ JsonValue& jsonProp
 
     if (m_writeSessionCustomPropertiesJson)
     {
-        JsonDocument customJson{ &allocator };
-        customJson.Parse(m_sessionCustomPropertiesJson.c_str());
+        JsonDocument customPropertiesJson;
+        customPropertiesJson.Parse(m_sessionCustomPropertiesJson.c_str());
+
+        JsonValue customJson{ rapidjson::kObjectType };
+        for (const auto& name : m_dirtySessionCustomProperties)
+        {
+            JsonValue valueJson;
+            if (!customPropertiesJson.HasParseError() && customPropertiesJson.IsObject() && customPropertiesJson.HasMember(name.data()))
+            {
+                valueJson.CopyFrom(customPropertiesJson[name.data()], allocator);
+            }
+            customJson.AddMember(JsonValue{ name.data(), allocator }.Move(), valueJson.Move(), allocator);
+        }
         jsonProperties.AddMember("custom", customJson, allocator);
     }
 }
@@ -1906,15 +1932,7 @@ bool XblMultiplayerSession::IsPlayerInSession(
         return false;
     }
 
-    for (const auto& member : session->m_members)
-    {
-        if (xboxUserId == member.Xuid)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return session->m_memberIndex.find(xboxUserId) != session->m_memberIndex.end();
 }
 
 const XblMultiplayerSessionMember* XblMultiplayerSession::GetPlayerInSession(
@@ -1927,14 +1945,8 @@ const XblMultiplayerSessionMember* XblMultiplayerSession::GetPlayerInSession(
         return nullptr;
     }
 
-    for (const auto& member : session->m_members)
-    {
-        if (xboxUserId == member.Xuid)
-        {
-            return &member;
-        }
-    }
-    return nullptr;
+    auto iter = session->m_memberIndex.find(xboxUserId);
+    return iter != session->m_memberIndex.end() ? &session->m_members[iter->second] : nullptr;
 }
 
 const XblMultiplayerSessionMember* XblMultiplayerSession::HostMember(
@@ -2143,6 +2155,7 @@ HRESULT XblMultiplayerSession::DeserializeSessionProperties(
     {
         m_sessionCustomPropertiesJson = JsonUtils::SerializeJson(json["custom"]);
     }
+    m_sessionCustomPropertiesHash = utils::str_ihash(m_sessionCustomPropertiesJson.data());
     m_sessionProperties.SessionCustomPropertiesJson = m_sessionCustomPropertiesJson.data();
 
     return S_OK;
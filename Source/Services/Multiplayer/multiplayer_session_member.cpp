@@ -43,6 +43,7 @@ MultiplayerSessionMember::MultiplayerSessionMember(const xsapi_internal_string&
 MultiplayerSessionMember::MultiplayerSessionMember(const MultiplayerSessionMember& other) :
     m_customConstantsJson(other.m_customConstantsJson),
     m_customPropertiesString(other.m_customPropertiesString),
+    m_customPropertiesHash(other.m_customPropertiesHash),
     m_secureDeviceAddressBase64(other.m_secureDeviceAddressBase64),
     m_roles(other.m_roles),
     m_teamId(other.m_teamId),
@@ -67,7 +68,8 @@ MultiplayerSessionMember::MultiplayerSessionMember(const MultiplayerSessionMembe
     m_writeEncounters(other.m_writeEncounters),
     m_writeSubscribedChangeTypes(other.m_writeSubscribedChangeTypes),
     m_writeResults(other.m_writeResults),
-    m_writeCustomPropertiesJson(other.m_writeCustomPropertiesJson)
+    m_writeCustomPropertiesJson(other.m_writeCustomPropertiesJson),
+    m_dirtyCustomProperties(other.m_dirtyCustomProperties)
 {
     for (auto group : other.m_groups)
     {
@@ -255,8 +257,10 @@ MultiplayerSessionMember::SetCustomPropertyJson(
     if (SUCCEEDED(hr))
     {
         m_customPropertiesString = JsonUtils::SerializeJson(m_customPropertiesJson);
+        m_customPropertiesHash = utils::str_ihash(m_customPropertiesString.data());
         m_member->CustomPropertiesJson = m_customPropertiesString.data();
         m_writeCustomPropertiesJson = true;
+        m_dirtyCustomProperties.insert(name);
     }
 
     return hr;
@@ -323,6 +327,33 @@ const JsonValue& MultiplayerSessionMember::CustomPropertiesJsonUnsafe() const
     return m_customPropertiesJson;
 }
 
+uint64_t MultiplayerSessionMember::CustomPropertiesHash() const
+{
+    std::lock_guard<std::recursive_mutex> lock{ m_lockMember };
+    return m_customPropertiesHash;
+}
+
+bool MultiplayerSessionMember::CustomPropertiesEqual(
+    _In_ const MultiplayerSessionMember& other
+) const
+{
+    std::unique_lock<std::recursive_mutex> lock{ m_lockMember, std::defer_lock };
+    std::unique_lock<std::recursive_mutex> otherLock{ other.m_lockMember, std::defer_lock };
+    std::lock(lock, otherLock);
+
+    if (m_customPropertiesHash != other.m_customPropertiesHash)
+    {
+        return false;
+    }
+
+    // Members deserialized without custom properties have an empty string, which is equivalent to "{}"
+    auto serialized = [](const xsapi_internal_string& customProperties)
+    {
+        return customProperties.empty() ? "{}" : customProperties.data();
+    };
+    return utils::str_icmp(serialized(m_customPropertiesString), serialized(other.m_customPropertiesString)) == 0;
+}
+
 void MultiplayerSessionMember::SetRtaConnectionId(
     _In_ const xsapi_internal_string& rtaConnectionId
     )
@@ -417,6 +448,7 @@ Result<XblMultiplayerSessionMember> MultiplayerSessionMember::Deserialize(
         {
             JsonUtils::CopyFrom(returnResultInternal->m_customPropertiesJson, propertiesJson["custom"]);
             returnResultInternal->m_customPropertiesString = JsonUtils::SerializeJson(returnResultInternal->m_customPropertiesJson);
+            returnResultInternal->m_customPropertiesHash = utils::str_ihash(returnResultInternal->m_customPropertiesString.data());
         }
 
         if (propertiesJson.IsObject() && propertiesJson.HasMember("system"))
@@ -695,7 +727,17 @@ void MultiplayerSessionMember::Serialize(_Out_ JsonValue& json, _In_ JsonDocumen
 
         if (m_writeCustomPropertiesJson)
         {
-            propertiesJson.AddMember("custom", JsonValue{}.CopyFrom(m_customPropertiesJson, allocator).Move(), allocator);
+            JsonValue customJson{ rapidjson::kObjectType };
+            for (const auto& name : m_dirtyCustomProperties)
+            {
+                JsonValue valueJson;
+                if (m_customPropertiesJson.HasMember(name.data()))
+                {
+                    valueJson.CopyFrom(m_customPropertiesJson[name.data()], allocator);
+                }
+                customJson.AddMember(JsonValue{ name.data(), allocator }.Move(), valueJson.Move(), allocator);
+            }
+            propertiesJson.AddMember("custom", customJson.Move(), allocator);
         }
 
         if (propertiesJson.MemberCount())
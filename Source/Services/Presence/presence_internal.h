@@ -192,7 +192,8 @@ public:
 
     HRESULT GetBatchPresence(
         _In_ UserBatchRequest&& batchRequest,
-        _In_ AsyncContext<Result<Vector<std::shared_ptr<XblPresenceRecord>>>> async
+        _In_ AsyncContext<Result<Vector<std::shared_ptr<XblPresenceRecord>>>> async,
+        _In_ HttpCallPriority priority = HttpCallPriority::Interactive
     ) const noexcept;
 
 private:
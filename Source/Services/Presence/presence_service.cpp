@@ -362,7 +362,8 @@ HRESULT PresenceService::GetPresence(
 
 HRESULT PresenceService::GetBatchPresence(
     _In_ UserBatchRequest&& batchRequest,
-    _In_ AsyncContext<Result<xsapi_internal_vector<std::shared_ptr<XblPresenceRecord>>>> async
+    _In_ AsyncContext<Result<xsapi_internal_vector<std::shared_ptr<XblPresenceRecord>>>> async,
+    _In_ HttpCallPriority priority
 ) const noexcept
 {
     Result<User> userResult = m_user.Copy();
@@ -376,6 +377,8 @@ HRESULT PresenceService::GetBatchPresence(
         xbox_live_api::get_presence_for_multiple_users
     ));
 
+    httpCall->SetPriority(priority);
+
     JsonDocument batchRequestJson(rapidjson::kObjectType);
     batchRequest.Serialize(batchRequestJson, batchRequestJson.GetAllocator());
     httpCall->SetRequestBody(batchRequestJson);
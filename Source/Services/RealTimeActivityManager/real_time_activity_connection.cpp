@@ -45,6 +45,9 @@ struct ServiceSubscription
 
     uint32_t subscribeAttempt{ 0 };
 
+    // Whether a handshake message for the current status is queued but has not yet been sent
+    bool messageQueued{ false };
+
     Set<std::shared_ptr<Subscription>> clientSubscriptions;
     List<AsyncContext<Result<void>>> subscribeAsyncContexts;
     List<AsyncContext<Result<void>>> unsubscribeAsyncContexts;
@@ -72,6 +75,89 @@ enum class ErrorCode : uint32_t
     ServiceUnavailable = 1002
 };
 
+// Scans the fixed prefix of an RTA message ("[<TYPE>, <ID>, ...") in place, so that event messages can be routed
+// without building a DOM for the entire message.
+class MessageScanner
+{
+public:
+    MessageScanner(const char* message, size_t length) noexcept : m_pos{ message }, m_end{ message + length } {}
+
+    bool Consume(char c) noexcept
+    {
+        SkipWhitespace();
+        if (m_pos < m_end && *m_pos == c)
+        {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReadUint32(uint32_t& value) noexcept
+    {
+        SkipWhitespace();
+        uint64_t result{ 0 };
+        const char* begin{ m_pos };
+        while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9')
+        {
+            result = result * 10 + static_cast<uint64_t>(*m_pos - '0');
+            if (result > UINT32_MAX)
+            {
+                return false;
+            }
+            ++m_pos;
+        }
+        value = static_cast<uint32_t>(result);
+        return m_pos != begin;
+    }
+
+    // Returns the remainder of the message, excluding the closing bracket, as the final element of the message array.
+    // The element itself is not validated here.
+    bool ReadLastElement(const char*& element, size_t& length) noexcept
+    {
+        SkipWhitespace();
+        const char* end{ m_end };
+        while (end > m_pos && IsWhitespace(*(end - 1)))
+        {
+            --end;
+        }
+        if (end == m_pos || *(end - 1) != ']')
+        {
+            return false;
+        }
+        --end;
+        while (end > m_pos && IsWhitespace(*(end - 1)))
+        {
+            --end;
+        }
+        if (end == m_pos)
+        {
+            return false;
+        }
+
+        element = m_pos;
+        length = static_cast<size_t>(end - m_pos);
+        return true;
+    }
+
+private:
+    static bool IsWhitespace(char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    void SkipWhitespace() noexcept
+    {
+        while (m_pos < m_end && IsWhitespace(*m_pos))
+        {
+            ++m_pos;
+        }
+    }
+
+    const char* m_pos;
+    const char* const m_end;
+};
+
 HRESULT ConvertRTAErrorCode(ErrorCode rtaErrorCode) noexcept
 {
     switch (rtaErrorCode)
@@ -83,6 +169,129 @@ HRESULT ConvertRTAErrorCode(ErrorCode rtaErrorCode) noexcept
     }
 }
 
+std::shared_ptr<ServiceSubscription> ServiceSubscriptionTable::Find(uint32_t serviceId) const noexcept
+{
+    if (m_count == 0)
+    {
+        return nullptr;
+    }
+
+    const size_t mask{ m_slots.size() - 1 };
+    for (size_t i = HomeSlot(serviceId); m_slots[i].subscription; i = (i + 1) & mask)
+    {
+        if (m_slots[i].serviceId == serviceId)
+        {
+            return m_slots[i].subscription;
+        }
+    }
+    return nullptr;
+}
+
+void ServiceSubscriptionTable::Insert(uint32_t serviceId, std::shared_ptr<ServiceSubscription> subscription) noexcept
+{
+    assert(subscription);
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    if ((m_count + 1) * 2 > m_slots.size())
+    {
+        Grow();
+    }
+
+    const size_t mask{ m_slots.size() - 1 };
+    size_t i{ HomeSlot(serviceId) };
+    for (; m_slots[i].subscription; i = (i + 1) & mask)
+    {
+        if (m_slots[i].serviceId == serviceId)
+        {
+            m_slots[i].subscription = std::move(subscription);
+            return;
+        }
+    }
+
+    m_slots[i].serviceId = serviceId;
+    m_slots[i].subscription = std::move(subscription);
+    ++m_count;
+}
+
+void ServiceSubscriptionTable::Erase(uint32_t serviceId) noexcept
+{
+    if (m_count == 0)
+    {
+        return;
+    }
+
+    const size_t mask{ m_slots.size() - 1 };
+    size_t i{ HomeSlot(serviceId) };
+    for (; m_slots[i].subscription; i = (i + 1) & mask)
+    {
+        if (m_slots[i].serviceId == serviceId)
+        {
+            break;
+        }
+    }
+    if (!m_slots[i].subscription)
+    {
+        return;
+    }
+
+    // Backward shift deletion: move later entries of the probe sequence into the hole so that lookups
+    // never need tombstones
+    for (size_t j = (i + 1) & mask; m_slots[j].subscription; j = (j + 1) & mask)
+    {
+        size_t home{ HomeSlot(m_slots[j].serviceId) };
+        bool homeInRange = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!homeInRange)
+        {
+            m_slots[i] = std::move(m_slots[j]);
+            i = j;
+        }
+    }
+
+    m_slots[i] = Slot{};
+    --m_count;
+}
+
+void ServiceSubscriptionTable::Clear() noexcept
+{
+    for (auto& slot : m_slots)
+    {
+        slot = Slot{};
+    }
+    m_count = 0;
+}
+
+bool ServiceSubscriptionTable::Empty() const noexcept
+{
+    return m_count == 0;
+}
+
+size_t ServiceSubscriptionTable::HomeSlot(uint32_t serviceId) const noexcept
+{
+    // Service IDs tend to be sequential, so mix the bits before masking
+    uint32_t hash{ serviceId };
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash & (m_slots.size() - 1);
+}
+
+void ServiceSubscriptionTable::Grow() noexcept
+{
+    ArenaVector<XblMemSubsystem::RealTimeActivity, Slot> oldSlots(m_slots.empty() ? 16 : m_slots.size() * 2);
+    std::swap(oldSlots, m_slots);
+    m_count = 0;
+
+    for (auto& slot : oldSlots)
+    {
+        if (slot.subscription)
+        {
+            Insert(slot.serviceId, std::move(slot.subscription));
+        }
+    }
+}
+
 Connection::Connection(
     User&& user,
     const TaskQueue& queue,
@@ -179,7 +388,7 @@ HRESULT Connection::AddSubscription(
     }
     else
     {
-        serviceSub = MakeShared<ServiceSubscription>(sub->ResourceUri(), m_nextSubId++);
+        serviceSub = ArenaMakeShared<XblMemSubsystem::RealTimeActivity, ServiceSubscription>(sub->ResourceUri(), m_nextSubId++);
         assert(m_subsByClientId.find(serviceSub->clientId) == m_subsByClientId.end());
         m_subsByClientId[serviceSub->clientId] = serviceSub;
         m_subsByUri[serviceSub->uri] = serviceSub;
@@ -195,10 +404,10 @@ HRESULT Connection::AddSubscription(
     {
         serviceSub->subscribeAsyncContexts.push_back(std::move(async));
 
-        // If our connection is active, immediately register with RTA service
+        // If our connection is active, register with RTA service. Otherwise we'll subscribe after connecting.
         if (m_state == XblRealTimeActivityConnectionState::Connected)
         {
-            return SendSubscribeMessage(serviceSub, std::move(lock));
+            QueueSubscribeMessage(serviceSub);
         }
         return S_OK;
     }
@@ -223,6 +432,27 @@ HRESULT Connection::AddSubscription(
     }
     case ServiceSubscription::Status::Unsubscribing:
     {
+        if (serviceSub->messageQueued)
+        {
+            // The unsubscribe message hasn't been sent yet, so cancel it. The subscription remains active and
+            // unsubscribe operations are completed with E_ABORT
+            serviceSub->messageQueued = false;
+            serviceSub->status = ServiceSubscription::Status::Active;
+
+            List<AsyncContext<Result<void>>> unsubscribeAsyncContexts{ std::move(serviceSub->unsubscribeAsyncContexts) };
+
+            lock.unlock();
+
+            for (auto& asyncContext : unsubscribeAsyncContexts)
+            {
+                asyncContext.Complete(E_ABORT);
+            }
+
+            sub->OnSubscribe(serviceSub->onSubscribeData);
+            async.Complete(S_OK);
+            return S_OK;
+        }
+
         // Wait for unsubscribe to finish before resubscribing
         serviceSub->status = ServiceSubscription::Status::PendingSubscribe;
         serviceSub->subscribeAsyncContexts.push_back(std::move(async));
@@ -301,7 +531,8 @@ HRESULT Connection::RemoveSubscription(
     {
         // Unregister subscription from RTA service
         serviceSub->unsubscribeAsyncContexts.push_back(std::move(async));
-        return SendUnsubscribeMessage(serviceSub, std::move(lock));
+        QueueUnsubscribeMessage(serviceSub);
+        return S_OK;
     }
     case ServiceSubscription::Status::PendingSubscribe:
     {
@@ -323,6 +554,27 @@ HRESULT Connection::RemoveSubscription(
     }
     case ServiceSubscription::Status::Subscribing:
     {
+        if (serviceSub->messageQueued)
+        {
+            // The subscribe message hasn't been sent yet, so the RTA service has no knowledge of the subscription.
+            // Cancel it and remove it from our local state.
+            serviceSub->messageQueued = false;
+            serviceSub->status = ServiceSubscription::Status::Inactive;
+            m_subsByClientId.erase(serviceSub->clientId);
+            m_subsByUri.erase(serviceSub->uri);
+
+            List<AsyncContext<Result<void>>> subscribeAsyncContexts{ std::move(serviceSub->subscribeAsyncContexts) };
+
+            lock.unlock();
+
+            for (auto& asyncContext : subscribeAsyncContexts)
+            {
+                asyncContext.Complete(E_ABORT);
+            }
+            async.Complete(S_OK);
+            return S_OK;
+        }
+
         // We are in the process of subscribing. RTA protocol doesn't allow us to unsubscribe
         // until subscription is complete, so just mark the subscription as pending unsubscribe.
         // After the subscription completes, we will unsubscribe and complete the AsyncContext.
@@ -352,12 +604,16 @@ size_t Connection::SubscriptionCount() const noexcept
     return m_subsByClientId.size();
 }
 
+bool Connection::HasSubscription(const String& resourceUri) const noexcept
+{
+    std::unique_lock<std::mutex> lock{ m_lock };
+    return m_subsByUri.find(resourceUri) != m_subsByUri.end();
+}
+
 JsonDocument Connection::AssembleSubscribeMessage(std::shared_ptr<ServiceSubscription> sub) const noexcept
 {
     // Payload format [<API_ID>, <SEQUENCE_N>, <RESOURCE_URI>]
 
-    sub->status = ServiceSubscription::Status::Subscribing;
-
     JsonDocument request{ rapidjson::kArrayType };
     auto& a{ request.GetAllocator() };
 
@@ -368,44 +624,275 @@ JsonDocument Connection::AssembleSubscribeMessage(std::shared_ptr<ServiceSubscri
     return request;
 }
 
-HRESULT Connection::SendSubscribeMessage(
-    std::shared_ptr<ServiceSubscription> sub,
-    std::unique_lock<std::mutex>&& lock
-) const noexcept
+JsonDocument Connection::AssembleUnsubscribeMessage(std::shared_ptr<ServiceSubscription> sub) const noexcept
 {
-    JsonDocument request = AssembleSubscribeMessage(sub);
+    // Payload format [<API_ID>, <SEQUENCE_N>, <SUB_ID>]
 
-    lock.unlock();
+    JsonDocument request{ rapidjson::kArrayType };
+    auto& a{ request.GetAllocator() };
+
+    request.PushBack(static_cast<uint32_t>(MessageType::Unsubscribe), a);
+    request.PushBack(sub->clientId, a);
+    request.PushBack(sub->serviceId, a);
 
-    return SendAssembledMessage(request);
+    return request;
 }
 
-HRESULT Connection::SendAssembledMessage(_In_ const JsonValue& request) const noexcept
+void Connection::QueueSubscribeMessage(
+    std::shared_ptr<ServiceSubscription> sub
+) noexcept
 {
-    String requestString{ JsonUtils::SerializeJson(request) };
-    LOGS_DEBUG << __FUNCTION__ << "[" << this << "]: " << requestString;
+    sub->status = ServiceSubscription::Status::Subscribing;
+    if (!sub->messageQueued)
+    {
+        sub->messageQueued = true;
+        m_queuedMessages.push_back(std::move(sub));
+    }
+    ScheduleFlush();
+}
 
-    return m_websocket->Send(requestString.data());
+void Connection::QueueUnsubscribeMessage(
+    std::shared_ptr<ServiceSubscription> sub
+) noexcept
+{
+    sub->status = ServiceSubscription::Status::Unsubscribing;
+    if (!sub->messageQueued)
+    {
+        sub->messageQueued = true;
+        m_queuedMessages.push_back(std::move(sub));
+    }
+    ScheduleFlush();
 }
 
-HRESULT Connection::SendUnsubscribeMessage(
-    std::shared_ptr<ServiceSubscription> sub,
-    std::unique_lock<std::mutex>&& lock
-) const noexcept
+void Connection::HandshakeCompleted() noexcept
 {
-    // Payload format [<API_ID>, <SEQUENCE_N>, <SUB_ID>]
+    if (m_handshakesInFlight > 0)
+    {
+        --m_handshakesInFlight;
+    }
+    if (!m_queuedMessages.empty())
+    {
+        ScheduleFlush();
+    }
+}
 
-    sub->status = ServiceSubscription::Status::Unsubscribing;
+void Connection::ScheduleFlush() noexcept
+{
+    // Messages queued during the same tick are sent together
+    if (m_flushScheduled)
+    {
+        return;
+    }
+    m_flushScheduled = true;
 
-    JsonDocument request{ rapidjson::kArrayType };
-    auto& a{ request.GetAllocator() };
+    m_queue.RunWork([weakThis = std::weak_ptr<Connection>{ shared_from_this() }]
+    {
+        if (auto sharedThis{ weakThis.lock() })
+        {
+            sharedThis->FlushQueuedMessages();
+        }
+    });
+}
 
-    request.PushBack(static_cast<uint32_t>(MessageType::Unsubscribe), a);
-    request.PushBack(sub->clientId, a);
-    request.PushBack(sub->serviceId, a);
+void Connection::FlushQueuedMessages() noexcept
+{
+    std::unique_lock<std::mutex> lock{ m_lock };
+    m_flushScheduled = false;
+
+    if (m_state != XblRealTimeActivityConnectionState::Connected)
+    {
+        // All subscriptions will be restored after reconnecting
+        return;
+    }
+
+    const uint32_t maxInFlight{ AppConfig::Instance()->RtaMaxHandshakesInFlight() };
+
+    List<std::pair<std::shared_ptr<ServiceSubscription>, JsonDocument>> messages;
+    while (!m_queuedMessages.empty() && (maxInFlight == 0 || m_handshakesInFlight < maxInFlight))
+    {
+        auto sub{ std::move(m_queuedMessages.front()) };
+        m_queuedMessages.pop_front();
+
+        if (!sub->messageQueued)
+        {
+            // Message was cancelled after being queued
+            continue;
+        }
+        sub->messageQueued = false;
+
+        switch (sub->status)
+        {
+        case ServiceSubscription::Status::Subscribing:
+        {
+            messages.emplace_back(sub, AssembleSubscribeMessage(sub));
+            break;
+        }
+        case ServiceSubscription::Status::Unsubscribing:
+        {
+            messages.emplace_back(sub, AssembleUnsubscribeMessage(sub));
+            break;
+        }
+        default:
+        {
+            assert(false);
+            continue;
+        }
+        }
+        ++m_handshakesInFlight;
+    }
+
+    if (messages.empty())
+    {
+        return;
+    }
+
+    LOGS_DEBUG << __FUNCTION__ << ": Sending " << messages.size() << " handshake messages, " << m_queuedMessages.size() << " remain queued";
+
+    const uint32_t connectNum{ m_connectNum };
+    lock.unlock();
+
+    List<std::pair<std::shared_ptr<ServiceSubscription>, HRESULT>> failedSends;
+
+    for (auto& message : messages)
+    {
+        HRESULT hr = SendAssembledMessage(message.second);
+        if (FAILED(hr))
+        {
+            failedSends.emplace_back(message.first, hr);
+        }
+    }
+
+    if (failedSends.empty())
+    {
+        return;
+    }
+
+    lock.lock();
+
+    // If we've since disconnected, in flight handshakes were already reset and subscriptions will be restored after reconnecting
+    if (m_state != XblRealTimeActivityConnectionState::Connected || m_connectNum != connectNum)
+    {
+        return;
+    }
+
+    HandshakeCompletions completions;
+    for (auto& failedSend : failedSends)
+    {
+        HandshakeSendFailed(failedSend.first, failedSend.second, completions);
+    }
 
     lock.unlock();
 
+    for (auto& onSubscribe : completions.onSubscribe)
+    {
+        onSubscribe.first->OnSubscribe(onSubscribe.second->onSubscribeData);
+    }
+    for (auto& completion : completions.asyncContexts)
+    {
+        completion.first.Complete(completion.second);
+    }
+}
+
+void Connection::HandshakeSendFailed(
+    std::shared_ptr<ServiceSubscription> serviceSub,
+    HRESULT hr,
+    HandshakeCompletions& completions
+) noexcept
+{
+    LOGS_ERROR << __FUNCTION__ << ": [" << serviceSub->clientId << "] Failed to send handshake, hr=" << hr << ", ServiceStatus=" << EnumName(serviceSub->status);
+
+    // The handshake never reached the service, so no response will free its slot
+    HandshakeCompleted();
+
+    if (m_subsByClientId.find(serviceSub->clientId) == m_subsByClientId.end())
+    {
+        return;
+    }
+
+    switch (serviceSub->status)
+    {
+    case ServiceSubscription::Status::Subscribing:
+    case ServiceSubscription::Status::Unsubscribing:
+    {
+        // Retry the handshake after a backoff. It is marked queued in the meantime so that the client can
+        // still cancel it as if it was never sent.
+        serviceSub->messageQueued = true;
+
+        uint64_t backoff = __min(std::pow(serviceSub->subscribeAttempt++, 2), 60) * 1000;
+        m_queue.RunWork([weakSub = std::weak_ptr<ServiceSubscription>{ serviceSub }, status = serviceSub->status, connectNum = m_connectNum, weakThis = std::weak_ptr<Connection>{ shared_from_this() }]
+            {
+                auto sharedThis{ weakThis.lock() };
+                if (sharedThis)
+                {
+                    std::unique_lock<std::mutex> lock{ sharedThis->m_lock };
+
+                    // If we've since disconnected, the subscription will be restored after reconnecting
+                    auto serviceSub{ weakSub.lock() };
+                    if (serviceSub && serviceSub->messageQueued && serviceSub->status == status &&
+                        sharedThis->m_state == XblRealTimeActivityConnectionState::Connected && sharedThis->m_connectNum == connectNum)
+                    {
+                        sharedThis->m_queuedMessages.push_back(std::move(serviceSub));
+                        sharedThis->ScheduleFlush();
+                    }
+                }
+            },
+            backoff
+        );
+        return;
+    }
+    case ServiceSubscription::Status::PendingUnsubscribe:
+    {
+        // The client removed the subscription while the subscribe message was being sent. The service never saw
+        // the subscription, so remove it from our state as if the subscribe was cancelled.
+        m_subsByClientId.erase(serviceSub->clientId);
+        m_subsByUri.erase(serviceSub->uri);
+        serviceSub->status = ServiceSubscription::Status::Inactive;
+
+        for (auto& asyncContext : serviceSub->subscribeAsyncContexts)
+        {
+            completions.asyncContexts.emplace_back(std::move(asyncContext), E_ABORT);
+        }
+        for (auto& asyncContext : serviceSub->unsubscribeAsyncContexts)
+        {
+            completions.asyncContexts.emplace_back(std::move(asyncContext), S_OK);
+        }
+        serviceSub->subscribeAsyncContexts.clear();
+        serviceSub->unsubscribeAsyncContexts.clear();
+        return;
+    }
+    case ServiceSubscription::Status::PendingSubscribe:
+    {
+        // The client re-added the subscription while the unsubscribe message was being sent. The service still has
+        // the subscription, so it remains active.
+        serviceSub->status = ServiceSubscription::Status::Active;
+
+        for (auto& asyncContext : serviceSub->unsubscribeAsyncContexts)
+        {
+            completions.asyncContexts.emplace_back(std::move(asyncContext), E_ABORT);
+        }
+        for (auto& asyncContext : serviceSub->subscribeAsyncContexts)
+        {
+            completions.asyncContexts.emplace_back(std::move(asyncContext), S_OK);
+        }
+        serviceSub->subscribeAsyncContexts.clear();
+        serviceSub->unsubscribeAsyncContexts.clear();
+
+        for (auto& clientSub : serviceSub->clientSubscriptions)
+        {
+            completions.onSubscribe.emplace_back(clientSub, serviceSub);
+        }
+        return;
+    }
+    default:
+    {
+        assert(false);
+        return;
+    }
+    }
+}
+
+HRESULT Connection::SendAssembledMessage(_In_ const JsonValue& request) const noexcept
+{
     String requestString{ JsonUtils::SerializeJson(request) };
     LOGS_DEBUG << __FUNCTION__ << "[" << this << "]: " << requestString;
 
@@ -421,6 +908,9 @@ void Connection::SubscribeResponseHandler(_In_ const JsonValue& message) noexcep
     auto clientId = message[1].GetUint();
     auto errorCode = static_cast<ErrorCode>(message[2].GetUint());
 
+    // Each response frees up a slot for a queued handshake
+    HandshakeCompleted();
+
     auto subIter{ m_subsByClientId.find(clientId) };
     if (subIter == m_subsByClientId.end())
     {
@@ -437,7 +927,7 @@ void Connection::SubscribeResponseHandler(_In_ const JsonValue& message) noexcep
         serviceSub->serviceId = message[3].GetInt();
         serviceSub->onSubscribeData.CopyFrom(message[4], serviceSub->onSubscribeData.GetAllocator());
 
-        m_subsByServiceId[serviceSub->serviceId] = serviceSub;
+        m_subsByServiceId.Insert(serviceSub->serviceId, serviceSub);
         List<AsyncContext<Result<void>>> subscribeAsyncContexts{ std::move(serviceSub->subscribeAsyncContexts) };
         List<std::shared_ptr<Subscription>> clientSubs{ serviceSub->clientSubscriptions.begin(), serviceSub->clientSubscriptions.end() };
 
@@ -452,7 +942,7 @@ void Connection::SubscribeResponseHandler(_In_ const JsonValue& message) noexcep
         {
             // Client has removed the subscription while subscribe handshake was happening,
             // so immediately begin unsubscribing.
-            SendUnsubscribeMessage(serviceSub, std::move(lock));
+            QueueUnsubscribeMessage(serviceSub);
             break;
         }
         default:
@@ -505,10 +995,12 @@ void Connection::SubscribeResponseHandler(_In_ const JsonValue& message) noexcep
                     {
                         std::unique_lock<std::mutex> lock{ sharedThis->m_lock };
 
+                        // If we've since disconnected, the subscription will be restored after reconnecting
                         auto serviceSub{ weakSub.lock() };
-                        if (serviceSub && serviceSub->status == ServiceSubscription::Status::Inactive)
+                        if (serviceSub && serviceSub->status == ServiceSubscription::Status::Inactive &&
+                            sharedThis->m_state == XblRealTimeActivityConnectionState::Connected)
                         {
-                            sharedThis->SendSubscribeMessage(serviceSub, std::move(lock));
+                            sharedThis->QueueSubscribeMessage(serviceSub);
                         }
                     }
                 },
@@ -566,6 +1058,9 @@ void Connection::UnsubscribeResponseHandler(_In_ const JsonValue& message) noexc
     auto clientId = message[1].GetUint();
     auto errorCode = static_cast<ErrorCode>(message[2].GetUint());
 
+    // Each response frees up a slot for a queued handshake
+    HandshakeCompleted();
+
     if (errorCode != ErrorCode::Success)
     {
         // Not sure why unsubscribing would ever fail
@@ -580,7 +1075,7 @@ void Connection::UnsubscribeResponseHandler(_In_ const JsonValue& message) noexc
         return;
     }
     auto serviceSub{ subIter->second };
-    m_subsByServiceId.erase(serviceSub->serviceId);
+    m_subsByServiceId.Erase(serviceSub->serviceId);
     serviceSub->serviceId = 0;
 
     LOGS_DEBUG << __FUNCTION__ << ": [" << serviceSub->clientId <<"] ServiceStatus=" << EnumName(serviceSub->status);
@@ -601,7 +1096,7 @@ void Connection::UnsubscribeResponseHandler(_In_ const JsonValue& message) noexc
     {
         // Client has re-added the subscription while unsubscibe handshake was happening,
         // so immediately begin subscribing.
-        SendSubscribeMessage(serviceSub, std::move(lock));
+        QueueSubscribeMessage(serviceSub);
         break;
     }
     default:
@@ -622,24 +1117,24 @@ void Connection::UnsubscribeResponseHandler(_In_ const JsonValue& message) noexc
     }
 }
 
-void Connection::EventHandler(_In_ const JsonValue& message) const noexcept
+void Connection::EventHandler(uint32_t serviceId, const EventData& data) const noexcept
 {
     // Payload format [<API_ID>, <SUB_ID>, <DATA>]
 
     std::unique_lock<std::mutex> lock{ m_lock };
-
-    auto serviceId = message[1].GetInt();
-    const auto& data = message[2];
-
-    auto subIter{ m_subsByServiceId.find(serviceId) };
-    assert(subIter != m_subsByServiceId.end());
-    auto serviceSub = subIter->second;
-
+    auto serviceSub{ m_subsByServiceId.Find(serviceId) };
     lock.unlock();
 
+    if (!serviceSub)
+    {
+        // Events can still arrive for a subscription after we've processed the unsubscribe response
+        LOGS_DEBUG << __FUNCTION__ << ": Ignoring event for unknown subscription " << serviceId;
+        return;
+    }
+
     for (auto& clientSub : serviceSub->clientSubscriptions)
     {
-        clientSub->OnEvent(data);
+        clientSub->OnEventData(data);
     }
 }
 
@@ -660,13 +1155,14 @@ void Connection::ConnectCompleteHandler(WebsocketResult result) noexcept
         m_connectAttempt = 0;
         m_connectNum++;
 
-        assert(m_subsByServiceId.empty());
+        assert(m_subsByServiceId.Empty());
 
-        List<JsonDocument> subMessages{};
+        // Restore all subscriptions. They are sent in batches as the service acknowledges them.
+        assert(m_queuedMessages.empty() && m_handshakesInFlight == 0);
         for (auto& pair : m_subsByClientId)
         {
             assert(pair.second->status == ServiceSubscription::Status::Inactive);
-            subMessages.push_back(AssembleSubscribeMessage(pair.second));
+            QueueSubscribeMessage(pair.second);
         }
 
         // RTA v2 has a lifetime of 2 hours. After 2 hours RTA service will disconnect the title. On some platforms
@@ -692,11 +1188,6 @@ void Connection::ConnectCompleteHandler(WebsocketResult result) noexcept
         );
 
         lock.unlock();
-
-        for (auto& request : subMessages)
-        {
-            SendAssembledMessage(request);
-        }
     }
     else
     {
@@ -767,7 +1258,9 @@ void Connection::DisconnectHandler(WebSocketCloseStatus status) noexcept
     std::unique_lock<std::mutex> lock{ m_lock };
 
     // All subs are inactive if we are disconnected
-    m_subsByServiceId.clear();
+    m_subsByServiceId.Clear();
+    m_queuedMessages.clear();
+    m_handshakesInFlight = 0;
 
     // Update state of our subs
     for (auto subsIter = m_subsByClientId.begin(); subsIter != m_subsByClientId.end();)
@@ -819,6 +1312,7 @@ void Connection::DisconnectHandler(WebSocketCloseStatus status) noexcept
 
         serviceSub->serviceId = 0;
         serviceSub->subscribeAttempt = 0;
+        serviceSub->messageQueued = false;
         serviceSub->status = ServiceSubscription::Status::Inactive;
     }
 
@@ -841,28 +1335,56 @@ void Connection::DisconnectHandler(WebSocketCloseStatus status) noexcept
 void Connection::WebsocketMessageReceived(const String& message) noexcept
 {
     // Payload format defined here http://xboxwiki/wiki/Real_Time_Activity
+    XSAPI_PROFILE_SCOPE(XblProfileArea::RtaMessageDispatch);
 
     LOGS_DEBUG << __FUNCTION__ << "[" << this << "]: " << message;
 
-    JsonDocument msgJson;
-    msgJson.Parse(message.c_str());
-    MessageType messageType = static_cast<MessageType>(msgJson[0].GetInt());
+    // Only the message type and, for events, the subscription ID are scanned up front. Event payloads are
+    // handed to subscriptions in place and only parsed if they ask for a DOM.
+    MessageScanner scanner{ message.data(), message.size() };
+    uint32_t messageTypeValue{ 0 };
+    if (!scanner.Consume('[') || !scanner.ReadUint32(messageTypeValue))
+    {
+        LOGS_ERROR << "Received malformed RTA payload, ignoring";
+        return;
+    }
+    MessageType messageType = static_cast<MessageType>(messageTypeValue);
 
     switch (messageType)
     {
     case MessageType::Subscribe:
-    {
-        SubscribeResponseHandler(msgJson);
-        break;
-    }
     case MessageType::Unsubscribe:
     {
-        UnsubscribeResponseHandler(msgJson);
+        JsonDocument msgJson;
+        msgJson.Parse(message.data(), message.size());
+        if (msgJson.HasParseError() || !msgJson.IsArray())
+        {
+            LOGS_ERROR << "Received malformed RTA payload, ignoring";
+            break;
+        }
+
+        if (messageType == MessageType::Subscribe)
+        {
+            SubscribeResponseHandler(msgJson);
+        }
+        else
+        {
+            UnsubscribeResponseHandler(msgJson);
+        }
         break;
     }
     case MessageType::Event:
     {
-        EventHandler(msgJson);
+        uint32_t serviceId{ 0 };
+        const char* data{ nullptr };
+        size_t dataLength{ 0 };
+        if (!scanner.Consume(',') || !scanner.ReadUint32(serviceId) || !scanner.Consume(',') || !scanner.ReadLastElement(data, dataLength))
+        {
+            LOGS_ERROR << "Received malformed RTA event, ignoring";
+            break;
+        }
+
+        EventHandler(serviceId, EventData{ data, dataLength });
         break;
     }
     case MessageType::Resync:
@@ -918,7 +1440,7 @@ HRESULT Connection::InitializeWebsocket() noexcept
         }
     });
 
-    m_websocket->SetReceiveHandler([thisWeakPtr](String message)
+    m_websocket->SetReceiveHandler([thisWeakPtr](const String& message)
     {
         auto sharedThis{ thisWeakPtr.lock() };
         if (sharedThis)
@@ -11,6 +11,32 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
 
 struct ServiceSubscription;
 
+// Routing table from service assigned subscription IDs to subscriptions. Every RTA event message is routed through
+// it, so it is an open addressing table with linear probing rather than a node based map.
+class ServiceSubscriptionTable
+{
+public:
+    std::shared_ptr<ServiceSubscription> Find(uint32_t serviceId) const noexcept;
+    void Insert(uint32_t serviceId, std::shared_ptr<ServiceSubscription> subscription) noexcept;
+    void Erase(uint32_t serviceId) noexcept;
+    void Clear() noexcept;
+    bool Empty() const noexcept;
+
+private:
+    // A slot is empty if it has no subscription
+    struct Slot
+    {
+        uint32_t serviceId{ 0 };
+        std::shared_ptr<ServiceSubscription> subscription;
+    };
+
+    size_t HomeSlot(uint32_t serviceId) const noexcept;
+    void Grow() noexcept;
+
+    ArenaVector<XblMemSubsystem::RealTimeActivity, Slot> m_slots;
+    size_t m_count{ 0 };
+};
+
 class Connection : public std::enable_shared_from_this<Connection>
 {
 public:
@@ -38,6 +64,8 @@ public:
 
     size_t SubscriptionCount() const noexcept;
 
+    bool HasSubscription(const String& resourceUri) const noexcept;
+
 #if HC_PLATFORM == HC_PLATFORM_GDK
     void AppStateChangeNotificationReceived(
         bool isSuspended
@@ -56,22 +84,45 @@ private:
         std::shared_ptr<ServiceSubscription> sub
     ) const noexcept;
 
-    // RTA protocol implementation
-    HRESULT SendSubscribeMessage(
-        std::shared_ptr<ServiceSubscription> subscription,
-        std::unique_lock<std::mutex>&& lock
+    JsonDocument AssembleUnsubscribeMessage(
+        std::shared_ptr<ServiceSubscription> sub
     ) const noexcept;
 
-    HRESULT SendUnsubscribeMessage(
+    // RTA protocol implementation. Handshake messages are queued and sent in batches from the connection's
+    // queue, with at most AppConfig::RtaMaxHandshakesInFlight handshakes outstanding. A handshake which is
+    // cancelled before it is sent is dropped without ever reaching the service. Require m_lock to be held.
+    void QueueSubscribeMessage(
+        std::shared_ptr<ServiceSubscription> subscription
+    ) noexcept;
+
+    void QueueUnsubscribeMessage(
+        std::shared_ptr<ServiceSubscription> subscription
+    ) noexcept;
+
+    void HandshakeCompleted() noexcept;
+    void ScheduleFlush() noexcept;
+    void FlushQueuedMessages() noexcept;
+
+    // Client callbacks owed after a handshake failed to send. They are invoked once m_lock is released.
+    struct HandshakeCompletions
+    {
+        List<std::pair<AsyncContext<Result<void>>, HRESULT>> asyncContexts;
+        List<std::pair<std::shared_ptr<Subscription>, std::shared_ptr<ServiceSubscription>>> onSubscribe;
+    };
+
+    // A handshake which fails to send frees its in flight slot. Subscribe and unsubscribe handshakes are retried
+    // with backoff; if the client reversed the operation in the meantime, the reversal is completed locally.
+    void HandshakeSendFailed(
         std::shared_ptr<ServiceSubscription> subscription,
-        std::unique_lock<std::mutex>&& lock
-    ) const noexcept;
+        HRESULT hr,
+        HandshakeCompletions& completions
+    ) noexcept;
 
     HRESULT SendAssembledMessage(_In_ const JsonValue& message) const noexcept;
 
     void SubscribeResponseHandler(_In_ const JsonValue& message) noexcept;
     void UnsubscribeResponseHandler(_In_ const JsonValue& message) noexcept;
-    void EventHandler(_In_ const JsonValue& message) const noexcept;
+    void EventHandler(uint32_t serviceId, const EventData& data) const noexcept;
 
     // IWebsocket handlers
     void ConnectCompleteHandler(WebsocketResult result) noexcept;
@@ -91,12 +142,19 @@ private:
     const ConnectionStateChangedHandler m_stateChangedHandler;
     const real_time_activity::ResyncHandler m_resyncHandler;
 
-    Map<String, std::shared_ptr<ServiceSubscription>> m_subsByUri; // needed to add/remove client subscription
-    Map<uint32_t, std::shared_ptr<ServiceSubscription>> m_subsByClientId; // needed for subscribe/unsubscribe handshake
-    Map<uint32_t, std::shared_ptr<ServiceSubscription>> m_subsByServiceId; // needed to handle subscription events
+    template<class K>
+    using SubscriptionMap = ArenaMap<XblMemSubsystem::RealTimeActivity, K, std::shared_ptr<ServiceSubscription>>;
+
+    SubscriptionMap<String> m_subsByUri; // needed to add/remove client subscription
+    SubscriptionMap<uint32_t> m_subsByClientId; // needed for subscribe/unsubscribe handshake
+    ServiceSubscriptionTable m_subsByServiceId; // needed to handle subscription events
 
     uint32_t m_nextSubId{ 1 };
 
+    ArenaDeque<XblMemSubsystem::RealTimeActivity, std::shared_ptr<ServiceSubscription>> m_queuedMessages;
+    uint32_t m_handshakesInFlight{ 0 };
+    bool m_flushScheduled{ false };
+
     mutable std::mutex m_lock;
 };
 
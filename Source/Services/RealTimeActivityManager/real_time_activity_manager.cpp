@@ -26,13 +26,16 @@ void RealTimeActivityManager::Cleanup()
     // Don't invoke disconnect handlers during cleanup
     m_stateChangedHandlers.clear();
 
-    Map<uint64_t, std::shared_ptr<Connection>> connections{ std::move(m_rtaConnections) };
+    Map<uint64_t, Vector<ConnectionShard>> connections{ std::move(m_rtaConnections) };
     m_rtaConnections.clear();
     lock.unlock();
 
     for (auto& pair : connections)
     {
-        pair.second->Cleanup();
+        for (auto& shard : pair.second)
+        {
+            shard.connection->Cleanup();
+        }
     }
 }
 
@@ -45,7 +48,7 @@ HRESULT RealTimeActivityManager::AddSubscription(
     RETURN_HR_INVALIDARGUMENT_IF_NULL(subscription);
 
     std::lock_guard<std::recursive_mutex> lock{ m_lock };
-    auto connectionResult{ GetConnection(user) };
+    auto connectionResult{ GetConnection(user, subscription->ResourceUri()) };
     RETURN_HR_IF_FAILED(connectionResult.Hresult());
     return connectionResult.ExtractPayload()->AddSubscription(subscription, AsyncContext<Result<void>>{ m_queue });
 }
@@ -66,9 +69,20 @@ HRESULT RealTimeActivityManager::RemoveSubscription(
         return S_OK;
     }
 
-    return iter->second->RemoveSubscription(subscription, AsyncContext<Result<void>>{ m_queue,
+    auto& shards{ iter->second };
+    auto shardIter = std::find_if(shards.begin(), shards.end(), [&](const ConnectionShard& shard)
+    {
+        return shard.connection->HasSubscription(subscription->ResourceUri());
+    });
+    if (shardIter == shards.end())
+    {
+        return S_OK;
+    }
+
+    return shardIter->connection->RemoveSubscription(subscription, AsyncContext<Result<void>>{ m_queue,
         [
             xuid{ user.Xuid() },
+            connectionId{ shardIter->id },
             weakThis{ std::weak_ptr<RealTimeActivityManager>{ shared_from_this() } }
         ]
     (Result<void> result)
@@ -76,13 +90,17 @@ HRESULT RealTimeActivityManager::RemoveSubscription(
         if (auto sharedThis{ weakThis.lock() })
         {
             std::unique_lock<std::recursive_mutex> lock{ sharedThis->m_lock };
-            // If that was the last remaining subscription and there are no remaining legacy activations, close the connection
             auto iter{ sharedThis->m_rtaConnections.find(xuid) };
-            if (iter != sharedThis->m_rtaConnections.end() && iter->second->SubscriptionCount() == 0 && sharedThis->m_legacyActivations[xuid] == 0)
+            if (iter == sharedThis->m_rtaConnections.end())
+            {
+                return;
+            }
+
+            // If that was the last remaining subscription and there are no remaining legacy activations, close the connection
+            if (sharedThis->SubscriptionCount(xuid) == 0 && sharedThis->m_legacyActivations[xuid] == 0)
             {
                 LOGS_DEBUG << __FUNCTION__ << ": No remaining activations or subscriptions, tearing down connection";
-                iter->second->Cleanup();
-                sharedThis->m_rtaConnections.erase(iter);
+                sharedThis->CleanupConnections(xuid);
 
                 // Maintain legacy behavior and raise Disconnected event even on intentional shutdown
                 auto handlers{ sharedThis->m_stateChangedHandlers[xuid] };
@@ -92,6 +110,20 @@ HRESULT RealTimeActivityManager::RemoveSubscription(
                 {
                     handler.second(XblRealTimeActivityConnectionState::Disconnected);
                 }
+                return;
+            }
+
+            // Close additional connections once their subscriptions have all been removed
+            auto& shards{ iter->second };
+            for (size_t i = 1; i < shards.size(); ++i)
+            {
+                if (shards[i].id == connectionId && shards[i].connection->SubscriptionCount() == 0)
+                {
+                    LOGS_DEBUG << __FUNCTION__ << ": Closing additional connection " << connectionId;
+                    shards[i].connection->Cleanup();
+                    shards.erase(shards.begin() + i);
+                    break;
+                }
             }
         }
     }
@@ -159,8 +191,7 @@ void RealTimeActivityManager::Deactivate(
     std::unique_lock<std::recursive_mutex> lock{ m_lock };
 
     auto& activationCount{ m_legacyActivations[user.Xuid()] };
-    auto connectionIter{ m_rtaConnections.find(user.Xuid()) };
-    if (connectionIter == m_rtaConnections.end())
+    if (m_rtaConnections.find(user.Xuid()) == m_rtaConnections.end())
     {
         return;
     }
@@ -171,11 +202,10 @@ void RealTimeActivityManager::Deactivate(
         // When the activation count reaches 0, tear down the WebSocket connection if the title
         // manually activated/deactivated RTA or if there are no remaining subscriptions.
         // The second case is important due to a race condition between RemoveSubscription and Deactivate.
-        if (m_titleActivated || connectionIter->second->SubscriptionCount() == 0)
+        if (m_titleActivated || SubscriptionCount(user.Xuid()) == 0)
         {
             LOGS_DEBUG << __FUNCTION__ << ": No remaining activations tearing down connection";
-            connectionIter->second->Cleanup();
-            m_rtaConnections.erase(connectionIter);
+            CleanupConnections(user.Xuid());
 
             // Maintain legacy behavior and raise Disconnected event even on intentional shutdown
             auto handlers{ m_stateChangedHandlers[user.Xuid()] };
@@ -208,74 +238,175 @@ Result<std::shared_ptr<Connection>> RealTimeActivityManager::GetConnection(
     const User& user
 ) noexcept
 {
-    std::shared_ptr<Connection> connection;
+    auto iter{ m_rtaConnections.find(user.Xuid()) };
+    if (iter != m_rtaConnections.end() && !iter->second.empty())
+    {
+        return iter->second.front().connection;
+    }
+    return MakeConnection(user);
+}
 
+Result<std::shared_ptr<Connection>> RealTimeActivityManager::GetConnection(
+    const User& user,
+    const String& resourceUri
+) noexcept
+{
     auto iter{ m_rtaConnections.find(user.Xuid()) };
-    if (iter != m_rtaConnections.end())
+    if (iter == m_rtaConnections.end() || iter->second.empty())
     {
-        connection = iter->second;
+        return MakeConnection(user);
     }
-    else
+
+    auto& shards{ iter->second };
+    for (auto& shard : shards)
     {
-        ConnectionStateChangedHandler stateChangedHandler =
-            [
-                xuid{ user.Xuid() },
-                weakThis{ std::weak_ptr<RealTimeActivityManager>{ shared_from_this() } }
-            ]
-        (XblRealTimeActivityConnectionState state)
+        // Subscriptions to the same resource always share a connection
+        if (shard.connection->HasSubscription(resourceUri))
         {
-            if (auto sharedThis{ weakThis.lock() })
-            {
-                std::unique_lock<std::recursive_mutex> lock{ sharedThis->m_lock };
-                auto handlers{ sharedThis->m_stateChangedHandlers[xuid] };
-                lock.unlock();
+            return shard.connection;
+        }
+    }
 
-                for (auto& handler : handlers)
-                {
-                    handler.second(state);
-                }
-            }
-        };
-
-        ResyncHandler resyncHandler =
-            [
-                xuid{ user.Xuid() },
-                weakThis{ std::weak_ptr<RealTimeActivityManager>{ shared_from_this() } }
-            ]
-        (void)
+    auto subscriptionsPerConnection{ AppConfig::Instance()->RtaSubscriptionsPerConnection() };
+    if (subscriptionsPerConnection == 0)
+    {
+        return shards.front().connection;
+    }
+
+    for (auto& shard : shards)
+    {
+        if (shard.connection->SubscriptionCount() < subscriptionsPerConnection)
         {
-            if (auto sharedThis{ weakThis.lock() })
-            {
-                std::unique_lock<std::recursive_mutex> lock{ sharedThis->m_lock };
-                auto handlers{ sharedThis->m_resyncHandlers[xuid] };
-                lock.unlock();
+            return shard.connection;
+        }
+    }
 
-                for (auto& handler : handlers)
-                {
-                    handler.second();
-                }
-            }
-        };
+    LOGS_DEBUG << __FUNCTION__ << ": All " << shards.size() << " connections are full, opening an additional connection";
+    return MakeConnection(user);
+}
 
-        auto copyUserResult{ user.Copy() };
-        if (Failed(copyUserResult))
+Result<std::shared_ptr<Connection>> RealTimeActivityManager::MakeConnection(
+    const User& user
+) noexcept
+{
+    auto connectionId{ m_nextConnectionId++ };
+
+    ConnectionStateChangedHandler stateChangedHandler =
+        [
+            xuid{ user.Xuid() },
+            connectionId,
+            weakThis{ std::weak_ptr<RealTimeActivityManager>{ shared_from_this() } }
+        ]
+    (XblRealTimeActivityConnectionState state)
+    {
+        if (auto sharedThis{ weakThis.lock() })
         {
-            return copyUserResult.Hresult();
+            sharedThis->ConnectionStateChanged(xuid, connectionId, state);
         }
+    };
 
-        auto connectionResult = Connection::Make(copyUserResult.ExtractPayload(), m_queue, std::move(stateChangedHandler), std::move(resyncHandler));
-        if (Failed(connectionResult))
+    ResyncHandler resyncHandler =
+        [
+            xuid{ user.Xuid() },
+            weakThis{ std::weak_ptr<RealTimeActivityManager>{ shared_from_this() } }
+        ]
+    (void)
+    {
+        if (auto sharedThis{ weakThis.lock() })
         {
-            return connectionResult.Hresult();
+            std::unique_lock<std::recursive_mutex> lock{ sharedThis->m_lock };
+            auto handlers{ sharedThis->m_resyncHandlers[xuid] };
+            lock.unlock();
+
+            for (auto& handler : handlers)
+            {
+                handler.second();
+            }
         }
-        
-        connection = connectionResult.ExtractPayload();
-        m_rtaConnections[user.Xuid()] = connection;
+    };
+
+    auto copyUserResult{ user.Copy() };
+    if (Failed(copyUserResult))
+    {
+        return copyUserResult.Hresult();
     }
 
+    auto connectionResult = Connection::Make(copyUserResult.ExtractPayload(), m_queue, std::move(stateChangedHandler), std::move(resyncHandler));
+    if (Failed(connectionResult))
+    {
+        return connectionResult.Hresult();
+    }
+
+    auto connection{ connectionResult.ExtractPayload() };
+    m_rtaConnections[user.Xuid()].push_back(ConnectionShard{ connectionId, connection, XblRealTimeActivityConnectionState::Connecting });
+
     return connection;
 }
 
+size_t RealTimeActivityManager::SubscriptionCount(
+    uint64_t xuid
+) const noexcept
+{
+    size_t count{ 0 };
+    auto iter{ m_rtaConnections.find(xuid) };
+    if (iter != m_rtaConnections.end())
+    {
+        for (auto& shard : iter->second)
+        {
+            count += shard.connection->SubscriptionCount();
+        }
+    }
+    return count;
+}
+
+void RealTimeActivityManager::CleanupConnections(
+    uint64_t xuid
+) noexcept
+{
+    auto iter{ m_rtaConnections.find(xuid) };
+    if (iter != m_rtaConnections.end())
+    {
+        for (auto& shard : iter->second)
+        {
+            shard.connection->Cleanup();
+        }
+        m_rtaConnections.erase(iter);
+    }
+}
+
+void RealTimeActivityManager::ConnectionStateChanged(
+    uint64_t xuid,
+    uint32_t connectionId,
+    XblRealTimeActivityConnectionState state
+) noexcept
+{
+    std::unique_lock<std::recursive_mutex> lock{ m_lock };
+
+    // When a user has multiple connections, report the least connected state among them. The enum is ordered
+    // from most to least connected.
+    auto reportedState{ state };
+    auto iter{ m_rtaConnections.find(xuid) };
+    if (iter != m_rtaConnections.end())
+    {
+        for (auto& shard : iter->second)
+        {
+            if (shard.id == connectionId)
+            {
+                shard.state = state;
+            }
+            reportedState = std::max(reportedState, shard.state);
+        }
+    }
+
+    auto handlers{ m_stateChangedHandlers[xuid] };
+    lock.unlock();
+
+    for (auto& handler : handlers)
+    {
+        handler.second(reportedState);
+    }
+}
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_END
 
 // Test Hook
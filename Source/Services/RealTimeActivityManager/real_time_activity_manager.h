@@ -65,11 +65,48 @@ public:
     void TriggerResync() const noexcept;
 
 private:
+    // A user's subscriptions are served by a single connection unless AppConfig::RtaSubscriptionsPerConnection
+    // is set, in which case additional connections are opened as the existing ones fill up. The first connection
+    // is kept for as long as the user has subscriptions or activations.
+    struct ConnectionShard
+    {
+        uint32_t id;
+        std::shared_ptr<class Connection> connection;
+        XblRealTimeActivityConnectionState state;
+    };
+
+    // Returns the user's first connection, creating it if needed
     Result<std::shared_ptr<class Connection>> GetConnection(
         const User& user
     ) noexcept;
 
-    Map<uint64_t, std::shared_ptr<class Connection>> m_rtaConnections;
+    // Returns the connection which has or should have the subscription, opening a new connection if
+    // the existing ones are full
+    Result<std::shared_ptr<class Connection>> GetConnection(
+        const User& user,
+        const String& resourceUri
+    ) noexcept;
+
+    Result<std::shared_ptr<class Connection>> MakeConnection(
+        const User& user
+    ) noexcept;
+
+    size_t SubscriptionCount(
+        uint64_t xuid
+    ) const noexcept;
+
+    void CleanupConnections(
+        uint64_t xuid
+    ) noexcept;
+
+    void ConnectionStateChanged(
+        uint64_t xuid,
+        uint32_t connectionId,
+        XblRealTimeActivityConnectionState state
+    ) noexcept;
+
+    Map<uint64_t, Vector<ConnectionShard>> m_rtaConnections;
+    uint32_t m_nextConnectionId{ 1 };
     TaskQueue const m_queue;
 
     XblFunctionContext m_nextToken{ 1 };
@@ -19,6 +19,41 @@ private:
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
 
+// View of the DATA element of an RTA event message. The payload is only parsed into a JsonDocument the
+// first time it is requested, and at most once regardless of how many subscriptions the event is dispatched to.
+// Only valid for the duration of the dispatch.
+class EventData
+{
+public:
+    EventData(const char* data, size_t length) noexcept : m_data{ data }, m_length{ length } {}
+    EventData(const EventData&) = delete;
+    EventData& operator=(const EventData&) = delete;
+
+    const char* Data() const noexcept { return m_data; }
+    size_t Length() const noexcept { return m_length; }
+
+    const JsonValue& Json() const noexcept
+    {
+        if (!m_parsed)
+        {
+            m_parsed = true;
+            m_json.Parse(m_data, m_length);
+            if (m_json.HasParseError())
+            {
+                LOGS_ERROR << "Unable to parse RTA event payload, error " << m_json.GetParseError();
+                m_json.SetNull();
+            }
+        }
+        return m_json;
+    }
+
+private:
+    const char* const m_data;
+    size_t const m_length;
+    mutable JsonDocument m_json{ rapidjson::kNullType };
+    mutable bool m_parsed{ false };
+};
+
 class Subscription
 {
 public:
@@ -38,6 +73,13 @@ public:
     };
     virtual void OnEvent(const JsonValue& event) noexcept = 0;
 
+    // Called by the RTA connection for each event. Subscriptions may override this to consume the raw
+    // payload without building a DOM, by default the payload is parsed and forwarded to OnEvent.
+    virtual void OnEventData(const EventData& event) noexcept
+    {
+        OnEvent(event.Json());
+    }
+
 protected:
     String m_resourceUri;
 };
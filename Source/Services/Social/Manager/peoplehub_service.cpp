@@ -21,20 +21,22 @@ PeoplehubService::PeoplehubService(
 HRESULT PeoplehubService::GetSocialGraph(
     _In_ uint64_t xuid,
     _In_ XblSocialManagerExtraDetailLevel decorations,
-    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+    _In_ HttpCallPriority priority
 ) const noexcept
 {
-    return MakeServiceCall(xuid, decorations, RelationshipType::Social, Vector<uint64_t>{}, async);
+    return MakeServiceCall(xuid, decorations, RelationshipType::Social, Vector<uint64_t>{}, async, priority);
 }
 
 HRESULT PeoplehubService::GetSocialUsers(
     _In_ uint64_t xuid,
     _In_ XblSocialManagerExtraDetailLevel decorations,
     _In_ const Vector<uint64_t>& xuids,
-    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+    _In_ HttpCallPriority priority
 ) const noexcept
 {
-    return MakeServiceCall(xuid, decorations, RelationshipType::Batch, xuids, async);
+    return MakeServiceCall(xuid, decorations, RelationshipType::Batch, xuids, async, priority);
 }
     
 HRESULT PeoplehubService::MakeServiceCall(
@@ -42,7 +44,8 @@ HRESULT PeoplehubService::MakeServiceCall(
     _In_ XblSocialManagerExtraDetailLevel decorations,
     _In_ RelationshipType relationshipType,
     _In_opt_ const Vector<uint64_t>& batchUsers,
-    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+    _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+    _In_ HttpCallPriority priority
 ) const noexcept
 {
     Stringstream subpath;
@@ -100,6 +103,7 @@ HRESULT PeoplehubService::MakeServiceCall(
     ));
 
     httpCall->SetXblServiceContractVersion(7);
+    httpCall->SetPriority(priority);
 
     if (!bodyJson.IsNull())
     {
@@ -128,30 +132,505 @@ HRESULT PeoplehubService::MakeServiceCall(
             return async.Complete({ utils::convert_xbox_live_error_code_to_hresult(xbl_error_code::http_status_424_failed_dependency) });
         }
 
-        Vector<XblSocialManagerUser> users;
+        return async.Complete(DeserializeUsers(*httpCall));
+    } });
+}
+
+Result<Vector<XblSocialManagerUser>> PeoplehubService::DeserializeUsers(
+    const HttpCall& httpCall
+)
+{
+    auto appConfig{ AppConfig::Instance() };
+    auto mode{ appConfig ? appConfig->JsonDeserializationMode() : JsonDeserializationMode::Dom };
+
+    switch (mode)
+    {
+    case JsonDeserializationMode::Verify:
+    {
+        auto domResult{ DeserializeUsersDom(httpCall) };
+        auto saxResult{ DeserializeUsersSax(httpCall) };
+        if (domResult.Hresult() != saxResult.Hresult() || !UsersEqual(domResult.Payload(), saxResult.Payload()))
+        {
+            LOGS_ERROR << __FUNCTION__ << ": DOM and SAX deserialization results differ, using the DOM result";
+        }
+        return domResult;
+    }
+    case JsonDeserializationMode::Sax:
+    {
+        return DeserializeUsersSax(httpCall);
+    }
+    case JsonDeserializationMode::Dom:
+    default:
+    {
+        return DeserializeUsersDom(httpCall);
+    }
+    }
+}
 
-        JsonDocument responseBodyJson = httpCall->GetResponseBodyJson();
-        auto peopleJsonArray = JsonUtils::ExtractJsonArray(
-            responseBodyJson,
-            "people",
-            false
-        );
+Result<Vector<XblSocialManagerUser>> PeoplehubService::DeserializeUsersDom(
+    const HttpCall& httpCall
+)
+{
+    Vector<XblSocialManagerUser> users;
 
-        for (auto& user : peopleJsonArray)
+    JsonDocument responseBodyJson = httpCall.GetResponseBodyJson();
+    auto peopleJsonArray = JsonUtils::ExtractJsonArray(
+        responseBodyJson,
+        "people",
+        false
+    );
+
+    for (auto& user : peopleJsonArray)
+    {
+        auto result{ DeserializeUser(user) };
+        if (Succeeded(result))
+        {
+            users.push_back(result.ExtractPayload());
+        }
+        else
         {
-            auto result{ DeserializeUser(user) };
-            if (Succeeded(result))
+            return { result.Hresult() };
+        }
+    }
+
+    return users;
+}
+
+// Streaming deserializer for PeopleHub responses. Fills XblSocialManagerUsers directly from the response body and
+// produces the same output as the DOM based DeserializeUser path, including its handling of unexpected types.
+class PeoplehubSaxReader : public JsonSaxReader
+{
+public:
+    Vector<XblSocialManagerUser>& Users() noexcept
+    {
+        return m_users;
+    }
+
+    // First error reported by this reader, as opposed to malformed JSON reported by rapidjson
+    HRESULT DeserializationError() const noexcept
+    {
+        return m_error;
+    }
+
+private:
+    struct Scalar
+    {
+        enum class Type { Null, Bool, Number, String } type;
+        bool boolValue;
+        const char* string;
+        size_t length;
+    };
+
+    bool InPeople() const noexcept
+    {
+        return PathIs({ "", "people" }) && InArray();
+    }
+
+    bool InUser() const noexcept
+    {
+        return m_inUser && !InArray() && PathIs({ "", "people", "" });
+    }
+
+    bool InPresenceDetails() const noexcept
+    {
+        return m_inUser && InArray() && PathIs({ "", "people", "", "presenceDetails" });
+    }
+
+    bool InTitleRecord() const noexcept
+    {
+        return m_inTitleRecord && !InArray() && PathIs({ "", "people", "", "presenceDetails", "" });
+    }
+
+    bool InTitleHistory() const noexcept
+    {
+        return m_inUser && !InArray() && PathIs({ "", "people", "", "titleHistory" });
+    }
+
+    bool InPreferredColor() const noexcept
+    {
+        return m_inUser && !InArray() && PathIs({ "", "people", "", "preferredColor" });
+    }
+
+    bool OnNull() override { return OnScalar({ Scalar::Type::Null, false, nullptr, 0 }); }
+    bool OnBool(bool b) override { return OnScalar({ Scalar::Type::Bool, b, nullptr, 0 }); }
+    bool OnInt64(int64_t) override { return OnScalar({ Scalar::Type::Number, false, nullptr, 0 }); }
+    bool OnUint64(uint64_t) override { return OnScalar({ Scalar::Type::Number, false, nullptr, 0 }); }
+    bool OnDouble(double) override { return OnScalar({ Scalar::Type::Number, false, nullptr, 0 }); }
+    bool OnString(const char* str, size_t length) override { return OnScalar({ Scalar::Type::String, false, str, length }); }
+
+    bool OnStartObject() override
+    {
+        if (InPeople())
+        {
+            m_user = XblSocialManagerUser{};
+            m_user.presenceRecord.userState = XblPresenceRecord::UserStateFromString(xsapi_internal_string{});
+            m_hasXuid = false;
+            m_inUser = true;
+            return true;
+        }
+        else if (InPresenceDetails())
+        {
+            m_titleRecord = XblSocialManagerPresenceTitleRecord{};
+            m_titleRecord.deviceType = presence::DeviceRecord::DeviceTypeFromString(xsapi_internal_string{});
+            m_titleRecordValid = true;
+            m_inTitleRecord = true;
+            return true;
+        }
+        return OnNestedContainer();
+    }
+
+    bool OnStartArray() override
+    {
+        if (InPeople())
+        {
+            // Non-object users are deserialized as empty users
+            m_users.push_back(XblSocialManagerUser{});
+            return true;
+        }
+        else if (InPresenceDetails())
+        {
+            // Non-object title records are deserialized as empty records
+            AddTitleRecord(XblSocialManagerPresenceTitleRecord{});
+            return true;
+        }
+        return OnNestedContainer();
+    }
+
+    bool OnEndObject() override
+    {
+        if (InPeople())
+        {
+            m_inUser = false;
+            if (!m_hasXuid)
+            {
+                return Error(WEB_E_INVALID_JSON_STRING);
+            }
+
+            // isFavorite should reflect both isFavorite && isFriend from the service response
+            m_user.isFavorite = m_user.isFavorite && m_user.isFriend;
+            // Shim isFollowingUser and isFollowedByCaller to be true if isFriend is true
+            m_user.isFollowedByCaller = m_user.isFriend;
+            m_user.isFollowingUser = m_user.isFriend;
+            m_user.titleHistory.hasUserPlayed = m_user.titleHistory.lastTimeUserPlayed != 0;
+
+            m_users.push_back(m_user);
+        }
+        else if (InPresenceDetails())
+        {
+            m_inTitleRecord = false;
+            if (m_titleRecordValid)
             {
-                users.push_back(result.ExtractPayload());
+                //get titleName from Presence string: format should be "Title - Rich Presence Text"
+                for (int i = 0; i < XBL_TITLE_NAME_CHAR_SIZE; i++)
+                {
+                    char c = m_titleRecord.presenceText[i];
+                    if (c == '-' || c == '\0')
+                    {
+                        m_titleRecord.titleName[i] = '\0';
+                        break;
+                    }
+                    m_titleRecord.titleName[i] = c;
+                }
+                AddTitleRecord(m_titleRecord);
             }
-            else
+        }
+        return true;
+    }
+
+    // Handles a container appearing where one of the known scalar fields is expected
+    bool OnNestedContainer()
+    {
+        if (InUser())
+        {
+            if (KeyIs("xuid") || KeyIs("presenceState") || IsUserBoolField() || IsUserStringField())
             {
-                return async.Complete({ result.Hresult() });
+                return Error(WEB_E_INVALID_JSON_STRING);
             }
         }
+        else if (InTitleRecord())
+        {
+            if (KeyIs("Device") || KeyIs("PresenceText") || KeyIs("State") || KeyIs("TitleId") || KeyIs("IsPrimary"))
+            {
+                // Invalid title records are skipped rather than failing the user
+                m_titleRecordValid = false;
+            }
+        }
+        else if (InPreferredColor())
+        {
+            if (KeyIs("primaryColor") || KeyIs("secondaryColor") || KeyIs("tertiaryColor"))
+            {
+                return Error(WEB_E_INVALID_JSON_STRING);
+            }
+        }
+        return true;
+    }
 
-        return async.Complete(users);
-    } });
+    bool OnScalar(const Scalar& value)
+    {
+        if (InPeople())
+        {
+            m_users.push_back(XblSocialManagerUser{});
+        }
+        else if (InUser())
+        {
+            return OnUserField(value);
+        }
+        else if (InPresenceDetails())
+        {
+            AddTitleRecord(XblSocialManagerPresenceTitleRecord{});
+        }
+        else if (InTitleRecord())
+        {
+            OnTitleRecordField(value);
+        }
+        else if (InTitleHistory())
+        {
+            // If PeopleHub service fails to query TitleHistory, the "lastTimePlayed" field may be null.
+            // We don't want to fail deserialization in this case, so just treat the user as not having played
+            if (value.type != Scalar::Type::String)
+            {
+                return true;
+            }
+            else if (KeyIs("lastTimePlayed"))
+            {
+                auto lastTimePlayed = xbox::services::datetime::from_string(value.string, xbox::services::datetime::date_format::ISO_8601);
+                m_user.titleHistory.lastTimeUserPlayed = utils::time_t_from_datetime(lastTimePlayed);
+            }
+            else if (KeyIs("lastTimePlayedText"))
+            {
+                return CopyString(value, m_user.titleHistory.lastTimeUserPlayedText, XBL_LAST_TIME_PLAYED_CHAR_SIZE);
+            }
+        }
+        else if (InPreferredColor())
+        {
+            auto& color{ m_user.preferredColor };
+            if (KeyIs("primaryColor"))
+            {
+                return CopyString(value, color.primaryColor, sizeof(color.primaryColor));
+            }
+            else if (KeyIs("secondaryColor"))
+            {
+                return CopyString(value, color.secondaryColor, sizeof(color.secondaryColor));
+            }
+            else if (KeyIs("tertiaryColor"))
+            {
+                return CopyString(value, color.tertiaryColor, sizeof(color.tertiaryColor));
+            }
+        }
+        return true;
+    }
+
+    bool IsUserBoolField() const noexcept
+    {
+        return KeyIs("isFriend") || KeyIs("isFavorite") || KeyIs("useAvatar");
+    }
+
+    bool IsUserStringField() const noexcept
+    {
+        return KeyIs("displayName") || KeyIs("realName") || KeyIs("displayPicRaw") || KeyIs("gamertag") || KeyIs("modernGamertag") ||
+            KeyIs("modernGamertagSuffix") || KeyIs("uniqueModernGamertag") || KeyIs("gamerScore");
+    }
+
+    bool OnUserField(const Scalar& value)
+    {
+        if (KeyIs("xuid"))
+        {
+            m_hasXuid = true;
+            if (value.type == Scalar::Type::String)
+            {
+                m_user.xboxUserId = utils::internal_string_to_uint64(xsapi_internal_string{ value.string, value.length });
+                return true;
+            }
+            return value.type == Scalar::Type::Null || Error(WEB_E_INVALID_JSON_STRING);
+        }
+        else if (KeyIs("presenceState"))
+        {
+            if (value.type == Scalar::Type::String)
+            {
+                m_user.presenceRecord.userState = XblPresenceRecord::UserStateFromString(xsapi_internal_string{ value.string, value.length });
+                return true;
+            }
+            return value.type == Scalar::Type::Null || Error(WEB_E_INVALID_JSON_STRING);
+        }
+        else if (IsUserBoolField())
+        {
+            if (value.type != Scalar::Type::Bool)
+            {
+                return Error(WEB_E_INVALID_JSON_STRING);
+            }
+            bool& field = KeyIs("isFriend") ? m_user.isFriend : KeyIs("isFavorite") ? m_user.isFavorite : m_user.useAvatar;
+            field = value.boolValue;
+        }
+        else if (KeyIs("displayName")) { return CopyString(value, m_user.displayName, sizeof(m_user.displayName)); }
+        else if (KeyIs("realName")) { return CopyString(value, m_user.realName, sizeof(m_user.realName)); }
+        else if (KeyIs("displayPicRaw")) { return CopyString(value, m_user.displayPicUrlRaw, sizeof(m_user.displayPicUrlRaw)); }
+        else if (KeyIs("gamertag")) { return CopyString(value, m_user.gamertag, sizeof(m_user.gamertag)); }
+        else if (KeyIs("modernGamertag")) { return CopyString(value, m_user.modernGamertag, sizeof(m_user.modernGamertag)); }
+        else if (KeyIs("modernGamertagSuffix")) { return CopyString(value, m_user.modernGamertagSuffix, sizeof(m_user.modernGamertagSuffix)); }
+        else if (KeyIs("uniqueModernGamertag")) { return CopyString(value, m_user.uniqueModernGamertag, sizeof(m_user.uniqueModernGamertag)); }
+        else if (KeyIs("gamerScore")) { return CopyString(value, m_user.gamerscore, sizeof(m_user.gamerscore)); }
+        return true;
+    }
+
+    void OnTitleRecordField(const Scalar& value)
+    {
+        if (KeyIs("IsPrimary"))
+        {
+            m_titleRecordValid = m_titleRecordValid && value.type == Scalar::Type::Bool;
+            m_titleRecord.isPrimary = value.boolValue;
+            return;
+        }
+        else if (value.type == Scalar::Type::Null)
+        {
+            // Null strings are treated as empty
+            return;
+        }
+        else if (value.type != Scalar::Type::String)
+        {
+            m_titleRecordValid = m_titleRecordValid && !(KeyIs("Device") || KeyIs("PresenceText") || KeyIs("State") || KeyIs("TitleId"));
+            return;
+        }
+
+        xsapi_internal_string str{ value.string, value.length };
+        if (KeyIs("Device"))
+        {
+            m_titleRecord.deviceType = presence::DeviceRecord::DeviceTypeFromString(str);
+        }
+        else if (KeyIs("PresenceText"))
+        {
+            m_titleRecordValid = m_titleRecordValid && str.size() < sizeof(m_titleRecord.presenceText);
+            if (m_titleRecordValid)
+            {
+                utils::strcpy(m_titleRecord.presenceText, sizeof(m_titleRecord.presenceText), str.data());
+            }
+        }
+        else if (KeyIs("State"))
+        {
+            m_titleRecord.isTitleActive = utils::str_icmp_internal(str, "active") == 0;
+        }
+        else if (KeyIs("TitleId"))
+        {
+            m_titleRecord.titleId = utils::internal_string_to_uint32(str);
+        }
+    }
+
+    void AddTitleRecord(const XblSocialManagerPresenceTitleRecord& titleRecord)
+    {
+        auto& presenceRecord{ m_user.presenceRecord };
+        if (presenceRecord.presenceTitleRecordCount < XBL_NUM_PRESENCE_RECORDS)
+        {
+            presenceRecord.presenceTitleRecords[presenceRecord.presenceTitleRecordCount++] = titleRecord;
+        }
+    }
+
+    // Copies a string field into a fixed size buffer. Null fields are left empty
+    bool CopyString(const Scalar& value, char* dest, size_t size)
+    {
+        if (value.type == Scalar::Type::Null)
+        {
+            return true;
+        }
+        else if (value.type != Scalar::Type::String)
+        {
+            return Error(WEB_E_INVALID_JSON_STRING);
+        }
+        else if (value.length >= size)
+        {
+            return Error(E_INVALIDARG);
+        }
+        utils::strcpy(dest, size, value.string);
+        return true;
+    }
+
+    bool Error(HRESULT hr)
+    {
+        m_error = hr;
+        return Fail(hr);
+    }
+
+    Vector<XblSocialManagerUser> m_users;
+    XblSocialManagerUser m_user{};
+    bool m_inUser{ false };
+    bool m_hasXuid{ false };
+    XblSocialManagerPresenceTitleRecord m_titleRecord{};
+    bool m_inTitleRecord{ false };
+    bool m_titleRecordValid{ false };
+    HRESULT m_error{ S_OK };
+};
+
+Result<Vector<XblSocialManagerUser>> PeoplehubService::DeserializeUsersSax(
+    const HttpCall& httpCall
+)
+{
+    PeoplehubSaxReader reader;
+    HRESULT hr = httpCall.GetResponseBodyJson(reader);
+    if (FAILED(reader.DeserializationError()))
+    {
+        return { reader.DeserializationError() };
+    }
+    else if (FAILED(hr))
+    {
+        // Consistent with the DOM path, a malformed response is treated as having no users
+        return Vector<XblSocialManagerUser>{};
+    }
+    return std::move(reader.Users());
+}
+
+bool PeoplehubService::UsersEqual(
+    const Vector<XblSocialManagerUser>& lhs,
+    const Vector<XblSocialManagerUser>& rhs
+)
+{
+    auto titleRecordsEqual = [](const XblSocialManagerPresenceTitleRecord& a, const XblSocialManagerPresenceTitleRecord& b)
+    {
+        return a.isTitleActive == b.isTitleActive &&
+            a.isBroadcasting == b.isBroadcasting &&
+            a.deviceType == b.deviceType &&
+            a.titleId == b.titleId &&
+            a.isPrimary == b.isPrimary &&
+            strcmp(a.titleName, b.titleName) == 0 &&
+            strcmp(a.presenceText, b.presenceText) == 0;
+    };
+
+    auto usersEqual = [&](const XblSocialManagerUser& a, const XblSocialManagerUser& b)
+    {
+        if (a.xboxUserId != b.xboxUserId ||
+            a.isFavorite != b.isFavorite ||
+            a.isFollowingUser != b.isFollowingUser ||
+            a.isFollowedByCaller != b.isFollowedByCaller ||
+            a.isFriend != b.isFriend ||
+            a.useAvatar != b.useAvatar ||
+            strcmp(a.displayName, b.displayName) != 0 ||
+            strcmp(a.realName, b.realName) != 0 ||
+            strcmp(a.displayPicUrlRaw, b.displayPicUrlRaw) != 0 ||
+            strcmp(a.gamerscore, b.gamerscore) != 0 ||
+            strcmp(a.gamertag, b.gamertag) != 0 ||
+            strcmp(a.modernGamertag, b.modernGamertag) != 0 ||
+            strcmp(a.modernGamertagSuffix, b.modernGamertagSuffix) != 0 ||
+            strcmp(a.uniqueModernGamertag, b.uniqueModernGamertag) != 0 ||
+            a.titleHistory.hasUserPlayed != b.titleHistory.hasUserPlayed ||
+            a.titleHistory.lastTimeUserPlayed != b.titleHistory.lastTimeUserPlayed ||
+            strcmp(a.titleHistory.lastTimeUserPlayedText, b.titleHistory.lastTimeUserPlayedText) != 0 ||
+            strcmp(a.preferredColor.primaryColor, b.preferredColor.primaryColor) != 0 ||
+            strcmp(a.preferredColor.secondaryColor, b.preferredColor.secondaryColor) != 0 ||
+            strcmp(a.preferredColor.tertiaryColor, b.preferredColor.tertiaryColor) != 0 ||
+            a.presenceRecord.userState != b.presenceRecord.userState ||
+            a.presenceRecord.presenceTitleRecordCount != b.presenceRecord.presenceTitleRecordCount)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.presenceRecord.presenceTitleRecordCount; ++i)
+        {
+            if (!titleRecordsEqual(a.presenceRecord.presenceTitleRecords[i], b.presenceRecord.presenceTitleRecords[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), usersEqual);
 }
 
 Result<XblSocialManagerUser> PeoplehubService::DeserializeUser(
@@ -19,14 +19,16 @@ public:
     HRESULT GetSocialGraph(
         _In_ uint64_t xuid,
         _In_ XblSocialManagerExtraDetailLevel decorations,
-        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+        _In_ HttpCallPriority priority = HttpCallPriority::Interactive
     ) const noexcept;
 
     HRESULT GetSocialUsers(
         _In_ uint64_t xuid,
         _In_ XblSocialManagerExtraDetailLevel decorations,
         _In_ const Vector<uint64_t>& xuids,
-        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+        _In_ HttpCallPriority priority = HttpCallPriority::Interactive
     ) const noexcept;
 
 private:
@@ -41,9 +43,17 @@ private:
         _In_ XblSocialManagerExtraDetailLevel decorations,
         _In_ RelationshipType relationshipType,
         _In_opt_ const Vector<uint64_t>& batchUsers,
-        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async
+        _In_ AsyncContext<Result<Vector<XblSocialManagerUser>>> async,
+        _In_ HttpCallPriority priority
     ) const noexcept;
 
+    // Deserializes the users in a PeopleHub response, using either the DOM or streaming path
+    // depending on the configured JsonDeserializationMode.
+    static Result<Vector<XblSocialManagerUser>> DeserializeUsers(const HttpCall& httpCall);
+    static Result<Vector<XblSocialManagerUser>> DeserializeUsersDom(const HttpCall& httpCall);
+    static Result<Vector<XblSocialManagerUser>> DeserializeUsersSax(const HttpCall& httpCall);
+    static bool UsersEqual(const Vector<XblSocialManagerUser>& lhs, const Vector<XblSocialManagerUser>& rhs);
+
     static Result<XblSocialManagerUser> DeserializeUser(const JsonValue& json);
     static Result<XblSocialManagerPresenceRecord> DeserializePresenceRecord(const JsonValue& json);
     static Result<XblSocialManagerPresenceTitleRecord> DeserializePresenceTitleRecord(const JsonValue& json);
@@ -5,7 +5,6 @@
 #include "social_graph.h"
 #include "xbox_live_context_internal.h"
 #include "social_manager_user_group.h"
-#include "perf_tester.h"
 
 // Max full graph refresh interval - 20 mins in ms
 #define GRAPH_REFRESH_INTERVAL_MS (20 * 60 * 1000)
@@ -40,15 +39,23 @@ struct ServiceCallManager : public std::enable_shared_from_this<ServiceCallManag
 
     ~ServiceCallManager() noexcept;
 
-    // Poll rich presence for a set of users. Result delivered via PresenceResultHandler.
+    // Poll rich presence for a set of users. Result delivered via PresenceResultHandler. Presence polls only keep
+    // the graph up to date, so they are made as background calls.
     HRESULT PollPresence(const Vector<uint64_t>& xuids) noexcept;
 
-    // Poll PeopleHub profiles for a set of users. Result delivered via PeoplehubResultHandler.
-    HRESULT PollPeopleHub(const Vector<uint64_t>& xuids) noexcept;
+    // Poll PeopleHub profiles for a set of users. Result delivered via PeoplehubResultHandler. Polls are batched, and a
+    // batch is made as an interactive call if any of its users were polled with interactive priority.
+    HRESULT PollPeopleHub(
+        const Vector<uint64_t>& xuids,
+        HttpCallPriority priority = HttpCallPriority::Interactive
+    ) noexcept;
 
     // Get PeopleHub profiles for all followed users. Non-batched, but service failures will be retried
     // automatically. Result delivered via 'handler' arg
-    HRESULT PeopleHubGetFollowedUsers(PeopleHubResultHandler handler) const noexcept;
+    HRESULT PeopleHubGetFollowedUsers(
+        PeopleHubResultHandler handler,
+        HttpCallPriority priority
+    ) const noexcept;
 
     // Needed to check compatibility between determined detail level and XblPresenceFilter for a social group
     XblSocialManagerExtraDetailLevel GetDetailLevel() const noexcept;
@@ -72,6 +79,7 @@ private:
 
     // Peoplehub polling state
     UnorderedSet<uint64_t> m_usersPendingPeoplehub;
+    HttpCallPriority m_pendingPeoplehubPriority{ HttpCallPriority::Background };
     bool m_peoplehubPollInProgress{ false };
     PeopleHubResultHandler const m_peopleHubResultHandler;
 
@@ -196,6 +204,11 @@ Result<std::shared_ptr<SocialGraph>> SocialGraph::Make(
     {
         if (auto graph{ weakGraph.lock() })
         {
+            // The title is waiting on the initial graph load. Once the graph is loaded, these are periodic refreshes.
+            std::unique_lock<std::recursive_mutex> initializedLock{ graph->m_mutex };
+            auto callPriority{ graph->m_initialized ? HttpCallPriority::Background : HttpCallPriority::Interactive };
+            initializedLock.unlock();
+
             graph->m_serviceCallManager->PeopleHubGetFollowedUsers([weakGraph](Vector<XblSocialManagerUser>&& profiles)
             {
                 if (auto graph{ weakGraph.lock() })
@@ -233,7 +246,7 @@ Result<std::shared_ptr<SocialGraph>> SocialGraph::Make(
                         graph->m_initialized = true;
                     }
                 }
-            });
+            }, callPriority);
 
             std::unique_lock<std::recursive_mutex> lock{ graph->m_mutex };
             Vector<uint64_t> nonFollowedXuids;
@@ -248,7 +261,7 @@ Result<std::shared_ptr<SocialGraph>> SocialGraph::Make(
 
             if (!nonFollowedXuids.empty())
             {
-                graph->m_serviceCallManager->PollPeopleHub(nonFollowedXuids);
+                graph->m_serviceCallManager->PollPeopleHub(nonFollowedXuids, callPriority);
             }
         }
     });
@@ -311,7 +324,6 @@ void SocialGraph::DoWork(
     _Inout_ Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers
 ) noexcept
 {
-    PERF_START();
     // For performance reasons, don't wait for the mutex if a background thread holds it
     std::unique_lock<std::recursive_mutex> lock{ m_mutex, std::defer_lock };
     if (lock.try_lock() && m_initialized)
@@ -323,7 +335,8 @@ void SocialGraph::DoWork(
             m_localUserAdded = true;
         }
 
-        // Apply graph updates
+        // Apply graph updates. Groups only need to look at events generated by this graph
+        size_t firstGraphEvent{ events.size() };
         ApplyGraphUpdates(events, affectedUsers);
 
         // Notify groups of graph changes
@@ -339,7 +352,7 @@ void SocialGraph::DoWork(
                 m_queue.RunWork([this, sharedThis{ shared_from_this() }, group{ pair.first }]
                 {
                     std::unique_lock<std::recursive_mutex> lock{ m_mutex };
-                    group->Initialize(m_profiles);
+                    group->Initialize(m_profiles, GetFilterIndex(*group));
                     m_groups[group] = GroupInitializationStage::Complete;
                 });
 
@@ -347,7 +360,7 @@ void SocialGraph::DoWork(
             }
             case GroupInitializationStage::Complete:
             {
-                pair.first->DoWork(events);
+                pair.first->DoWork(events, firstGraphEvent, GetFilterIndex(*pair.first));
                 break;
             }
             case GroupInitializationStage::Scheduled:
@@ -358,7 +371,6 @@ void SocialGraph::DoWork(
             }
         }
     }
-    PERF_STOP();
 }
 
 void SocialGraph::RegisterGroup(std::shared_ptr<XblSocialManagerUserGroup> group) noexcept
@@ -370,6 +382,10 @@ void SocialGraph::RegisterGroup(std::shared_ptr<XblSocialManagerUserGroup> group
     auto iter{ m_groups.find(group) };
     if (iter == m_groups.end() || iter->second == GroupInitializationStage::Complete)
     {
+        if (iter == m_groups.end() && group->type == XblSocialUserGroupType::FilterType)
+        {
+            AddFilterIndexReference(*group);
+        }
         m_groups[group] = GroupInitializationStage::Pending;
 
         // Check if the filter is one that relies on title history but TitleHistoryLevel is not set
@@ -386,7 +402,80 @@ void SocialGraph::RegisterGroup(std::shared_ptr<XblSocialManagerUserGroup> group
 void SocialGraph::UnregisterGroup(std::shared_ptr<XblSocialManagerUserGroup> group) noexcept
 {
     std::lock_guard<std::recursive_mutex> lock{ m_mutex };
-    m_groups.erase(group);
+    if (m_groups.erase(group) && group->type == XblSocialUserGroupType::FilterType)
+    {
+        RemoveFilterIndexReference(*group);
+    }
+}
+
+uint32_t SocialGraph::FilterIndexKey(
+    XblPresenceFilter presenceFilter,
+    XblRelationshipFilter relationshipFilter
+) noexcept
+{
+    return (static_cast<uint32_t>(presenceFilter) << 16) | static_cast<uint32_t>(relationshipFilter);
+}
+
+const FilterIndex* SocialGraph::GetFilterIndex(const XblSocialManagerUserGroup& group) const noexcept
+{
+    if (group.type != XblSocialUserGroupType::FilterType)
+    {
+        return nullptr;
+    }
+
+    auto iter{ m_filterIndexes.find(FilterIndexKey(group.presenceFilter, group.relationshipFilter)) };
+    return iter == m_filterIndexes.end() ? nullptr : &iter->second;
+}
+
+void SocialGraph::AddFilterIndexReference(const XblSocialManagerUserGroup& group) noexcept
+{
+    auto& index{ m_filterIndexes[FilterIndexKey(group.presenceFilter, group.relationshipFilter)] };
+    if (index.refCount++ == 0)
+    {
+        // First group using this filter combination, build the index from the current graph
+        index.presenceFilter = group.presenceFilter;
+        index.relationshipFilter = group.relationshipFilter;
+        for (auto& pair : m_profiles)
+        {
+            if (XblSocialManagerUserGroup::MatchesFilter(pair.second.get(), index.presenceFilter, index.relationshipFilter))
+            {
+                index.members[pair.first] = pair.second.get();
+            }
+        }
+    }
+}
+
+void SocialGraph::RemoveFilterIndexReference(const XblSocialManagerUserGroup& group) noexcept
+{
+    auto iter{ m_filterIndexes.find(FilterIndexKey(group.presenceFilter, group.relationshipFilter)) };
+    if (iter != m_filterIndexes.end() && --iter->second.refCount == 0)
+    {
+        m_filterIndexes.erase(iter);
+    }
+}
+
+void SocialGraph::UpdateFilterIndexes(const std::shared_ptr<XblSocialManagerUser>& profile) noexcept
+{
+    for (auto& pair : m_filterIndexes)
+    {
+        auto& index{ pair.second };
+        if (XblSocialManagerUserGroup::MatchesFilter(profile.get(), index.presenceFilter, index.relationshipFilter))
+        {
+            index.members[profile->xboxUserId] = profile.get();
+        }
+        else
+        {
+            index.members.erase(profile->xboxUserId);
+        }
+    }
+}
+
+void SocialGraph::RemoveFromFilterIndexes(uint64_t xuid) noexcept
+{
+    for (auto& pair : m_filterIndexes)
+    {
+        pair.second.members.erase(xuid);
+    }
 }
 
 void SocialGraph::TrackUsers(
@@ -492,7 +581,6 @@ void SocialGraph::PeoplehubResultHandler(
     const Vector<XblSocialManagerUser>& users
 ) noexcept
 {
-    PERF_START();
     std::unique_lock<std::recursive_mutex> lock{ m_mutex };
 
     for (auto& profile : users)
@@ -500,21 +588,19 @@ void SocialGraph::PeoplehubResultHandler(
         auto iter{ m_profiles.find(profile.xboxUserId) };
         if (iter == m_profiles.end())
         {
-            m_pendingUpdates[profile.xboxUserId] = { ProfileChanges::None, MakeShared<XblSocialManagerUser>(profile) };
+            m_pendingUpdates[profile.xboxUserId] = { ProfileChanges::None, ArenaMakeShared<XblMemSubsystem::SocialManager, XblSocialManagerUser>(profile) };
         }
         else if (auto changes = CompareProfiles(*iter->second, profile))
         {
-            m_pendingUpdates[profile.xboxUserId] = { changes, MakeShared<XblSocialManagerUser>(profile) };
+            m_pendingUpdates[profile.xboxUserId] = { changes, ArenaMakeShared<XblMemSubsystem::SocialManager, XblSocialManagerUser>(profile) };
         }
     }
-    PERF_STOP();
 }
 
 void SocialGraph::PresenceResultHandler(
     const Vector<std::shared_ptr<XblPresenceRecord>>& presenceRecords
 ) noexcept
 {
-    PERF_START();
     std::unique_lock<std::recursive_mutex> lock{ m_mutex };
     for (auto& record : presenceRecords)
     {
@@ -542,14 +628,13 @@ void SocialGraph::PresenceResultHandler(
             auto smRecord{ ConvertPresenceRecord(record) };
             if (memcmp(&compareProfile->presenceRecord, &smRecord, sizeof(XblSocialManagerPresenceRecord)))
             {
-                auto updatedProfile = MakeShared<XblSocialManagerUser>(*compareProfile);
+                auto updatedProfile = ArenaMakeShared<XblMemSubsystem::SocialManager, XblSocialManagerUser>(*compareProfile);
                 memcpy(&updatedProfile->presenceRecord, &smRecord, sizeof(XblSocialManagerPresenceRecord));
 
                 m_pendingUpdates[updatedProfile->xboxUserId] = { ProfileChanges::PresenceChanged, updatedProfile };
             }
         }
     }
-    PERF_STOP();
 }
 
 void SocialGraph::SocialRelationshipChangedHandler(
@@ -604,37 +689,35 @@ void SocialGraph::AddOrUpdateEvent(
     XblSocialManagerEventType type,
     const std::shared_ptr<XblSocialManagerUser>& affectedUser,
     Vector<XblSocialManagerEvent>& events,
-    Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers
+    Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers,
+    size_t* openEvents
 ) noexcept
 {
-    PERF_START();
-
     // Update affected users set
     affectedUsers.push_back(affectedUser);
 
-    // Try to update an existing event first
-    for (auto& event : events)
+    // Try to update the open event of this type first. Events are filled in order, so only the most recently
+    // added event of each type can have room left
+    auto& openEvent{ openEvents[static_cast<size_t>(type)] };
+    if (openEvent < events.size())
     {
-        if (event.eventType == type)
+        auto& event{ events[openEvent] };
+        uint8_t affectedUserIndex{ 0 };
+        for (; affectedUserIndex < std::extent<decltype(event.usersAffected)>::value && event.usersAffected[affectedUserIndex]; ++affectedUserIndex);
+        if (affectedUserIndex < std::extent<decltype(event.usersAffected)>::value)
         {
-            uint8_t affectedUserIndex{ 0 };
-            for (; affectedUserIndex < std::extent<decltype(event.usersAffected)>::value && event.usersAffected[affectedUserIndex]; ++affectedUserIndex);
-            if (affectedUserIndex < std::extent<decltype(event.usersAffected)>::value)
-            {
-                event.usersAffected[affectedUserIndex] = affectedUser.get();
-                return;
-            }
+            event.usersAffected[affectedUserIndex] = affectedUser.get();
+            return;
         }
     }
 
     // If we couldn't update an existing event, add a new one
+    openEvent = events.size();
     events.emplace_back();
     auto& newEvent{ events.back() };
     newEvent.eventType = type;
     newEvent.user = m_user->Handle();
     newEvent.usersAffected[0] = affectedUser.get();
-
-    PERF_STOP();
 }
 
 void SocialGraph::ApplyGraphUpdates(
@@ -642,14 +725,25 @@ void SocialGraph::ApplyGraphUpdates(
     _Inout_ Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers
 ) noexcept
 {
-    PERF_START();
-
-    // Apply updates. After initialization, apply at most MAX_GRAPH_UPDATES_PER_FRAME
-    size_t updatesApplied = 0;
-    size_t updateLimit{ m_initialized ? MAX_GRAPH_UPDATES_PER_FRAME : 1000u };
-
-    for (auto updateIter = m_pendingUpdates.begin(); updateIter != m_pendingUpdates.end() && updatesApplied < updateLimit; updateIter = m_pendingUpdates.erase(updateIter), ++updatesApplied)
+    // Index of the event being filled for each graph event type. Events generated by other graphs are never reused
+    size_t openEvents[static_cast<size_t>(XblSocialManagerEventType::SocialRelationshipsChanged) + 1];
+    std::fill(std::begin(openEvents), std::end(openEvents), SIZE_MAX);
+
+    // After initialization, apply updates until the time budget is exhausted. The clock is only sampled every
+    // GRAPH_UPDATE_BUDGET_CHECK_INTERVAL updates to keep the check itself cheap.
+    std::chrono::microseconds budget{ AppConfig::Instance()->SocialGraphUpdateBudgetMicroseconds() };
+    bool const budgeted{ m_initialized && budget.count() > 0 };
+    auto const deadline{ budgeted ? std::chrono::steady_clock::now() + budget : std::chrono::steady_clock::time_point{} };
+
+    size_t updatesApplied{ 0 };
+    for (auto updateIter = m_pendingUpdates.begin(); updateIter != m_pendingUpdates.end(); updateIter = m_pendingUpdates.erase(updateIter), ++updatesApplied)
     {
+        if (budgeted && updatesApplied > 0 && updatesApplied % GRAPH_UPDATE_BUDGET_CHECK_INTERVAL == 0 &&
+            std::chrono::steady_clock::now() >= deadline)
+        {
+            break;
+        }
+
         auto& xuid{ updateIter->first };
         auto trackedUserIter{ m_trackedUsers.find(xuid) };
         auto profileIter{ m_profiles.find(xuid) };
@@ -659,7 +753,8 @@ void SocialGraph::ApplyGraphUpdates(
         // If we are no longer tracking the user remove the profile and add event
         if (trackedUserIter == m_trackedUsers.end() && profileIter != m_profiles.end())
         {
-            AddOrUpdateEvent(XblSocialManagerEventType::UsersRemovedFromSocialGraph, profileIter->second, events, affectedUsers);
+            AddOrUpdateEvent(XblSocialManagerEventType::UsersRemovedFromSocialGraph, profileIter->second, events, affectedUsers, openEvents);
+            RemoveFromFilterIndexes(xuid);
             m_profiles.erase(profileIter);
         }
         else if (updatedProfile) // This could be null in cases where the user is untracked/tracked in the same DoWork cycle
@@ -667,7 +762,7 @@ void SocialGraph::ApplyGraphUpdates(
             // If this is a new profile, generate only a user added event. Otherwise generate depending on the profileChanges
             if (profileIter == m_profiles.end())
             {
-                AddOrUpdateEvent(XblSocialManagerEventType::UsersAddedToSocialGraph, updatedProfile, events, affectedUsers);
+                AddOrUpdateEvent(XblSocialManagerEventType::UsersAddedToSocialGraph, updatedProfile, events, affectedUsers, openEvents);
                 m_profiles.insert({ xuid, updatedProfile });
             }
             else
@@ -675,20 +770,20 @@ void SocialGraph::ApplyGraphUpdates(
                 profileIter->second = updatedProfile;
                 if (profileChanges & ProfileChanges::PresenceChanged)
                 {
-                    AddOrUpdateEvent(XblSocialManagerEventType::PresenceChanged, updatedProfile, events, affectedUsers);
+                    AddOrUpdateEvent(XblSocialManagerEventType::PresenceChanged, updatedProfile, events, affectedUsers, openEvents);
                 }
                 if (profileChanges & ProfileChanges::RelationshipChanged)
                 {
-                    AddOrUpdateEvent(XblSocialManagerEventType::SocialRelationshipsChanged, updatedProfile, events, affectedUsers);
+                    AddOrUpdateEvent(XblSocialManagerEventType::SocialRelationshipsChanged, updatedProfile, events, affectedUsers, openEvents);
                 }
                 if (profileChanges & ProfileChanges::ProfileChanged)
                 {
-                    AddOrUpdateEvent(XblSocialManagerEventType::ProfilesChanged, updatedProfile, events, affectedUsers);
+                    AddOrUpdateEvent(XblSocialManagerEventType::ProfilesChanged, updatedProfile, events, affectedUsers, openEvents);
                 }
             }
+            UpdateFilterIndexes(updatedProfile);
         }
     }
-    PERF_STOP();
 }
 
 ProfileChanges SocialGraph::CompareProfiles(
@@ -774,11 +869,9 @@ TrackedUser::TrackedUser(
     : xuid{ _xuid },
     presenceService{ std::move(_presenceService) }
 {
-    PERF_START();
     HRESULT hr = presenceService->TrackUsers({ xuid });
     assert(SUCCEEDED(hr));
     UNREFERENCED_PARAMETER(hr);
-    PERF_STOP();
 }
 
 TrackedUser::TrackedUser(const TrackedUser& other) noexcept
@@ -788,10 +881,8 @@ TrackedUser::TrackedUser(const TrackedUser& other) noexcept
 
 TrackedUser::~TrackedUser() noexcept
 {
-    PERF_START();
     assert(presenceService);
     presenceService->StopTrackingUsers({ xuid });
-    PERF_STOP();
 }
 
 /// -----------------------------------------------------------------------------------------------
@@ -834,11 +925,18 @@ HRESULT ServiceCallManager::PollPresence(const Vector<uint64_t>& xuids) noexcept
     return S_OK;
 }
 
-HRESULT ServiceCallManager::PollPeopleHub(const Vector<uint64_t>& xuids) noexcept
+HRESULT ServiceCallManager::PollPeopleHub(
+    const Vector<uint64_t>& xuids,
+    HttpCallPriority priority
+) noexcept
 {
     std::unique_lock<std::mutex> lock{ m_mutex };
 
     m_usersPendingPeoplehub.insert(xuids.begin(), xuids.end());
+    if (priority == HttpCallPriority::Interactive)
+    {
+        m_pendingPeoplehubPriority = HttpCallPriority::Interactive;
+    }
     if (!m_peoplehubPollInProgress)
     {
         return PollPeopleHubServiceCall(std::move(lock));
@@ -846,23 +944,27 @@ HRESULT ServiceCallManager::PollPeopleHub(const Vector<uint64_t>& xuids) noexcep
     return S_OK;
 }
 
-HRESULT ServiceCallManager::PeopleHubGetFollowedUsers(PeopleHubResultHandler handler) const noexcept
+HRESULT ServiceCallManager::PeopleHubGetFollowedUsers(
+    PeopleHubResultHandler handler,
+    HttpCallPriority priority
+) const noexcept
 {
     return m_peoplehubService->GetSocialGraph(m_localUserXuid, m_peoplehubDetailLevel, { m_queue,
         [
             weakThis = std::weak_ptr<ServiceCallManager const>{ shared_from_this() },
             this,
-            handler{ std::move(handler) }
+            handler{ std::move(handler) },
+            priority
         ]
     (Result<Vector<XblSocialManagerUser>> result)
     {
         if (Failed(result))
         {
-            m_queue.RunWork([weakThis, this, handler]
+            m_queue.RunWork([weakThis, this, handler, priority]
             {
                 if (auto sharedThis{ weakThis.lock() })
                 {
-                    PeopleHubGetFollowedUsers(handler);
+                    PeopleHubGetFollowedUsers(handler, priority);
                 }
             }, c_failureRetryIntervalMs);
         }
@@ -871,7 +973,7 @@ HRESULT ServiceCallManager::PeopleHubGetFollowedUsers(PeopleHubResultHandler han
             handler(result.ExtractPayload());
         }
     }
-    });
+    }, priority);
 }
 
 HRESULT ServiceCallManager::PollPresenceServiceCall(std::unique_lock<std::mutex> lock) noexcept
@@ -929,7 +1031,7 @@ HRESULT ServiceCallManager::PollPresenceServiceCall(std::unique_lock<std::mutex>
             }
         }
     }
-    });
+    }, HttpCallPriority::Background);
 
     m_presencePollInProgress = true;
     m_usersPendingPresence.clear();
@@ -946,12 +1048,14 @@ HRESULT ServiceCallManager::PollPeopleHubServiceCall(std::unique_lock<std::mutex
     }
 
     Vector<uint64_t> pollXuids{ m_usersPendingPeoplehub.begin(), m_usersPendingPeoplehub.end() };
+    auto priority{ m_pendingPeoplehubPriority };
 
     auto hr = m_peoplehubService->GetSocialUsers(m_localUserXuid, m_peoplehubDetailLevel, pollXuids, { m_queue,
         [
             weakThis = std::weak_ptr<ServiceCallManager>{ shared_from_this() },
             this,
-            pollXuids
+            pollXuids,
+            priority
         ]
     (Result<Vector<XblSocialManagerUser>> result)
     {
@@ -964,6 +1068,10 @@ HRESULT ServiceCallManager::PollPeopleHubServiceCall(std::unique_lock<std::mutex
             {
                 // Ensure failed xuids are retried. Increase poll interval for failures
                 m_usersPendingPeoplehub.insert(pollXuids.begin(), pollXuids.end());
+                if (priority == HttpCallPriority::Interactive)
+                {
+                    m_pendingPeoplehubPriority = HttpCallPriority::Interactive;
+                }
                 interval = c_failureRetryIntervalMs;
             }
             else
@@ -988,10 +1096,11 @@ HRESULT ServiceCallManager::PollPeopleHubServiceCall(std::unique_lock<std::mutex
             }
         }
     }
-    });
+    }, priority);
 
     m_peoplehubPollInProgress = true;
     m_usersPendingPeoplehub.clear();
+    m_pendingPeoplehubPriority = HttpCallPriority::Background;
 
     return hr;
 }
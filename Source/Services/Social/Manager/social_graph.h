@@ -12,11 +12,17 @@
 #undef max
 #endif
 
-// Throttle the maximum number of updates the SocialGraph will process each call to DoWork
-#define MAX_GRAPH_UPDATES_PER_FRAME 5
+// Number of updates the SocialGraph applies between checks of its per DoWork time budget,
+// see AppConfig::SocialGraphUpdateBudgetMicroseconds
+#define GRAPH_UPDATE_BUDGET_CHECK_INTERVAL 16
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
 
+// Graph state is allocated from the SocialManager arena, see XblMemSetArenaPolicy
+template<class K, class V>
+using SocialGraphMap = ArenaUnorderedMap<XblMemSubsystem::SocialManager, K, V>;
+using ProfileMap = SocialGraphMap<uint64_t, std::shared_ptr<XblSocialManagerUser>>;
+
 // Enum describing how a profile has changed
 enum ProfileChanges : uint32_t
 {
@@ -28,6 +34,17 @@ enum ProfileChanges : uint32_t
 
 DEFINE_ENUM_FLAG_OPERATORS(ProfileChanges);
 
+// Secondary index over the graph containing the profiles matching a single presence/relationship filter combination.
+// Indexes are shared by all filter groups using the same combination, so membership is evaluated once per graph
+// change rather than once per group, and groups can be initialized without scanning the full graph.
+struct FilterIndex
+{
+    XblPresenceFilter presenceFilter{ XblPresenceFilter::Unknown };
+    XblRelationshipFilter relationshipFilter{ XblRelationshipFilter::Unknown };
+    uint32_t refCount{ 0 };
+    SocialGraphMap<uint64_t, const XblSocialManagerUser*> members;
+};
+
 // Metadata about a user tracked by SocialGraph. Maintains RTA tracking and counts references within the SocialGraph
 struct TrackedUser
 {
@@ -116,20 +133,31 @@ private:
         _In_ PeoplehubPollMode refreshMode
     ) noexcept;
 
-    // Helper that aggregates events based on graph updates
+    // Helper that aggregates events based on graph updates. 'openEvents' holds, per event type, the index
+    // of the event generated during this pass that still has room for more affected users
     inline void AddOrUpdateEvent(
         XblSocialManagerEventType type,
         const std::shared_ptr<XblSocialManagerUser>& affectedUser,
         Vector<XblSocialManagerEvent>& events,
-        Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers
+        Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers,
+        size_t* openEvents
     ) noexcept;
 
-    // Applies all pending updates to local graph. Updates events and affected users
+    // Applies pending updates to local graph. Updates events and affected users. Once the graph is initialized,
+    // application stops when the time budget is exhausted and remaining updates are applied in later calls.
     void ApplyGraphUpdates(
         _Inout_ Vector<XblSocialManagerEvent>& events,
         _Inout_ Vector<std::shared_ptr<XblSocialManagerUser>>& affectedUsers
     ) noexcept;
 
+    // Filter index maintenance. Indexes are keyed by their presence and relationship filters
+    static uint32_t FilterIndexKey(XblPresenceFilter presenceFilter, XblRelationshipFilter relationshipFilter) noexcept;
+    const FilterIndex* GetFilterIndex(const XblSocialManagerUserGroup& group) const noexcept;
+    void AddFilterIndexReference(const XblSocialManagerUserGroup& group) noexcept;
+    void RemoveFilterIndexReference(const XblSocialManagerUserGroup& group) noexcept;
+    void UpdateFilterIndexes(const std::shared_ptr<XblSocialManagerUser>& profile) noexcept;
+    void RemoveFromFilterIndexes(uint64_t xuid) noexcept;
+
     static ProfileChanges CompareProfiles(
         const XblSocialManagerUser& old,
         const XblSocialManagerUser& updated
@@ -143,13 +171,14 @@ private:
     TaskQueue const m_queue;
 
     // Graph state
-    UnorderedMap<uint64_t, std::shared_ptr<XblSocialManagerUser>> m_profiles;
-    UnorderedMap<uint64_t, TrackedUser> m_trackedUsers;
-    UnorderedMap<uint64_t, std::pair<ProfileChanges, std::shared_ptr<XblSocialManagerUser>>> m_pendingUpdates;
+    ProfileMap m_profiles;
+    SocialGraphMap<uint64_t, TrackedUser> m_trackedUsers;
+    SocialGraphMap<uint64_t, std::pair<ProfileChanges, std::shared_ptr<XblSocialManagerUser>>> m_pendingUpdates;
 
     // Groups. Initialization stage indicates whether or not a group has been initialized yet
     enum GroupInitializationStage{ Pending, Scheduled, Complete };
     Map<std::shared_ptr<XblSocialManagerUserGroup>, GroupInitializationStage> m_groups;
+    SocialGraphMap<uint32_t, FilterIndex> m_filterIndexes;
 
     bool m_presencePollingEnabled{ false };
     bool m_localUserAdded{ false };
@@ -5,15 +5,14 @@
 #include "social_manager_internal.h"
 #include "social_manager_user_group.h"
 #include "social_graph.h"
-#include "perf_tester.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SOCIAL_MANAGER_CPP_BEGIN
 
 SocialManager::SocialManager() noexcept
 {
-    // MAX_GRAPH_UPDATES_PER_FRAME doesn't directly map to a number XblSocialManagerEvents, but it is correlated so
-    // we can use it to preallocate some memory for events nonetheless
-    m_events.reserve(MAX_GRAPH_UPDATES_PER_FRAME * 2);
+    // Graph updates are applied against a time budget rather than a fixed count, so the number of events per DoWork
+    // varies. GRAPH_UPDATE_BUDGET_CHECK_INTERVAL is the fewest updates a graph applies, so preallocate based on that
+    m_events.reserve(GRAPH_UPDATE_BUDGET_CHECK_INTERVAL);
     m_affectedUsersLifetime.reserve(m_events.capacity() * std::extent<decltype(XblSocialManagerEvent::usersAffected)>::value);
 }
 
@@ -160,7 +159,7 @@ HRESULT SocialManager::DestroyUserGroup(
 
 const Vector<XblSocialManagerEvent>& SocialManager::DoWork() noexcept
 {
-    PERF_START();
+    XSAPI_PROFILE_SCOPE(XblProfileArea::SocialManagerDoWork);
     std::unique_lock<std::mutex> eventsLock{ m_eventsMutex };
 
     m_events.clear();
@@ -177,7 +176,6 @@ const Vector<XblSocialManagerEvent>& SocialManager::DoWork() noexcept
         }
     }
 
-    PERF_STOP();
     return m_events;
 }
 
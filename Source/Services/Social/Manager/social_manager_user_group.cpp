@@ -3,7 +3,6 @@
 
 #include "pch.h"
 #include "social_manager_user_group.h"
-#include "perf_tester.h"
 
 using namespace xbox::services;
 using namespace xbox::services::social::manager;
@@ -73,24 +72,39 @@ std::shared_ptr<XblSocialManagerUserGroup> XblSocialManagerUserGroup::Make(
     return group;
 }
 
-void XblSocialManagerUserGroup::Initialize(const UnorderedMap<uint64_t, std::shared_ptr<XblSocialManagerUser>>& graphSnapshot) noexcept
+void XblSocialManagerUserGroup::Initialize(
+    const ProfileMap& graphSnapshot,
+    const FilterIndex* filterIndex
+) noexcept
 {
     std::lock_guard<std::mutex> lock{ m_mutex };
+    ClearUsers();
+
     switch (type)
     {
     case XblSocialUserGroupType::FilterType:
     {
-        for (auto& pair : graphSnapshot)
+        if (filterIndex)
+        {
+            m_users.reserve(filterIndex->members.size());
+            m_usersView.reserve(filterIndex->members.size());
+            m_trackedUsersView.reserve(filterIndex->members.size());
+            for (auto& pair : filterIndex->members)
+            {
+                AddOrUpdateUser(pair.second);
+            }
+        }
+        else
         {
-            if (IsMemberOfGroup(pair.second.get()))
+            // Group was unregistered before initialization ran, so the graph no longer indexes its filters
+            for (auto& pair : graphSnapshot)
             {
-                m_users[pair.first] = pair.second.get();
+                if (MatchesFilter(pair.second.get(), presenceFilter, relationshipFilter))
+                {
+                    AddOrUpdateUser(pair.second.get());
+                }
             }
         }
-        // Do allocations for view structures now, but don't actually populate them until they
-        // are requested.
-        m_usersView.reserve(m_users.size());
-        m_trackedUsersView.reserve(m_users.size());
         break;
     }
     case XblSocialUserGroupType::UserListType:
@@ -100,7 +114,7 @@ void XblSocialManagerUserGroup::Initialize(const UnorderedMap<uint64_t, std::sha
             auto graphIter{ graphSnapshot.find(xuid) };
             if (graphIter != graphSnapshot.end())
             {
-                m_users[xuid] = graphIter->second.get();
+                AddOrUpdateUser(graphIter->second.get());
             }
         }
         break;
@@ -113,15 +127,17 @@ void XblSocialManagerUserGroup::Initialize(const UnorderedMap<uint64_t, std::sha
 }
 
 void XblSocialManagerUserGroup::DoWork(
-    _Inout_ Vector<XblSocialManagerEvent>& events
+    _Inout_ Vector<XblSocialManagerEvent>& events,
+    _In_ size_t firstGraphEvent,
+    _In_opt_ const FilterIndex* filterIndex
 ) noexcept
 {
-    PERF_START();
     std::lock_guard<std::mutex> lock{ m_mutex };
 
     // Update users based on graph events
-    for (auto& event : events)
+    for (size_t eventIndex = firstGraphEvent; eventIndex < events.size(); ++eventIndex)
     {
+        auto& event{ events[eventIndex] };
         switch (event.eventType)
         {
         case XblSocialManagerEventType::ProfilesChanged:
@@ -131,13 +147,13 @@ void XblSocialManagerUserGroup::DoWork(
         {
             for (uint8_t i = 0; i < std::extent<decltype(event.usersAffected)>::value && event.usersAffected[i]; ++i)
             {
-                if (IsMemberOfGroup(event.usersAffected[i]))
+                if (IsMemberOfGroup(event.usersAffected[i], filterIndex))
                 {
-                    m_users[event.usersAffected[i]->xboxUserId] = event.usersAffected[i];
+                    AddOrUpdateUser(event.usersAffected[i]);
                 }
                 else
                 {
-                    m_users.erase(event.usersAffected[i]->xboxUserId);
+                    RemoveUser(event.usersAffected[i]->xboxUserId);
                 }
             }
             break;
@@ -146,7 +162,7 @@ void XblSocialManagerUserGroup::DoWork(
         {
             for (uint8_t i = 0; i < std::extent<decltype(event.usersAffected)>::value && event.usersAffected[i]; ++i)
             {
-                m_users.erase(event.usersAffected[i]->xboxUserId);
+                RemoveUser(event.usersAffected[i]->xboxUserId);
             }
             break;
         }
@@ -195,55 +211,75 @@ void XblSocialManagerUserGroup::DoWork(
         }
         }
     }
-    PERF_STOP();
 }
 
 const Vector<const XblSocialManagerUser*>& XblSocialManagerUserGroup::Users() noexcept
 {
-    PERF_START();
     std::unique_lock<std::mutex> lock{ m_mutex };
-    m_usersView.clear();
-    if (m_loaded)
-    {
-        std::transform(m_users.begin(), m_users.end(), std::back_inserter(m_usersView), [](const auto& pair)
-        {
-            return pair.second;
-        });
-    }
-    PERF_STOP();
-    return m_usersView;
+    return m_loaded ? m_usersView : m_emptyUsersView;
 }
 
 const Vector<uint64_t>& XblSocialManagerUserGroup::TrackedUsers() noexcept
 {
-    PERF_START();
+    // For Filter groups the view is maintained alongside the users view. For List groups it is static
     std::unique_lock<std::mutex> lock{ m_mutex };
-    if (m_loaded)
+    return m_loaded ? m_trackedUsersView : m_emptyTrackedUsersView;
+}
+
+void XblSocialManagerUserGroup::AddOrUpdateUser(XblSocialManagerUser const* user) noexcept
+{
+    auto iter{ m_users.find(user->xboxUserId) };
+    if (iter != m_users.end())
     {
-        switch (type)
-        {
-        case XblSocialUserGroupType::FilterType:
+        m_usersView[iter->second] = user;
+    }
+    else
+    {
+        m_users[user->xboxUserId] = m_usersView.size();
+        m_usersView.push_back(user);
+        if (type == XblSocialUserGroupType::FilterType)
         {
-            m_trackedUsersView.clear();
-            std::transform(m_users.begin(), m_users.end(), std::back_inserter(m_trackedUsersView), [](const auto& pair)
-                {
-                    return pair.first;
-                });
-            break;
+            m_trackedUsersView.push_back(user->xboxUserId);
         }
-        case XblSocialUserGroupType::UserListType:
+    }
+}
+
+void XblSocialManagerUserGroup::RemoveUser(uint64_t xuid) noexcept
+{
+    auto iter{ m_users.find(xuid) };
+    if (iter == m_users.end())
+    {
+        return;
+    }
+
+    // Move the last user into the vacated position
+    size_t position{ iter->second };
+    m_users.erase(iter);
+
+    if (position != m_usersView.size() - 1)
+    {
+        m_usersView[position] = m_usersView.back();
+        m_users[m_usersView[position]->xboxUserId] = position;
+        if (type == XblSocialUserGroupType::FilterType)
         {
-            // Tracked users view is static
-            break;
-        }
+            m_trackedUsersView[position] = m_trackedUsersView.back();
         }
     }
-    else
+    m_usersView.pop_back();
+    if (type == XblSocialUserGroupType::FilterType)
+    {
+        m_trackedUsersView.pop_back();
+    }
+}
+
+void XblSocialManagerUserGroup::ClearUsers() noexcept
+{
+    m_users.clear();
+    m_usersView.clear();
+    if (type == XblSocialUserGroupType::FilterType)
     {
         m_trackedUsersView.clear();
     }
-    PERF_STOP();
-    return m_trackedUsersView;
 }
 
 std::shared_ptr<User> XblSocialManagerUserGroup::LocalUser() const noexcept
@@ -276,7 +312,7 @@ HRESULT XblSocialManagerUserGroup::UpdateTrackedUsers(
         m_trackedUsersView = trackedUsers;
         m_trackedUsers.clear();
         m_trackedUsers.insert(m_trackedUsersView.begin(), m_trackedUsersView.end());
-        m_users.clear();
+        ClearUsers();
 
         // Register again to retrigger initialization
         graph->RegisterGroup(shared_from_this());
@@ -293,56 +329,21 @@ HRESULT XblSocialManagerUserGroup::UpdateTrackedUsers(
     }
 }
 
-bool XblSocialManagerUserGroup::IsMemberOfGroup(XblSocialManagerUser const* user) const noexcept
+bool XblSocialManagerUserGroup::IsMemberOfGroup(
+    XblSocialManagerUser const* user,
+    const FilterIndex* filterIndex
+) const noexcept
 {
     switch (type)
     {
     case XblSocialUserGroupType::FilterType:
     {
-        if ((relationshipFilter == XblRelationshipFilter::Friends && !user->isFollowedByCaller) ||
-            (relationshipFilter == XblRelationshipFilter::Favorite && !user->isFavorite))
-        {
-            return false;
-        }
-
-        switch (presenceFilter)
-        {
-        case XblPresenceFilter::All:
+        // The graph keeps the index up to date as it applies changes
+        if (filterIndex)
         {
-            return true;
+            return filterIndex->members.find(user->xboxUserId) != filterIndex->members.end();
         }
-        case XblPresenceFilter::AllOffline:
-        {
-            return user->presenceRecord.userState == XblPresenceUserState::Offline;
-        }
-        case XblPresenceFilter::AllOnline:
-        {
-            return user->presenceRecord.userState == XblPresenceUserState::Online;
-        }
-        case XblPresenceFilter::AllTitle:
-        {
-            return user->titleHistory.hasUserPlayed;
-        }
-        case XblPresenceFilter::TitleOffline:
-        {
-            return user->titleHistory.hasUserPlayed && user->presenceRecord.userState == XblPresenceUserState::Offline;
-        }
-        case XblPresenceFilter::TitleOnline:
-        {
-            return XblSocialManagerPresenceRecordIsUserPlayingTitle(&user->presenceRecord, AppConfig::Instance()->TitleId());
-        }
-        case XblPresenceFilter::TitleOnlineOutsideTitle:
-        {
-            return user->titleHistory.hasUserPlayed &&
-                user->presenceRecord.userState == XblPresenceUserState::Online &&
-                !XblSocialManagerPresenceRecordIsUserPlayingTitle(&user->presenceRecord, AppConfig::Instance()->TitleId());
-        }
-        default:
-        {
-            return false;
-        }
-        }
-        return true;
+        return MatchesFilter(user, presenceFilter, relationshipFilter);
     }
     case XblSocialUserGroupType::UserListType:
     {
@@ -355,3 +356,54 @@ bool XblSocialManagerUserGroup::IsMemberOfGroup(XblSocialManagerUser const* user
     }
     }
 }
+
+bool XblSocialManagerUserGroup::MatchesFilter(
+    const XblSocialManagerUser* user,
+    XblPresenceFilter presenceFilter,
+    XblRelationshipFilter relationshipFilter
+) noexcept
+{
+    if ((relationshipFilter == XblRelationshipFilter::Friends && !user->isFollowedByCaller) ||
+        (relationshipFilter == XblRelationshipFilter::Favorite && !user->isFavorite))
+    {
+        return false;
+    }
+
+    switch (presenceFilter)
+    {
+    case XblPresenceFilter::All:
+    {
+        return true;
+    }
+    case XblPresenceFilter::AllOffline:
+    {
+        return user->presenceRecord.userState == XblPresenceUserState::Offline;
+    }
+    case XblPresenceFilter::AllOnline:
+    {
+        return user->presenceRecord.userState == XblPresenceUserState::Online;
+    }
+    case XblPresenceFilter::AllTitle:
+    {
+        return user->titleHistory.hasUserPlayed;
+    }
+    case XblPresenceFilter::TitleOffline:
+    {
+        return user->titleHistory.hasUserPlayed && user->presenceRecord.userState == XblPresenceUserState::Offline;
+    }
+    case XblPresenceFilter::TitleOnline:
+    {
+        return XblSocialManagerPresenceRecordIsUserPlayingTitle(&user->presenceRecord, AppConfig::Instance()->TitleId());
+    }
+    case XblPresenceFilter::TitleOnlineOutsideTitle:
+    {
+        return user->titleHistory.hasUserPlayed &&
+            user->presenceRecord.userState == XblPresenceUserState::Online &&
+            !XblSocialManagerPresenceRecordIsUserPlayingTitle(&user->presenceRecord, AppConfig::Instance()->TitleId());
+    }
+    default:
+    {
+        return false;
+    }
+    }
+}
@@ -24,13 +24,28 @@ public:
 
     ~XblSocialManagerUserGroup() noexcept;
 
-    // Initializes the group based on the current state of the SocialGraph.
-    void Initialize(const UnorderedMap<uint64_t, std::shared_ptr<XblSocialManagerUser>>& profiles) noexcept;
+    // Initializes the group based on the current state of the SocialGraph. Filter groups are initialized
+    // from the graph's index for their filter combination rather than by scanning all profiles.
+    void Initialize(
+        const xbox::services::social::manager::ProfileMap& profiles,
+        const xbox::services::social::manager::FilterIndex* filterIndex
+    ) noexcept;
 
     // Updates user and tracked user list based on graph changes since last DoWork call.
-    // Input events vector contains events generated by graph changes since the previous DoWork call.
+    // Input events vector contains events generated by graph changes since the previous DoWork call, starting at 'firstGraphEvent'.
     // Output events vector will also contain SocialUserGroupLoaded/Updated events if applicable.
-    void DoWork(_Inout_ Vector<XblSocialManagerEvent>& events) noexcept;
+    void DoWork(
+        _Inout_ Vector<XblSocialManagerEvent>& events,
+        _In_ size_t firstGraphEvent,
+        _In_opt_ const xbox::services::social::manager::FilterIndex* filterIndex
+    ) noexcept;
+
+    // Whether a user belongs in a filter group with the provided filters
+    static bool MatchesFilter(
+        const XblSocialManagerUser* user,
+        XblPresenceFilter presenceFilter,
+        XblRelationshipFilter relationshipFilter
+    ) noexcept;
 
     // Properties of the group
     XblSocialUserGroupType const type;
@@ -63,16 +78,27 @@ private:
         Vector<uint64_t>&& trackedUsers
     ) noexcept;
 
-    bool IsMemberOfGroup(XblSocialManagerUser const* user) const noexcept;
+    bool IsMemberOfGroup(
+        XblSocialManagerUser const* user,
+        const xbox::services::social::manager::FilterIndex* filterIndex
+    ) const noexcept;
+
+    // Maintain the users view incrementally so that Users() and TrackedUsers() don't rebuild it on each call
+    void AddOrUpdateUser(XblSocialManagerUser const* user) noexcept;
+    void RemoveUser(uint64_t xuid) noexcept;
+    void ClearUsers() noexcept;
 
     std::shared_ptr<User> m_localUser;
     std::weak_ptr<xbox::services::social::manager::SocialGraph> m_graph;
 
-    // Public views of users/trackedUesrs
+    // Public views of users/trackedUesrs. For Filter groups, m_trackedUsersView is kept parallel to m_usersView
     Vector<const XblSocialManagerUser*> m_usersView;
     Vector<uint64_t> m_trackedUsersView;
+    Vector<const XblSocialManagerUser*> const m_emptyUsersView;
+    Vector<uint64_t> const m_emptyTrackedUsersView;
 
-    UnorderedMap<uint64_t, XblSocialManagerUser const*> m_users;
+    // Maps xuid to the user's position in m_usersView
+    xbox::services::social::manager::SocialGraphMap<uint64_t, size_t> m_users;
     UnorderedSet<uint64_t> m_trackedUsers;
 
     bool m_loaded{ false };
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "xsapi-c/title_storage_c.h"
 #include "title_storage_internal.h"
+#include "title_storage_cache.h"
 #include "xbox_live_context_internal.h"
 
 using namespace xbox::services;
@@ -400,6 +401,63 @@ try
 }
 CATCH_RETURN()
 
+STDAPI XblTitleStorageSetDownloadParallelism(
+    _In_ XblContextHandle xboxLiveContext,
+    _In_ uint32_t maxConcurrentBlocks
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(xboxLiveContext == nullptr || maxConcurrentBlocks == 0);
+    VERIFY_XBL_INITIALIZED();
+
+    xboxLiveContext->TitleStorageService()->SetDownloadParallelism(maxConcurrentBlocks);
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblTitleStorageSetCacheBudget(
+    _In_ size_t budgetInBytes
+) XBL_NOEXCEPT
+try
+{
+    VERIFY_XBL_INITIALIZED();
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return E_XBL_NOT_INITIALIZED;
+    }
+
+    state->TitleStorageCache()->SetBudget(budgetInBytes);
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblTitleStorageGetCacheStats(
+    _Out_ XblTitleStorageCacheStats* stats
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF_NULL(stats);
+    VERIFY_XBL_INITIALIZED();
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return E_XBL_NOT_INITIALIZED;
+    }
+
+    auto cacheStats{ state->TitleStorageCache()->GetStats() };
+    *stats = XblTitleStorageCacheStats{
+        cacheStats.hits,
+        cacheStats.misses,
+        cacheStats.updates,
+        cacheStats.evictions,
+        cacheStats.bytesSaved,
+        cacheStats.bytesStored
+    };
+    return S_OK;
+}
+CATCH_RETURN()
+
 STDAPI XblTitleStorageUploadBlobAsync(
     _In_ XblContextHandle xboxLiveContext,
     _In_ XblTitleStorageBlobMetadata blobMetadata,
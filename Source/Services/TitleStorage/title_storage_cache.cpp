@@ -0,0 +1,572 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "title_storage_cache.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
+
+const char TITLE_STORAGE_CACHE_INDEX_KEY[] = "titlestorage_cache.json";
+
+size_t TitleStorageCache::Budget() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_budget;
+}
+
+void TitleStorageCache::SetBudget(size_t budgetInBytes) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_budget = budgetInBytes;
+
+    // Storage can only be reached through the user it belongs to, so each user's entries are deleted the next time
+    // they use title storage rather than through whichever user happened to use the cache last
+    if (m_budget == 0)
+    {
+        for (auto& pair : m_users)
+        {
+            pair.second.clearPending = true;
+        }
+    }
+}
+
+bool TitleStorageCache::IsEnabled(const User& user) noexcept
+{
+    if (Budget() > 0)
+    {
+        return true;
+    }
+
+    ClearIfDisabled(user);
+    return false;
+}
+
+void TitleStorageCache::ClearIfDisabled(const User& user) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        auto& cache{ CacheFor(user.Xuid()) };
+        if (m_budget > 0 || !cache.clearPending)
+        {
+            return;
+        }
+        cache.clearPending = false;
+    }
+
+    auto userCopy{ user.Copy() };
+    if (Failed(userCopy) || !Storage())
+    {
+        return;
+    }
+
+    // The index is loaded first, so the entries persisted by an earlier launch are deleted too
+    auto sharedUser{ MakeShared<User>(userCopy.ExtractPayload()) };
+    WhenLoaded(user, [sharedThis{ shared_from_this() }, sharedUser]()
+    {
+        std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+        auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+        while (!cache.entries.empty())
+        {
+            Remove(*sharedUser, cache, cache.entries.begin());
+        }
+
+        auto storage{ Storage() };
+        if (storage)
+        {
+            storage->ClearAsync(*sharedUser, TITLE_STORAGE_CACHE_INDEX_KEY, nullptr);
+        }
+    });
+}
+
+void TitleStorageCache::GetETag(
+    const User& user,
+    const String& key,
+    Callback<String> callback
+) noexcept
+{
+    WhenLoaded(user, [sharedThis{ shared_from_this() }, xuid{ user.Xuid() }, key, callback]()
+    {
+        String eTag;
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+            auto& cache{ sharedThis->CacheFor(xuid) };
+            auto iter{ cache.entries.find(key) };
+            if (iter != cache.entries.end())
+            {
+                eTag = iter->second.eTag;
+            }
+            else
+            {
+                ++sharedThis->m_stats.misses;
+            }
+        }
+        callback(std::move(eTag));
+    });
+}
+
+void TitleStorageCache::Read(
+    const User& user,
+    const String& key,
+    uint8_t* buffer,
+    size_t bufferSize,
+    Callback<Result<size_t>> callback
+) noexcept
+{
+    auto userCopy{ user.Copy() };
+    if (Failed(userCopy) || !Storage())
+    {
+        callback(Result<size_t>{ Failed(userCopy) ? userCopy.Hresult() : E_XBL_NOT_INITIALIZED });
+        return;
+    }
+
+    auto sharedUser{ MakeShared<User>(userCopy.ExtractPayload()) };
+    WhenLoaded(user, [sharedThis{ shared_from_this() }, sharedUser, key, buffer, bufferSize, callback]()
+    {
+        uint64_t id{ 0 };
+        size_t size{ 0 };
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+            auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+            auto iter{ cache.entries.find(key) };
+            if (iter == cache.entries.end())
+            {
+                callback(Result<size_t>{ E_FAIL });
+                return;
+            }
+            id = iter->second.id;
+            size = iter->second.size;
+        }
+
+        if (size > bufferSize)
+        {
+            callback(Result<size_t>{ E_BOUNDS });
+            return;
+        }
+
+        // Copied straight from storage into the caller's buffer, without a Vector in between where the platform allows
+        auto storage{ Storage() };
+        if (!storage)
+        {
+            callback(Result<size_t>{ E_XBL_NOT_INITIALIZED });
+            return;
+        }
+
+        auto bytesRead{ MakeShared<size_t>(0) };
+        HRESULT hr = storage->ReadInPlaceAsync(*sharedUser, DataKey(id),
+            [buffer, bufferSize, bytesRead](const uint8_t* data, size_t dataSize) -> HRESULT
+            {
+                if (dataSize > bufferSize)
+                {
+                    return E_BOUNDS;
+                }
+                if (dataSize > 0)
+                {
+                    memcpy(buffer, data, dataSize);
+                }
+                *bytesRead = dataSize;
+                return S_OK;
+            },
+            [sharedThis, sharedUser, key, id, size, bytesRead, callback](HRESULT hr)
+            {
+                if (SUCCEEDED(hr) && *bytesRead != size)
+                {
+                    hr = E_FAIL;
+                }
+
+                if (FAILED(hr))
+                {
+                    sharedThis->RemoveAndSave(*sharedUser, key, id);
+                    callback(Result<size_t>{ hr });
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                    ++sharedThis->m_stats.hits;
+                    sharedThis->m_stats.bytesSaved += size;
+
+                    auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+                    Touch(cache, key);
+                    SaveIndex(*sharedUser, cache);
+                }
+                callback(Result<size_t>{ size, S_OK });
+            });
+
+        if (FAILED(hr))
+        {
+            callback(Result<size_t>{ hr });
+        }
+    });
+}
+
+void TitleStorageCache::Read(
+    const User& user,
+    const String& key,
+    Callback<Result<Vector<uint8_t>>> callback
+) noexcept
+{
+    auto userCopy{ user.Copy() };
+    if (Failed(userCopy) || !Storage())
+    {
+        callback(Result<Vector<uint8_t>>{ Failed(userCopy) ? userCopy.Hresult() : E_XBL_NOT_INITIALIZED });
+        return;
+    }
+
+    auto sharedUser{ MakeShared<User>(userCopy.ExtractPayload()) };
+    WhenLoaded(user, [sharedThis{ shared_from_this() }, sharedUser, key, callback]()
+    {
+        uint64_t id{ 0 };
+        size_t size{ 0 };
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+            auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+            auto iter{ cache.entries.find(key) };
+            if (iter == cache.entries.end())
+            {
+                callback(Result<Vector<uint8_t>>{ E_FAIL });
+                return;
+            }
+            id = iter->second.id;
+            size = iter->second.size;
+        }
+
+        auto storage{ Storage() };
+        if (!storage)
+        {
+            callback(Result<Vector<uint8_t>>{ E_XBL_NOT_INITIALIZED });
+            return;
+        }
+
+        HRESULT hr = storage->ReadAsync(*sharedUser, DataKey(id),
+            [sharedThis, sharedUser, key, id, size, callback](Result<Vector<uint8_t>> result)
+            {
+                if (Succeeded(result) && result.Payload().size() != size)
+                {
+                    result = Result<Vector<uint8_t>>{ E_FAIL };
+                }
+
+                if (Failed(result))
+                {
+                    sharedThis->RemoveAndSave(*sharedUser, key, id);
+                    callback(std::move(result));
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+                    ++sharedThis->m_stats.hits;
+                    sharedThis->m_stats.bytesSaved += size;
+
+                    auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+                    Touch(cache, key);
+                    SaveIndex(*sharedUser, cache);
+                }
+                callback(std::move(result));
+            });
+
+        if (FAILED(hr))
+        {
+            callback(Result<Vector<uint8_t>>{ hr });
+        }
+    });
+}
+
+void TitleStorageCache::Store(
+    const User& user,
+    const String& key,
+    const String& eTag,
+    Vector<uint8_t>&& data
+) noexcept
+{
+    auto userCopy{ user.Copy() };
+    if (Failed(userCopy) || !Storage() || eTag.empty() || data.size() > Budget())
+    {
+        return;
+    }
+
+    auto sharedUser{ MakeShared<User>(userCopy.ExtractPayload()) };
+    auto sharedData{ MakeShared<Vector<uint8_t>>(std::move(data)) };
+    WhenLoaded(user, [sharedThis{ shared_from_this() }, sharedUser, key, eTag, sharedData]()
+    {
+        uint64_t id{ 0 };
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+            id = sharedThis->CacheFor(sharedUser->Xuid()).nextId++;
+        }
+
+        // The entry is only added to the index once its data has been written, so the index never refers to a
+        // partially written file
+        auto storage{ Storage() };
+        if (!storage)
+        {
+            return;
+        }
+
+        size_t size{ sharedData->size() };
+        storage->WriteAsync(*sharedUser, XblLocalStorageWriteMode::Truncate, DataKey(id), std::move(*sharedData),
+            [sharedThis, sharedUser, key, eTag, id, size](Result<size_t> result)
+            {
+                std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+                if (Failed(result))
+                {
+                    return;
+                }
+
+                auto& cache{ sharedThis->CacheFor(sharedUser->Xuid()) };
+                auto iter{ cache.entries.find(key) };
+                if (iter != cache.entries.end())
+                {
+                    ++sharedThis->m_stats.updates;
+                    Remove(*sharedUser, cache, iter);
+                }
+
+                cache.entries[key] = Entry{ id, eTag, size, ++cache.clock };
+                cache.size += size;
+                sharedThis->Trim(*sharedUser, cache);
+                SaveIndex(*sharedUser, cache);
+            });
+    });
+}
+
+TitleStorageCache::Stats TitleStorageCache::GetStats() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    Stats stats{ m_stats };
+    for (const auto& pair : m_users)
+    {
+        stats.bytesStored += pair.second.size;
+    }
+    return stats;
+}
+
+void TitleStorageCache::WhenLoaded(
+    const User& user,
+    Callback<> work
+) noexcept
+{
+    bool loaded{ false };
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        auto& cache{ CacheFor(user.Xuid()) };
+        switch (cache.loadState)
+        {
+        case LoadState::Loaded:
+        {
+            // Applies a budget lowered since the last use
+            Trim(user, cache);
+            loaded = true;
+            break;
+        }
+        case LoadState::Loading:
+        {
+            cache.loadWaiters.push_back(std::move(work));
+            return;
+        }
+        case LoadState::NotLoaded:
+        default:
+        {
+            cache.loadState = LoadState::Loading;
+            cache.loadWaiters.push_back(std::move(work));
+            break;
+        }
+        }
+    }
+
+    if (loaded)
+    {
+        work();
+        return;
+    }
+
+    auto complete = [sharedThis{ shared_from_this() }, xuid{ user.Xuid() }](const Vector<uint8_t>* data)
+    {
+        Vector<Callback<>> waiters;
+        {
+            std::lock_guard<std::mutex> lock{ sharedThis->m_mutex };
+
+            auto& cache{ sharedThis->CacheFor(xuid) };
+            if (data)
+            {
+                LoadIndex(cache, *data);
+            }
+            cache.loadState = LoadState::Loaded;
+            waiters = std::move(cache.loadWaiters);
+            cache.loadWaiters.clear();
+        }
+
+        for (auto& waiter : waiters)
+        {
+            waiter();
+        }
+    };
+
+    // A missing or unreadable index leaves the cache empty. Data files it doesn't know about are overwritten as
+    // new entries reuse their ids.
+    std::shared_ptr<system::LocalStorage> storage{ Storage() };
+    HRESULT hr = storage ? storage->ReadAsync(user, TITLE_STORAGE_CACHE_INDEX_KEY,
+        [complete](Result<Vector<uint8_t>> result)
+        {
+            complete(Succeeded(result) ? &result.Payload() : nullptr);
+        }) : E_XBL_NOT_INITIALIZED;
+
+    if (FAILED(hr))
+    {
+        complete(nullptr);
+    }
+}
+
+TitleStorageCache::UserCache& TitleStorageCache::CacheFor(uint64_t xuid) noexcept
+{
+    return m_users[xuid];
+}
+
+void TitleStorageCache::LoadIndex(UserCache& cache, const Vector<uint8_t>& data) noexcept
+{
+    JsonDocument json;
+    json.Parse(String{ data.begin(), data.end() }.c_str());
+    if (json.HasParseError() || !json.IsObject() || !json.HasMember("entries") || !json["entries"].IsArray())
+    {
+        return;
+    }
+
+    JsonUtils::ExtractJsonUInt64(json, "nextId", cache.nextId);
+    JsonUtils::ExtractJsonUInt64(json, "clock", cache.clock);
+
+    for (const auto& entryJson : json["entries"].GetArray())
+    {
+        String key;
+        Entry entry{};
+        uint64_t size{ 0 };
+        JsonUtils::ExtractJsonString(entryJson, "key", key);
+        JsonUtils::ExtractJsonUInt64(entryJson, "id", entry.id);
+        JsonUtils::ExtractJsonString(entryJson, "eTag", entry.eTag);
+        JsonUtils::ExtractJsonUInt64(entryJson, "size", size);
+        JsonUtils::ExtractJsonUInt64(entryJson, "lastUsed", entry.lastUsed);
+        entry.size = static_cast<size_t>(size);
+
+        if (!key.empty() && entry.id != 0 && !entry.eTag.empty())
+        {
+            cache.nextId = (std::max)(cache.nextId, entry.id + 1);
+            cache.size += entry.size;
+            cache.entries[key] = std::move(entry);
+        }
+    }
+}
+
+void TitleStorageCache::SaveIndex(const User& user, const UserCache& cache) noexcept
+{
+    JsonDocument json{ rapidjson::kObjectType };
+    auto& allocator{ json.GetAllocator() };
+    json.AddMember("nextId", JsonValue{ cache.nextId }, allocator);
+    json.AddMember("clock", JsonValue{ cache.clock }, allocator);
+
+    JsonValue entriesJson{ rapidjson::kArrayType };
+    for (const auto& pair : cache.entries)
+    {
+        JsonValue entryJson{ rapidjson::kObjectType };
+        entryJson.AddMember("key", JsonValue{ pair.first.c_str(), allocator }.Move(), allocator);
+        entryJson.AddMember("id", JsonValue{ pair.second.id }, allocator);
+        entryJson.AddMember("eTag", JsonValue{ pair.second.eTag.c_str(), allocator }.Move(), allocator);
+        entryJson.AddMember("size", JsonValue{ static_cast<uint64_t>(pair.second.size) }, allocator);
+        entryJson.AddMember("lastUsed", JsonValue{ pair.second.lastUsed }, allocator);
+        entriesJson.PushBack(entryJson, allocator);
+    }
+    json.AddMember("entries", entriesJson, allocator);
+
+    // Queued while m_mutex is held, so the index is written in the order it changed
+    auto storage{ Storage() };
+    if (!storage)
+    {
+        return;
+    }
+
+    auto serializedIndex{ JsonUtils::SerializeJson(json) };
+    storage->WriteAsync(
+        user,
+        XblLocalStorageWriteMode::Truncate,
+        TITLE_STORAGE_CACHE_INDEX_KEY,
+        Vector<uint8_t>{ serializedIndex.begin(), serializedIndex.end() },
+        nullptr
+    );
+}
+
+void TitleStorageCache::Remove(const User& user, UserCache& cache, Map<String, Entry>::iterator iter) noexcept
+{
+    auto storage{ Storage() };
+    if (storage)
+    {
+        storage->ClearAsync(user, DataKey(iter->second.id), nullptr);
+    }
+    cache.size -= iter->second.size;
+    cache.entries.erase(iter);
+}
+
+void TitleStorageCache::Trim(const User& user, UserCache& cache) noexcept
+{
+    bool trimmed{ false };
+    while (cache.size > m_budget && !cache.entries.empty())
+    {
+        auto leastRecentlyUsed{ cache.entries.begin() };
+        for (auto iter = cache.entries.begin(); iter != cache.entries.end(); ++iter)
+        {
+            if (iter->second.lastUsed < leastRecentlyUsed->second.lastUsed)
+            {
+                leastRecentlyUsed = iter;
+            }
+        }
+
+        ++m_stats.evictions;
+        Remove(user, cache, leastRecentlyUsed);
+        trimmed = true;
+    }
+
+    if (trimmed)
+    {
+        SaveIndex(user, cache);
+    }
+}
+
+void TitleStorageCache::Touch(UserCache& cache, const String& key) noexcept
+{
+    auto iter{ cache.entries.find(key) };
+    if (iter != cache.entries.end())
+    {
+        iter->second.lastUsed = ++cache.clock;
+    }
+}
+
+void TitleStorageCache::RemoveAndSave(const User& user, const String& key, uint64_t id) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    // The entry may have been replaced while it was being read
+    auto& cache{ CacheFor(user.Xuid()) };
+    auto iter{ cache.entries.find(key) };
+    if (iter != cache.entries.end() && iter->second.id == id)
+    {
+        Remove(user, cache, iter);
+        SaveIndex(user, cache);
+    }
+}
+
+String TitleStorageCache::DataKey(uint64_t id) noexcept
+{
+    Stringstream key;
+    key << "titlestorage_cache_" << id << ".bin";
+    return key.str();
+}
+
+std::shared_ptr<system::LocalStorage> TitleStorageCache::Storage() noexcept
+{
+    auto state{ GlobalState::Get() };
+    return state ? state->LocalStorage() : nullptr;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
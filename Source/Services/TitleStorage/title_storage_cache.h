@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
+
+// Persistent cache of title storage downloads, kept in LocalStorage so it survives between launches. Each entry
+// holds the response and the ETag it was served with. Entries are never trusted without asking the service: the
+// next request for a cached key is sent with If-None-Match, and only a 304 response is served from disk.
+//
+// LocalStorage handlers may keep each user's data separately, so every user has their own index and entries, and
+// storage is only ever accessed through the user the data belongs to.
+//
+// Each user's stored bytes are bounded by the budget, evicting the least recently used entries first. The cache is
+// disabled while the budget is zero, which is the default. A user's entries are deleted from storage the first time
+// they use title storage while the cache is disabled.
+class TitleStorageCache : public std::enable_shared_from_this<TitleStorageCache>
+{
+public:
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t updates;
+        uint64_t evictions;
+        uint64_t bytesSaved;
+        uint64_t bytesStored;
+    };
+
+    size_t Budget() const noexcept;
+    // Lowering the budget evicts entries the next time each user uses the cache. A budget of zero deletes each
+    // user's entries and index the next time IsEnabled is called for them.
+    void SetBudget(size_t budgetInBytes) noexcept;
+
+    // While the cache is disabled, the first call for a user also deletes anything the cache holds for them
+    bool IsEnabled(const User& user) noexcept;
+
+    // Calls callback with the ETag stored for key, or an empty string if there isn't an entry
+    void GetETag(
+        const User& user,
+        const String& key,
+        Callback<String> callback
+    ) noexcept;
+
+    // Copies the stored response for key into buffer, and passes back its size. Fails with
+    // E_BOUNDS if it doesn't fit. An entry that can't be read is removed.
+    void Read(
+        const User& user,
+        const String& key,
+        uint8_t* buffer,
+        size_t bufferSize,
+        Callback<Result<size_t>> callback
+    ) noexcept;
+
+    void Read(
+        const User& user,
+        const String& key,
+        Callback<Result<Vector<uint8_t>>> callback
+    ) noexcept;
+
+    // Replaces the entry for key once data has been written
+    void Store(
+        const User& user,
+        const String& key,
+        const String& eTag,
+        Vector<uint8_t>&& data
+    ) noexcept;
+
+    Stats GetStats() const noexcept;
+
+private:
+    struct Entry
+    {
+        uint64_t id;
+        String eTag;
+        size_t size;
+        uint64_t lastUsed;
+    };
+
+    enum class LoadState
+    {
+        NotLoaded,
+        Loading,
+        Loaded
+    };
+
+    // The part of the cache kept in one user's storage
+    struct UserCache
+    {
+        size_t size{ 0 };
+        Map<String, Entry> entries;
+        uint64_t nextId{ 1 };
+        uint64_t clock{ 0 };
+        LoadState loadState{ LoadState::NotLoaded };
+        Vector<Callback<>> loadWaiters;
+        bool clearPending{ true };
+    };
+
+    // Runs work once the user's index has been read from storage
+    void WhenLoaded(
+        const User& user,
+        Callback<> work
+    ) noexcept;
+
+    // Deletes the user's entries and index if the cache is disabled and they haven't been cleared since
+    void ClearIfDisabled(const User& user) noexcept;
+
+    // Must be called with m_mutex held
+    UserCache& CacheFor(uint64_t xuid) noexcept;
+    static void LoadIndex(UserCache& cache, const Vector<uint8_t>& data) noexcept;
+    static void SaveIndex(const User& user, const UserCache& cache) noexcept;
+    static void Remove(const User& user, UserCache& cache, Map<String, Entry>::iterator iter) noexcept;
+    void Trim(const User& user, UserCache& cache) noexcept;
+    static void Touch(UserCache& cache, const String& key) noexcept;
+    void RemoveAndSave(const User& user, const String& key, uint64_t id) noexcept;
+
+    static String DataKey(uint64_t id) noexcept;
+    static std::shared_ptr<system::LocalStorage> Storage() noexcept;
+
+    mutable std::mutex m_mutex;
+    size_t m_budget{ 0 };
+    Map<uint64_t, UserCache> m_users;
+    Stats m_stats{};
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
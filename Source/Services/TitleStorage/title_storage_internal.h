@@ -8,6 +8,7 @@
 NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
 
 class TitleStorageService;
+class TitleStorageCache;
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
 
@@ -101,6 +102,10 @@ public:
         _In_ size_t preferredUploadBlockSize,
         _In_ AsyncContext<Result<XblTitleStorageBlobMetadata>> async
     );
+
+    void SetDownloadParallelism(
+        _In_ uint32_t maxConcurrentBlocks
+    );
 private:
 
     struct BlobArgs
@@ -114,17 +119,150 @@ private:
         size_t preferredBlockSize{ 0 };
         size_t startByte{ 0 };
         AsyncContext<Result<XblTitleStorageBlobMetadata>> async;
+
+        // Uploads of more than one block persist their progress under this key, so an interrupted upload of the
+        // same blob can resume after the blocks the service already has. initialETag is the ETag the caller passed
+        // in, which a resumed upload must have been started with.
+        xsapi_internal_string uploadStateKey;
+        uint32_t uploadChecksum{ 0 };
+        xsapi_internal_string initialETag;
+        bool resumedUpload{ false };
+
+        // Set when the download may be served from the disk cache. While cachedETag is set, the first request is
+        // sent with If-None-Match and a 304 response is read from the cache.
+        xsapi_internal_string cacheKey;
+        xsapi_internal_string cachedETag;
+    };
+
+    struct BlobMetadataArgs
+    {
+        xsapi_internal_string scid;
+        uint64_t xuid{ 0 };
+        XblTitleStorageType storageType{};
+        xsapi_internal_string blobPath;
+        xsapi_internal_string subpath;
+        AsyncContext<Result<std::shared_ptr<XblTitleStorageBlobMetadataResult>>> async;
+
+        xsapi_internal_string cacheKey;
+        xsapi_internal_string cachedETag;
+    };
+
+    HRESULT GetBlobMetadataHelper(
+        _In_ std::shared_ptr<BlobMetadataArgs> blobMetadataArgs
+    );
+
+    // Once the length of a binary blob is known, its remaining blocks are downloaded as independent ranges,
+    // up to m_downloadParallelism at a time. libHttpClient buffers each response body, which is then copied once
+    // into the caller's buffer at the range's offset. A range that fails or comes back short is requested again
+    // from where it stopped.
+    struct RangedDownload
+    {
+        std::shared_ptr<BlobArgs> args;
+        xsapi_internal_string etag;
+        size_t length{ 0 };
+        std::mutex mutex;
+        // Ranges still to be requested, as [start, end) byte offsets
+        xsapi_internal_vector<std::pair<size_t, size_t>> pendingRanges;
+        uint32_t rangesInFlight{ 0 };
+        uint32_t retriesRemaining{ 0 };
+        HRESULT result{ S_OK };
+        bool completed{ false };
     };
 
     HRESULT DownloadBlobHelper(
         _In_ std::shared_ptr<BlobArgs> downloadBlobArgs
     );
 
+    void DownloadRanges(
+        _In_ std::shared_ptr<RangedDownload> download
+    );
+
+    HRESULT DownloadRange(
+        _In_ std::shared_ptr<RangedDownload> download,
+        _In_ size_t startByte,
+        _In_ size_t endByte
+    );
+
+    void CompleteRange(
+        _In_ std::shared_ptr<RangedDownload> download,
+        _In_ size_t startByte,
+        _In_ size_t endByte,
+        _In_ size_t bytesReceived,
+        _In_ HRESULT hr,
+        _In_ bool retriable
+    );
+
+    HRESULT CreateDownloadCall(
+        _In_ const BlobArgs& args,
+        _Out_ std::shared_ptr<XblHttpCall>& httpCall
+    );
+
+    static size_t ContentRangeLength(
+        _In_ const xsapi_internal_string& contentRange
+    );
+
+    // Stores a completed download in the disk cache if it was eligible for caching
+    void CacheBlob(
+        _In_ const BlobArgs& downloadBlobArgs
+    );
+
+    // Returns null while the disk cache is disabled
+    std::shared_ptr<TitleStorageCache> EnabledCache();
+
     HRESULT UploadBlobHelper(
         _In_ std::shared_ptr<BlobArgs> uploadBlobArgs,
         _In_ const xsapi_internal_string& continuationToken
     );
 
+    HRESULT ResumeUpload(
+        _In_ std::shared_ptr<BlobArgs> uploadBlobArgs
+    );
+
+    // Returns the continuation token to resume with, or an empty string if the saved state doesn't apply. Saved
+    // state for the same blob that doesn't apply, or that has expired, is cleared.
+    xsapi_internal_string LoadUploadState(
+        _In_ BlobArgs& uploadBlobArgs,
+        _In_ const Vector<uint8_t>& data
+    );
+
+    void SaveUploadState(
+        _In_ const BlobArgs& uploadBlobArgs,
+        _In_ const xsapi_internal_string& continuationToken
+    );
+
+    void ClearUploadState(
+        _In_ const BlobArgs& uploadBlobArgs
+    );
+
+    // Clears expired state left by uploads that were interrupted and never retried. Runs on the first upload made
+    // through this service, and skips the slot of the upload in progress.
+    void ClearExpiredUploadStates(
+        _In_ const xsapi_internal_string& activeUploadStateKey
+    );
+
+    static bool IsUploadStateExpired(
+        _In_ const JsonValue& uploadState
+    );
+
+    static xsapi_internal_string UploadStateIdentity(
+        _In_ const XblTitleStorageBlobMetadata& blobMetadata
+    );
+
+    static xsapi_internal_string UploadStateKey(
+        _In_ uint64_t xuid,
+        _In_ uint32_t slot
+    );
+
+    static xsapi_internal_string UploadStateKey(
+        _In_ uint64_t xuid,
+        _In_ const XblTitleStorageBlobMetadata& blobMetadata
+    );
+
+    // Upload state is kept in a fixed number of slots per user, so interrupted uploads can't accumulate in
+    // LocalStorage. Saved state older than c_uploadStateMaxAgeInSeconds isn't resumed.
+    static constexpr uint32_t c_uploadStateSlotCount{ 8 };
+    static constexpr uint64_t c_uploadStateMaxAgeInSeconds{ 24 * 60 * 60 };
+
     static Result<xsapi_internal_string> TitleStorageQuotaSubpath(
         _In_ XblTitleStorageType storageType,
         _In_ const xsapi_internal_string& serviceConfigurationId,
@@ -171,6 +309,8 @@ private:
 
     User m_user;
     std::shared_ptr<xbox::services::XboxLiveContextSettings> m_xboxLiveContextSettings;
+    std::atomic<uint32_t> m_downloadParallelism{ XBL_TITLE_STORAGE_DEFAULT_DOWNLOAD_PARALLELISM };
+    std::atomic<bool> m_expiredUploadStatesCleared{ false };
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "title_storage_internal.h"
+#include "title_storage_cache.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
 
@@ -12,6 +13,8 @@ const char IF_MATCH_HEADER_NAME[] = "If-Match";
 const char IF_NONE_HEADER_NAME[] = "If-None-Match";
 const char E_TAG_INVALID_VALUE[] = "InvalidETagValue";
 const char RANGE_HEADER_NAME[] = "Range";
+const char CONTENT_RANGE_HEADER_NAME[] = "Content-Range";
+const uint32_t MAX_DOWNLOAD_RANGE_RETRIES = 3;
  
 TitleStorageService::TitleStorageService(
     _In_ User&& user,
@@ -139,6 +142,39 @@ TitleStorageService::GetBlobMetadata(
 
     RETURN_HR_INVALIDARGUMENT_IF(!Succeeded(subpath));
 
+    auto args = MakeShared<BlobMetadataArgs>();
+    args->scid = scid;
+    args->xuid = xuid;
+    args->storageType = storageType;
+    args->blobPath = blobPath;
+    args->subpath = subpath.ExtractPayload();
+    args->async = std::move(async);
+
+    auto cache{ EnabledCache() };
+    if (cache)
+    {
+        args->cacheKey = "metadata:" + args->subpath;
+        cache->GetETag(m_user, args->cacheKey, [sharedThis{ shared_from_this() }, args](String eTag)
+        {
+            args->cachedETag = std::move(eTag);
+
+            HRESULT hr = sharedThis->GetBlobMetadataHelper(args);
+            if (FAILED(hr))
+            {
+                args->async.Complete(hr);
+            }
+        });
+        return S_OK;
+    }
+
+    return GetBlobMetadataHelper(args);
+}
+
+HRESULT
+TitleStorageService::GetBlobMetadataHelper(
+    _In_ std::shared_ptr<BlobMetadataArgs> args
+)
+{
     Result<User> userResult = m_user.Copy();
     RETURN_HR_IF_FAILED(userResult.Hresult());
 
@@ -146,26 +182,60 @@ TitleStorageService::GetBlobMetadata(
     HRESULT hr = httpCall->Init(
         m_xboxLiveContextSettings,
         "GET",
-        XblHttpCall::BuildUrl("titlestorage", subpath.Payload()),
+        XblHttpCall::BuildUrl("titlestorage", args->subpath),
         xbox_live_api::get_blob_metadata
     );
 
     RETURN_HR_IF_FAILED(hr);
 
+    if (!args->cachedETag.empty())
+    {
+        RETURN_HR_IF_FAILED(SetEtagHeader(httpCall, args->cachedETag, XblTitleStorageETagMatchCondition::IfNotMatch));
+    }
+
     hr = httpCall->Perform(
         AsyncContext<HttpResult>{
-        async.Queue(),
+        args->async.Queue(),
             [
-                sharedThis{ shared_from_this() }, 
-                scid, 
-                xuid, 
-                storageType, 
-                blobPath, 
-                async
+                sharedThis{ shared_from_this() },
+                args
             ]
         (HttpResult httpResult)
         {
             HRESULT hr = httpResult.Hresult();
+            auto state{ GlobalState::Get() };
+            auto cache{ state ? state->TitleStorageCache() : nullptr };
+            if (SUCCEEDED(hr) && !args->cachedETag.empty() && cache && httpResult.Payload()->HttpStatus() == 304)
+            {
+                // The cached page is current. If it can't be read, request it again without the ETag.
+                args->cachedETag.clear();
+                cache->Read(sharedThis->m_user, args->cacheKey, [sharedThis, args](Result<Vector<uint8_t>> cached)
+                {
+                    if (Succeeded(cached))
+                    {
+                        JsonDocument json;
+                        json.Parse(String{ cached.Payload().begin(), cached.Payload().end() }.c_str());
+                        if (!json.HasParseError())
+                        {
+                            auto result = XblTitleStorageBlobMetadataResult::Deserialize(json);
+                            if (Succeeded(result))
+                            {
+                                result.Payload()->Initialize(sharedThis, args->scid, args->xuid, args->storageType, args->blobPath);
+                                args->async.Complete(result);
+                                return;
+                            }
+                        }
+                    }
+
+                    HRESULT hr = sharedThis->GetBlobMetadataHelper(args);
+                    if (FAILED(hr))
+                    {
+                        args->async.Complete(hr);
+                    }
+                });
+                return;
+            }
+
             if (SUCCEEDED(hr))
             {
                 hr = httpResult.Payload()->Result();
@@ -174,15 +244,26 @@ TitleStorageService::GetBlobMetadata(
                     auto result = XblTitleStorageBlobMetadataResult::Deserialize(httpResult.Payload()->GetResponseBodyJson());
                     if (Succeeded(result))
                     {
-                        result.Payload()->Initialize(sharedThis, scid, xuid, storageType, blobPath);
+                        result.Payload()->Initialize(sharedThis, args->scid, args->xuid, args->storageType, args->blobPath);
+
+                        // The page can only be cached if the service gave it an ETag to revalidate with
+                        if (!args->cacheKey.empty() && cache)
+                        {
+                            cache->Store(
+                                sharedThis->m_user,
+                                args->cacheKey,
+                                httpResult.Payload()->GetResponseHeader(ETAG_HEADER),
+                                httpResult.Payload()->GetResponseBodyBytes()
+                            );
+                        }
                     }
-                    async.Complete(result);
+                    args->async.Complete(result);
                 }
             }
 
             if (!SUCCEEDED(hr))
             {
-                async.Complete(hr);
+                args->async.Complete(hr);
             }
         }});
 
@@ -280,6 +361,24 @@ TitleStorageService::DownloadBlob(
     args->startByte = 0;
     args->async = std::move(async);
 
+    // Downloads that set their own match condition bypass the cache, since its revalidation would replace it
+    auto cache{ EnabledCache() };
+    if (cache && etagMatchCondition == XblTitleStorageETagMatchCondition::NotUsed)
+    {
+        args->cacheKey = "blob:" + subpath.Payload();
+        cache->GetETag(m_user, args->cacheKey, [sharedThis{ shared_from_this() }, args](String eTag)
+        {
+            args->cachedETag = std::move(eTag);
+
+            HRESULT hr = sharedThis->DownloadBlobHelper(args);
+            if (FAILED(hr))
+            {
+                args->async.Complete(hr);
+            }
+        });
+        return S_OK;
+    }
+
     return DownloadBlobHelper(args);
 }
 
@@ -290,30 +389,22 @@ HRESULT TitleStorageService::DownloadBlobHelper(
     RETURN_HR_INVALIDARGUMENT_IF_NULL(args->downloadBlobBuffer);
     RETURN_HR_INVALIDARGUMENT_IF(args->blobBufferSize < args->blobMetadata.length);
 
-    Result<xsapi_internal_string> subpath = TitleStorageDownloadBlobSubpath(args->blobMetadata, args->selectQuery);
-
-    RETURN_HR_INVALIDARGUMENT_IF(!Succeeded(subpath));
-
-    Result<User> userResult = m_user.Copy();
-    RETURN_HR_IF_FAILED(userResult.Hresult());
-
-    auto httpCall = MakeShared<XblHttpCall>(userResult.ExtractPayload());
-    HRESULT hr = httpCall->Init(
-        m_xboxLiveContextSettings,
-        "GET",
-        XblHttpCall::BuildUrl("titlestorage", subpath.Payload()),
-        xbox_live_api::download_blob
-    );
+    std::shared_ptr<XblHttpCall> httpCall;
+    HRESULT hr = CreateDownloadCall(*args, httpCall);
     RETURN_HR_IF_FAILED(hr);
-    
-    RETURN_HR_IF_FAILED(httpCall->SetHeader(CONTENT_TYPE_HEADER, CONTENT_TYPE_HEADER_VALUE));
-    httpCall->SetLongHttpCall(true);
 
-    hr = SetEtagHeader(
-        httpCall,
-        args->blobMetadata.eTag,
-        args->etagMatchCondition
-    );
+    if (args->startByte == 0 && !args->cachedETag.empty())
+    {
+        hr = SetEtagHeader(httpCall, args->cachedETag, XblTitleStorageETagMatchCondition::IfNotMatch);
+    }
+    else
+    {
+        hr = SetEtagHeader(
+            httpCall,
+            args->blobMetadata.eTag,
+            args->etagMatchCondition
+        );
+    }
     RETURN_HR_IF_FAILED(hr);
 
     if (args->blobMetadata.blobType == XblTitleStorageBlobType::Binary)
@@ -336,36 +427,100 @@ HRESULT TitleStorageService::DownloadBlobHelper(
             ](HttpResult httpResult)
             {
                 HRESULT hr = httpResult.Hresult();
+                auto state{ GlobalState::Get() };
+                auto cache{ state ? state->TitleStorageCache() : nullptr };
+                if (SUCCEEDED(hr) && !args->cachedETag.empty() && cache && httpResult.Payload()->HttpStatus() == 304)
+                {
+                    // The cached copy is current. If it can't be read, download the blob without the ETag.
+                    auto cachedETag{ std::move(args->cachedETag) };
+                    args->cachedETag.clear();
+                    cache->Read(sharedThis->m_user, args->cacheKey, args->downloadBlobBuffer, args->blobBufferSize,
+                        [args, cachedETag, sharedThis](Result<size_t> cached)
+                        {
+                            if (Succeeded(cached))
+                            {
+                                utils::strcpy(args->blobMetadata.eTag, cachedETag.length() + 1, cachedETag.c_str());
+                                args->blobMetadata.length = cached.Payload();
+                                args->async.Complete(std::move(args->blobMetadata));
+                                return;
+                            }
+
+                            HRESULT hr = sharedThis->DownloadBlobHelper(args);
+                            if (FAILED(hr))
+                            {
+                                args->async.Complete(hr);
+                            }
+                        });
+                    return;
+                }
+
                 if (SUCCEEDED(hr))
                 {
                     hr = httpResult.Payload()->Result();
 
+                    size_t responseBodySize{ 0 };
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = httpResult.Payload()->GetResponseBodyBytesSize(&responseBodySize);
+                    }
+
                     if (SUCCEEDED(hr))
                     {
-                        auto responseBody = httpResult.Payload()->GetResponseBodyBytes();
-                        if (args->startByte + responseBody.size() > args->blobBufferSize)
+                        if (args->startByte + responseBodySize > args->blobBufferSize)
                         {
                             args->async.Complete(E_NOT_SUFFICIENT_BUFFER);
                             return;
                         }
 
-                        memcpy(args->downloadBlobBuffer + args->startByte, responseBody.data(), responseBody.size());
-                        
-                        args->startByte += responseBody.size();
+                        hr = httpResult.Payload()->GetResponseBodyBytes(responseBodySize, args->downloadBlobBuffer + args->startByte, nullptr);
+                    }
+
+                    if (SUCCEEDED(hr))
+                    {
+                        args->startByte += responseBodySize;
+                        auto etag = httpResult.Payload()->GetResponseHeader(ETAG_HEADER);
+
+                        size_t length{ args->blobMetadata.length };
+                        if (args->blobMetadata.blobType == XblTitleStorageBlobType::Binary)
+                        {
+                            size_t contentRangeLength = ContentRangeLength(httpResult.Payload()->GetResponseHeader(CONTENT_RANGE_HEADER_NAME));
+                            length = contentRangeLength > 0 ? contentRangeLength : length;
+                        }
 
                         // Check if there is more data to load
                         // If not binary blob type then the service has returned the entire payload.
                         // If binary blob type then check if the service returned less data than requested or
-                        // if we've loaded all the data defined by the blob metadata length property.
+                        // if we've loaded all the data defined by the blob length.
                         if (args->blobMetadata.blobType != XblTitleStorageBlobType::Binary ||
-                            responseBody.size() < args->preferredBlockSize ||
-                            args->startByte == args->blobMetadata.length)
+                            responseBodySize < args->preferredBlockSize ||
+                            args->startByte == length)
                         {
-                            auto etag = httpResult.Payload()->GetResponseHeader(ETAG_HEADER);
                             utils::strcpy(args->blobMetadata.eTag, etag.length() + 1, etag.c_str());
                             args->blobMetadata.length = args->startByte;
+                            sharedThis->CacheBlob(*args);
                             args->async.Complete(std::move(args->blobMetadata));
                         }
+                        else if (length > args->startByte)
+                        {
+                            if (length > args->blobBufferSize)
+                            {
+                                args->async.Complete(E_NOT_SUFFICIENT_BUFFER);
+                                return;
+                            }
+
+                            // With the length known, the rest of the blob can be requested as independent ranges
+                            auto download = MakeShared<RangedDownload>();
+                            download->args = args;
+                            download->etag = etag;
+                            download->length = length;
+                            download->retriesRemaining = MAX_DOWNLOAD_RANGE_RETRIES;
+                            for (size_t startByte = args->startByte; startByte < length; startByte += args->preferredBlockSize)
+                            {
+                                download->pendingRanges.emplace_back(startByte, (std::min)(startByte + args->preferredBlockSize, length));
+                            }
+
+                            sharedThis->DownloadRanges(download);
+                        }
                         else
                         {
                             hr = sharedThis->DownloadBlobHelper(args);
@@ -380,6 +535,247 @@ HRESULT TitleStorageService::DownloadBlobHelper(
             }});
 }
 
+void TitleStorageService::DownloadRanges(
+    _In_ std::shared_ptr<RangedDownload> download
+    )
+{
+    xsapi_internal_vector<std::pair<size_t, size_t>> ranges;
+    {
+        std::lock_guard<std::mutex> lock{ download->mutex };
+
+        while (SUCCEEDED(download->result) &&
+            !download->pendingRanges.empty() &&
+            download->rangesInFlight < m_downloadParallelism)
+        {
+            ranges.push_back(download->pendingRanges.front());
+            download->pendingRanges.erase(download->pendingRanges.begin());
+            ++download->rangesInFlight;
+        }
+    }
+
+    for (const auto& range : ranges)
+    {
+        HRESULT hr = DownloadRange(download, range.first, range.second);
+        if (FAILED(hr))
+        {
+            std::lock_guard<std::mutex> lock{ download->mutex };
+            --download->rangesInFlight;
+            download->result = SUCCEEDED(download->result) ? hr : download->result;
+        }
+    }
+
+    bool complete{ false };
+    {
+        std::lock_guard<std::mutex> lock{ download->mutex };
+
+        // After a failure, the download completes once the ranges already in flight have returned
+        if (!download->completed &&
+            download->rangesInFlight == 0 &&
+            (FAILED(download->result) || download->pendingRanges.empty()))
+        {
+            download->completed = true;
+            complete = true;
+        }
+    }
+
+    if (complete)
+    {
+        auto& args{ *download->args };
+        if (SUCCEEDED(download->result))
+        {
+            utils::strcpy(args.blobMetadata.eTag, download->etag.length() + 1, download->etag.c_str());
+            args.blobMetadata.length = download->length;
+            CacheBlob(args);
+            args.async.Complete(std::move(args.blobMetadata));
+        }
+        else
+        {
+            args.async.Complete(download->result);
+        }
+    }
+}
+
+HRESULT TitleStorageService::DownloadRange(
+    _In_ std::shared_ptr<RangedDownload> download,
+    _In_ size_t startByte,
+    _In_ size_t endByte
+    )
+{
+    const auto& args{ *download->args };
+
+    std::shared_ptr<XblHttpCall> httpCall;
+    HRESULT hr = CreateDownloadCall(args, httpCall);
+    RETURN_HR_IF_FAILED(hr);
+
+    // Every range must come from the version of the blob the first block came from
+    if (!download->etag.empty())
+    {
+        hr = SetEtagHeader(httpCall, download->etag, XblTitleStorageETagMatchCondition::IfMatch);
+    }
+    else
+    {
+        hr = SetEtagHeader(httpCall, args.blobMetadata.eTag, args.etagMatchCondition);
+    }
+    RETURN_HR_IF_FAILED(hr);
+
+    hr = SetRangeHeader(httpCall, startByte, endByte - 1);
+    RETURN_HR_IF_FAILED(hr);
+
+    return httpCall->Perform(
+        AsyncContext<HttpResult>{
+            args.async.Queue(),
+            [
+                download,
+                startByte,
+                endByte,
+                sharedThis{ shared_from_this() }
+            ](HttpResult httpResult)
+            {
+                size_t bytesReceived{ 0 };
+                bool retriable{ false };
+
+                HRESULT hr = httpResult.Hresult();
+                if (SUCCEEDED(hr))
+                {
+                    hr = httpResult.Payload()->Result();
+
+                    // Network errors have no status. XblHttpCall has already retried the statuses that call for it.
+                    retriable = FAILED(hr) && httpResult.Payload()->HttpStatus() == 0;
+
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = httpResult.Payload()->GetResponseBodyBytesSize(&bytesReceived);
+                    }
+
+                    if (SUCCEEDED(hr) && bytesReceived > endByte - startByte)
+                    {
+                        hr = E_UNEXPECTED;
+                    }
+
+                    if (SUCCEEDED(hr))
+                    {
+                        hr = httpResult.Payload()->GetResponseBodyBytes(bytesReceived, download->args->downloadBlobBuffer + startByte, nullptr);
+                    }
+                }
+
+                sharedThis->CompleteRange(download, startByte, endByte, bytesReceived, hr, retriable);
+            }});
+}
+
+void TitleStorageService::CompleteRange(
+    _In_ std::shared_ptr<RangedDownload> download,
+    _In_ size_t startByte,
+    _In_ size_t endByte,
+    _In_ size_t bytesReceived,
+    _In_ HRESULT hr,
+    _In_ bool retriable
+    )
+{
+    {
+        std::lock_guard<std::mutex> lock{ download->mutex };
+        --download->rangesInFlight;
+
+        if (SUCCEEDED(hr) && bytesReceived == 0)
+        {
+            // The range is inside the blob, so an empty response would never make progress
+            hr = E_UNEXPECTED;
+        }
+
+        if (SUCCEEDED(hr))
+        {
+            if (startByte + bytesReceived < endByte)
+            {
+                // Resume a short response from where it stopped
+                download->pendingRanges.emplace_back(startByte + bytesReceived, endByte);
+            }
+        }
+        else if (retriable && download->retriesRemaining > 0)
+        {
+            --download->retriesRemaining;
+            download->pendingRanges.emplace_back(startByte, endByte);
+        }
+        else if (SUCCEEDED(download->result))
+        {
+            download->result = hr;
+        }
+    }
+
+    DownloadRanges(download);
+}
+
+HRESULT TitleStorageService::CreateDownloadCall(
+    _In_ const BlobArgs& args,
+    _Out_ std::shared_ptr<XblHttpCall>& httpCall
+    )
+{
+    Result<xsapi_internal_string> subpath = TitleStorageDownloadBlobSubpath(args.blobMetadata, args.selectQuery);
+
+    RETURN_HR_INVALIDARGUMENT_IF(!Succeeded(subpath));
+
+    Result<User> userResult = m_user.Copy();
+    RETURN_HR_IF_FAILED(userResult.Hresult());
+
+    httpCall = MakeShared<XblHttpCall>(userResult.ExtractPayload());
+    HRESULT hr = httpCall->Init(
+        m_xboxLiveContextSettings,
+        "GET",
+        XblHttpCall::BuildUrl("titlestorage", subpath.Payload()),
+        xbox_live_api::download_blob
+    );
+    RETURN_HR_IF_FAILED(hr);
+
+    RETURN_HR_IF_FAILED(httpCall->SetHeader(CONTENT_TYPE_HEADER, CONTENT_TYPE_HEADER_VALUE));
+    httpCall->SetLongHttpCall(true);
+
+    return S_OK;
+}
+
+void TitleStorageService::CacheBlob(
+    _In_ const BlobArgs& args
+    )
+{
+    auto cache{ EnabledCache() };
+    if (cache && !args.cacheKey.empty())
+    {
+        cache->Store(
+            m_user,
+            args.cacheKey,
+            args.blobMetadata.eTag,
+            Vector<uint8_t>{ args.downloadBlobBuffer, args.downloadBlobBuffer + args.blobMetadata.length }
+        );
+    }
+}
+
+std::shared_ptr<TitleStorageCache> TitleStorageService::EnabledCache()
+{
+    auto state{ GlobalState::Get() };
+    if (!state || !state->TitleStorageCache()->IsEnabled(m_user))
+    {
+        return nullptr;
+    }
+    return state->TitleStorageCache();
+}
+
+void TitleStorageService::SetDownloadParallelism(
+    _In_ uint32_t maxConcurrentBlocks
+    )
+{
+    m_downloadParallelism = (std::max)(1u, (std::min)(maxConcurrentBlocks, static_cast<uint32_t>(XBL_TITLE_STORAGE_MAX_DOWNLOAD_PARALLELISM)));
+}
+
+size_t TitleStorageService::ContentRangeLength(
+    _In_ const xsapi_internal_string& contentRange
+    )
+{
+    // bytes <first>-<last>/<length>, where the length is * if the service doesn't know it
+    size_t separator = contentRange.rfind('/');
+    if (separator == xsapi_internal_string::npos)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(strtoull(contentRange.c_str() + separator + 1, nullptr, 10));
+}
+
 HRESULT
 TitleStorageService::UploadBlob(
     _In_ XblTitleStorageBlobMetadata blobMetadata,
@@ -417,9 +813,281 @@ TitleStorageService::UploadBlob(
         args->blobMetadata.xboxUserId = m_user.Xuid();
     }
 
+    if (args->blobMetadata.blobType == XblTitleStorageBlobType::Binary && blobBufferSize > preferredUploadBlockSize)
+    {
+        args->uploadStateKey = UploadStateKey(m_user.Xuid(), args->blobMetadata);
+    }
+
+    if (!m_expiredUploadStatesCleared.exchange(true))
+    {
+        ClearExpiredUploadStates(args->uploadStateKey);
+    }
+
+    if (!args->uploadStateKey.empty())
+    {
+        // Uploads of more than one block may be picking up from an earlier attempt that was interrupted
+        return ResumeUpload(args);
+    }
+
     return UploadBlobHelper(args, "");
 }
 
+constexpr uint32_t TitleStorageService::c_uploadStateSlotCount;
+constexpr uint64_t TitleStorageService::c_uploadStateMaxAgeInSeconds;
+
+HRESULT
+TitleStorageService::ResumeUpload(
+    _In_ std::shared_ptr<BlobArgs> args
+    )
+{
+    args->initialETag = args->blobMetadata.eTag;
+
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return UploadBlobHelper(args, "");
+    }
+
+    return state->LocalStorage()->ReadAsync(
+        m_user,
+        args->uploadStateKey,
+        [
+            args,
+            sharedThis{ shared_from_this() }
+        ](Result<Vector<uint8_t>> result)
+        {
+            xsapi_internal_string continuationToken;
+            if (Succeeded(result) && !result.Payload().empty())
+            {
+                continuationToken = sharedThis->LoadUploadState(*args, result.Payload());
+            }
+
+            HRESULT hr = sharedThis->UploadBlobHelper(args, continuationToken);
+            if (FAILED(hr))
+            {
+                args->async.Complete(hr);
+            }
+        });
+}
+
+xsapi_internal_string
+TitleStorageService::LoadUploadState(
+    _In_ BlobArgs& args,
+    _In_ const Vector<uint8_t>& data
+    )
+{
+    JsonDocument json;
+    json.Parse(xsapi_internal_string{ data.begin(), data.end() }.c_str());
+    if (json.HasParseError() || !json.IsObject())
+    {
+        ClearUploadState(args);
+        return xsapi_internal_string{};
+    }
+
+    xsapi_internal_string blob;
+    JsonUtils::ExtractJsonString(json, "blob", blob);
+    if (blob != UploadStateIdentity(args.blobMetadata))
+    {
+        // The slot holds the state of another blob's upload, which is left for that blob unless it has expired
+        if (IsUploadStateExpired(json))
+        {
+            ClearUploadState(args);
+        }
+        return xsapi_internal_string{};
+    }
+
+    uint64_t length{ 0 };
+    uint64_t bytesUploaded{ 0 };
+    uint64_t checksum{ 0 };
+    uint64_t etagMatchCondition{ 0 };
+    xsapi_internal_string initialETag;
+    xsapi_internal_string etag;
+    xsapi_internal_string continuationToken;
+    JsonUtils::ExtractJsonUInt64(json, "length", length);
+    JsonUtils::ExtractJsonUInt64(json, "bytesUploaded", bytesUploaded);
+    JsonUtils::ExtractJsonUInt64(json, "checksum", checksum);
+    JsonUtils::ExtractJsonUInt64(json, "eTagMatchCondition", etagMatchCondition);
+    JsonUtils::ExtractJsonString(json, "initialETag", initialETag);
+    JsonUtils::ExtractJsonString(json, "eTag", etag);
+    JsonUtils::ExtractJsonString(json, "continuationToken", continuationToken);
+
+    // The earlier attempt's ETag condition was checked against the blob as it was before that attempt. It is only
+    // continued if the caller is asking for the same condition.
+    bool sameCondition = etagMatchCondition == static_cast<uint64_t>(args.etagMatchCondition) && initialETag == args.initialETag;
+
+    if (IsUploadStateExpired(json) ||
+        !sameCondition ||
+        length != args.blobBufferSize ||
+        bytesUploaded == 0 ||
+        bytesUploaded >= length ||
+        continuationToken.empty() ||
+        etag.length() >= XBL_TITLE_STORAGE_BLOB_ETAG_MAX_LENGTH)
+    {
+        ClearUploadState(args);
+        return xsapi_internal_string{};
+    }
+
+    // Only pick up where the earlier attempt stopped if the part it uploaded is still what the caller is uploading
+    uint32_t uploadedChecksum = utils::crc32(args.uploadBlobBuffer, static_cast<size_t>(bytesUploaded));
+    if (uploadedChecksum != checksum)
+    {
+        ClearUploadState(args);
+        return xsapi_internal_string{};
+    }
+
+    // The remaining blocks are sent with the ETag of the last block the service accepted, as they would have been
+    // had the earlier attempt not been interrupted
+    LOGS_DEBUG << "Resuming title storage upload of " << args.blobMetadata.blobPath << " at byte " << bytesUploaded;
+
+    args.startByte = static_cast<size_t>(bytesUploaded);
+    args.uploadChecksum = uploadedChecksum;
+    args.resumedUpload = true;
+    utils::strcpy(args.blobMetadata.eTag, etag.length() + 1, etag.c_str());
+    return continuationToken;
+}
+
+void
+TitleStorageService::SaveUploadState(
+    _In_ const BlobArgs& args,
+    _In_ const xsapi_internal_string& continuationToken
+    )
+{
+    auto state{ GlobalState::Get() };
+    if (!state || args.uploadStateKey.empty())
+    {
+        return;
+    }
+
+    JsonDocument json{ rapidjson::kObjectType };
+    auto& allocator{ json.GetAllocator() };
+    json.AddMember("blob", JsonValue{ UploadStateIdentity(args.blobMetadata).c_str(), allocator }.Move(), allocator);
+    json.AddMember("length", JsonValue{ static_cast<uint64_t>(args.blobBufferSize) }, allocator);
+    json.AddMember("bytesUploaded", JsonValue{ static_cast<uint64_t>(args.startByte) }, allocator);
+    json.AddMember("checksum", JsonValue{ static_cast<uint64_t>(args.uploadChecksum) }, allocator);
+    json.AddMember("eTagMatchCondition", JsonValue{ static_cast<uint64_t>(args.etagMatchCondition) }, allocator);
+    json.AddMember("initialETag", JsonValue{ args.initialETag.c_str(), allocator }.Move(), allocator);
+    json.AddMember("eTag", JsonValue{ args.blobMetadata.eTag, allocator }.Move(), allocator);
+    json.AddMember("continuationToken", JsonValue{ continuationToken.c_str(), allocator }.Move(), allocator);
+    json.AddMember("savedAt", JsonValue{ static_cast<uint64_t>(utils::TimeTFromDatetime(datetime::utc_now())) }, allocator);
+
+    auto serializedState{ JsonUtils::SerializeJson(json) };
+    state->LocalStorage()->WriteAsync(
+        m_user,
+        XblLocalStorageWriteMode::Truncate,
+        args.uploadStateKey,
+        Vector<uint8_t>{ serializedState.begin(), serializedState.end() },
+        nullptr
+    );
+}
+
+void
+TitleStorageService::ClearUploadState(
+    _In_ const BlobArgs& args
+    )
+{
+    auto state{ GlobalState::Get() };
+    if (state && !args.uploadStateKey.empty())
+    {
+        state->LocalStorage()->ClearAsync(m_user, args.uploadStateKey, nullptr);
+    }
+}
+
+void
+TitleStorageService::ClearExpiredUploadStates(
+    _In_ const xsapi_internal_string& activeUploadStateKey
+    )
+{
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < c_uploadStateSlotCount; ++slot)
+    {
+        auto key{ UploadStateKey(m_user.Xuid(), slot) };
+        if (key == activeUploadStateKey)
+        {
+            continue;
+        }
+
+        state->LocalStorage()->ReadAsync(
+            m_user,
+            key,
+            [
+                key,
+                sharedThis{ shared_from_this() }
+            ](Result<Vector<uint8_t>> result)
+            {
+                if (Failed(result) || result.Payload().empty())
+                {
+                    return;
+                }
+
+                JsonDocument json;
+                json.Parse(xsapi_internal_string{ result.Payload().begin(), result.Payload().end() }.c_str());
+                if (json.HasParseError() || !json.IsObject() || IsUploadStateExpired(json))
+                {
+                    auto state{ GlobalState::Get() };
+                    if (state)
+                    {
+                        state->LocalStorage()->ClearAsync(sharedThis->m_user, key, nullptr);
+                    }
+                }
+            });
+    }
+}
+
+bool
+TitleStorageService::IsUploadStateExpired(
+    _In_ const JsonValue& uploadState
+    )
+{
+    uint64_t savedAt{ 0 };
+    JsonUtils::ExtractJsonUInt64(uploadState, "savedAt", savedAt);
+
+    // State saved in the future is also treated as expired, so a clock that was wrong doesn't keep it forever
+    uint64_t now = static_cast<uint64_t>(utils::TimeTFromDatetime(datetime::utc_now()));
+    return savedAt + c_uploadStateMaxAgeInSeconds < now || savedAt > now + c_uploadStateMaxAgeInSeconds;
+}
+
+xsapi_internal_string
+TitleStorageService::UploadStateIdentity(
+    _In_ const XblTitleStorageBlobMetadata& blobMetadata
+    )
+{
+    xsapi_internal_stringstream identity;
+    identity << static_cast<uint32_t>(blobMetadata.storageType) << "/";
+    identity << static_cast<uint32_t>(blobMetadata.blobType) << "/";
+    identity << blobMetadata.serviceConfigurationId << "/";
+    identity << blobMetadata.xboxUserId << "/";
+    identity << blobMetadata.blobPath;
+    return identity.str();
+}
+
+xsapi_internal_string
+TitleStorageService::UploadStateKey(
+    _In_ uint64_t xuid,
+    _In_ uint32_t slot
+    )
+{
+    xsapi_internal_stringstream key;
+    key << "titlestorage_upload_" << xuid << "_" << slot << ".json";
+    return key.str();
+}
+
+xsapi_internal_string
+TitleStorageService::UploadStateKey(
+    _In_ uint64_t xuid,
+    _In_ const XblTitleStorageBlobMetadata& blobMetadata
+    )
+{
+    // The blob path can't be used in a storage key as is, so the slot is picked by a checksum of it. The full
+    // identity is kept in the state itself and compared when it is loaded.
+    auto identity{ UploadStateIdentity(blobMetadata) };
+    return UploadStateKey(xuid, utils::crc32(reinterpret_cast<const uint8_t*>(identity.data()), identity.size()) % c_uploadStateSlotCount);
+}
+
 HRESULT 
 TitleStorageService::UploadBlobHelper(
     _In_ std::shared_ptr<BlobArgs> args,
@@ -462,11 +1130,11 @@ TitleStorageService::UploadBlobHelper(
     RETURN_HR_IF_FAILED(httpCall->SetHeader(CONTENT_TYPE_HEADER, CONTENT_TYPE_HEADER_VALUE));
     httpCall->SetLongHttpCall(true);
 
+    size_t blockStartByte = args->startByte;
     if (isBinary)
     {
-        xsapi_internal_vector<uint8_t> dataChunk(dataChunkSize);
-        memcpy(dataChunk.data(), args->uploadBlobBuffer + args->startByte, dataChunkSize);
-        RETURN_HR_IF_FAILED(httpCall->SetRequestBody(std::move(dataChunk)));
+        // The block is sent from the caller's buffer, which must stay unchanged until the upload completes
+        RETURN_HR_IF_FAILED(httpCall->SetBorrowedRequestBody(args->uploadBlobBuffer + args->startByte, dataChunkSize));
         
         args->startByte += dataChunkSize; // Now move the start byte forward
     }
@@ -488,6 +1156,8 @@ TitleStorageService::UploadBlobHelper(
             [
                 args,
                 finalBlock,
+                blockStartByte,
+                dataChunkSize,
                 sharedThis{ shared_from_this() }
             ](HttpResult httpResult)
         {
@@ -500,9 +1170,11 @@ TitleStorageService::UploadBlobHelper(
                 {
                     auto etag = httpResult.Payload()->GetResponseHeader(ETAG_HEADER);
                     utils::strcpy(args->blobMetadata.eTag, etag.length() + 1, etag.c_str());
+                    args->resumedUpload = false;
 
                     if (finalBlock)
                     {
+                        sharedThis->ClearUploadState(*args);
                         args->async.Complete(std::move(args->blobMetadata));
                     }
                     else
@@ -510,9 +1182,24 @@ TitleStorageService::UploadBlobHelper(
                         auto responseBody = httpResult.Payload()->GetResponseBodyJson();
                         xsapi_internal_string continuationToken;
                         JsonUtils::ExtractJsonString(responseBody, "continuationToken", continuationToken);
+
+                        // Record how far the upload got, so it can resume from here if it is interrupted
+                        args->uploadChecksum = utils::crc32(args->uploadBlobBuffer + blockStartByte, dataChunkSize, args->uploadChecksum);
+                        sharedThis->SaveUploadState(*args, continuationToken);
+
                         hr = sharedThis->UploadBlobHelper(args, continuationToken);
                     }
                 }
+                else if (args->resumedUpload && httpResult.Payload()->HttpStatus() >= 400 && httpResult.Payload()->HttpStatus() < 500)
+                {
+                    // The service no longer accepts the saved continuation, so start the upload over
+                    sharedThis->ClearUploadState(*args);
+                    args->resumedUpload = false;
+                    args->startByte = 0;
+                    args->uploadChecksum = 0;
+                    utils::strcpy(args->blobMetadata.eTag, args->initialETag.length() + 1, args->initialETag.c_str());
+                    hr = sharedThis->UploadBlobHelper(args, "");
+                }
             }
 
             if (!SUCCEEDED(hr))
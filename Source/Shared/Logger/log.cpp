@@ -6,6 +6,103 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+namespace
+{
+
+size_t round_up_to_power_of_two(size_t value)
+{
+    size_t result{ 2 };
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+log_buffer::log_buffer(size_t capacity) :
+    m_cells(round_up_to_power_of_two(capacity)),
+    m_mask{ m_cells.size() - 1 }
+{
+    for (size_t i = 0; i < m_cells.size(); ++i)
+    {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool log_buffer::push(entry&& e) noexcept
+{
+    // Each cell's sequence tells producers and consumers whose turn it is. A cell is free for the producer
+    // claiming position 'pos' when sequence == pos, and holds a value for the consumer at 'pos' when sequence == pos + 1.
+    cell* c{ nullptr };
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        c = &m_cells[pos & m_mask];
+        size_t sequence = c->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Buffer is full
+            return false;
+        }
+        else
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    c->value = std::move(e);
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool log_buffer::pop(entry& e) noexcept
+{
+    cell* c{ nullptr };
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        c = &m_cells[pos & m_mask];
+        size_t sequence = c->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Buffer is empty
+            return false;
+        }
+        else
+        {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    e = std::move(c->value);
+    c->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+logger::logger(const TaskQueue& queue) :
+    m_queue{ queue },
+    m_buffer{ MakeUnique<log_buffer>(1024) }
+{
+}
+
 std::shared_ptr<logger> logger::get_logger()
 {
     auto state = GlobalState::Get();
@@ -40,6 +137,52 @@ bool logger::is_log_enabled(HCTraceLevel level)
 }
 
 void logger::add_log(const log_entry& logEntry)
+{
+    if (!m_buffer)
+    {
+        write_to_outputs(logEntry);
+        return;
+    }
+
+    if (!is_log_enabled(logEntry.get_log_level()))
+    {
+        return;
+    }
+
+    if (m_buffer->push({ logEntry.get_log_level(), logEntry.category(), logEntry.msg_stream().str() }))
+    {
+        schedule_flush();
+    }
+    else
+    {
+        ++m_droppedCount;
+    }
+}
+
+void logger::flush()
+{
+    if (!m_buffer)
+    {
+        return;
+    }
+
+    // Clear the flag before draining so that entries pushed while we drain schedule another flush
+    m_flushScheduled = false;
+
+    auto droppedCount = m_droppedCount.exchange(0);
+    if (droppedCount > 0)
+    {
+        write_to_outputs(log_entry{ HCTraceLevel::Warning, "" } << "Log buffer full, dropped " << droppedCount << " entries");
+    }
+
+    log_buffer::entry e{};
+    while (m_buffer->pop(e))
+    {
+        write_to_outputs(log_entry{ e.level, std::move(e.category), std::move(e.message) });
+    }
+}
+
+void logger::write_to_outputs(const log_entry& logEntry)
 {
     for(const auto& output : m_log_outputs)
     {
@@ -50,6 +193,30 @@ void logger::add_log(const log_entry& logEntry)
     }
 }
 
+void logger::schedule_flush()
+{
+    if (m_flushScheduled.exchange(true))
+    {
+        return;
+    }
+
+    std::weak_ptr<logger> weakThis{ shared_from_this() };
+    HRESULT hr = m_queue.RunWork([weakThis]
+    {
+        auto sharedThis{ weakThis.lock() };
+        if (sharedThis)
+        {
+            sharedThis->flush();
+        }
+    });
+
+    if (FAILED(hr))
+    {
+        // Queue has been terminated, fall back to writing synchronously
+        flush();
+    }
+}
+
 void logger::operator+=(const log_entry& logEntry)
 {
     add_log(logEntry);
@@ -14,14 +14,17 @@
     #define LOG(logger, level, category, msg)  \
         __pragma(warning( push )) \
         __pragma(warning( disable : 26444 )) \
-        { auto logInst = logger; if (logInst) { logInst->add_log({ level, category, msg }); } } \
+        { if (xbox::services::log_level_enabled(level)) { auto logInst = logger; if (logInst) { logInst->add_log({ level, category, msg }); } } } \
         __pragma(warning( pop ))
 #else
     #define LOG(logger, level, category, msg) \
-        { auto logInst = logger; if (logInst) { logInst->add_log({ level, category, msg }); } }
+        { if (xbox::services::log_level_enabled(level)) { auto logInst = logger; if (logInst) { logInst->add_log({ level, category, msg }); } } }
 #endif
 
-#define LOGS(level, category) xbox::services::logger_raii() += xbox::services::log_entry(level, category)
+// The level check happens before the log_entry is constructed, so nothing streamed into a disabled LOGS
+// statement is evaluated. The empty if branch keeps a trailing else bound to the caller's if statement.
+#define LOGS(level, category) \
+    if (!xbox::services::log_level_enabled(level)) {} else xbox::services::logger_raii() += xbox::services::log_entry(level, category)
 
 // default logging macro
 const char defaultCategory[] = "";
@@ -51,6 +54,14 @@ const char defaultCategory[] = "";
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
+// Cheap check used by the logging macros. All log outputs share the libHttpClient trace level.
+inline bool log_level_enabled(HCTraceLevel level) noexcept
+{
+    HCTraceLevel traceLevel = HCTraceLevel::Off;
+    HCSettingsGetTraceLevel(&traceLevel);
+    return traceLevel >= level;
+}
+
 class log_entry
 {
 public:
@@ -133,11 +144,50 @@ private:
     mutable std::mutex m_mutex;
 };
 
-class logger
+// Bounded, lock-free multi-producer/multi-consumer queue of formatted log messages. Producers never block;
+// push fails if the buffer is full.
+class log_buffer
+{
+public:
+    struct entry
+    {
+        HCTraceLevel level;
+        xsapi_internal_string category;
+        xsapi_internal_string message;
+    };
+
+    // Capacity is rounded up to a power of two
+    explicit log_buffer(size_t capacity);
+
+    log_buffer(const log_buffer&) = delete;
+    log_buffer& operator=(const log_buffer&) = delete;
+
+    bool push(entry&& e) noexcept;
+    bool pop(entry& e) noexcept;
+
+private:
+    struct cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        entry value;
+    };
+
+    Vector<cell> m_cells;
+    size_t m_mask;
+    std::atomic<size_t> m_enqueuePos{ 0 };
+    std::atomic<size_t> m_dequeuePos{ 0 };
+};
+
+class logger : public std::enable_shared_from_this<logger>
 {
 public:
+    // Entries are written to the outputs synchronously on the logging thread
     logger() {}
 
+    // Entries are queued in a log_buffer and written to the outputs from 'queue', so logging threads
+    // never block on output I/O
+    explicit logger(const TaskQueue& queue);
+
     static std::shared_ptr<logger> get_logger();
 
     void set_log_level(HCTraceLevel level);
@@ -147,8 +197,18 @@ public:
     bool is_log_enabled(HCTraceLevel level);
     void operator+=(const log_entry& record);
 
+    // Synchronously writes any queued entries to the outputs
+    void flush();
+
 private:
+    void write_to_outputs(const log_entry& entry);
+    void schedule_flush();
+
     Vector<std::shared_ptr<log_output>> m_log_outputs;
+    TaskQueue m_queue{ nullptr };
+    UniquePtr<log_buffer> m_buffer;
+    std::atomic<bool> m_flushScheduled{ false };
+    std::atomic<uint64_t> m_droppedCount{ 0 };
 };
 
 class logger_raii
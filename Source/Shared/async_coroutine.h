@@ -0,0 +1,268 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+// Coroutine support requires C++20. When it isn't available, XSAPI_COROUTINES is 0 and internal flows fall back
+// to chained AsyncContext callbacks.
+#ifndef XSAPI_COROUTINES
+    #if defined(__cpp_impl_coroutine) && defined(__has_include)
+        #if __has_include(<coroutine>)
+            #define XSAPI_COROUTINES 1
+        #endif
+    #endif
+#endif
+
+#ifndef XSAPI_COROUTINES
+    #define XSAPI_COROUTINES 0
+#endif
+
+#if XSAPI_COROUTINES
+
+#include <coroutine>
+#include <optional>
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+// Return type for internal fire-and-forget coroutines. The coroutine starts running immediately and its frame is
+// destroyed when it finishes, so results must be delivered through an AsyncContext owned by the coroutine.
+// Frames are allocated with the XSAPI memhooks. If the frame can't be allocated the coroutine never runs
+// and Hresult() returns E_OUTOFMEMORY.
+class AsyncCoroutine
+{
+public:
+    struct promise_type
+    {
+        static void* operator new(size_t size) noexcept
+        {
+            return Alloc(size);
+        }
+
+        static void operator delete(void* pointer) noexcept
+        {
+            Free(pointer);
+        }
+
+        static AsyncCoroutine get_return_object_on_allocation_failure() noexcept
+        {
+            return AsyncCoroutine{ E_OUTOFMEMORY };
+        }
+
+        AsyncCoroutine get_return_object() noexcept
+        {
+            return AsyncCoroutine{ S_OK };
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            LOGS_ERROR << "Unexpected exception in AsyncCoroutine";
+            assert(false);
+        }
+    };
+
+    HRESULT Hresult() const noexcept
+    {
+        return m_hr;
+    }
+
+private:
+    explicit AsyncCoroutine(HRESULT hr) noexcept : m_hr{ hr } {}
+
+    HRESULT m_hr;
+};
+
+// Awaitable adapter for operations taking an AsyncContext<T>. The initiator is invoked with an AsyncContext
+// that resumes the awaiting coroutine, and co_await yields the completion value. If the initiator fails
+// synchronously, co_await yields the failure HRESULT instead. The awaiter lives in the coroutine frame so
+// awaiting doesn't allocate beyond what the initiator itself does.
+template<typename T, typename Initiator>
+class AsyncAwaiter
+{
+public:
+    AsyncAwaiter(TaskQueue queue, Initiator&& initiator) noexcept
+        : m_queue{ std::move(queue) },
+        m_initiator{ std::move(initiator) }
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        m_handle = handle;
+
+        HRESULT hr = m_initiator(AsyncContext<T>{ m_queue, [this](T result)
+        {
+            m_result.emplace(std::move(result));
+
+            // If await_suspend hasn't returned yet it will continue the coroutine itself
+            if (m_completed.exchange(true))
+            {
+                m_handle.resume();
+            }
+        } });
+
+        if (FAILED(hr))
+        {
+            m_result.emplace(hr);
+            return false;
+        }
+
+        // The coroutine may be resumed (and destroyed) on another thread as soon as this exchange happens,
+        // so no members can be touched afterwards.
+        return !m_completed.exchange(true);
+    }
+
+    T await_resume() noexcept
+    {
+        return std::move(*m_result);
+    }
+
+private:
+    TaskQueue m_queue;
+    Initiator m_initiator;
+    std::coroutine_handle<> m_handle;
+    std::optional<T> m_result;
+    std::atomic<bool> m_completed{ false };
+};
+
+template<typename T, typename Initiator>
+AsyncAwaiter<T, typename std::decay<Initiator>::type> AsyncAwait(
+    TaskQueue queue,
+    Initiator&& initiator
+) noexcept
+{
+    return AsyncAwaiter<T, typename std::decay<Initiator>::type>{ std::move(queue), std::forward<Initiator>(initiator) };
+}
+
+// Awaitable that resumes the coroutine on the work port of a TaskQueue after an optional delay. co_await yields
+// the HRESULT from scheduling the work; on failure the coroutine continues immediately on the current thread.
+// If the queue is terminated before the work runs, the coroutine is never resumed and its frame is destroyed when
+// the queue drops the work instead. Locals of the coroutine are destroyed without running the rest of its body,
+// so an AsyncContext it owns is released without being completed, just as a dropped callback would be.
+class TaskQueueAwaiter
+{
+    enum class State
+    {
+        Pending,
+        Submitted,
+        Abandoned
+    };
+
+    // Owned by the queued work. If the work is destroyed without running, the frame is destroyed with it. The state
+    // is shared rather than kept in the awaiter because the work may resume (and finish) the coroutine before
+    // RunWork returns, e.g. on an immediate dispatch queue.
+    class FrameOwner
+    {
+    public:
+        FrameOwner(std::shared_ptr<std::atomic<State>> state, std::coroutine_handle<> handle) noexcept
+            : m_state{ std::move(state) },
+            m_handle{ handle }
+        {
+        }
+
+        FrameOwner(FrameOwner&& other) noexcept
+            : m_state{ std::move(other.m_state) },
+            m_handle{ std::exchange(other.m_handle, nullptr) }
+        {
+        }
+
+        FrameOwner(const FrameOwner&) = delete;
+        FrameOwner& operator=(const FrameOwner&) = delete;
+        FrameOwner& operator=(FrameOwner&&) = delete;
+
+        ~FrameOwner() noexcept
+        {
+            // Only destroy the frame once await_suspend has seen the work scheduled. If scheduling failed, await_suspend
+            // resumes the coroutine inline; if the work was dropped before then, await_suspend destroys the frame.
+            if (m_handle && m_state->exchange(State::Abandoned) == State::Submitted)
+            {
+                m_handle.destroy();
+            }
+        }
+
+        void Resume() noexcept
+        {
+            std::exchange(m_handle, nullptr).resume();
+        }
+
+    private:
+        std::shared_ptr<std::atomic<State>> m_state;
+        std::coroutine_handle<> m_handle;
+    };
+
+public:
+    TaskQueueAwaiter(TaskQueue queue, uint64_t delayInMs) noexcept
+        : m_queue{ std::move(queue) },
+        m_delayInMs{ delayInMs }
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        auto state{ MakeShared<std::atomic<State>>(State::Pending) };
+
+        HRESULT hr = m_queue.RunWork([owner = FrameOwner{ state, handle }]() mutable
+        {
+            owner.Resume();
+        }, m_delayInMs);
+
+        if (FAILED(hr))
+        {
+            m_hr = hr;
+            return false;
+        }
+
+        // The coroutine may already have been resumed and the awaiter destroyed, so only the shared state is touched
+        if (state->exchange(State::Submitted) == State::Abandoned)
+        {
+            // The queue was terminated and dropped the work before we got here
+            handle.destroy();
+        }
+        return true;
+    }
+
+    HRESULT await_resume() const noexcept
+    {
+        return m_hr;
+    }
+
+private:
+    TaskQueue m_queue;
+    uint64_t m_delayInMs;
+    HRESULT m_hr{ S_OK };
+};
+
+inline TaskQueueAwaiter AsyncDelay(
+    TaskQueue queue,
+    uint64_t delayInMs = 0
+) noexcept
+{
+    return TaskQueueAwaiter{ std::move(queue), delayInMs };
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
+
+#endif // XSAPI_COROUTINES
@@ -107,6 +107,8 @@ HRESULT TaskQueue::RunOnPort(
     _In_ uint64_t delayInMs
 ) const noexcept
 {
+    // XTaskQueue only carries a context pointer, so the work is moved into a heap allocated AsyncWork which the
+    // callback takes back ownership of. This is the one allocation made per hop for work stored inline.
     auto context{ MakeUnique<AsyncWork>(std::move(work)) };
 
     HRESULT hr = XTaskQueueSubmitDelayedCallback(m_handle, port, static_cast<uint32_t>(delayInMs), context.get(),
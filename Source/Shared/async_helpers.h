@@ -7,122 +7,334 @@
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
-// Memhook aware function class with type erasure
+namespace detail
+{
+
+// Callables up to this size are stored inline by Function and MoveOnlyFunction rather than on the heap. This fits
+// the typical continuation lambda (a few shared_ptrs, a TaskQueue and a nested callback) without an allocation.
+constexpr size_t FunctionInlineSize = 48;
+
+template<typename Functor>
+struct FunctionIsInline : std::integral_constant<bool,
+    sizeof(Functor) <= FunctionInlineSize &&
+    alignof(Functor) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible<Functor>::value>
+{
+};
+
+// Manages a functor living in a FunctionStorage buffer
+template<typename Functor, bool Inline = FunctionIsInline<Functor>::value>
+struct FunctionManager
+{
+    static Functor* Get(void* storage) noexcept
+    {
+        return static_cast<Functor*>(storage);
+    }
+
+    static void Create(void* storage, Functor&& functor)
+    {
+        new (storage) Functor(std::move(functor));
+    }
+
+    static void Copy(void* dest, const void* src)
+    {
+        new (dest) Functor(*static_cast<const Functor*>(src));
+    }
+
+    static void Move(void* dest, void* src) noexcept
+    {
+        new (dest) Functor(std::move(*Get(src)));
+        Get(src)->~Functor();
+    }
+
+    static void Destroy(void* storage) noexcept
+    {
+        Get(storage)->~Functor();
+    }
+};
+
+// Functors that don't fit inline are heap allocated (through the memhooks) and the buffer holds a pointer to them
+template<typename Functor>
+struct FunctionManager<Functor, false>
+{
+    static Functor* Get(void* storage) noexcept
+    {
+        return *static_cast<Functor**>(storage);
+    }
+
+    static void Create(void* storage, Functor&& functor)
+    {
+        *static_cast<Functor**>(storage) = Make<Functor>(std::move(functor));
+    }
+
+    static void Copy(void* dest, const void* src)
+    {
+        *static_cast<Functor**>(dest) = Make<Functor>(**static_cast<Functor* const*>(src));
+    }
+
+    static void Move(void* dest, void* src) noexcept
+    {
+        *static_cast<Functor**>(dest) = Get(src);
+        *static_cast<Functor**>(src) = nullptr;
+    }
+
+    static void Destroy(void* storage) noexcept
+    {
+        Delete(Get(storage));
+    }
+};
+
+// Type erased storage shared by Function and MoveOnlyFunction
+template<typename Ret, typename... Args>
+class FunctionStorage
+{
+protected:
+    struct Ops
+    {
+        Ret(*invoke)(void* storage, Args... args);
+        void(*copy)(void* dest, const void* src); // null for functors stored by MoveOnlyFunction
+        void(*move)(void* dest, void* src) noexcept;
+        void(*destroy)(void* storage) noexcept;
+    };
+
+    FunctionStorage() noexcept = default;
+    FunctionStorage(const FunctionStorage&) = delete;
+    FunctionStorage& operator=(const FunctionStorage&) = delete;
+
+    ~FunctionStorage() noexcept
+    {
+        Reset();
+    }
+
+    template<typename Functor, bool Copyable>
+    void Emplace(Functor&& functor)
+    {
+        Reset();
+        FunctionManager<Functor>::Create(m_storage, std::move(functor));
+        m_ops = GetOps<Functor>(std::integral_constant<bool, Copyable>{});
+    }
+
+    void CopyFrom(const FunctionStorage& other)
+    {
+        Reset();
+        if (other.m_ops)
+        {
+            other.m_ops->copy(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+        }
+    }
+
+    void MoveFrom(FunctionStorage& other) noexcept
+    {
+        Reset();
+        if (other.m_ops)
+        {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    void Reset() noexcept
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    Ret Invoke(Args... args) const
+    {
+        if (m_ops != nullptr)
+        {
+            return m_ops->invoke(m_storage, std::forward<Args>(args)...);
+        }
+        else
+        {
+            return Ret();
+        }
+    }
+
+    bool Empty() const noexcept
+    {
+        return m_ops == nullptr;
+    }
+
+private:
+    template<typename Functor>
+    static Ret InvokeFunctor(void* storage, Args... args)
+    {
+        return (*FunctionManager<Functor>::Get(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename Functor>
+    static const Ops* GetOps(std::true_type /*copyable*/) noexcept
+    {
+        static const Ops ops{ &InvokeFunctor<Functor>, &FunctionManager<Functor>::Copy, &FunctionManager<Functor>::Move, &FunctionManager<Functor>::Destroy };
+        return &ops;
+    }
+
+    template<typename Functor>
+    static const Ops* GetOps(std::false_type /*copyable*/) noexcept
+    {
+        static const Ops ops{ &InvokeFunctor<Functor>, nullptr, &FunctionManager<Functor>::Move, &FunctionManager<Functor>::Destroy };
+        return &ops;
+    }
+
+    alignas(std::max_align_t) mutable unsigned char m_storage[FunctionInlineSize];
+    const Ops* m_ops{ nullptr };
+};
+
+} // namespace detail
+
+// Memhook aware function class with type erasure. Small callables are stored inline.
 template<typename T>
 class Function;
 
 template<typename Ret, typename... Args>
-class Function<Ret(Args...)>
+class Function<Ret(Args...)> : private detail::FunctionStorage<Ret, Args...>
 {
+    using Base = detail::FunctionStorage<Ret, Args...>;
+
+    template<typename Functor>
+    using EnableIfFunctor = typename std::enable_if<!std::is_same<typename std::decay<Functor>::type, Function>::value>::type;
+
 public:
     Function() noexcept = default;
     ~Function() = default;
 
-    Function(std::nullptr_t) noexcept : m_callable{ nullptr }
+    Function(std::nullptr_t) noexcept
     {
     }
 
-    template <typename Functor>
+    template <typename Functor, typename = EnableIfFunctor<Functor>>
     Function(Functor functor) noexcept
     {
-        m_callable = UniquePtr<ICallable>{ MakeUnique<Callable<Functor>>(std::move(functor)).release() };
+        Base::template Emplace<Functor, true>(std::move(functor));
     }
 
     Function(const Function& rhs) noexcept
     {
-        *this = rhs;
+        Base::CopyFrom(rhs);
     }
 
     Function(Function&& rhs) noexcept
     {
-        *this = std::move(rhs);
+        Base::MoveFrom(rhs);
     }
 
-    template <typename Functor>
+    template <typename Functor, typename = EnableIfFunctor<Functor>>
     Function& operator=(Functor f) noexcept
     {
-        m_callable = UniquePtr<ICallable>{ MakeUnique<Callable<Functor>>(std::move(f)).release() };
+        Base::template Emplace<Functor, true>(std::move(f));
         return *this;
     }
 
     Function& operator=(const Function& rhs) noexcept
     {
-        if (rhs.m_callable != nullptr)
+        if (this != &rhs)
         {
-            m_callable = rhs.m_callable->Copy();
-        }
-        else
-        {
-            m_callable.reset();
+            Base::CopyFrom(rhs);
         }
         return *this;
     }
 
     Function& operator=(Function&& rhs) noexcept
     {
-        m_callable = std::move(rhs.m_callable);
+        if (this != &rhs)
+        {
+            Base::MoveFrom(rhs);
+        }
         return *this;
     }
 
     Function& operator=(std::nullptr_t) noexcept
     {
-        m_callable.reset();
+        Base::Reset();
         return *this;
     }
 
     Ret operator()(Args... args) const
     {
-        if (m_callable != nullptr)
-        {
-            return (*m_callable)(args...);
-        }
-        else
-        {
-            return Ret();
-        }
+        return Base::Invoke(std::forward<Args>(args)...);
     }
 
     bool operator==(std::nullptr_t) const noexcept
     {
-        return m_callable == nullptr;
+        return Base::Empty();
     }
 
     bool operator!=(std::nullptr_t) const noexcept
     {
-        return m_callable != nullptr;
+        return !Base::Empty();
     }
+};
 
-private:
-    struct ICallable
+// Move only variant of Function for one shot work and completions. Accepts callables that can't be copied and
+// never deep copies the callable.
+template<typename T>
+class MoveOnlyFunction;
+
+template<typename Ret, typename... Args>
+class MoveOnlyFunction<Ret(Args...)> : private detail::FunctionStorage<Ret, Args...>
+{
+    using Base = detail::FunctionStorage<Ret, Args...>;
+
+    template<typename Functor>
+    using EnableIfFunctor = typename std::enable_if<!std::is_same<typename std::decay<Functor>::type, MoveOnlyFunction>::value>::type;
+
+public:
+    MoveOnlyFunction() noexcept = default;
+    ~MoveOnlyFunction() = default;
+
+    MoveOnlyFunction(std::nullptr_t) noexcept
     {
-        virtual ~ICallable() = default;
-        virtual Ret operator()(Args...) = 0;
-        virtual UniquePtr<ICallable> Copy() = 0;
-    };
+    }
 
-    template <typename Functor>
-    struct Callable : public ICallable
+    template <typename Functor, typename = EnableIfFunctor<Functor>>
+    MoveOnlyFunction(Functor functor) noexcept
     {
-        Callable(Functor functor) : m_functor{ std::move(functor) }
-        {
-        }
+        Base::template Emplace<Functor, false>(std::move(functor));
+    }
 
-        ~Callable() override = default;
+    MoveOnlyFunction(const MoveOnlyFunction&) = delete;
+    MoveOnlyFunction& operator=(const MoveOnlyFunction&) = delete;
 
-        Ret operator()(Args... args) override
-        {
-            return m_functor(args...);
-        }
+    MoveOnlyFunction(MoveOnlyFunction&& rhs) noexcept
+    {
+        Base::MoveFrom(rhs);
+    }
 
-        UniquePtr<ICallable> Copy() override
+    MoveOnlyFunction& operator=(MoveOnlyFunction&& rhs) noexcept
+    {
+        if (this != &rhs)
         {
-            return UniquePtr<ICallable>{ MakeUnique<Callable<Functor>>(m_functor).release() };
+            Base::MoveFrom(rhs);
         }
+        return *this;
+    }
 
-        Functor m_functor;
-    };
+    MoveOnlyFunction& operator=(std::nullptr_t) noexcept
+    {
+        Base::Reset();
+        return *this;
+    }
 
-    UniquePtr<ICallable> m_callable{ nullptr };
+    Ret operator()(Args... args) const
+    {
+        return Base::Invoke(std::forward<Args>(args)...);
+    }
+
+    bool operator==(std::nullptr_t) const noexcept
+    {
+        return Base::Empty();
+    }
+
+    bool operator!=(std::nullptr_t) const noexcept
+    {
+        return !Base::Empty();
+    }
 };
 
 template<typename... Args>
@@ -131,7 +343,7 @@ using xbox_live_callback = Function<void(Args...)>;
 template<typename... Args>
 using Callback = Function<void(Args...)>;
 
-using AsyncWork = Function<void(void)>;
+using AsyncWork = MoveOnlyFunction<void(void)>;
 
 // RAII wrapper around XTaskQueueHandle
 class TaskQueue
@@ -218,19 +430,19 @@ public:
     AsyncContext() noexcept = default;
 
     AsyncContext(Function<void(Args...)>&& callback) noexcept
-        : m_callback{ callback }
+        : m_callback{ std::move(callback) }
     {
     }
 
     AsyncContext(TaskQueue queue, Function<void(Args...)>&& callback) noexcept
         : m_queue{ std::move(queue) },
-        m_callback{ callback }
+        m_callback{ std::move(callback) }
     {
     }
 
     AsyncContext(XTaskQueueHandle queueHandle, Function<void(Args...)>&& callback) noexcept
         : m_queue{ queueHandle },
-        m_callback{ callback }
+        m_callback{ std::move(callback) }
     {
     }
 
@@ -251,6 +463,7 @@ public:
     AsyncContext(const AsyncContext& other) = default;
     AsyncContext(AsyncContext&& other) = default;
     AsyncContext& operator=(const AsyncContext& other) = default;
+    AsyncContext& operator=(AsyncContext&& other) = default;
     ~AsyncContext() = default;
 
     void Complete(Args... args) const noexcept
@@ -305,7 +518,7 @@ inline AsyncContext<Result<void>>::AsyncContext(XAsyncBlock* asyncBlock) noexcep
     };
 }
 
-typedef Function<HRESULT(XAsyncOp, const XAsyncProviderData*)> AsyncProvider;
+typedef MoveOnlyFunction<HRESULT(XAsyncOp, const XAsyncProviderData*)> AsyncProvider;
 
 // Helper method for writing XAsync Providers.
 // AsyncProvider type allows for capture enabled lambdas. XAsyncProvider context lifetime is managed automatically.
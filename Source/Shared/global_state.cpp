@@ -7,6 +7,7 @@
 #include "multiplayer_manager_internal.h"
 #include "social_manager_internal.h"
 #include "real_time_activity_manager.h"
+#include "title_storage_cache.h"
 #include "Logger/log_hc_output.h"
 #if HC_PLATFORM == HC_PLATFORM_ANDROID
 #include "a/utils_a.h"
@@ -31,7 +32,10 @@ GlobalState::GlobalState(
     m_localStorage{ MakeShared<system::LocalStorage>(m_taskQueue) },
 #endif
     m_appConfig{ MakeShared<xbox::services::AppConfig>() },
-    m_logger{ MakeShared<logger>() }
+    m_logger{ MakeShared<logger>(m_taskQueue) },
+    m_tokenCache{ MakeShared<xbox::services::TokenCache>() },
+    m_httpCallGovernor{ MakeShared<xbox::services::HttpCallGovernor>() },
+    m_titleStorageCache{ MakeShared<title_storage::TitleStorageCache>() }
 {
 #if HC_PLATFORM_IS_MICROSOFT
     HCTraceSetEtwEnabled(true);
@@ -145,6 +149,24 @@ HRESULT GlobalState::Create(
     // GlobalState object has been created and initialized successfully at this point so store it.
     (void)AccessHelper(AccessMode::SET, state);
 
+    // Drop cached tokens for users that sign out
+    auto userChangeRegistrationResult = User::RegisterChangeEventHandler(
+        [tokenCache{ state->m_tokenCache }](UserLocalId localId, UserChangeType changeType)
+        {
+            if (changeType == XalUserChange_SignedOut)
+            {
+                tokenCache->RemoveUser(localId.value);
+            }
+        });
+    if (Succeeded(userChangeRegistrationResult))
+    {
+        state->m_userChangeEventToken = userChangeRegistrationResult.Payload();
+    }
+    else
+    {
+        LOGS_ERROR << "Failed to register for user changes, hr=" << userChangeRegistrationResult.Hresult();
+    }
+
 #if HC_PLATFORM == HC_PLATFORM_GDK
     RegisterAppStateChangeNotification(AppStateChangeNotificationReceived, nullptr, &state->m_registrationID);
 #endif
@@ -177,6 +199,11 @@ HRESULT GlobalState::CleanupAsync(
     UnregisterAppStateChangeNotification(state->m_registrationID);
 #endif
 
+    if (state->m_userChangeEventToken)
+    {
+        User::UnregisterChangeEventHandle(state->m_userChangeEventToken);
+    }
+
     return XAsyncBegin(
         async,
         state.get(),
@@ -275,6 +302,9 @@ HRESULT GlobalState::CleanupAsync(
                 }
 #endif
 
+                // Write any log entries whose flush was canceled by the queue termination
+                state->m_logger->flush();
+
                 // Release the leaked reference from Create
                 state->DecRef();
 
@@ -321,6 +351,9 @@ void GlobalState::HCCleanupComplete(XAsyncBlock* async) noexcept
     }
     context.reset(); // Cleanup context before returning to caller
 
+    // Return pooled memory before the client is free to tear down their memhooks
+    ArenaReleaseUnused();
+
     XAsyncComplete(xblCleanupAsyncBlock, hr, 0);
 }
 
@@ -407,6 +440,21 @@ void GlobalState::InsertUserExpiredToken(uint64_t xuid) noexcept
     m_userExpiredTokens.insert(xuid);
 }
 
+std::shared_ptr<xbox::services::TokenCache> GlobalState::TokenCache() const noexcept
+{
+    return m_tokenCache;
+}
+
+std::shared_ptr<xbox::services::HttpCallGovernor> GlobalState::HttpCallGovernor() const noexcept
+{
+    return m_httpCallGovernor;
+}
+
+std::shared_ptr<title_storage::TitleStorageCache> GlobalState::TitleStorageCache() const noexcept
+{
+    return m_titleStorageCache;
+}
+
 XblFunctionContext GlobalState::AddServiceCallRoutedHandler(
     _In_ XblCallRoutedHandler callback,
     _In_opt_ void* context
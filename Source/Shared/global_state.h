@@ -5,6 +5,8 @@
 
 #include "service_call_routed_handler.h"
 #include "local_storage.h"
+#include "token_cache.h"
+#include "http_call_governor.h"
 #include "fault_injection.h"
 
 #if HC_PLATFORM == HC_PLATFORM_GDK
@@ -33,6 +35,10 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_BEGIN
     class RealTimeActivityManager;
 NAMESPACE_MICROSOFT_XBOX_SERVICES_RTA_CPP_END
 
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_BEGIN
+    class TitleStorageCache;
+NAMESPACE_MICROSOFT_XBOX_SERVICES_TITLE_STORAGE_CPP_END
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
 
 #if HC_PLATFORM == HC_PLATFORM_GDK
@@ -60,6 +66,9 @@ public:
 
     size_t EraseUserExpiredToken(uint64_t xuid) noexcept;
     void InsertUserExpiredToken(uint64_t xuid) noexcept;
+    std::shared_ptr<xbox::services::TokenCache> TokenCache() const noexcept;
+    std::shared_ptr<xbox::services::HttpCallGovernor> HttpCallGovernor() const noexcept;
+    std::shared_ptr<title_storage::TitleStorageCache> TitleStorageCache() const noexcept;
 
     XblFunctionContext AddServiceCallRoutedHandler(
         _In_ XblCallRoutedHandler handler,
@@ -122,6 +131,7 @@ private:
     Set<uint64_t> m_userExpiredTokens;
 
     UnorderedMap<uint64_t, std::shared_ptr<UserChangeEventHandler>> m_userChangeHandlers;
+    uint64_t m_userChangeEventToken{ 0 };
     XblFunctionContext m_nextHandlerToken{ 1 };
     UnorderedMap<XblFunctionContext, std::shared_ptr<ServiceCallRoutedHandler>> m_callRoutedHandlers;
 
@@ -133,6 +143,15 @@ private:
     // from Shared\Logger\log.cpp
     const std::shared_ptr<logger> m_logger;
 
+    // from Shared\token_cache.cpp
+    const std::shared_ptr<xbox::services::TokenCache> m_tokenCache;
+
+    // from Shared\http_call_governor.cpp
+    const std::shared_ptr<xbox::services::HttpCallGovernor> m_httpCallGovernor;
+
+    // from Services\TitleStorage\title_storage_cache.cpp
+    const std::shared_ptr<title_storage::TitleStorageCache> m_titleStorageCache;
+
 #if HC_PLATFORM == HC_PLATFORM_XDK
     String m_achivementsEventProviderName;
     GUID m_achievementsSessionId{};
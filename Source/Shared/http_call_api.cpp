@@ -322,3 +322,64 @@ try
     return call->ResponseGetHeaderAtIndex(headerIndex, headerName, headerValue);
 }
 CATCH_RETURN()
+
+STDAPI XblHttpCallSetBudget(
+    _In_opt_z_ const char* host,
+    _In_opt_ const XblHttpCallBudget* budget
+) XBL_NOEXCEPT
+try
+{
+    VERIFY_XBL_INITIALIZED();
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return E_XBL_NOT_INITIALIZED;
+    }
+
+    if (budget)
+    {
+        RETURN_HR_INVALIDARGUMENT_IF(budget->burstCallCount == 0 || budget->burstPeriodInSeconds == 0);
+        RETURN_HR_INVALIDARGUMENT_IF(budget->sustainedCallCount == 0 || budget->sustainedPeriodInSeconds == 0);
+
+        HttpCallGovernor::Budget governorBudget{
+            budget->burstCallCount,
+            std::chrono::seconds{ budget->burstPeriodInSeconds },
+            budget->sustainedCallCount,
+            std::chrono::seconds{ budget->sustainedPeriodInSeconds }
+        };
+        state->HttpCallGovernor()->SetBudget(host ? host : "", &governorBudget);
+    }
+    else
+    {
+        state->HttpCallGovernor()->SetBudget(host ? host : "", nullptr);
+    }
+    return S_OK;
+}
+CATCH_RETURN()
+
+STDAPI XblHttpCallGetBudgetHeadroom(
+    _In_ uint64_t xboxUserId,
+    _In_z_ const char* host,
+    _Out_ XblHttpCallBudgetHeadroom* headroom
+) XBL_NOEXCEPT
+try
+{
+    RETURN_HR_INVALIDARGUMENT_IF(host == nullptr || headroom == nullptr);
+    VERIFY_XBL_INITIALIZED();
+    auto state{ GlobalState::Get() };
+    if (!state)
+    {
+        return E_XBL_NOT_INITIALIZED;
+    }
+
+    auto governorHeadroom{ state->HttpCallGovernor()->GetHeadroom(xboxUserId, host) };
+    *headroom = XblHttpCallBudgetHeadroom{
+        governorHeadroom.isLimited,
+        governorHeadroom.burstCallsRemaining,
+        governorHeadroom.sustainedCallsRemaining,
+        governorHeadroom.deferredCallCount,
+        governorHeadroom.throttledCallCount
+    };
+    return S_OK;
+}
+CATCH_RETURN()
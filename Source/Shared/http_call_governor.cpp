@@ -0,0 +1,274 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_call_governor.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+constexpr uint32_t HttpCallGovernor::BackgroundReservePercent;
+constexpr std::chrono::minutes HttpCallGovernor::EndpointIdleTimeout;
+
+void HttpCallGovernor::SetBudget(
+    const String& host,
+    const Budget* budget
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    String key{ utils::ToLower(host) };
+    if (budget)
+    {
+        m_budgets[key] = *budget;
+    }
+    else
+    {
+        m_budgets.erase(key);
+    }
+}
+
+std::chrono::milliseconds HttpCallGovernor::Acquire(
+    uint64_t xuid,
+    const String& url,
+    HttpCallPriority priority
+) noexcept
+{
+    String host{ utils::HostFromUrl(url) };
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto now{ chrono_clock_t::now() };
+    PruneIdleEndpoints(now);
+
+    EndpointKey key{ xuid, std::move(host) };
+    auto budget{ FindBudget(key.second) };
+    if (!budget)
+    {
+        // Endpoints without a budget are only held back after the service has throttled them
+        auto iter{ m_endpoints.find(key) };
+        if (iter == m_endpoints.end())
+        {
+            return std::chrono::milliseconds{ 0 };
+        }
+
+        iter->second.lastUsed = now;
+        if (now < iter->second.blockedUntil)
+        {
+            ++iter->second.deferredCallCount;
+            return std::chrono::duration_cast<std::chrono::milliseconds>(iter->second.blockedUntil - now) + std::chrono::milliseconds{ 1 };
+        }
+        return std::chrono::milliseconds{ 0 };
+    }
+
+    auto& endpoint{ m_endpoints[key] };
+    endpoint.lastUsed = now;
+    if (!endpoint.initialized)
+    {
+        endpoint.initialized = true;
+        endpoint.burst = Bucket{ static_cast<double>(budget->burstCallCount), now };
+        endpoint.sustained = Bucket{ static_cast<double>(budget->sustainedCallCount), now };
+    }
+
+    Refill(endpoint.burst, budget->burstCallCount, budget->burstPeriod, now);
+    Refill(endpoint.sustained, budget->sustainedCallCount, budget->sustainedPeriod, now);
+
+    if (now < endpoint.blockedUntil)
+    {
+        ++endpoint.deferredCallCount;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(endpoint.blockedUntil - now) + std::chrono::milliseconds{ 1 };
+    }
+
+    // The calls a bucket needs to have before this call can be made, including the reserve for interactive calls
+    auto required = [priority](uint32_t capacity)
+    {
+        double reserve{ priority == HttpCallPriority::Background ? capacity * BackgroundReservePercent / 100.0 : 0.0 };
+        return (std::min)(1.0 + reserve, static_cast<double>((std::max)(capacity, 1u)));
+    };
+
+    double burstRequired{ required(budget->burstCallCount) };
+    double sustainedRequired{ required(budget->sustainedCallCount) };
+    if (endpoint.burst.calls >= burstRequired && endpoint.sustained.calls >= sustainedRequired)
+    {
+        endpoint.burst.calls -= 1;
+        endpoint.sustained.calls -= 1;
+        return std::chrono::milliseconds{ 0 };
+    }
+
+    ++endpoint.deferredCallCount;
+    return (std::max)(
+        TimeUntil(endpoint.burst, burstRequired, budget->burstCallCount, budget->burstPeriod),
+        TimeUntil(endpoint.sustained, sustainedRequired, budget->sustainedCallCount, budget->sustainedPeriod)
+    );
+}
+
+void HttpCallGovernor::OnThrottled(
+    uint64_t xuid,
+    const String& url,
+    std::chrono::seconds retryAfter
+) noexcept
+{
+    String host{ utils::HostFromUrl(url) };
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto now{ chrono_clock_t::now() };
+    PruneIdleEndpoints(now);
+
+    auto& endpoint{ m_endpoints[EndpointKey{ xuid, std::move(host) }] };
+    endpoint.lastUsed = now;
+    ++endpoint.throttledCallCount;
+    endpoint.blockedUntil = (std::max)(endpoint.blockedUntil, now + retryAfter);
+
+    // The service's view of the budget is what counts, so start refilling from empty
+    if (endpoint.initialized)
+    {
+        endpoint.burst = Bucket{ 0, endpoint.blockedUntil };
+        endpoint.sustained = Bucket{ 0, endpoint.blockedUntil };
+    }
+}
+
+std::chrono::seconds HttpCallGovernor::ParseRetryAfter(
+    const String& retryAfter,
+    const String& responseDate
+) noexcept
+{
+    size_t begin{ retryAfter.find_first_not_of(" \t") };
+    if (begin == String::npos)
+    {
+        return std::chrono::seconds{ 0 };
+    }
+    size_t end{ retryAfter.find_last_not_of(" \t") + 1 };
+    String value{ retryAfter.substr(begin, end - begin) };
+
+    if (std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; }))
+    {
+        return std::chrono::seconds{ strtoull(value.data(), nullptr, 10) };
+    }
+
+    auto retryTime{ utils::TimeTFromDatetime(datetime::from_string(value, datetime::RFC_1123)) };
+    if (retryTime == 0)
+    {
+        return std::chrono::seconds{ 0 };
+    }
+
+    auto now{ utils::TimeTFromDatetime(datetime::from_string(responseDate, datetime::RFC_1123)) };
+    if (now == 0)
+    {
+        now = utils::TimeTFromDatetime(datetime::utc_now());
+    }
+
+    return std::chrono::seconds{ retryTime > now ? retryTime - now : 0 };
+}
+
+HttpCallGovernor::Headroom HttpCallGovernor::GetHeadroom(
+    uint64_t xuid,
+    const String& host
+) const noexcept
+{
+    String lowercaseHost{ utils::ToLower(host) };
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    Headroom headroom{};
+    auto budget{ FindBudget(lowercaseHost) };
+    if (budget)
+    {
+        headroom.isLimited = true;
+        headroom.burstCallsRemaining = budget->burstCallCount;
+        headroom.sustainedCallsRemaining = budget->sustainedCallCount;
+    }
+
+    auto iter{ m_endpoints.find(EndpointKey{ xuid, lowercaseHost }) };
+    if (iter != m_endpoints.end())
+    {
+        Endpoint endpoint{ iter->second };
+        headroom.deferredCallCount = endpoint.deferredCallCount;
+        headroom.throttledCallCount = endpoint.throttledCallCount;
+
+        if (budget && endpoint.initialized)
+        {
+            auto now{ chrono_clock_t::now() };
+            Refill(endpoint.burst, budget->burstCallCount, budget->burstPeriod, now);
+            Refill(endpoint.sustained, budget->sustainedCallCount, budget->sustainedPeriod, now);
+            headroom.burstCallsRemaining = static_cast<uint32_t>(endpoint.burst.calls);
+            headroom.sustainedCallsRemaining = static_cast<uint32_t>(endpoint.sustained.calls);
+        }
+    }
+
+    return headroom;
+}
+
+const HttpCallGovernor::Budget* HttpCallGovernor::FindBudget(const String& host) const noexcept
+{
+    auto iter{ m_budgets.find(host) };
+    if (iter == m_budgets.end())
+    {
+        iter = m_budgets.find(String{});
+    }
+    return iter == m_budgets.end() ? nullptr : &iter->second;
+}
+
+void HttpCallGovernor::Refill(
+    Bucket& bucket,
+    uint32_t capacity,
+    std::chrono::seconds period,
+    chrono_clock_t::time_point now
+) noexcept
+{
+    if (now > bucket.lastRefill && period.count() > 0)
+    {
+        std::chrono::duration<double> elapsed{ now - bucket.lastRefill };
+        bucket.calls += elapsed.count() * capacity / period.count();
+        bucket.lastRefill = now;
+    }
+    bucket.calls = (std::min)(bucket.calls, static_cast<double>(capacity));
+}
+
+std::chrono::milliseconds HttpCallGovernor::TimeUntil(
+    const Bucket& bucket,
+    double calls,
+    uint32_t capacity,
+    std::chrono::seconds period
+) noexcept
+{
+    if (bucket.calls >= calls)
+    {
+        return std::chrono::milliseconds{ 0 };
+    }
+    if (capacity == 0 || period.count() == 0)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(period) + std::chrono::milliseconds{ 1 };
+    }
+
+    double seconds{ (calls - bucket.calls) * period.count() / capacity };
+    return std::chrono::milliseconds{ static_cast<int64_t>(seconds * 1000) + 1 };
+}
+
+void HttpCallGovernor::PruneIdleEndpoints(chrono_clock_t::time_point now) noexcept
+{
+    // Endpoints are per user, so without pruning they would accumulate for every user that ever made a call
+    if (now < m_nextPrune)
+    {
+        return;
+    }
+    m_nextPrune = now + EndpointIdleTimeout / 4;
+
+    for (auto iter = m_endpoints.begin(); iter != m_endpoints.end();)
+    {
+        auto& endpoint{ iter->second };
+        bool idle{ now - endpoint.lastUsed >= EndpointIdleTimeout && now >= endpoint.blockedUntil };
+
+        auto budget{ FindBudget(iter->first.second) };
+        if (idle && budget && endpoint.initialized)
+        {
+            // An endpoint that is still refilling would give the user a fresh budget if it were forgotten
+            Refill(endpoint.burst, budget->burstCallCount, budget->burstPeriod, now);
+            Refill(endpoint.sustained, budget->sustainedCallCount, budget->sustainedPeriod, now);
+            idle = endpoint.burst.calls >= budget->burstCallCount && endpoint.sustained.calls >= budget->sustainedCallCount;
+        }
+
+        iter = idle ? m_endpoints.erase(iter) : std::next(iter);
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+enum class HttpCallPriority : uint32_t
+{
+    // Calls a player is waiting on
+    Interactive,
+    // Periodic or deferrable work, such as event uploads and Social Manager graph refreshes and presence polls
+    Background
+};
+
+// Client side model of Xbox Live's per user, per endpoint call limits. Each endpoint has a burst and a sustained
+// token bucket, and a call is only made once both have a call to spare. Calls that would exceed the budget are
+// deferred rather than sent and throttled. Background calls also leave BackgroundReservePercent of each bucket for
+// interactive calls, so interactive calls get through first under load.
+//
+// Calls are also held after a 429 response until its Retry-After has passed. Otherwise endpoints are only governed
+// once a budget is set for them, either for their host or as the default.
+//
+// Endpoints are tracked per user and host, matching the granularity budgets are set at. An endpoint is forgotten,
+// along with its counts, once the user hasn't called it for EndpointIdleTimeout and it has its full budget back.
+class HttpCallGovernor
+{
+public:
+    static constexpr uint32_t BackgroundReservePercent{ 25 };
+    static constexpr std::chrono::minutes EndpointIdleTimeout{ 60 };
+
+    struct Budget
+    {
+        uint32_t burstCallCount;
+        std::chrono::seconds burstPeriod;
+        uint32_t sustainedCallCount;
+        std::chrono::seconds sustainedPeriod;
+    };
+
+    struct Headroom
+    {
+        bool isLimited;
+        uint32_t burstCallsRemaining;
+        uint32_t sustainedCallsRemaining;
+        uint64_t deferredCallCount;
+        uint64_t throttledCallCount;
+    };
+
+    // Sets the budget for a host, or the default budget if host is empty. A null budget removes it.
+    void SetBudget(
+        const String& host,
+        const Budget* budget
+    ) noexcept;
+
+    // Returns zero if the call can be made now, and counts it against the endpoint's budget. Otherwise returns how
+    // long to wait before calling Acquire again.
+    std::chrono::milliseconds Acquire(
+        uint64_t xuid,
+        const String& url,
+        HttpCallPriority priority
+    ) noexcept;
+
+    // Records a 429 response. No calls are made to the endpoint until retryAfter has passed.
+    void OnThrottled(
+        uint64_t xuid,
+        const String& url,
+        std::chrono::seconds retryAfter
+    ) noexcept;
+
+    Headroom GetHeadroom(
+        uint64_t xuid,
+        const String& host
+    ) const noexcept;
+
+    // Converts a Retry-After header to a wait. The header is either a number of seconds or an HTTP-date, which is
+    // measured from the response's Date header so the client clock doesn't skew it. If the response has no Date
+    // header the current time is used. Unparseable values give no wait.
+    static std::chrono::seconds ParseRetryAfter(
+        const String& retryAfter,
+        const String& responseDate
+    ) noexcept;
+
+private:
+    struct Bucket
+    {
+        double calls{ 0 };
+        chrono_clock_t::time_point lastRefill{};
+    };
+
+    struct Endpoint
+    {
+        bool initialized{ false };
+        Bucket burst;
+        Bucket sustained;
+        chrono_clock_t::time_point blockedUntil{};
+        chrono_clock_t::time_point lastUsed{};
+        uint64_t deferredCallCount{ 0 };
+        uint64_t throttledCallCount{ 0 };
+    };
+
+    using EndpointKey = std::pair<uint64_t, String>;
+
+    const Budget* FindBudget(const String& host) const noexcept;
+    static void Refill(Bucket& bucket, uint32_t capacity, std::chrono::seconds period, chrono_clock_t::time_point now) noexcept;
+    static std::chrono::milliseconds TimeUntil(const Bucket& bucket, double calls, uint32_t capacity, std::chrono::seconds period) noexcept;
+    void PruneIdleEndpoints(chrono_clock_t::time_point now) noexcept;
+
+    mutable std::mutex m_mutex;
+    Map<String, Budget> m_budgets;
+    Map<EndpointKey, Endpoint> m_endpoints;
+    chrono_clock_t::time_point m_nextPrune{};
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
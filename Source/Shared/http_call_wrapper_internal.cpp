@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "xbox_live_context_internal.h"
+#include "http_compression.h"
 #include <httpClient/httpProvider.h>
 
 using namespace xbox::services;
@@ -48,12 +49,14 @@ HRESULT HttpCall::SetHeader(
 HRESULT HttpCall::SetRequestBody(const xsapi_internal_vector<uint8_t>& bytes)
 {
     assert(m_step == Step::Pending);
+    ClearBorrowedRequestBody();
     return HCHttpCallRequestSetRequestBodyBytes(m_callHandle, bytes.data(), static_cast<uint32_t>(bytes.size()));
 }
 
 HRESULT HttpCall::SetRequestBody(const xsapi_internal_string& bodyString)
 {
     assert(m_step == Step::Pending);
+    ClearBorrowedRequestBody();
     return HCHttpCallRequestSetRequestBodyString(m_callHandle, bodyString.data());
 }
 
@@ -124,6 +127,7 @@ HRESULT HttpCall::Perform(
         }
         else
         {
+            m_performTimer = ProfileTimer{ XblProfileArea::HttpPerform };
             hr = HCHttpCallPerformAsync(m_callHandle, &m_asyncBlock);
         }
 
@@ -187,12 +191,19 @@ HRESULT HttpCall::CopyHttpCallHandle()
         RETURN_HR_IF_FAILED(HCHttpCallRequestSetHeader(newCallHandle.h, headerName, headerValue, false));
     }
 
-    const uint8_t* requestBodyBytes{ nullptr };
-    uint32_t requestBodySize{ 0 };
-    RETURN_HR_IF_FAILED(HCHttpCallRequestGetRequestBodyBytes(m_callHandle, &requestBodyBytes, &requestBodySize));
-    if (requestBodyBytes != nullptr && requestBodySize > 0)
+    if (m_borrowedRequestBody != nullptr)
     {
-        RETURN_HR_IF_FAILED(HCHttpCallRequestSetRequestBodyBytes(newCallHandle.h, requestBodyBytes, requestBodySize));
+        RETURN_HR_IF_FAILED(HCHttpCallRequestSetRequestBodyReadFunction(newCallHandle.h, ReadBorrowedRequestBody, m_borrowedRequestBodySize, this));
+    }
+    else
+    {
+        const uint8_t* requestBodyBytes{ nullptr };
+        uint32_t requestBodySize{ 0 };
+        RETURN_HR_IF_FAILED(HCHttpCallRequestGetRequestBodyBytes(m_callHandle, &requestBodyBytes, &requestBodySize));
+        if (requestBodyBytes != nullptr && requestBodySize > 0)
+        {
+            RETURN_HR_IF_FAILED(HCHttpCallRequestSetRequestBodyBytes(newCallHandle.h, requestBodyBytes, requestBodySize));
+        }
     }
 
     HCHttpCallCloseHandle(m_callHandle);
@@ -213,6 +224,33 @@ HRESULT xbox::services::HttpCall::ResetAndCopyForRetry()
     return hr;
 }
 
+HRESULT HttpCall::CompleteWithResponse(
+    AsyncContext<HttpResult> async,
+    uint32_t httpStatus,
+    const HttpHeaders& headers,
+    const xsapi_internal_vector<uint8_t>& body
+)
+{
+    assert(m_step == Step::Pending);
+
+    RETURN_HR_IF_FAILED(HCHttpCallResponseSetStatusCode(m_callHandle, httpStatus));
+    for (const auto& header : headers)
+    {
+        RETURN_HR_IF_FAILED(HCHttpCallResponseSetHeader(m_callHandle, header.first.data(), header.second.data()));
+    }
+    RETURN_HR_IF_FAILED(HCHttpCallResponseSetResponseBodyBytes(m_callHandle, body.data(), body.size()));
+
+    m_asyncContext = std::move(async);
+    m_performAlreadyCalled = true;
+    m_step = Step::Done;
+
+    // Complete on the queue as a network response would, rather than from within the caller
+    return m_asyncContext.Queue().RunCompletion([sharedThis{ shared_from_this() }]
+    {
+        sharedThis->m_asyncContext.Complete(HttpResult{ sharedThis });
+    });
+}
+
 HRESULT HttpCall::ConvertHttpStatusToHRESULT(_In_ uint32_t httpStatusCode)
 {
     xbox::services::xbl_error_code errCode = static_cast<xbox::services::xbl_error_code>(httpStatusCode);
@@ -377,6 +415,7 @@ JsonDocument HttpCall::GetResponseBodyJson() const
     JsonDocument json;
     if (bodyString != nullptr)
     {
+        XSAPI_PROFILE_SCOPE(XblProfileArea::JsonParse);
         json.Parse(bodyString);
         if (!json.HasParseError())
         {
@@ -386,6 +425,23 @@ JsonDocument HttpCall::GetResponseBodyJson() const
     return JsonDocument(rapidjson::kNullType);
 }
 
+HRESULT HttpCall::GetResponseBodyJson(
+    _In_ JsonSaxReader& reader
+) const
+{
+    assert(m_step == Step::Done);
+
+    const char* bodyString{ nullptr };
+    RETURN_HR_IF_FAILED(HCHttpCallResponseGetResponseString(m_callHandle, &bodyString));
+    if (bodyString == nullptr)
+    {
+        return WEB_E_INVALID_JSON_STRING;
+    }
+
+    XSAPI_PROFILE_SCOPE(XblProfileArea::JsonParse);
+    return reader.Parse(bodyString);
+}
+
 xsapi_internal_string HttpCall::GetResponseHeader(const xsapi_internal_string& key) const
 {
     assert(m_step == Step::Done);
@@ -403,6 +459,7 @@ HRESULT HttpCall::SetRequestBody(
     _In_ uint32_t requestBodySize
 )
 {
+    ClearBorrowedRequestBody();
     return HCHttpCallRequestSetRequestBodyBytes(m_callHandle, requestBodyBytes, requestBodySize);
 }
 
@@ -410,9 +467,53 @@ HRESULT HttpCall::SetRequestBody(
     _In_z_ const char* requestBodyString
 )
 {
+    ClearBorrowedRequestBody();
     return HCHttpCallRequestSetRequestBodyString(m_callHandle, requestBodyString);
 }
 
+HRESULT HttpCall::SetBorrowedRequestBody(
+    _In_reads_bytes_(requestBodySize) const uint8_t* requestBodyBytes,
+    _In_ size_t requestBodySize
+)
+{
+    assert(m_step == Step::Pending);
+    RETURN_HR_IF_FAILED(HCHttpCallRequestSetRequestBodyReadFunction(m_callHandle, ReadBorrowedRequestBody, requestBodySize, this));
+
+    m_borrowedRequestBody = requestBodyBytes;
+    m_borrowedRequestBodySize = requestBodySize;
+    return S_OK;
+}
+
+void HttpCall::ClearBorrowedRequestBody()
+{
+    m_borrowedRequestBody = nullptr;
+    m_borrowedRequestBodySize = 0;
+}
+
+HRESULT CALLBACK HttpCall::ReadBorrowedRequestBody(
+    _In_ HCCallHandle callHandle,
+    _In_ size_t offset,
+    _In_ size_t bytesAvailable,
+    _In_opt_ void* context,
+    _Out_writes_bytes_to_(bytesAvailable, *bytesWritten) uint8_t* destination,
+    _Out_ size_t* bytesWritten
+)
+{
+    UNREFERENCED_PARAMETER(callHandle);
+
+    // The call outlives its requests, so the context is still valid here
+    auto httpCall{ static_cast<HttpCall*>(context) };
+    if (httpCall == nullptr || offset > httpCall->m_borrowedRequestBodySize)
+    {
+        return E_UNEXPECTED;
+    }
+
+    size_t count{ (std::min)(bytesAvailable, httpCall->m_borrowedRequestBodySize - offset) };
+    memcpy(destination, httpCall->m_borrowedRequestBody + offset, count);
+    *bytesWritten = count;
+    return S_OK;
+}
+
 HRESULT HttpCall::GetResponseString(
     _Out_ const char** responseString
 )
@@ -512,6 +613,7 @@ void HttpCall::CompletionCallback(_In_ XAsyncBlock* async)
     auto sharedThis{ static_cast<HttpCall*>(async->context)->shared_from_this() };
     sharedThis->DecRef();
 
+    sharedThis->m_performTimer.Stop();
     sharedThis->m_step = Step::Done;
     sharedThis->m_asyncContext.Complete(HttpResult{ sharedThis });
 }
@@ -537,6 +639,11 @@ void XblHttpCall::SetLongHttpCall(_In_ bool longHttpCall)
     m_longHttpCall = longHttpCall;
 }
 
+void XblHttpCall::SetPriority(_In_ HttpCallPriority priority)
+{
+    m_priority = priority;
+}
+
 XblHttpCall::XblHttpCall(_In_ User&& user)
     : m_user{ std::move(user) }
 {
@@ -563,6 +670,25 @@ HRESULT XblHttpCall::Init(
     RETURN_HR_IF_FAILED(SetHeader(ACCEPT_LANGUAGE_HEADER, utils::get_locales()));
     RETURN_HR_IF_FAILED(SetUserAgent(contextSettings->HttpUserAgent()));
 
+    // Event uploads can wait, so they don't use up the budget interactive calls need. Other callers mark their
+    // deferrable calls with SetPriority.
+    if (xboxLiveApi == xbox_live_api::events_upload)
+    {
+        m_priority = HttpCallPriority::Background;
+    }
+
+    if (utils::str_icmp_internal(httpMethod, "GET") == 0)
+    {
+        m_responseCache = contextSettings->ResponseCache(fullUrl);
+    }
+
+    m_compressionAllowed = contextSettings->IsCompressionAllowed(fullUrl);
+    m_compressionThreshold = contextSettings->RequestCompressionThreshold();
+    if (m_compressionAllowed)
+    {
+        RETURN_HR_IF_FAILED(SetHeader(ACCEPT_ENCODING_HEADER, "gzip, deflate"));
+    }
+
     return S_OK;
 }
 
@@ -632,7 +758,7 @@ HRESULT XblHttpCall::SetUserAgent(_In_ HttpCallAgent userAgent)
 HRESULT XblHttpCall::SetRequestBody(const xsapi_internal_vector<uint8_t>& bytes)
 {
     m_requestBody = bytes;
-    return HttpCall::SetRequestBody(xsapi_internal_vector<uint8_t>{ bytes });
+    return HttpCall::SetRequestBody(m_requestBody);
 }
 
 HRESULT XblHttpCall::SetRequestBody(_In_reads_bytes_(requestBodySize) const uint8_t* requestBodyBytes, _In_ uint32_t requestBodySize)
@@ -658,6 +784,16 @@ HRESULT XblHttpCall::SetRequestBody(const JsonValue& bodyJson)
     return SetRequestBody(JsonUtils::SerializeJson(bodyJson));
 }
 
+HRESULT XblHttpCall::SetBorrowedRequestBody(
+    _In_reads_bytes_(requestBodySize) const uint8_t* requestBodyBytes,
+    _In_ size_t requestBodySize
+)
+{
+    // Borrowed bodies are signed in place and never compressed, so the call doesn't need its own copy
+    m_requestBody.clear();
+    return HttpCall::SetBorrowedRequestBody(requestBodyBytes, requestBodySize);
+}
+
 void XblHttpCall::SetAuthRetryAllowed(bool authRetryAllowed)
 {
     m_authRetryExplicitlyAllowed = authRetryAllowed;
@@ -670,15 +806,71 @@ HRESULT XblHttpCall::Perform(
 {
     m_asyncContext = std::move(async);
 
-    std::shared_ptr<XblHttpCall> sharedThis = { std::dynamic_pointer_cast<XblHttpCall>(shared_from_this()) };
-
-    auto now = chrono_clock_t::now();
     if (m_iterationNumber == 0)
     {
-        m_firstCallStartTime = now;
+        m_firstCallStartTime = chrono_clock_t::now();
+
+        // Compress before signing so the signature covers the bytes that are sent
+        RETURN_HR_IF_FAILED(CompressRequestBody());
+
+        if (m_responseCache)
+        {
+            bool requestNeeded{ true };
+            HRESULT hr = LookupResponseCache(requestNeeded);
+            if (FAILED(hr) || !requestNeeded)
+            {
+                ReleaseResponseCache();
+                return hr;
+            }
+        }
+    }
+
+    HRESULT hr = GovernAndPerform(forceRefresh);
+    if (FAILED(hr))
+    {
+        ReleaseResponseCache();
+    }
+    return hr;
+}
+
+HRESULT XblHttpCall::GovernAndPerform(bool forceRefresh)
+{
+    // Hold the call until the endpoint's budget allows it rather than sending it to be throttled
+    auto state{ GlobalState::Get() };
+    auto delay{ state ? state->HttpCallGovernor()->Acquire(m_user.Xuid(), m_fullUrl, m_priority) : std::chrono::milliseconds{ 0 } };
+    if (delay.count() == 0)
+    {
+        return AuthorizeAndPerform(forceRefresh);
     }
+
+    // Don't hold the call past its timeout window. A Retry-After can be far longer than the title expects a call
+    // to take, so fail it as throttled rather than leave the title waiting on it.
+    auto window{ std::chrono::seconds{ m_longHttpCall ? m_longHttpTimeout : m_httpTimeoutWindowInSeconds } };
+    auto elapsed{ std::chrono::duration_cast<std::chrono::milliseconds>(chrono_clock_t::now() - m_firstCallStartTime) };
+    if (elapsed + delay > window)
+    {
+        LOGS_DEBUG << "Call to " << m_fullUrl << " would be held for " << delay.count() << "ms, past its timeout window";
+        return MAKE_HTTP_HRESULT(429);
+    }
+
+    std::shared_ptr<XblHttpCall> sharedThis = { std::dynamic_pointer_cast<XblHttpCall>(shared_from_this()) };
+    return m_asyncContext.Queue().RunWork([sharedThis, forceRefresh]
+    {
+        HRESULT hr = sharedThis->GovernAndPerform(forceRefresh);
+        if (FAILED(hr))
+        {
+            sharedThis->ReleaseResponseCache();
+            sharedThis->m_asyncContext.Complete(HttpResult{ hr });
+        }
+    }, static_cast<uint64_t>(delay.count()));
+}
+
+HRESULT XblHttpCall::AuthorizeAndPerform(bool forceRefresh)
+{
+    std::shared_ptr<XblHttpCall> sharedThis = { std::dynamic_pointer_cast<XblHttpCall>(shared_from_this()) };
+
     m_iterationNumber++;
-    m_requestStartTime = now;
+    m_requestStartTime = chrono_clock_t::now();
 
     if (forceRefresh)
     {
@@ -689,8 +881,8 @@ HRESULT XblHttpCall::Perform(
         m_httpMethod,
         m_fullUrl,
         m_requestHeaders,
-        m_requestBody.data(),
-        m_requestBody.size(),
+        m_borrowedRequestBody ? m_borrowedRequestBody : m_requestBody.data(),
+        m_borrowedRequestBody ? m_borrowedRequestBodySize : m_requestBody.size(),
         false, // allUsersAuthRequired
         AsyncContext<xbox::services::Result<TokenAndSignature>>{ m_asyncContext.Queue(),
         [
@@ -745,11 +937,169 @@ HRESULT XblHttpCall::Perform(
     });
 }
 
+HRESULT XblHttpCall::LookupResponseCache(_Out_ bool& requestNeeded)
+{
+    requestNeeded = true;
+
+    // Requests that differ in any header may get different responses
+    m_responseCacheKey = m_fullUrl;
+    for (const auto& header : m_requestHeaders)
+    {
+        m_responseCacheKey += '\n' + header.first + ':' + header.second;
+    }
+
+    std::shared_ptr<XblHttpCall> sharedThis = { std::dynamic_pointer_cast<XblHttpCall>(shared_from_this()) };
+    HttpResponseCache::Waiter waiter{ [sharedThis](std::shared_ptr<const HttpResponseCache::Response> response)
+    {
+        // Share the response of the request this call was waiting on, or make the request if there isn't one
+        HRESULT hr = response ?
+            sharedThis->CompleteWithResponse(sharedThis->m_asyncContext, 200, response->headers, response->body) :
+            sharedThis->GovernAndPerform(false);
+
+        if (FAILED(hr))
+        {
+            sharedThis->m_asyncContext.Complete(HttpResult{ hr });
+        }
+    } };
+
+    auto lookup{ m_responseCache->Acquire(m_responseCacheKey, waiter) };
+    switch (lookup.action)
+    {
+    case HttpResponseCache::Action::UseCached:
+    {
+        requestNeeded = false;
+        return CompleteWithResponse(m_asyncContext, 200, lookup.response->headers, lookup.response->body);
+    }
+    case HttpResponseCache::Action::Joined:
+    {
+        requestNeeded = false;
+        return S_OK;
+    }
+    case HttpResponseCache::Action::Revalidate:
+    {
+        m_responseCachePending = true;
+
+        auto etag{ HttpResponseCache::GetHeader(lookup.response->headers, ETAG_HEADER) };
+        if (!etag.empty())
+        {
+            m_revalidatedResponse = std::move(lookup.response);
+            return SetHeader(IF_NONE_MATCH_HEADER, etag);
+        }
+        return S_OK;
+    }
+    default:
+    {
+        m_responseCachePending = true;
+        return S_OK;
+    }
+    }
+}
+
+HRESULT XblHttpCall::UpdateResponseCache()
+{
+    if (!m_responseCachePending)
+    {
+        return S_OK;
+    }
+    m_responseCachePending = false;
+
+    uint32_t httpStatus{ HttpStatus() };
+    if (httpStatus == 304 && m_revalidatedResponse)
+    {
+        auto response{ m_responseCache->Complete(m_responseCacheKey, httpStatus, GetResponseHeaders(), xsapi_internal_vector<uint8_t>{}, m_revalidatedResponse) };
+
+        // Return the stored response as though the service had sent it, keeping any headers sent with the 304
+        RETURN_HR_IF_FAILED(HCHttpCallResponseSetStatusCode(m_callHandle, 200));
+        for (const auto& header : response->headers)
+        {
+            const char* value{ nullptr };
+            if (FAILED(HCHttpCallResponseGetHeader(m_callHandle, header.first.data(), &value)) || value == nullptr)
+            {
+                RETURN_HR_IF_FAILED(HCHttpCallResponseSetHeader(m_callHandle, header.first.data(), header.second.data()));
+            }
+        }
+        return HCHttpCallResponseSetResponseBodyBytes(m_callHandle, response->body.data(), response->body.size());
+    }
+
+    m_responseCache->Complete(
+        m_responseCacheKey,
+        httpStatus,
+        GetResponseHeaders(),
+        httpStatus == 200 ? GetResponseBodyBytes() : xsapi_internal_vector<uint8_t>{},
+        nullptr
+    );
+    return S_OK;
+}
+
+void XblHttpCall::ReleaseResponseCache()
+{
+    // Lets requests waiting on this one make their own
+    if (m_responseCachePending)
+    {
+        m_responseCachePending = false;
+        m_responseCache->Complete(m_responseCacheKey, 0, HttpHeaders{}, xsapi_internal_vector<uint8_t>{}, nullptr);
+    }
+}
+
+HRESULT XblHttpCall::CompressRequestBody()
+{
+    if (!m_compressionAllowed || m_requestBody.empty() || m_requestBody.size() < m_compressionThreshold)
+    {
+        return S_OK;
+    }
+
+    auto compressResult = HttpCompression::Compress(HttpContentEncoding::Gzip, m_requestBody.data(), m_requestBody.size());
+    if (Failed(compressResult) || compressResult.Payload().size() >= m_requestBody.size())
+    {
+        // Not worth compressing, send the body as is
+        return S_OK;
+    }
+
+    m_requestBody = compressResult.ExtractPayload();
+    RETURN_HR_IF_FAILED(SetHeader(CONTENT_ENCODING_HEADER, HttpCompression::HeaderValue(HttpContentEncoding::Gzip)));
+    return HttpCall::SetRequestBody(m_requestBody);
+}
+
+HRESULT XblHttpCall::DecompressResponseBody()
+{
+    // Only codings offered in Accept-Encoding are decoded, and only when the response says it used one. The body
+    // itself is never sniffed, so an uncompressed body that happens to look compressed is left alone.
+    HttpContentEncoding encoding{ HttpCompression::EncodingFromHeader(GetResponseHeader(CONTENT_ENCODING_HEADER)) };
+    if (encoding == HttpContentEncoding::Identity)
+    {
+        return S_OK;
+    }
+
+    auto body{ GetResponseBodyBytes() };
+    if (body.empty())
+    {
+        return S_OK;
+    }
+
+    auto decompressResult = HttpCompression::Decompress(encoding, body.data(), body.size());
+    RETURN_HR_IF_FAILED(decompressResult.Hresult());
+
+    const auto& decompressedBody{ decompressResult.Payload() };
+    return HCHttpCallResponseSetResponseBodyBytes(m_callHandle, decompressedBody.data(), decompressedBody.size());
+}
+
 void XblHttpCall::IntermediateHttpCallCompleteCallback(HttpResult result)
 {
     auto httpCall = result.Payload();
     if (httpCall)
     {
+        if (m_compressionAllowed)
+        {
+            HRESULT hr = DecompressResponseBody();
+            if (FAILED(hr))
+            {
+                LOGS_ERROR << "Failed to decompress response from " << m_fullUrl << ", hr=" << hr;
+                ReleaseResponseCache();
+                m_asyncContext.Complete(HttpResult{ hr });
+                return;
+            }
+        }
+
         bool wasHandled{ false };
         HRESULT hr = HandleAuthError(httpCall, wasHandled);
         if (wasHandled)
@@ -758,13 +1108,22 @@ void XblHttpCall::IntermediateHttpCallCompleteCallback(HttpResult result)
         }
         if (FAILED(hr))
         {
+            ReleaseResponseCache();
             m_asyncContext.Complete(HttpResult{ hr });
             return;
         }
 
         HandleThrottleError(httpCall);
+
+        hr = UpdateResponseCache();
+        if (FAILED(hr))
+        {
+            m_asyncContext.Complete(HttpResult{ hr });
+            return;
+        }
     }
 
+    ReleaseResponseCache();
     m_asyncContext.Complete(std::move(result));
 }
 
@@ -814,6 +1173,17 @@ void XblHttpCall::HandleThrottleError(_In_ std::shared_ptr<class HttpCall> httpC
         return;
     }
 
+    // Hold further calls to the endpoint until the service will accept them again
+    auto state{ GlobalState::Get() };
+    if (state)
+    {
+        auto retryAfter{ HttpCallGovernor::ParseRetryAfter(
+            httpCall->GetResponseHeader(RETRY_AFTER_HEADER),
+            httpCall->GetResponseHeader(DATE_HEADER)
+        ) };
+        state->HttpCallGovernor()->OnThrottled(m_user.Xuid(), m_fullUrl, retryAfter);
+    }
+
     // Assert if we were throttled by the service so the game dev knows that they are calling Xbox Live to agressively
     auto appConfig = AppConfig::Instance();
     if (appConfig && utils::str_icmp_internal(appConfig->Sandbox(), "RETAIL") != 0)
@@ -2,6 +2,7 @@
 #include "httpClient/httpClient.h"
 #include "shared_macros.h"
 #include "xbox_live_context_settings_internal.h"
+#include "http_call_governor.h"
 
 const char CONTENT_TYPE_HEADER[] = "Content-Type";
 const char ACCEPT_LANGUAGE_HEADER[] = "Accept-Language";
@@ -133,6 +134,9 @@ public:
     virtual HRESULT SetRequestBody(const xsapi_internal_string& bodyString);
     virtual HRESULT SetRequestBody(const JsonValue& bodyJson);
     virtual HRESULT SetRequestBody(_In_z_ const char* requestBodyString);
+    // Sends the body straight from the caller's memory rather than from a copy held by the call. The bytes must
+    // stay valid and unchanged until the call completes.
+    virtual HRESULT SetBorrowedRequestBody(_In_reads_bytes_(requestBodySize) const uint8_t* requestBodyBytes, _In_ size_t requestBodySize);
     virtual HRESULT SetRetryAllowed(bool retryAllowed);
     virtual HRESULT SetRetryCacheId(uint32_t retryAfterCacheId);
     virtual HRESULT SetRetryDelay(uint32_t retryDelayInSeconds);
@@ -158,6 +162,8 @@ public:
     virtual xsapi_internal_string GetResponseBodyString() const;
     virtual HRESULT GetResponseString(_Out_ const char** responseString);
     virtual JsonDocument GetResponseBodyJson() const;
+    // Streams the response body through a SAX reader rather than building a JsonDocument
+    virtual HRESULT GetResponseBodyJson(_In_ JsonSaxReader& reader) const;
     virtual HRESULT GetNetworkErrorCode(_Out_ HRESULT* networkErrorCode, _Out_ uint32_t* platformNetworkErrorCode);
     virtual HRESULT GetPlatformNetworkErrorMessage(_Out_ const char** platformNetworkErrorMessage);
     virtual HRESULT ResponseGetHeader(_In_z_ const char* headerName, _Out_ const char** headerValue);
@@ -171,10 +177,21 @@ private:
     std::shared_ptr<RefCounter> GetSharedThis() override;
     static HRESULT ConvertHttpStatusToHRESULT(_In_ uint32_t httpStatusCode);
     HRESULT CopyHttpCallHandle();
+    void ClearBorrowedRequestBody();
+
+    static HRESULT CALLBACK ReadBorrowedRequestBody(
+        _In_ HCCallHandle callHandle,
+        _In_ size_t offset,
+        _In_ size_t bytesAvailable,
+        _In_opt_ void* context,
+        _Out_writes_bytes_to_(bytesAvailable, *bytesWritten) uint8_t* destination,
+        _Out_ size_t* bytesWritten
+    );
 
     XAsyncBlock m_asyncBlock{};
     AsyncContext<HttpResult> m_asyncContext;
     bool m_performAlreadyCalled{ false };
+    ProfileTimer m_performTimer;
 
     enum class Step
     {
@@ -186,7 +203,18 @@ private:
 
 protected:
     HCCallHandle m_callHandle{ nullptr };
+    const uint8_t* m_borrowedRequestBody{ nullptr };
+    size_t m_borrowedRequestBodySize{ 0 };
     HRESULT ResetAndCopyForRetry();
+
+    // Completes the call with a response that didn't come from the network, such as a cached response. The
+    // response is set on the call handle, so it is read the same way as a network response.
+    HRESULT CompleteWithResponse(
+        AsyncContext<HttpResult> async,
+        uint32_t httpStatus,
+        const HttpHeaders& headers,
+        const xsapi_internal_vector<uint8_t>& body
+    );
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -219,6 +247,9 @@ public:
     HRESULT SetUserAgent(_In_ HttpCallAgent userAgent);
 
     void SetLongHttpCall(_In_ bool longHttpCall);
+
+    // Background calls leave part of the endpoint's budget for interactive calls. See HttpCallGovernor.
+    void SetPriority(_In_ HttpCallPriority priority);
     HRESULT SetXblServiceContractVersion(uint32_t contractVersion);
 
     HRESULT SetRequestBody(const xsapi_internal_vector<uint8_t>& bytes) override;
@@ -226,6 +257,7 @@ public:
     HRESULT SetRequestBody(const xsapi_internal_string& bodyString) override;
     HRESULT SetRequestBody(const JsonValue& bodyJson) override;
     HRESULT SetRequestBody(_In_z_ const char* requestBodyString) override;
+    HRESULT SetBorrowedRequestBody(_In_reads_bytes_(requestBodySize) const uint8_t* requestBodyBytes, _In_ size_t requestBodySize) override;
 
     void SetAuthRetryAllowed(bool authRetryAllowed);
     HRESULT Perform(
@@ -246,6 +278,13 @@ private:
     HRESULT HandleAuthError(_In_ std::shared_ptr<class HttpCall> httpCall, _Out_ bool& wasHandled);
     void HandleThrottleError(_In_ std::shared_ptr<class HttpCall> httpCall);
     HRESULT CalcHttpTimeout();
+    HRESULT CompressRequestBody();
+    HRESULT DecompressResponseBody();
+    HRESULT GovernAndPerform(bool forceRefresh);
+    HRESULT AuthorizeAndPerform(bool forceRefresh);
+    HRESULT LookupResponseCache(_Out_ bool& requestNeeded);
+    HRESULT UpdateResponseCache();
+    void ReleaseResponseCache();
 
     User m_user;
     xsapi_internal_vector<uint8_t> m_requestBody;
@@ -261,4 +300,11 @@ private:
     AsyncContext<HttpResult> m_asyncContext;
     bool m_authRetryExplicitlyAllowed{ false };
     bool m_hasPerformedRetryOn401{ false };
+    bool m_compressionAllowed{ false };
+    size_t m_compressionThreshold{ 0 };
+    std::shared_ptr<HttpResponseCache> m_responseCache;
+    xsapi_internal_string m_responseCacheKey;
+    std::shared_ptr<const HttpResponseCache::Response> m_revalidatedResponse;
+    bool m_responseCachePending{ false };
+    HttpCallPriority m_priority{ HttpCallPriority::Interactive };
 };
\ No newline at end of file
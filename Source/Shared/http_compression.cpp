@@ -0,0 +1,907 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_compression.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+namespace
+{
+
+// DEFLATE length and distance code tables (RFC 1951 section 3.2.5)
+constexpr uint16_t LengthBase[29]{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr uint8_t LengthExtraBits[29]{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr uint16_t DistanceBase[30]{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr uint8_t DistanceExtraBits[30]{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+constexpr uint32_t EndOfBlock{ 256 };
+constexpr size_t MaxStoredBlockSize{ 0xFFFF };
+
+constexpr size_t WindowSize{ 32768 };
+constexpr size_t MinMatch{ 3 };
+constexpr size_t MaxMatch{ 258 };
+constexpr uint32_t HashBits{ 15 };
+// Bounds the match search. Request bodies are mostly small JSON documents, for which a short chain finds nearly
+// all of the available matches.
+constexpr uint32_t MaxChainLength{ 64 };
+
+constexpr size_t GzipHeaderSize{ 10 };
+constexpr size_t GzipTrailerSize{ 8 };
+constexpr uint8_t GzipFlagHeaderCrc{ 0x02 };
+constexpr uint8_t GzipFlagExtra{ 0x04 };
+constexpr uint8_t GzipFlagName{ 0x08 };
+constexpr uint8_t GzipFlagComment{ 0x10 };
+constexpr uint8_t GzipFlagsReserved{ 0xE0 };
+constexpr size_t ZlibHeaderSize{ 2 };
+constexpr size_t ZlibTrailerSize{ 4 };
+
+class BitWriter
+{
+public:
+    explicit BitWriter(Vector<uint8_t>& output) noexcept : m_output{ output } {}
+
+    // Writes count bits of value, least significant bit first
+    void Write(uint32_t value, uint32_t count) noexcept
+    {
+        m_bits |= value << m_count;
+        m_count += count;
+        while (m_count >= 8)
+        {
+            m_output.push_back(static_cast<uint8_t>(m_bits));
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    // Huffman codes are packed most significant bit first
+    void WriteCode(uint32_t code, uint32_t length) noexcept
+    {
+        uint32_t reversed{ 0 };
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        Write(reversed, length);
+    }
+
+    void Flush() noexcept
+    {
+        if (m_count > 0)
+        {
+            m_output.push_back(static_cast<uint8_t>(m_bits));
+            m_bits = 0;
+            m_count = 0;
+        }
+    }
+
+private:
+    Vector<uint8_t>& m_output;
+    uint32_t m_bits{ 0 };
+    uint32_t m_count{ 0 };
+};
+
+void WriteFixedLiteral(BitWriter& writer, uint32_t symbol) noexcept
+{
+    if (symbol < 144)
+    {
+        writer.WriteCode(0x30 + symbol, 8);
+    }
+    else if (symbol < 256)
+    {
+        writer.WriteCode(0x190 + symbol - 144, 9);
+    }
+    else if (symbol < 280)
+    {
+        writer.WriteCode(symbol - 256, 7);
+    }
+    else
+    {
+        writer.WriteCode(0xC0 + symbol - 280, 8);
+    }
+}
+
+void WriteFixedMatch(BitWriter& writer, size_t length, size_t distance) noexcept
+{
+    uint32_t lengthCode{ 28 };
+    while (LengthBase[lengthCode] > length)
+    {
+        --lengthCode;
+    }
+    WriteFixedLiteral(writer, 257 + lengthCode);
+    writer.Write(static_cast<uint32_t>(length - LengthBase[lengthCode]), LengthExtraBits[lengthCode]);
+
+    uint32_t distanceCode{ 29 };
+    while (DistanceBase[distanceCode] > distance)
+    {
+        --distanceCode;
+    }
+    writer.WriteCode(distanceCode, 5);
+    writer.Write(static_cast<uint32_t>(distance - DistanceBase[distanceCode]), DistanceExtraBits[distanceCode]);
+}
+
+uint32_t Hash(const uint8_t* data) noexcept
+{
+    uint32_t value{ static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 | static_cast<uint32_t>(data[2]) << 16 };
+    return (value * 2654435761u) >> (32 - HashBits);
+}
+
+// Single block of LZ77 matches coded with the fixed Huffman tables. Fixed codes avoid building per-body trees,
+// which keeps compression cheap, while still capturing most of the redundancy in JSON bodies.
+void DeflateFixed(const uint8_t* data, size_t size, Vector<uint8_t>& output) noexcept
+{
+    BitWriter writer{ output };
+    writer.Write(1, 1); // BFINAL
+    writer.Write(1, 2); // BTYPE = fixed Huffman
+
+    Vector<int32_t> head(size_t{ 1 } << HashBits, -1);
+    Vector<int32_t> previous(std::min(size, WindowSize), -1);
+
+    auto insert = [&](size_t position)
+    {
+        uint32_t hash{ Hash(data + position) };
+        previous[position % WindowSize] = head[hash];
+        head[hash] = static_cast<int32_t>(position);
+    };
+
+    size_t position{ 0 };
+    while (position < size)
+    {
+        size_t bestLength{ 0 };
+        size_t bestDistance{ 0 };
+
+        if (size - position >= MinMatch)
+        {
+            size_t maxLength{ std::min(MaxMatch, size - position) };
+            int32_t candidate{ head[Hash(data + position)] };
+
+            for (uint32_t chain = 0; chain < MaxChainLength && candidate >= 0; ++chain)
+            {
+                size_t candidatePosition{ static_cast<size_t>(candidate) };
+                if (position - candidatePosition > WindowSize)
+                {
+                    break;
+                }
+
+                if (data[candidatePosition + bestLength] == data[position + bestLength])
+                {
+                    size_t length{ 0 };
+                    while (length < maxLength && data[candidatePosition + length] == data[position + length])
+                    {
+                        ++length;
+                    }
+
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = position - candidatePosition;
+                        if (length == maxLength)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                int32_t next{ previous[candidatePosition % WindowSize] };
+                if (next >= candidate)
+                {
+                    break;
+                }
+                candidate = next;
+            }
+            insert(position);
+        }
+
+        if (bestLength >= MinMatch)
+        {
+            WriteFixedMatch(writer, bestLength, bestDistance);
+            for (size_t i = position + 1; i < position + bestLength && size - i >= MinMatch; ++i)
+            {
+                insert(i);
+            }
+            position += bestLength;
+        }
+        else
+        {
+            WriteFixedLiteral(writer, data[position]);
+            ++position;
+        }
+    }
+
+    WriteFixedLiteral(writer, EndOfBlock);
+    writer.Flush();
+}
+
+// Fallback for incompressible data so the output never grows by more than a few bytes per 64KB
+void DeflateStored(const uint8_t* data, size_t size, Vector<uint8_t>& output) noexcept
+{
+    size_t offset{ 0 };
+    do
+    {
+        size_t blockSize{ std::min(MaxStoredBlockSize, size - offset) };
+        bool last{ offset + blockSize == size };
+        uint16_t length{ static_cast<uint16_t>(blockSize) };
+        uint16_t lengthComplement{ static_cast<uint16_t>(~length) };
+
+        output.push_back(last ? 1 : 0); // BFINAL, BTYPE = stored, then pad to a byte boundary
+        output.push_back(static_cast<uint8_t>(length));
+        output.push_back(static_cast<uint8_t>(length >> 8));
+        output.push_back(static_cast<uint8_t>(lengthComplement));
+        output.push_back(static_cast<uint8_t>(lengthComplement >> 8));
+        output.insert(output.end(), data + offset, data + offset + blockSize);
+        offset += blockSize;
+    } while (offset < size);
+}
+
+void Deflate(const uint8_t* data, size_t size, Vector<uint8_t>& output) noexcept
+{
+    size_t start{ output.size() };
+    DeflateFixed(data, size, output);
+
+    size_t storedSize{ size + 5 * (size / MaxStoredBlockSize + 1) };
+    if (output.size() - start > storedSize)
+    {
+        output.resize(start);
+        DeflateStored(data, size, output);
+    }
+}
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size) noexcept : m_data{ data }, m_size{ size } {}
+
+    bool Read(uint32_t count, uint32_t& value) noexcept
+    {
+        while (m_count < count)
+        {
+            if (m_position == m_size)
+            {
+                return false;
+            }
+            m_bits |= static_cast<uint32_t>(m_data[m_position++]) << m_count;
+            m_count += 8;
+        }
+
+        value = m_bits & ((1u << count) - 1);
+        m_bits >>= count;
+        m_count -= count;
+        return true;
+    }
+
+    // Discards bits up to the next byte boundary and returns the offset of the next unread byte
+    size_t AlignToByte() noexcept
+    {
+        m_bits = 0;
+        m_count = 0;
+        return m_position;
+    }
+
+    bool ReadBytes(size_t count, const uint8_t*& bytes) noexcept
+    {
+        assert(m_count == 0);
+        if (m_size - m_position < count)
+        {
+            return false;
+        }
+        bytes = m_data + m_position;
+        m_position += count;
+        return true;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_position{ 0 };
+    uint32_t m_bits{ 0 };
+    uint32_t m_count{ 0 };
+};
+
+constexpr uint32_t MaxCodeLength{ 15 };
+constexpr uint32_t MaxLiteralLengthCodes{ 286 };
+constexpr uint32_t MaxDistanceCodes{ 30 };
+
+// Canonical Huffman decoding table: the number of codes of each length, and the symbols ordered by code
+struct Huffman
+{
+    uint16_t count[MaxCodeLength + 1];
+    uint16_t symbol[288];
+
+    // Returns 0 for a complete code, a positive value for an incomplete code and a negative value for an
+    // over-subscribed code
+    int Build(const uint16_t* lengths, uint32_t symbolCount) noexcept
+    {
+        std::fill(std::begin(count), std::end(count), uint16_t{ 0 });
+        for (uint32_t i = 0; i < symbolCount; ++i)
+        {
+            ++count[lengths[i]];
+        }
+        if (count[0] == symbolCount)
+        {
+            return 0;
+        }
+
+        int left{ 1 };
+        for (uint32_t length = 1; length <= MaxCodeLength; ++length)
+        {
+            left <<= 1;
+            left -= count[length];
+            if (left < 0)
+            {
+                return left;
+            }
+        }
+
+        uint16_t offsets[MaxCodeLength + 1]{ 0, 0 };
+        for (uint32_t length = 1; length < MaxCodeLength; ++length)
+        {
+            offsets[length + 1] = static_cast<uint16_t>(offsets[length] + count[length]);
+        }
+        for (uint32_t i = 0; i < symbolCount; ++i)
+        {
+            if (lengths[i] != 0)
+            {
+                symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+        return left;
+    }
+
+    int Decode(BitReader& reader) const noexcept
+    {
+        int code{ 0 };
+        int first{ 0 };
+        int index{ 0 };
+        for (uint32_t length = 1; length <= MaxCodeLength; ++length)
+        {
+            uint32_t bit{ 0 };
+            if (!reader.Read(1, bit))
+            {
+                return -1;
+            }
+            code |= static_cast<int>(bit);
+
+            int codeCount{ count[length] };
+            if (code - codeCount < first)
+            {
+                return symbol[index + (code - first)];
+            }
+            index += codeCount;
+            first += codeCount;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+struct FixedHuffmanTables
+{
+    FixedHuffmanTables() noexcept
+    {
+        uint16_t lengths[288];
+        std::fill(lengths, lengths + 144, uint16_t{ 8 });
+        std::fill(lengths + 144, lengths + 256, uint16_t{ 9 });
+        std::fill(lengths + 256, lengths + 280, uint16_t{ 7 });
+        std::fill(lengths + 280, lengths + 288, uint16_t{ 8 });
+        literalLength.Build(lengths, 288);
+
+        std::fill(lengths, lengths + MaxDistanceCodes, uint16_t{ 5 });
+        distance.Build(lengths, MaxDistanceCodes);
+    }
+
+    Huffman literalLength;
+    Huffman distance;
+};
+
+HRESULT InflateCodes(
+    BitReader& reader,
+    const Huffman& literalLength,
+    const Huffman& distance,
+    Vector<uint8_t>& output
+) noexcept
+{
+    for (;;)
+    {
+        int symbol{ literalLength.Decode(reader) };
+        if (symbol < 0)
+        {
+            return E_UNEXPECTED;
+        }
+        if (symbol < 256)
+        {
+            if (output.size() >= HttpCompression::MaxDecompressedSize)
+            {
+                return E_BOUNDS;
+            }
+            output.push_back(static_cast<uint8_t>(symbol));
+            continue;
+        }
+        if (symbol == EndOfBlock)
+        {
+            return S_OK;
+        }
+
+        uint32_t lengthCode{ static_cast<uint32_t>(symbol) - 257 };
+        uint32_t extra{ 0 };
+        if (lengthCode >= 29 || !reader.Read(LengthExtraBits[lengthCode], extra))
+        {
+            return E_UNEXPECTED;
+        }
+        size_t length{ LengthBase[lengthCode] + extra };
+
+        int distanceCode{ distance.Decode(reader) };
+        if (distanceCode < 0 || distanceCode >= static_cast<int>(MaxDistanceCodes) || !reader.Read(DistanceExtraBits[distanceCode], extra))
+        {
+            return E_UNEXPECTED;
+        }
+        size_t matchDistance{ DistanceBase[distanceCode] + extra };
+        if (matchDistance > output.size())
+        {
+            return E_UNEXPECTED;
+        }
+        if (output.size() + length > HttpCompression::MaxDecompressedSize)
+        {
+            return E_BOUNDS;
+        }
+
+        // Matches may overlap the bytes they produce, so copy one byte at a time
+        size_t source{ output.size() - matchDistance };
+        for (size_t i = 0; i < length; ++i)
+        {
+            uint8_t byte{ output[source + i] };
+            output.push_back(byte);
+        }
+    }
+}
+
+HRESULT InflateDynamicTables(
+    BitReader& reader,
+    Huffman& literalLength,
+    Huffman& distance
+) noexcept
+{
+    static constexpr uint8_t CodeLengthOrder[19]{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    uint32_t literalLengthCount{ 0 };
+    uint32_t distanceCount{ 0 };
+    uint32_t codeLengthCount{ 0 };
+    if (!reader.Read(5, literalLengthCount) || !reader.Read(5, distanceCount) || !reader.Read(4, codeLengthCount))
+    {
+        return E_UNEXPECTED;
+    }
+    literalLengthCount += 257;
+    distanceCount += 1;
+    codeLengthCount += 4;
+    if (literalLengthCount > MaxLiteralLengthCodes || distanceCount > MaxDistanceCodes)
+    {
+        return E_UNEXPECTED;
+    }
+
+    uint16_t lengths[MaxLiteralLengthCodes + MaxDistanceCodes]{};
+    for (uint32_t i = 0; i < codeLengthCount; ++i)
+    {
+        uint32_t length{ 0 };
+        if (!reader.Read(3, length))
+        {
+            return E_UNEXPECTED;
+        }
+        lengths[CodeLengthOrder[i]] = static_cast<uint16_t>(length);
+    }
+
+    Huffman codeLength;
+    if (codeLength.Build(lengths, 19) != 0)
+    {
+        return E_UNEXPECTED;
+    }
+
+    uint32_t index{ 0 };
+    while (index < literalLengthCount + distanceCount)
+    {
+        int symbol{ codeLength.Decode(reader) };
+        if (symbol < 0)
+        {
+            return E_UNEXPECTED;
+        }
+        if (symbol < 16)
+        {
+            lengths[index++] = static_cast<uint16_t>(symbol);
+            continue;
+        }
+
+        uint16_t repeatedLength{ 0 };
+        uint32_t repeat{ 0 };
+        bool read{ false };
+        if (symbol == 16)
+        {
+            if (index == 0)
+            {
+                return E_UNEXPECTED;
+            }
+            repeatedLength = lengths[index - 1];
+            read = reader.Read(2, repeat);
+            repeat += 3;
+        }
+        else if (symbol == 17)
+        {
+            read = reader.Read(3, repeat);
+            repeat += 3;
+        }
+        else
+        {
+            read = reader.Read(7, repeat);
+            repeat += 11;
+        }
+
+        if (!read || index + repeat > literalLengthCount + distanceCount)
+        {
+            return E_UNEXPECTED;
+        }
+        std::fill(lengths + index, lengths + index + repeat, repeatedLength);
+        index += repeat;
+    }
+
+    if (lengths[EndOfBlock] == 0)
+    {
+        return E_UNEXPECTED;
+    }
+
+    // Incomplete codes are only allowed when they have a single symbol
+    int result{ literalLength.Build(lengths, literalLengthCount) };
+    if (result < 0 || (result > 0 && literalLengthCount - literalLength.count[0] != 1))
+    {
+        return E_UNEXPECTED;
+    }
+    result = distance.Build(lengths + literalLengthCount, distanceCount);
+    if (result < 0 || (result > 0 && distanceCount - distance.count[0] != 1))
+    {
+        return E_UNEXPECTED;
+    }
+    return S_OK;
+}
+
+// Decodes a raw DEFLATE stream, appending to output. On success consumed is set to the number of input bytes
+// used, which may be fewer than size if the stream is followed by a trailer.
+HRESULT Inflate(
+    const uint8_t* data,
+    size_t size,
+    Vector<uint8_t>& output,
+    size_t& consumed
+) noexcept
+{
+    static const FixedHuffmanTables fixedTables{};
+
+    BitReader reader{ data, size };
+    uint32_t last{ 0 };
+    do
+    {
+        uint32_t type{ 0 };
+        if (!reader.Read(1, last) || !reader.Read(2, type))
+        {
+            return E_UNEXPECTED;
+        }
+
+        switch (type)
+        {
+        case 0:
+        {
+            reader.AlignToByte();
+            const uint8_t* header{ nullptr };
+            if (!reader.ReadBytes(4, header))
+            {
+                return E_UNEXPECTED;
+            }
+            uint16_t length{ static_cast<uint16_t>(header[0] | header[1] << 8) };
+            uint16_t lengthComplement{ static_cast<uint16_t>(header[2] | header[3] << 8) };
+            if (length != static_cast<uint16_t>(~lengthComplement))
+            {
+                return E_UNEXPECTED;
+            }
+
+            const uint8_t* bytes{ nullptr };
+            if (!reader.ReadBytes(length, bytes))
+            {
+                return E_UNEXPECTED;
+            }
+            if (output.size() + length > HttpCompression::MaxDecompressedSize)
+            {
+                return E_BOUNDS;
+            }
+            output.insert(output.end(), bytes, bytes + length);
+            break;
+        }
+        case 1:
+        {
+            RETURN_HR_IF_FAILED(InflateCodes(reader, fixedTables.literalLength, fixedTables.distance, output));
+            break;
+        }
+        case 2:
+        {
+            Huffman literalLength;
+            Huffman distance;
+            RETURN_HR_IF_FAILED(InflateDynamicTables(reader, literalLength, distance));
+            RETURN_HR_IF_FAILED(InflateCodes(reader, literalLength, distance, output));
+            break;
+        }
+        default:
+        {
+            return E_UNEXPECTED;
+        }
+        }
+    } while (!last);
+
+    consumed = reader.AlignToByte();
+    return S_OK;
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) noexcept
+{
+    constexpr uint32_t Modulus{ 65521 };
+    // Largest run of bytes that can be summed before b could overflow 32 bits
+    constexpr size_t MaxRun{ 5552 };
+
+    uint32_t a{ 1 };
+    uint32_t b{ 0 };
+    while (size > 0)
+    {
+        size_t run{ std::min(size, MaxRun) };
+        for (size_t i = 0; i < run; ++i)
+        {
+            a += data[i];
+            b += a;
+        }
+        a %= Modulus;
+        b %= Modulus;
+        data += run;
+        size -= run;
+    }
+    return (b << 16) | a;
+}
+
+void AppendUInt32LE(Vector<uint8_t>& output, uint32_t value) noexcept
+{
+    output.insert(output.end(), {
+        static_cast<uint8_t>(value),
+        static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16),
+        static_cast<uint8_t>(value >> 24)
+    });
+}
+
+uint32_t ReadUInt32LE(const uint8_t* data) noexcept
+{
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+        static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+bool IsGzipHeader(const uint8_t* data, size_t size) noexcept
+{
+    return size >= GzipHeaderSize && data[0] == 0x1F && data[1] == 0x8B && data[2] == 8;
+}
+
+bool IsZlibHeader(const uint8_t* data, size_t size) noexcept
+{
+    // Compression method 8 with a window of at most 32KB, and a valid header check value
+    return size >= ZlibHeaderSize && (data[0] & 0x0F) == 8 && (data[0] >> 4) <= 7 &&
+        ((static_cast<uint32_t>(data[0]) << 8) | data[1]) % 31 == 0;
+}
+
+HRESULT DecompressGzipMember(
+    const uint8_t* data,
+    size_t size,
+    Vector<uint8_t>& output,
+    size_t& consumed
+) noexcept
+{
+    if (!IsGzipHeader(data, size))
+    {
+        return E_UNEXPECTED;
+    }
+
+    uint8_t flags{ data[3] };
+    if (flags & GzipFlagsReserved)
+    {
+        return E_UNEXPECTED;
+    }
+
+    size_t offset{ GzipHeaderSize };
+    if (flags & GzipFlagExtra)
+    {
+        if (size - offset < 2)
+        {
+            return E_UNEXPECTED;
+        }
+        size_t extraSize{ static_cast<size_t>(data[offset] | data[offset + 1] << 8) };
+        offset += 2;
+        if (size - offset < extraSize)
+        {
+            return E_UNEXPECTED;
+        }
+        offset += extraSize;
+    }
+    for (uint8_t stringFlag : { GzipFlagName, GzipFlagComment })
+    {
+        if (flags & stringFlag)
+        {
+            const uint8_t* terminator{ static_cast<const uint8_t*>(memchr(data + offset, 0, size - offset)) };
+            if (terminator == nullptr)
+            {
+                return E_UNEXPECTED;
+            }
+            offset = static_cast<size_t>(terminator - data) + 1;
+        }
+    }
+    if (flags & GzipFlagHeaderCrc)
+    {
+        // The low 16 bits of the CRC-32 of the header up to this point
+        if (size - offset < 2 || static_cast<uint32_t>(data[offset] | data[offset + 1] << 8) != (utils::crc32(data, offset) & 0xFFFF))
+        {
+            return E_UNEXPECTED;
+        }
+        offset += 2;
+    }
+
+    size_t start{ output.size() };
+    size_t deflateSize{ 0 };
+    RETURN_HR_IF_FAILED(Inflate(data + offset, size - offset, output, deflateSize));
+    offset += deflateSize;
+
+    if (size - offset < GzipTrailerSize)
+    {
+        return E_UNEXPECTED;
+    }
+    size_t memberSize{ output.size() - start };
+    if (ReadUInt32LE(data + offset) != utils::crc32(output.data() + start, memberSize) ||
+        ReadUInt32LE(data + offset + 4) != static_cast<uint32_t>(memberSize))
+    {
+        return E_UNEXPECTED;
+    }
+
+    consumed = offset + GzipTrailerSize;
+    return S_OK;
+}
+
+}
+
+constexpr size_t HttpCompression::MaxDecompressedSize;
+
+Result<Vector<uint8_t>> HttpCompression::Compress(
+    _In_ HttpContentEncoding encoding,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+) noexcept
+{
+    RETURN_HR_INVALIDARGUMENT_IF(data == nullptr && size > 0);
+    RETURN_HR_INVALIDARGUMENT_IF(size > INT32_MAX);
+
+    Vector<uint8_t> output;
+    switch (encoding)
+    {
+    case HttpContentEncoding::Identity:
+    {
+        output.assign(data, data + size);
+        break;
+    }
+    case HttpContentEncoding::Gzip:
+    {
+        // No file name or modification time, unknown OS
+        output.insert(output.end(), { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF });
+        Deflate(data, size, output);
+        AppendUInt32LE(output, utils::crc32(data, size));
+        AppendUInt32LE(output, static_cast<uint32_t>(size));
+        break;
+    }
+    case HttpContentEncoding::Deflate:
+    {
+        // 32KB window, fastest compression level
+        output.insert(output.end(), { 0x78, 0x01 });
+        Deflate(data, size, output);
+        uint32_t adler{ Adler32(data, size) };
+        output.insert(output.end(), {
+            static_cast<uint8_t>(adler >> 24),
+            static_cast<uint8_t>(adler >> 16),
+            static_cast<uint8_t>(adler >> 8),
+            static_cast<uint8_t>(adler)
+        });
+        break;
+    }
+    default:
+    {
+        return E_INVALIDARG;
+    }
+    }
+    return output;
+}
+
+Result<Vector<uint8_t>> HttpCompression::Decompress(
+    _In_ HttpContentEncoding encoding,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+) noexcept
+{
+    RETURN_HR_INVALIDARGUMENT_IF(data == nullptr && size > 0);
+
+    Vector<uint8_t> output;
+    switch (encoding)
+    {
+    case HttpContentEncoding::Identity:
+    {
+        output.assign(data, data + size);
+        break;
+    }
+    case HttpContentEncoding::Gzip:
+    {
+        // A gzip body may contain several members, which decode to their concatenation
+        size_t offset{ 0 };
+        do
+        {
+            size_t consumed{ 0 };
+            RETURN_HR_IF_FAILED(DecompressGzipMember(data + offset, size - offset, output, consumed));
+            offset += consumed;
+        } while (offset < size);
+        break;
+    }
+    case HttpContentEncoding::Deflate:
+    {
+        if (!IsZlibHeader(data, size) || (data[1] & 0x20))
+        {
+            // Preset dictionaries aren't used in HTTP
+            return E_UNEXPECTED;
+        }
+
+        size_t consumed{ 0 };
+        RETURN_HR_IF_FAILED(Inflate(data + ZlibHeaderSize, size - ZlibHeaderSize, output, consumed));
+
+        const uint8_t* trailer{ data + ZlibHeaderSize + consumed };
+        if (size - ZlibHeaderSize - consumed < ZlibTrailerSize)
+        {
+            return E_UNEXPECTED;
+        }
+        uint32_t adler{ static_cast<uint32_t>(trailer[0]) << 24 | static_cast<uint32_t>(trailer[1]) << 16 |
+            static_cast<uint32_t>(trailer[2]) << 8 | static_cast<uint32_t>(trailer[3]) };
+        if (adler != Adler32(output.data(), output.size()))
+        {
+            return E_UNEXPECTED;
+        }
+        break;
+    }
+    default:
+    {
+        return E_INVALIDARG;
+    }
+    }
+    return output;
+}
+
+HttpContentEncoding HttpCompression::EncodingFromHeader(_In_ const String& headerValue) noexcept
+{
+    size_t begin{ headerValue.find_first_not_of(" \t") };
+    size_t end{ headerValue.find_last_not_of(" \t") };
+    if (begin == String::npos)
+    {
+        return HttpContentEncoding::Identity;
+    }
+
+    String coding{ utils::ToLower(headerValue.substr(begin, end - begin + 1)) };
+    if (coding == "gzip" || coding == "x-gzip")
+    {
+        return HttpContentEncoding::Gzip;
+    }
+    else if (coding == "deflate")
+    {
+        return HttpContentEncoding::Deflate;
+    }
+    return HttpContentEncoding::Identity;
+}
+
+const char* HttpCompression::HeaderValue(_In_ HttpContentEncoding encoding) noexcept
+{
+    switch (encoding)
+    {
+    case HttpContentEncoding::Gzip: return "gzip";
+    case HttpContentEncoding::Deflate: return "deflate";
+    default: return "identity";
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
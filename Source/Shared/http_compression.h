@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const char CONTENT_ENCODING_HEADER[] = "Content-Encoding";
+const char ACCEPT_ENCODING_HEADER[] = "Accept-Encoding";
+
+// HTTP content codings (RFC 9110 section 8.4.1) that XSAPI can produce and consume itself. Compression is done
+// in XSAPI rather than by the platform HTTP stack so request signatures cover the bytes actually sent and so
+// behavior is the same on every platform.
+enum class HttpContentEncoding : uint32_t
+{
+    Identity,
+    Gzip,   // RFC 1952
+    Deflate // RFC 1950 zlib stream
+};
+
+class HttpCompression
+{
+public:
+    // Largest body Decompress will produce, guarding against responses that expand without bound
+    static constexpr size_t MaxDecompressedSize{ 64 * 1024 * 1024 };
+
+    // Compresses data with DEFLATE (RFC 1951) and wraps it in the framing for the requested coding.
+    // Compressing with Identity returns a copy of the data.
+    static Result<Vector<uint8_t>> Compress(
+        _In_ HttpContentEncoding encoding,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    ) noexcept;
+
+    // Decompresses a body in the given coding, verifying its framing and checksum. Fails with E_UNEXPECTED if the
+    // body is malformed or truncated, and E_BOUNDS if it would expand beyond MaxDecompressedSize.
+    static Result<Vector<uint8_t>> Decompress(
+        _In_ HttpContentEncoding encoding,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    ) noexcept;
+
+    // Maps a Content-Encoding header value to a coding. Unrecognized values map to Identity.
+    static HttpContentEncoding EncodingFromHeader(_In_ const String& headerValue) noexcept;
+    static const char* HeaderValue(_In_ HttpContentEncoding encoding) noexcept;
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
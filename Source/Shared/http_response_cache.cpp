@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "http_response_cache.h"
+#include "http_compression.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+HttpResponseCache::HttpResponseCache(size_t budgetInBytes) noexcept
+    : m_budget{ budgetInBytes }
+{
+}
+
+size_t HttpResponseCache::Budget() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_budget;
+}
+
+void HttpResponseCache::SetBudget(size_t budgetInBytes) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_budget = budgetInBytes;
+    Trim();
+}
+
+HttpResponseCache::Lookup HttpResponseCache::Acquire(
+    const String& key,
+    Waiter& waiter
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto inFlight{ m_inFlight.find(key) };
+    if (inFlight != m_inFlight.end())
+    {
+        ++m_stats.joinedRequests;
+        inFlight->second.push_back(std::move(waiter));
+        return Lookup{ Action::Joined, nullptr };
+    }
+
+    auto iter{ m_entries.find(key) };
+    if (iter != m_entries.end())
+    {
+        m_lru.splice(m_lru.end(), m_lru, iter->second.lruPosition);
+
+        if (chrono_clock_t::now() < iter->second.expiry)
+        {
+            ++m_stats.hits;
+            m_stats.bytesSaved += iter->second.response->body.size();
+            return Lookup{ Action::UseCached, iter->second.response };
+        }
+
+        m_inFlight[key];
+        return Lookup{ Action::Revalidate, iter->second.response };
+    }
+
+    ++m_stats.misses;
+    m_inFlight[key];
+    return Lookup{ Action::Request, nullptr };
+}
+
+std::shared_ptr<const HttpResponseCache::Response> HttpResponseCache::Complete(
+    const String& key,
+    uint32_t httpStatus,
+    HttpHeaders&& headers,
+    Vector<uint8_t>&& body,
+    std::shared_ptr<const Response> revalidated
+) noexcept
+{
+    std::shared_ptr<const Response> response;
+    Vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        auto inFlight{ m_inFlight.find(key) };
+        if (inFlight != m_inFlight.end())
+        {
+            waiters = std::move(inFlight->second);
+            m_inFlight.erase(inFlight);
+        }
+
+        if (httpStatus == 200)
+        {
+            // The body has already been decoded, so the stored headers must not describe an encoding
+            for (auto iter = headers.begin(); iter != headers.end();)
+            {
+                if (utils::str_icmp_internal(iter->first, CONTENT_ENCODING_HEADER) == 0 ||
+                    utils::str_icmp_internal(iter->first, "Content-Length") == 0)
+                {
+                    iter = headers.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+
+            auto freshness{ GetFreshness(GetHeader(headers, CACHE_CONTROL_HEADER), !GetHeader(headers, ETAG_HEADER).empty()) };
+            response = MakeShared<Response>(Response{ std::move(headers), std::move(body) });
+            if (freshness.storable)
+            {
+                Store(key, response, freshness.maxAge);
+            }
+            else
+            {
+                auto iter{ m_entries.find(key) };
+                if (iter != m_entries.end())
+                {
+                    Remove(iter);
+                }
+            }
+        }
+        else if (httpStatus == 304 && revalidated)
+        {
+            ++m_stats.revalidations;
+            m_stats.bytesSaved += revalidated->body.size();
+
+            // A 304 may update the response's freshness. Otherwise the stored Cache-Control applies again.
+            String cacheControl{ GetHeader(headers, CACHE_CONTROL_HEADER) };
+            if (cacheControl.empty())
+            {
+                cacheControl = GetHeader(revalidated->headers, CACHE_CONTROL_HEADER);
+            }
+
+            auto freshness{ GetFreshness(cacheControl, !GetHeader(revalidated->headers, ETAG_HEADER).empty()) };
+            response = std::move(revalidated);
+            if (freshness.storable)
+            {
+                Store(key, response, freshness.maxAge);
+            }
+        }
+
+        if (response)
+        {
+            m_stats.bytesSaved += waiters.size() * response->body.size();
+        }
+    }
+
+    // Requests that were waiting share the response. They make their own request if there isn't one.
+    for (auto& waiter : waiters)
+    {
+        waiter(response);
+    }
+
+    return response;
+}
+
+HttpResponseCache::Stats HttpResponseCache::GetStats() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    Stats stats{ m_stats };
+    stats.bytesStored = m_size;
+    return stats;
+}
+
+HttpResponseCache::Freshness HttpResponseCache::GetFreshness(
+    const String& cacheControl,
+    bool hasETag
+) noexcept
+{
+    bool noStore{ false };
+    bool noCache{ false };
+    std::chrono::seconds maxAge{ 0 };
+
+    String directives{ utils::ToLower(cacheControl) };
+    size_t begin{ 0 };
+    while (begin < directives.size())
+    {
+        size_t end{ directives.find(',', begin) };
+        if (end == String::npos)
+        {
+            end = directives.size();
+        }
+
+        String directive{ directives.substr(begin, end - begin) };
+        directive.erase(0, directive.find_first_not_of(' '));
+        directive.erase(directive.find_last_not_of(' ') + 1);
+
+        if (directive == "no-store")
+        {
+            noStore = true;
+        }
+        else if (directive == "no-cache")
+        {
+            noCache = true;
+        }
+        else if (directive.compare(0, 8, "max-age=") == 0)
+        {
+            maxAge = std::chrono::seconds{ strtoul(directive.data() + 8, nullptr, 10) };
+        }
+
+        begin = end + 1;
+    }
+
+    if (noCache)
+    {
+        // Stored, but revalidated every time it is used
+        maxAge = std::chrono::seconds{ 0 };
+    }
+
+    // Without an ETag a response can't be revalidated, so it is only worth storing while it is fresh
+    return Freshness{ !noStore && (hasETag || maxAge.count() > 0), maxAge };
+}
+
+String HttpResponseCache::GetHeader(const HttpHeaders& headers, const char* name) noexcept
+{
+    for (const auto& header : headers)
+    {
+        if (utils::str_icmp_internal(header.first, name) == 0)
+        {
+            return header.second;
+        }
+    }
+    return String{};
+}
+
+void HttpResponseCache::Store(
+    const String& key,
+    std::shared_ptr<const Response> response,
+    std::chrono::seconds maxAge
+) noexcept
+{
+    size_t size{ key.size() + response->body.size() };
+    for (const auto& header : response->headers)
+    {
+        size += header.first.size() + header.second.size();
+    }
+
+    auto iter{ m_entries.find(key) };
+    if (iter != m_entries.end())
+    {
+        Remove(iter);
+    }
+
+    if (size > m_budget)
+    {
+        return;
+    }
+
+    m_lru.push_back(key);
+    m_entries[key] = Entry{ std::move(response), chrono_clock_t::now() + maxAge, size, std::prev(m_lru.end()) };
+    m_size += size;
+    Trim();
+}
+
+void HttpResponseCache::Remove(Map<String, Entry>::iterator iter) noexcept
+{
+    m_size -= iter->second.size;
+    m_lru.erase(iter->second.lruPosition);
+    m_entries.erase(iter);
+}
+
+void HttpResponseCache::Trim() noexcept
+{
+    while (m_size > m_budget && !m_lru.empty())
+    {
+        Remove(m_entries.find(m_lru.front()));
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
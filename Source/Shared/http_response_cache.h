@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+const char IF_NONE_MATCH_HEADER[] = "If-None-Match";
+const char CACHE_CONTROL_HEADER[] = "Cache-Control";
+
+// Caches responses to GET requests and collapses concurrent identical requests into a single request.
+//
+// Responses are stored when they carry an ETag or a Cache-Control max-age, and not stored at all with
+// Cache-Control no-store. A response is served without a request until its max-age passes. After that it is
+// revalidated with If-None-Match, and a 304 response serves the stored body. The stored bodies are bounded by a
+// byte budget, evicting the least recently used responses first.
+class HttpResponseCache
+{
+public:
+    struct Response
+    {
+        HttpHeaders headers;
+        Vector<uint8_t> body;
+    };
+
+    // Called when the in-flight request a caller was waiting on completes. The response is null if the request
+    // failed or returned something other than 200 or 304, in which case the caller should make its own request.
+    using Waiter = Function<void(std::shared_ptr<const Response>)>;
+
+    enum class Action
+    {
+        // Serve the stored response without a request
+        UseCached,
+        // Make the request with If-None-Match set to the stored response's ETag and report the result with Complete
+        Revalidate,
+        // Make the request and report the result with Complete
+        Request,
+        // An identical request is in flight and the waiter was queued behind it
+        Joined
+    };
+
+    struct Lookup
+    {
+        Action action;
+        std::shared_ptr<const Response> response;
+    };
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t revalidations;
+        uint64_t joinedRequests;
+        uint64_t bytesSaved;
+        uint64_t bytesStored;
+    };
+
+    HttpResponseCache(size_t budgetInBytes) noexcept;
+
+    size_t Budget() const noexcept;
+    void SetBudget(size_t budgetInBytes) noexcept;
+
+    // The waiter is only taken if the result is Joined
+    Lookup Acquire(
+        const String& key,
+        Waiter& waiter
+    ) noexcept;
+
+    // Records the result of a request started for a Request or Revalidate result and completes the requests that
+    // were waiting on it. For a 304, revalidated is the response that Acquire returned. Returns the response to
+    // serve, or null if the request failed.
+    std::shared_ptr<const Response> Complete(
+        const String& key,
+        uint32_t httpStatus,
+        HttpHeaders&& headers,
+        Vector<uint8_t>&& body,
+        std::shared_ptr<const Response> revalidated
+    ) noexcept;
+
+    Stats GetStats() const noexcept;
+
+    // Header names are matched case insensitively
+    static String GetHeader(const HttpHeaders& headers, const char* name) noexcept;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const Response> response;
+        chrono_clock_t::time_point expiry;
+        size_t size;
+        List<String>::iterator lruPosition;
+    };
+
+    struct Freshness
+    {
+        bool storable;
+        std::chrono::seconds maxAge;
+    };
+
+    static Freshness GetFreshness(const String& cacheControl, bool hasETag) noexcept;
+
+    void Store(const String& key, std::shared_ptr<const Response> response, std::chrono::seconds maxAge) noexcept;
+    void Remove(Map<String, Entry>::iterator iter) noexcept;
+    void Trim() noexcept;
+
+    mutable std::mutex m_mutex;
+    size_t m_budget;
+    size_t m_size{ 0 };
+    Map<String, Entry> m_entries;
+    List<String> m_lru;
+    Map<String, Vector<Waiter>> m_inFlight;
+    Stats m_stats{};
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
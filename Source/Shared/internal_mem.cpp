@@ -70,6 +70,266 @@ void STDAPIVCALLTYPE Free(
     }
 }
 
+namespace
+{
+
+// Size classes served by SizeClassPool. These are sized for map/list/hash nodes and shared_ptr control blocks,
+// anything larger is forwarded to the memhooks.
+constexpr size_t s_sizeClasses[]{ 16, 32, 48, 64, 96, 128, 192, 256 };
+constexpr size_t s_sizeClassCount{ sizeof(s_sizeClasses) / sizeof(s_sizeClasses[0]) };
+constexpr size_t s_slabSize{ 16 * 1024 };
+constexpr size_t s_subsystemCount{ static_cast<size_t>(XblMemSubsystem::Events) + 1 };
+
+class SizeClassPool
+{
+public:
+    SizeClassPool() noexcept = default;
+    SizeClassPool(const SizeClassPool&) = delete;
+    SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+    // Returns the index of the smallest size class that fits 'size' or s_sizeClassCount if it is too large
+    static size_t SizeClassIndex(size_t size) noexcept
+    {
+        for (size_t i = 0; i < s_sizeClassCount; ++i)
+        {
+            if (size <= s_sizeClasses[i])
+            {
+                return i;
+            }
+        }
+        return s_sizeClassCount;
+    }
+
+    // Allocates a block from the size class. 'bytesReserved' is set to the number of bytes newly reserved from the memhooks
+    void* Allocate(size_t sizeClassIndex, size_t& bytesReserved) noexcept
+    {
+        assert(sizeClassIndex < s_sizeClassCount);
+        auto& sizeClass{ m_sizeClasses[sizeClassIndex] };
+
+        std::lock_guard<std::mutex> lock{ sizeClass.mutex };
+        bytesReserved = 0;
+
+        if (!sizeClass.freeList)
+        {
+            void* mem = Alloc(s_slabSize);
+            if (mem == nullptr)
+            {
+                return nullptr;
+            }
+            bytesReserved = s_slabSize;
+
+            // Slabs remember which free hook they need to be returned to in case the hooks change after cleanup
+            auto slab = new (mem) Slab{ sizeClass.slabs, g_pMemFreeHook };
+            sizeClass.slabs = slab;
+
+            const size_t blockSize{ s_sizeClasses[sizeClassIndex] };
+            auto begin = static_cast<uint8_t*>(mem) + sizeof(Slab);
+            auto end = static_cast<uint8_t*>(mem) + s_slabSize;
+            for (auto block = begin; block + blockSize <= end; block += blockSize)
+            {
+                sizeClass.freeList = new (block) FreeBlock{ sizeClass.freeList };
+            }
+        }
+
+        auto block{ sizeClass.freeList };
+        sizeClass.freeList = block->next;
+        return block;
+    }
+
+    void Free(void* pointer, size_t sizeClassIndex) noexcept
+    {
+        assert(sizeClassIndex < s_sizeClassCount);
+        auto& sizeClass{ m_sizeClasses[sizeClassIndex] };
+
+        std::lock_guard<std::mutex> lock{ sizeClass.mutex };
+        sizeClass.freeList = new (pointer) FreeBlock{ sizeClass.freeList };
+    }
+
+    // Returns all slabs to the memhooks. Only valid when there are no outstanding blocks. Returns the number of bytes released.
+    size_t Release() noexcept
+    {
+        size_t bytesReleased{ 0 };
+        for (auto& sizeClass : m_sizeClasses)
+        {
+            std::lock_guard<std::mutex> lock{ sizeClass.mutex };
+            while (sizeClass.slabs)
+            {
+                auto slab{ sizeClass.slabs };
+                sizeClass.slabs = slab->next;
+
+                auto freeHook{ slab->freeHook };
+                slab->~Slab();
+                freeHook(slab, 0);
+                bytesReleased += s_slabSize;
+            }
+            sizeClass.freeList = nullptr;
+        }
+        return bytesReleased;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Slab header. Aligned so that the blocks which follow it are suitably aligned for any type
+    struct alignas(std::max_align_t) Slab
+    {
+        Slab* next;
+        XblMemFreeFunction freeHook;
+    };
+
+    struct SizeClass
+    {
+        std::mutex mutex;
+        FreeBlock* freeList{ nullptr };
+        Slab* slabs{ nullptr };
+    };
+
+    SizeClass m_sizeClasses[s_sizeClassCount];
+};
+
+struct Arena
+{
+    std::atomic<XblMemArenaPolicy> policy{ XblMemArenaPolicy::Default };
+    SizeClassPool pool;
+
+    std::atomic<uint64_t> bytesInUse{ 0 };
+    std::atomic<uint64_t> peakBytesInUse{ 0 };
+    std::atomic<uint64_t> bytesReserved{ 0 };
+    std::atomic<uint64_t> allocationCount{ 0 };
+    std::atomic<uint64_t> freeCount{ 0 };
+    std::atomic<uint64_t> pooledAllocationCount{ 0 };
+};
+
+// Arenas are kept in function scope to avoid depending on static initialization order. Like the memhooks,
+// they are global and independent of GlobalState.
+Arena* GetArena(XblMemSubsystem subsystem) noexcept
+{
+    static Arena s_arenas[s_subsystemCount];
+
+    auto index{ static_cast<size_t>(subsystem) };
+    if (index >= s_subsystemCount)
+    {
+        return nullptr;
+    }
+    return &s_arenas[index];
+}
+
+}
+
+_Ret_maybenull_ void* ArenaAlloc(
+    XblMemSubsystem subsystem,
+    size_t size
+) noexcept
+{
+    auto arena{ GetArena(subsystem) };
+    assert(arena);
+
+    void* pointer{ nullptr };
+    auto sizeClassIndex{ SizeClassPool::SizeClassIndex(size) };
+    if (arena->policy == XblMemArenaPolicy::SizeClassPool && sizeClassIndex < s_sizeClassCount)
+    {
+        size_t bytesReserved{ 0 };
+        pointer = arena->pool.Allocate(sizeClassIndex, bytesReserved);
+        arena->bytesReserved += bytesReserved;
+        if (pointer)
+        {
+            ++arena->pooledAllocationCount;
+        }
+    }
+    else
+    {
+        pointer = Alloc(size);
+    }
+
+    if (pointer)
+    {
+        ++arena->allocationCount;
+        auto bytesInUse{ arena->bytesInUse += size };
+        auto peak{ arena->peakBytesInUse.load() };
+        while (bytesInUse > peak && !arena->peakBytesInUse.compare_exchange_weak(peak, bytesInUse)) {}
+    }
+    return pointer;
+}
+
+void ArenaFree(
+    XblMemSubsystem subsystem,
+    _In_opt_ _Post_invalid_ void* pointer,
+    size_t size
+) noexcept
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+
+    auto arena{ GetArena(subsystem) };
+    assert(arena);
+
+    ++arena->freeCount;
+    arena->bytesInUse -= size;
+
+    auto sizeClassIndex{ SizeClassPool::SizeClassIndex(size) };
+    if (arena->policy == XblMemArenaPolicy::SizeClassPool && sizeClassIndex < s_sizeClassCount)
+    {
+        arena->pool.Free(pointer, sizeClassIndex);
+    }
+    else
+    {
+        Free(pointer);
+    }
+}
+
+HRESULT ArenaSetPolicy(
+    XblMemSubsystem subsystem,
+    XblMemArenaPolicy policy
+) noexcept
+{
+    auto arena{ GetArena(subsystem) };
+    RETURN_HR_INVALIDARGUMENT_IF(arena == nullptr || policy > XblMemArenaPolicy::SizeClassPool);
+
+    // Blocks must be freed with the same policy they were allocated with
+    RETURN_HR_IF(arena->bytesInUse > 0, E_UNEXPECTED);
+
+    if (policy != XblMemArenaPolicy::SizeClassPool)
+    {
+        arena->bytesReserved -= arena->pool.Release();
+    }
+    arena->policy = policy;
+    return S_OK;
+}
+
+HRESULT ArenaGetStats(
+    XblMemSubsystem subsystem,
+    XblMemSubsystemStats* stats
+) noexcept
+{
+    auto arena{ GetArena(subsystem) };
+    RETURN_HR_INVALIDARGUMENT_IF(arena == nullptr || stats == nullptr);
+
+    stats->bytesInUse = arena->bytesInUse;
+    stats->peakBytesInUse = arena->peakBytesInUse;
+    stats->bytesReserved = arena->bytesReserved;
+    stats->allocationCount = arena->allocationCount;
+    stats->freeCount = arena->freeCount;
+    stats->pooledAllocationCount = arena->pooledAllocationCount;
+    return S_OK;
+}
+
+void ArenaReleaseUnused() noexcept
+{
+    for (size_t i = 0; i < s_subsystemCount; ++i)
+    {
+        auto arena{ GetArena(static_cast<XblMemSubsystem>(i)) };
+        if (arena->bytesInUse == 0)
+        {
+            arena->bytesReserved -= arena->pool.Release();
+        }
+    }
+}
+
 char* Make(const char* str)
 {
     auto length = strlen(str) + 1;
@@ -77,6 +77,76 @@ bool operator!=(Allocator<T> const&, Allocator<T> const&)
     return false;
 }
 
+// Per-subsystem arenas. Depending on the XblMemArenaPolicy configured for the subsystem, an arena
+// either forwards to Alloc/Free or serves small blocks from size-class pools. The size of the block
+// must be passed back to ArenaFree so the owning pool can be found without a header.
+_Ret_maybenull_ void* ArenaAlloc(
+    XblMemSubsystem subsystem,
+    size_t size
+) noexcept;
+
+void ArenaFree(
+    XblMemSubsystem subsystem,
+    _In_opt_ _Post_invalid_ void* pointer,
+    size_t size
+) noexcept;
+
+HRESULT ArenaSetPolicy(
+    XblMemSubsystem subsystem,
+    XblMemArenaPolicy policy
+) noexcept;
+
+HRESULT ArenaGetStats(
+    XblMemSubsystem subsystem,
+    XblMemSubsystemStats* stats
+) noexcept;
+
+// Returns pool slabs to the memhooks for any arena with no outstanding allocations
+void ArenaReleaseUnused() noexcept;
+
+template<typename T, XblMemSubsystem S>
+struct ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    template<class U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U, S> other;
+    };
+
+    ArenaAllocator() = default;
+    template<class U> ArenaAllocator(ArenaAllocator<U, S> const&) {}
+
+    T* allocate(size_t n)
+    {
+        T* p = static_cast<T*>(ArenaAlloc(S, n * sizeof(T)));
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    void deallocate(_In_opt_ T* p, size_t n)
+    {
+        ArenaFree(S, p, n * sizeof(T));
+    }
+};
+
+template<class T, class U, XblMemSubsystem S>
+bool operator==(ArenaAllocator<T, S> const&, ArenaAllocator<U, S> const&)
+{
+    return true;
+}
+
+template<class T, class U, XblMemSubsystem S>
+bool operator!=(ArenaAllocator<T, S> const&, ArenaAllocator<U, S> const&)
+{
+    return false;
+}
+
 template<class T>
 struct Deleter
 {
@@ -138,6 +208,28 @@ using Queue = std::queue<T, Deque<T>>;
 template<class T>
 using List = std::list<T, Allocator<T>>;
 
+// Arena backed STL types
+template<XblMemSubsystem S, class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T, S>>;
+
+template<XblMemSubsystem S, class K, class V, class LESS = std::less<K>>
+using ArenaMap = std::map<K, V, LESS, ArenaAllocator<std::pair<K const, V>, S>>;
+
+template<XblMemSubsystem S, class K, class V, class HASH = std::hash<K>, class EQUAL = std::equal_to<K>>
+using ArenaUnorderedMap = std::unordered_map<K, V, HASH, EQUAL, ArenaAllocator<std::pair<K const, V>, S>>;
+
+template<XblMemSubsystem S, class K, class HASH = std::hash<K>, class EQUAL = std::equal_to<K>>
+using ArenaUnorderedSet = std::unordered_set<K, HASH, EQUAL, ArenaAllocator<K, S>>;
+
+template<XblMemSubsystem S, class T>
+using ArenaDeque = std::deque<T, ArenaAllocator<T, S>>;
+
+template<XblMemSubsystem S, class T>
+using ArenaQueue = std::queue<T, ArenaDeque<S, T>>;
+
+template<XblMemSubsystem S, class T>
+using ArenaList = std::list<T, ArenaAllocator<T, S>>;
+
 // Memhooked allocation/deallocation helpers
 template<typename T, class... TArgs>
 inline std::shared_ptr<T> MakeShared(TArgs&&... args)
@@ -149,6 +241,17 @@ inline std::shared_ptr<T> MakeShared(TArgs&&... args)
 #endif
 }
 
+// Allocates the object and its control block together from a subsystem's arena
+template<XblMemSubsystem S, typename T, class... TArgs>
+inline std::shared_ptr<T> ArenaMakeShared(TArgs&&... args)
+{
+#if !HC_PLATFORM_IS_MICROSOFT || _MSC_VER >= 1910
+    return std::allocate_shared<T, ArenaAllocator<T, S>>(ArenaAllocator<T, S>(), std::forward<TArgs>(args)...);
+#else
+    return MakeShared<T>(std::forward<TArgs>(args)...);
+#endif
+}
+
 template<typename T, typename... TArgs>
 UniquePtr<T> MakeUnique(TArgs&& ... args)
 {
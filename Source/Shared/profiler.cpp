@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "profiler.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+namespace
+{
+
+// Samples below 4us get exact buckets. Above that, each power of two is split into 4 linear sub-buckets,
+// which bounds the error of a reported percentile to 25%. Samples are clamped to 2^40us (~12 days).
+constexpr uint32_t s_subBucketBits{ 2 };
+constexpr uint32_t s_subBucketCount{ 1 << s_subBucketBits };
+constexpr uint32_t s_maxSampleBits{ 40 };
+constexpr uint32_t s_bucketCount{ s_subBucketCount + (s_maxSampleBits - s_subBucketBits) * s_subBucketCount };
+constexpr size_t s_areaCount{ static_cast<size_t>(XblProfileArea::AchievementsManagerDoWork) + 1 };
+
+struct AreaHistogram
+{
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> max{ 0 };
+    std::atomic<uint64_t> buckets[s_bucketCount];
+};
+
+std::atomic<bool> s_enabled{ false };
+
+AreaHistogram* GetHistogram(XblProfileArea area) noexcept
+{
+    static AreaHistogram s_histograms[s_areaCount]{};
+
+    auto index{ static_cast<size_t>(area) };
+    if (index >= s_areaCount)
+    {
+        return nullptr;
+    }
+    return &s_histograms[index];
+}
+
+uint32_t MostSignificantBit(uint64_t value) noexcept
+{
+    uint32_t msb{ 0 };
+    while (value >>= 1)
+    {
+        ++msb;
+    }
+    return msb;
+}
+
+uint32_t BucketIndex(uint64_t microseconds) noexcept
+{
+    if (microseconds < s_subBucketCount)
+    {
+        return static_cast<uint32_t>(microseconds);
+    }
+
+    microseconds = (std::min)(microseconds, (uint64_t{ 1 } << s_maxSampleBits) - 1);
+    uint32_t msb{ MostSignificantBit(microseconds) };
+    uint32_t shift{ msb - s_subBucketBits };
+    uint32_t subBucket{ static_cast<uint32_t>((microseconds >> shift) & (s_subBucketCount - 1)) };
+    return s_subBucketCount + shift * s_subBucketCount + subBucket;
+}
+
+// Largest sample that maps to the bucket
+uint64_t BucketUpperBound(uint32_t index) noexcept
+{
+    if (index < s_subBucketCount)
+    {
+        return index;
+    }
+
+    uint32_t shift{ (index - s_subBucketCount) / s_subBucketCount };
+    uint64_t subBucket{ (index - s_subBucketCount) % s_subBucketCount };
+    return ((s_subBucketCount + subBucket + 1) << shift) - 1;
+}
+
+}
+
+bool Profiler::IsEnabled() noexcept
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetEnabled(bool enabled) noexcept
+{
+    s_enabled = enabled;
+}
+
+void Profiler::Record(XblProfileArea area, uint64_t microseconds) noexcept
+{
+    auto histogram{ GetHistogram(area) };
+    if (histogram == nullptr)
+    {
+        return;
+    }
+
+    histogram->buckets[BucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    histogram->total.fetch_add(microseconds, std::memory_order_relaxed);
+
+    auto max{ histogram->max.load(std::memory_order_relaxed) };
+    while (microseconds > max && !histogram->max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed)) {}
+}
+
+HRESULT Profiler::GetStats(XblProfileArea area, XblProfileAreaStats* stats) noexcept
+{
+    auto histogram{ GetHistogram(area) };
+    RETURN_HR_INVALIDARGUMENT_IF(histogram == nullptr || stats == nullptr);
+
+    *stats = XblProfileAreaStats{};
+
+    // Copy the buckets first and derive the count from them so the percentiles are self-consistent
+    uint64_t buckets[s_bucketCount];
+    uint64_t count{ 0 };
+    for (uint32_t i = 0; i < s_bucketCount; ++i)
+    {
+        buckets[i] = histogram->buckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    stats->count = count;
+    stats->totalMicroseconds = histogram->total.load(std::memory_order_relaxed);
+    stats->maxMicroseconds = histogram->max.load(std::memory_order_relaxed);
+
+    auto percentile = [&](uint64_t numerator, uint64_t denominator)
+    {
+        // Rank of the sample at the requested percentile, rounding up
+        uint64_t rank{ (count * numerator + denominator - 1) / denominator };
+        uint64_t cumulative{ 0 };
+        for (uint32_t i = 0; i < s_bucketCount; ++i)
+        {
+            cumulative += buckets[i];
+            if (cumulative >= rank && cumulative > 0)
+            {
+                return (std::min)(BucketUpperBound(i), stats->maxMicroseconds);
+            }
+        }
+        return stats->maxMicroseconds;
+    };
+
+    if (count > 0)
+    {
+        stats->p50Microseconds = percentile(50, 100);
+        stats->p99Microseconds = percentile(99, 100);
+    }
+    return S_OK;
+}
+
+void Profiler::Reset() noexcept
+{
+    for (size_t i = 0; i < s_areaCount; ++i)
+    {
+        auto histogram{ GetHistogram(static_cast<XblProfileArea>(i)) };
+        for (auto& bucket : histogram->buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        histogram->total = 0;
+        histogram->max = 0;
+    }
+}
+
+ProfileTimer::ProfileTimer(XblProfileArea area) noexcept
+    : m_area{ area },
+    m_running{ Profiler::IsEnabled() }
+{
+    if (m_running)
+    {
+        m_start = Profiler::Clock::now();
+    }
+}
+
+void ProfileTimer::Stop() noexcept
+{
+    if (m_running)
+    {
+        m_running = false;
+        auto elapsed{ std::chrono::duration_cast<std::chrono::microseconds>(Profiler::Clock::now() - m_start) };
+        Profiler::Record(m_area, static_cast<uint64_t>(elapsed.count()));
+    }
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
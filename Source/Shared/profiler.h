@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+// Backs the XblProfiler APIs. Each XblProfileArea has a fixed-bucket latency histogram updated with relaxed
+// atomics, so recording a sample never locks or allocates. Profiling is off until enabled at runtime.
+class Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static bool IsEnabled() noexcept;
+    static void SetEnabled(bool enabled) noexcept;
+
+    static void Record(XblProfileArea area, uint64_t microseconds) noexcept;
+    static HRESULT GetStats(XblProfileArea area, XblProfileAreaStats* stats) noexcept;
+    static void Reset() noexcept;
+};
+
+// Times a single operation which may complete asynchronously. The timer lives with the operation rather than in
+// shared state, so overlapping operations in the same area don't interfere. Stop records at most one sample.
+class ProfileTimer
+{
+public:
+    ProfileTimer() noexcept = default;
+    explicit ProfileTimer(XblProfileArea area) noexcept;
+
+    void Stop() noexcept;
+
+private:
+    XblProfileArea m_area{};
+    Profiler::Clock::time_point m_start{};
+    bool m_running{ false };
+};
+
+// Times the enclosing scope
+class ProfileScope
+{
+public:
+    explicit ProfileScope(XblProfileArea area) noexcept : m_timer{ area } {}
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    ~ProfileScope() noexcept { m_timer.Stop(); }
+
+private:
+    ProfileTimer m_timer;
+};
+
+#define XSAPI_PROFILE_SCOPE(area) xbox::services::ProfileScope xsapiProfileScope{ area }
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "token_cache.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+constexpr std::chrono::seconds TokenCache::TokenLifetime;
+constexpr std::chrono::seconds TokenCache::RefreshWindow;
+
+bool TokenCache::Key::operator<(const Key& other) const noexcept
+{
+    if (xuid != other.xuid)
+    {
+        return xuid < other.xuid;
+    }
+    if (localId != other.localId)
+    {
+        return localId < other.localId;
+    }
+    if (allUsers != other.allUsers)
+    {
+        return allUsers < other.allUsers;
+    }
+    return audience < other.audience;
+}
+
+TokenCache::Key TokenCache::MakeKey(
+    uint64_t xuid,
+    uint64_t localId,
+    bool allUsers,
+    const String& url
+) noexcept
+{
+    size_t hostBegin{ url.find("://") };
+    hostBegin = hostBegin == String::npos ? 0 : hostBegin + 3;
+    size_t hostEnd{ url.find_first_of("/?#", hostBegin) };
+
+    return Key{ xuid, localId, allUsers, utils::ToLower(url.substr(0, hostEnd)) };
+}
+
+TokenCache::Lookup TokenCache::Acquire(
+    const Key& key,
+    bool forceRefresh,
+    Waiter* waiter
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto now{ chrono_clock_t::now() };
+    if (now >= m_nextExpiryCheck)
+    {
+        RemoveExpiredEntriesInternal(now);
+        m_nextExpiryCheck = now + TokenLifetime;
+    }
+
+    auto& entry{ m_entries[key] };
+    entry.lastUsed = now;
+    if (entry.signing == Signing::Signed)
+    {
+        ++m_stats.bypassedRequests;
+        return Lookup{ Action::Bypass, String{}, false, entry.generation };
+    }
+
+    if (forceRefresh)
+    {
+        ++entry.generation;
+        entry.hasToken = false;
+        entry.token.clear();
+    }
+
+    if (entry.hasToken && now < entry.expiry)
+    {
+        ++m_stats.hits;
+
+        bool refresh{ !entry.requestInFlight && now >= entry.expiry - RefreshWindow };
+        if (refresh)
+        {
+            entry.requestInFlight = true;
+        }
+        return Lookup{ Action::UseCached, entry.token, refresh, entry.generation };
+    }
+
+    if (entry.requestInFlight && !forceRefresh)
+    {
+        if (waiter == nullptr)
+        {
+            return Lookup{ Action::Join, String{}, false, entry.generation };
+        }
+
+        ++m_stats.joinedRequests;
+        entry.waiters.push_back(std::move(*waiter));
+        return Lookup{ Action::Joined, String{}, false, entry.generation };
+    }
+
+    ++m_stats.requests;
+    entry.requestInFlight = true;
+    return Lookup{ Action::Request, String{}, false, entry.generation };
+}
+
+void TokenCache::Complete(
+    const Key& key,
+    uint64_t generation,
+    const Result<TokenAndSignature>& result
+) noexcept
+{
+    Vector<Waiter> waiters;
+    bool shared{ false };
+    String token;
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        auto iter{ m_entries.find(key) };
+        if (iter == m_entries.end())
+        {
+            // Entries aren't removed while a request is in flight, so there is nothing waiting on this one
+            return;
+        }
+
+        auto& entry{ iter->second };
+        entry.requestInFlight = false;
+        waiters = std::move(entry.waiters);
+        entry.waiters.clear();
+
+        if (Succeeded(result))
+        {
+            if (!result.Payload().signature.empty())
+            {
+                entry.signing = Signing::Signed;
+                entry.hasToken = false;
+                entry.token.clear();
+            }
+            else if (generation == entry.generation)
+            {
+                entry.signing = Signing::Unsigned;
+                entry.hasToken = true;
+                entry.token = result.Payload().token;
+                entry.expiry = chrono_clock_t::now() + TokenLifetime;
+                shared = true;
+                token = entry.token;
+            }
+        }
+    }
+
+    // Waiters share the token if it was cached, even if it is empty because the URL needs no token. Otherwise the
+    // audience needs signatures, the request failed, or the token was invalidated while it was in flight, and each
+    // waiter makes its own request.
+    for (auto& waiter : waiters)
+    {
+        if (shared)
+        {
+            waiter.async.Complete(TokenAndSignature{ token, String{} });
+        }
+        else
+        {
+            waiter.retry(std::move(waiter.async));
+        }
+    }
+}
+
+void TokenCache::Invalidate(uint64_t xuid) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    for (auto iter = m_entries.lower_bound(Key{ xuid, 0, false, String{} }); iter != m_entries.end() && iter->first.xuid == xuid; ++iter)
+    {
+        ++iter->second.generation;
+        iter->second.hasToken = false;
+        iter->second.token.clear();
+    }
+}
+
+void TokenCache::RemoveUser(uint64_t localId) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    for (auto iter = m_entries.begin(); iter != m_entries.end();)
+    {
+        if (iter->first.localId != localId)
+        {
+            ++iter;
+        }
+        else if (iter->second.requestInFlight)
+        {
+            // Keep the entry for the in-flight request to complete its waiters, but don't cache its token
+            ++iter->second.generation;
+            iter->second.hasToken = false;
+            iter->second.token.clear();
+            ++iter;
+        }
+        else
+        {
+            iter = m_entries.erase(iter);
+        }
+    }
+}
+
+void TokenCache::RemoveExpiredEntries(chrono_clock_t::time_point now) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    RemoveExpiredEntriesInternal(now);
+}
+
+void TokenCache::RemoveExpiredEntriesInternal(chrono_clock_t::time_point now) noexcept
+{
+    // m_mutex must be held when calling this function
+    for (auto iter = m_entries.begin(); iter != m_entries.end();)
+    {
+        const auto& entry{ iter->second };
+        bool hasValidToken{ entry.hasToken && now < entry.expiry };
+        if (!entry.requestInFlight && !hasValidToken && now >= entry.lastUsed + TokenLifetime)
+        {
+            iter = m_entries.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+size_t TokenCache::EntryCount() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_entries.size();
+}
+
+TokenCache::Stats TokenCache::GetStats() const noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_stats;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
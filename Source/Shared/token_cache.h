@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
+
+// Caches Xbox Live tokens and collapses concurrent token requests for the same audience into a single request.
+// Entries are keyed by user, whether the token is for all users, and audience. The audience (relying party) is
+// chosen from the request URL's scheme and host, so that is what keys the entry. A user's entries are removed
+// when they sign out, and entries that haven't been used for TokenLifetime are removed periodically.
+//
+// Only tokens for audiences that don't sign requests are cached. A signature covers a single request, so once an
+// audience returns a signature its requests bypass the cache.
+class TokenCache
+{
+public:
+    // The token service doesn't report token lifetimes, so cached tokens are treated as valid for a fixed time and
+    // refreshed in the background once they are within RefreshWindow of expiring. Tokens the service rejects are
+    // invalidated through User::SetTokenExpired.
+    static constexpr std::chrono::seconds TokenLifetime{ 10 * 60 };
+    static constexpr std::chrono::seconds RefreshWindow{ 60 };
+
+    struct Key
+    {
+        uint64_t xuid;
+        uint64_t localId;
+        bool allUsers;
+        String audience;
+
+        bool operator<(const Key& other) const noexcept;
+    };
+
+    static Key MakeKey(uint64_t xuid, uint64_t localId, bool allUsers, const String& url) noexcept;
+
+    // A request waiting on an in-flight token request. If that request's token can't be shared, retry is called
+    // to make the waiter's own token request.
+    struct Waiter
+    {
+        AsyncContext<Result<TokenAndSignature>> async;
+        Function<void(AsyncContext<Result<TokenAndSignature>>)> retry;
+    };
+
+    enum class Action
+    {
+        // Use the cached token. If refresh is set, the caller should also request a new token and report it
+        // with Complete
+        UseCached,
+        // Request a token and report the result with Complete
+        Request,
+        // Request a token and signature without involving the cache
+        Bypass,
+        // A request for the audience is in flight. Call Acquire again with a Waiter to wait for it
+        Join,
+        // The waiter was queued behind the in-flight request
+        Joined
+    };
+
+    struct Lookup
+    {
+        Action action;
+        String token;
+        bool refresh;
+        uint64_t generation;
+    };
+
+    Lookup Acquire(
+        const Key& key,
+        bool forceRefresh,
+        Waiter* waiter
+    ) noexcept;
+
+    // Records the result of a token request started for an Acquire result with the given generation, and
+    // completes the requests that were waiting on it. An empty token, which XAL returns for URLs that don't need
+    // one, is cached and shared like any other.
+    void Complete(
+        const Key& key,
+        uint64_t generation,
+        const Result<TokenAndSignature>& result
+    ) noexcept;
+
+    // Drops the cached tokens for a user. Requests in flight when this is called won't be cached.
+    void Invalidate(uint64_t xuid) noexcept;
+
+    // Removes all entries for a user that signed out. Requests in flight when this is called won't be cached.
+    void RemoveUser(uint64_t localId) noexcept;
+
+    // Removes entries that are idle and have no valid token. Acquire calls this every TokenLifetime.
+    void RemoveExpiredEntries(chrono_clock_t::time_point now) noexcept;
+
+    size_t EntryCount() const noexcept;
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t requests;
+        uint64_t joinedRequests;
+        uint64_t bypassedRequests;
+    };
+
+    Stats GetStats() const noexcept;
+
+private:
+    enum class Signing
+    {
+        Unknown,
+        Unsigned,
+        Signed
+    };
+
+    struct Entry
+    {
+        Signing signing{ Signing::Unknown };
+        bool hasToken{ false };
+        String token;
+        chrono_clock_t::time_point expiry;
+        chrono_clock_t::time_point lastUsed;
+        bool requestInFlight{ false };
+        uint64_t generation{ 0 };
+        Vector<Waiter> waiters;
+    };
+
+    void RemoveExpiredEntriesInternal(chrono_clock_t::time_point now) noexcept;
+
+    mutable std::mutex m_mutex;
+    Map<Key, Entry> m_entries;
+    chrono_clock_t::time_point m_nextExpiryCheck{ chrono_clock_t::now() + TokenLifetime };
+    Stats m_stats{};
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
@@ -256,6 +256,7 @@ HRESULT User::GetTokenAndSignature(
     }
 
     bool forceRefresh{ false };
+    std::shared_ptr<TokenCache> tokenCache;
 
     auto state{ GlobalState::Get() };
     if (state)
@@ -264,8 +265,111 @@ HRESULT User::GetTokenAndSignature(
         {
             forceRefresh = true;
         }
+        tokenCache = state->TokenCache();
     }
 
+    if (!tokenCache)
+    {
+        return RequestTokenAndSignature(httpMethod, url, headers, requestBody, requestBodySize, allUsers, forceRefresh, std::move(async));
+    }
+
+    auto key{ TokenCache::MakeKey(Xuid(), LocalId(), allUsers, url) };
+    auto lookup{ tokenCache->Acquire(key, forceRefresh, nullptr) };
+
+    if (lookup.action == TokenCache::Action::Join)
+    {
+        // Another request for this audience is in flight. The request is only copied here, when it has to wait,
+        // so that it can be retried if the in-flight token can't be shared.
+        auto copyResult{ Copy() };
+        RETURN_HR_IF_FAILED(copyResult.Hresult());
+
+        auto user{ MakeShared<User>(copyResult.ExtractPayload()) };
+        Vector<uint8_t> body{ requestBody, requestBody + requestBodySize };
+
+        TokenCache::Waiter waiter{ std::move(async),
+            [user, httpMethod, url, headers, body, allUsers](AsyncContext<Result<TokenAndSignature>> async)
+            {
+                HRESULT hr = user->RequestTokenAndSignature(httpMethod, url, headers, body.data(), body.size(), allUsers, false, AsyncContext<Result<TokenAndSignature>>{ async });
+                if (FAILED(hr))
+                {
+                    async.Complete(hr);
+                }
+            }
+        };
+
+        lookup = tokenCache->Acquire(key, forceRefresh, &waiter);
+        if (lookup.action == TokenCache::Action::Joined)
+        {
+            return S_OK;
+        }
+
+        // The in-flight request finished before the waiter was queued
+        async = std::move(waiter.async);
+    }
+
+    switch (lookup.action)
+    {
+    case TokenCache::Action::UseCached:
+    {
+        if (lookup.refresh)
+        {
+            // Refresh the token in the background so it is replaced before it expires
+            auto copyResult{ Copy() };
+            HRESULT hr{ copyResult.Hresult() };
+            if (SUCCEEDED(hr))
+            {
+                auto user{ MakeShared<User>(copyResult.ExtractPayload()) };
+                hr = user->RequestTokenAndSignature(httpMethod, url, headers, requestBody, requestBodySize, allUsers, false, AsyncContext<Result<TokenAndSignature>>{ async.Queue(),
+                    [user, tokenCache, key, generation{ lookup.generation }](Result<TokenAndSignature> result)
+                    {
+                        tokenCache->Complete(key, generation, result);
+                    }
+                });
+            }
+            if (FAILED(hr))
+            {
+                tokenCache->Complete(key, lookup.generation, hr);
+            }
+        }
+
+        async.Complete(TokenAndSignature{ std::move(lookup.token), String{} });
+        return S_OK;
+    }
+    case TokenCache::Action::Request:
+    {
+        TaskQueue queue{ async.Queue() };
+        HRESULT hr = RequestTokenAndSignature(httpMethod, url, headers, requestBody, requestBodySize, allUsers, forceRefresh, AsyncContext<Result<TokenAndSignature>>{ queue,
+            [tokenCache, key, generation{ lookup.generation }, async](Result<TokenAndSignature> result)
+            {
+                tokenCache->Complete(key, generation, result);
+                async.Complete(result);
+            }
+        });
+        if (FAILED(hr))
+        {
+            // Release any requests that queued behind this one
+            tokenCache->Complete(key, lookup.generation, hr);
+        }
+        return hr;
+    }
+    default:
+    {
+        return RequestTokenAndSignature(httpMethod, url, headers, requestBody, requestBodySize, allUsers, forceRefresh, std::move(async));
+    }
+    }
+}
+
+HRESULT User::RequestTokenAndSignature(
+    const String& httpMethod,
+    const String& url,
+    const HttpHeaders& headers,
+    const uint8_t* requestBody,
+    size_t requestBodySize,
+    bool allUsers,
+    bool forceRefresh,
+    AsyncContext<Result<TokenAndSignature>>&& async
+) noexcept
+{
     XalUserGetTokenAndSignatureArgs tokenAndSigArgs{
         httpMethod.data(),
         url.data(),
@@ -289,13 +393,20 @@ HRESULT User::GetTokenAndSignature(
         tokenAndSigArgs.headers = xalHttpHeaders.data();
     }
 
+    struct TokenRequestContext
+    {
+        AsyncContext<Result<TokenAndSignature>> async;
+        ProfileTimer timer;
+    };
+
     auto asyncBlock{ Make<XAsyncBlock>() };
 
     asyncBlock->queue = async.Queue().GetHandle();
-    asyncBlock->context = Make<AsyncContext<Result<TokenAndSignature>>>(std::move(async));
+    asyncBlock->context = Make<TokenRequestContext>(TokenRequestContext{ std::move(async), ProfileTimer{ XblProfileArea::TokenFetch } });
     asyncBlock->callback = [](XAsyncBlock* asyncBlock)
     {
-        auto async{ static_cast<AsyncContext<Result<TokenAndSignature>>*>(asyncBlock->context) };
+        auto context{ static_cast<TokenRequestContext*>(asyncBlock->context) };
+        context->timer.Stop();
 
         size_t bufferSize{ 0 };
         HRESULT hr = XalUserGetTokenAndSignatureSilentlyResultSize(asyncBlock, &bufferSize);
@@ -321,9 +432,9 @@ HRESULT User::GetTokenAndSignature(
             hr = S_OK;
         }
 
-        async->Complete(Result<TokenAndSignature>{ payload, hr });
+        context->async.Complete(Result<TokenAndSignature>{ payload, hr });
 
-        Delete(async);
+        Delete(context);
         Delete(asyncBlock);
     };
 
@@ -333,8 +444,8 @@ HRESULT User::GetTokenAndSignature(
         asyncBlock);
     if (FAILED(hr))
     {
-        auto asyncPtr{ static_cast<AsyncContext<Result<TokenAndSignature>>*>(asyncBlock->context) };
-        Delete(asyncPtr);
+        auto context{ static_cast<TokenRequestContext*>(asyncBlock->context) };
+        Delete(context);
         Delete(asyncBlock);
     }
     return hr;
@@ -351,6 +462,7 @@ void User::SetTokenExpired(uint64_t xuid) noexcept
     if (state)
     {
         state->InsertUserExpiredToken(xuid);
+        state->TokenCache()->Invalidate(xuid);
     }
 
 }
@@ -76,6 +76,19 @@ private:
     User(XblUserHandle userHandle) noexcept;
 
     HRESULT InitializeUser() noexcept;
+
+    // Requests a token and signature from XAL without consulting the token cache
+    HRESULT RequestTokenAndSignature(
+        const String& httpMethod,
+        const String& url,
+        const HttpHeaders& headers,
+        const uint8_t* requestBody,
+        size_t requestBodySize,
+        bool allUsers,
+        bool forceRefresh,
+        AsyncContext<Result<TokenAndSignature>>&& async
+    ) noexcept;
+
     Result<String> GetGamertagComponent(XalGamertagComponent component) const noexcept;	
     XblUserHandle m_handle{ nullptr };
     mutable uint64_t m_xuid;
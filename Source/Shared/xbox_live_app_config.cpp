@@ -122,6 +122,46 @@ bool AppConfig::IsDisableAssertsForXboxLiveThrottlingInDevSandboxes() const
     return m_disableAssertsForXboxLiveThrottlingInDevSandboxes;
 }
 
+JsonDeserializationMode AppConfig::JsonDeserializationMode() const
+{
+    return m_jsonDeserializationMode;
+}
+
+void AppConfig::SetJsonDeserializationMode(xbox::services::JsonDeserializationMode mode)
+{
+    m_jsonDeserializationMode = mode;
+}
+
+uint32_t AppConfig::RtaMaxHandshakesInFlight() const
+{
+    return m_rtaMaxHandshakesInFlight;
+}
+
+void AppConfig::SetRtaMaxHandshakesInFlight(uint32_t maxHandshakesInFlight)
+{
+    m_rtaMaxHandshakesInFlight = maxHandshakesInFlight;
+}
+
+uint32_t AppConfig::RtaSubscriptionsPerConnection() const
+{
+    return m_rtaSubscriptionsPerConnection;
+}
+
+void AppConfig::SetRtaSubscriptionsPerConnection(uint32_t subscriptionsPerConnection)
+{
+    m_rtaSubscriptionsPerConnection = subscriptionsPerConnection;
+}
+
+uint32_t AppConfig::SocialGraphUpdateBudgetMicroseconds() const
+{
+    return m_socialGraphUpdateBudgetMicroseconds;
+}
+
+void AppConfig::SetSocialGraphUpdateBudgetMicroseconds(uint32_t budgetMicroseconds)
+{
+    m_socialGraphUpdateBudgetMicroseconds = budgetMicroseconds;
+}
+
 #if HC_PLATFORM == HC_PLATFORM_IOS
 const xsapi_internal_string& AppConfig::APNSEnvironment() const
 {
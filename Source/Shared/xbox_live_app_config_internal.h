@@ -39,6 +39,23 @@ public:
     void DisableAssertsForXboxLiveThrottlingInDevSandboxes();
     bool IsDisableAssertsForXboxLiveThrottlingInDevSandboxes() const;
 
+    xbox::services::JsonDeserializationMode JsonDeserializationMode() const;
+    void SetJsonDeserializationMode(xbox::services::JsonDeserializationMode mode);
+
+    // Maximum number of RTA subscribe/unsubscribe handshakes outstanding on a connection. 0 means unbounded.
+    uint32_t RtaMaxHandshakesInFlight() const;
+    void SetRtaMaxHandshakesInFlight(uint32_t maxHandshakesInFlight);
+
+    // Number of subscriptions after which a user's RTA subscriptions are spread across additional
+    // connections. 0 means all of a user's subscriptions share a single connection.
+    uint32_t RtaSubscriptionsPerConnection() const;
+    void SetRtaSubscriptionsPerConnection(uint32_t subscriptionsPerConnection);
+
+    // Time a SocialGraph may spend applying pending updates during each call to SocialManager DoWork.
+    // Updates beyond the budget carry over to the next call. 0 means all pending updates are applied.
+    uint32_t SocialGraphUpdateBudgetMicroseconds() const;
+    void SetSocialGraphUpdateBudgetMicroseconds(uint32_t budgetMicroseconds);
+
 #if HC_PLATFORM == HC_PLATFORM_IOS
     const xsapi_internal_string& APNSEnvironment() const;
     void SetAPNSEnvironment(const xsapi_internal_string& apnsEnvironment);
@@ -95,6 +112,10 @@ private:
     xsapi_internal_string m_overrideScid;
     xsapi_internal_string m_endpointId;
     bool m_disableAssertsForXboxLiveThrottlingInDevSandboxes{ false };
+    xbox::services::JsonDeserializationMode m_jsonDeserializationMode{ xbox::services::JsonDeserializationMode::Dom };
+    uint32_t m_rtaMaxHandshakesInFlight{ 32 };
+    uint32_t m_rtaSubscriptionsPerConnection{ 0 };
+    uint32_t m_socialGraphUpdateBudgetMicroseconds{ 1000 };
 
 #if HC_PLATFORM == HC_PLATFORM_IOS
     xsapi_internal_string m_apnsEnvironment{ "apnsProduction" };
@@ -657,6 +657,168 @@ xsapi_internal_string JsonUtils::SerializeJson(_In_ const JsonValue& json)
     return buffer.GetString();
 }
 
+HRESULT JsonSaxReader::Parse(
+    _In_z_ const char* json
+) noexcept
+{
+    m_path.clear();
+    m_pathIsArray.clear();
+    m_key.clear();
+    m_hr = S_OK;
+
+    rapidjson::GenericReader<rapidjson::UTF8<>, rapidjson::UTF8<>, JsonAllocator> reader;
+    rapidjson::StringStream stream{ json };
+    auto parseResult = reader.Parse(stream, *this);
+    if (FAILED(m_hr))
+    {
+        return m_hr;
+    }
+    else if (parseResult.IsError())
+    {
+        return WEB_E_INVALID_JSON_STRING;
+    }
+    return S_OK;
+}
+
+bool JsonSaxReader::Null()
+{
+    return OnNull();
+}
+
+bool JsonSaxReader::Bool(bool b)
+{
+    return OnBool(b);
+}
+
+bool JsonSaxReader::Int(int i)
+{
+    return OnInt64(i);
+}
+
+bool JsonSaxReader::Uint(unsigned u)
+{
+    return OnUint64(u);
+}
+
+bool JsonSaxReader::Int64(int64_t i)
+{
+    return OnInt64(i);
+}
+
+bool JsonSaxReader::Uint64(uint64_t u)
+{
+    return OnUint64(u);
+}
+
+bool JsonSaxReader::Double(double d)
+{
+    return OnDouble(d);
+}
+
+bool JsonSaxReader::RawNumber(const char* str, rapidjson::SizeType length, bool)
+{
+    // Only called with kParseNumbersAsStringsFlag, which we don't use
+    return OnString(str, length);
+}
+
+bool JsonSaxReader::String(const char* str, rapidjson::SizeType length, bool)
+{
+    return OnString(str, length);
+}
+
+bool JsonSaxReader::StartObject()
+{
+    if (!OnStartObject())
+    {
+        return false;
+    }
+    PushContainer(false);
+    return true;
+}
+
+bool JsonSaxReader::Key(const char* str, rapidjson::SizeType length, bool)
+{
+    m_key.assign(str, length);
+    return true;
+}
+
+bool JsonSaxReader::EndObject(rapidjson::SizeType)
+{
+    PopContainer();
+    return OnEndObject();
+}
+
+bool JsonSaxReader::StartArray()
+{
+    if (!OnStartArray())
+    {
+        return false;
+    }
+    PushContainer(true);
+    return true;
+}
+
+bool JsonSaxReader::EndArray(rapidjson::SizeType)
+{
+    PopContainer();
+    return OnEndArray();
+}
+
+const xsapi_internal_vector<xsapi_internal_string>& JsonSaxReader::Path() const noexcept
+{
+    return m_path;
+}
+
+bool JsonSaxReader::PathIs(std::initializer_list<const char*> path) const noexcept
+{
+    if (path.size() != m_path.size())
+    {
+        return false;
+    }
+    return std::equal(path.begin(), path.end(), m_path.begin(), [](const char* expected, const xsapi_internal_string& actual)
+    {
+        return actual == expected;
+    });
+}
+
+const xsapi_internal_string& JsonSaxReader::Key() const noexcept
+{
+    return m_key;
+}
+
+bool JsonSaxReader::KeyIs(const char* key) const noexcept
+{
+    return m_key == key;
+}
+
+bool JsonSaxReader::InArray() const noexcept
+{
+    return !m_pathIsArray.empty() && m_pathIsArray.back();
+}
+
+bool JsonSaxReader::Fail(HRESULT hr) noexcept
+{
+    assert(FAILED(hr));
+    m_hr = hr;
+    return false;
+}
+
+void JsonSaxReader::PushContainer(bool isArray) noexcept
+{
+    m_path.push_back(m_key);
+    m_pathIsArray.push_back(isArray);
+    // Array elements have no key. Object members will set their key before each value
+    m_key.clear();
+}
+
+void JsonSaxReader::PopContainer() noexcept
+{
+    assert(!m_path.empty());
+    m_key = std::move(m_path.back());
+    m_path.pop_back();
+    m_pathIsArray.pop_back();
+}
+
 void* JsonAllocator::Malloc(size_t size)
 {
     if (size)
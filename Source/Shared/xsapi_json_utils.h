@@ -286,6 +286,82 @@ public:
     static xsapi_internal_string SerializeJson(_In_ const JsonValue& json);
 };
 
+// Selects how services which support streaming deserialization parse service responses. Dom is the default;
+// Verify runs both the DOM and SAX paths, logs any difference between them and returns the DOM result.
+enum class JsonDeserializationMode
+{
+    Dom,
+    Sax,
+    Verify
+};
 
+// Base class for streaming (SAX) deserializers. Implements the rapidjson Handler concept and tracks the
+// path to the value currently being visited so that derived readers can fill their output directly from
+// the response bytes without building an intermediate JsonDocument.
+//
+// Each container in the path is identified by its key in the parent, array elements and the root by an empty
+// string. For example, while visiting the "xuid" field of {"people":[{"xuid":"1"}]}, Path() is { "", "people", "" }
+// and Key() is "xuid".
+class JsonSaxReader
+{
+public:
+    JsonSaxReader() noexcept = default;
+    JsonSaxReader(const JsonSaxReader&) = delete;
+    JsonSaxReader& operator=(const JsonSaxReader&) = delete;
+    virtual ~JsonSaxReader() noexcept = default;
+
+    // Parses the document, invoking the callbacks below. Returns the first error reported by the reader via
+    // Fail, or WEB_E_INVALID_JSON_STRING if the document is malformed.
+    HRESULT Parse(_In_z_ const char* json) noexcept;
+
+    // rapidjson Handler concept. Maintains the path and forwards to the virtual callbacks.
+    bool Null();
+    bool Bool(bool b);
+    bool Int(int i);
+    bool Uint(unsigned u);
+    bool Int64(int64_t i);
+    bool Uint64(uint64_t u);
+    bool Double(double d);
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy);
+    bool String(const char* str, rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool Key(const char* str, rapidjson::SizeType length, bool copy);
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType elementCount);
+
+protected:
+    const xsapi_internal_vector<xsapi_internal_string>& Path() const noexcept;
+    bool PathIs(std::initializer_list<const char*> path) const noexcept;
+    const xsapi_internal_string& Key() const noexcept;
+    bool KeyIs(const char* key) const noexcept;
+    // True if the innermost container is an array
+    bool InArray() const noexcept;
+
+    // Records an error and stops parsing. Returns false so it can be returned directly from a callback.
+    bool Fail(HRESULT hr) noexcept;
+
+    // Callbacks for derived readers. When starting or ending a container, Path() and Key() describe the container itself,
+    // i.e. Path() is the path to the parent and Key() is the key of the container within the parent.
+    virtual bool OnStartObject() { return true; }
+    virtual bool OnEndObject() { return true; }
+    virtual bool OnStartArray() { return true; }
+    virtual bool OnEndArray() { return true; }
+    virtual bool OnNull() { return true; }
+    virtual bool OnBool(bool) { return true; }
+    virtual bool OnInt64(int64_t) { return true; }
+    virtual bool OnUint64(uint64_t) { return true; }
+    virtual bool OnDouble(double) { return true; }
+    virtual bool OnString(const char* /*str*/, size_t /*length*/) { return true; }
+
+private:
+    void PushContainer(bool isArray) noexcept;
+    void PopContainer() noexcept;
+
+    xsapi_internal_vector<xsapi_internal_string> m_path;
+    xsapi_internal_vector<bool> m_pathIsArray;
+    xsapi_internal_string m_key;
+    HRESULT m_hr{ S_OK };
+};
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_END
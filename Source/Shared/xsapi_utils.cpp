@@ -1170,6 +1170,49 @@ String utils::ToLower(String str) noexcept
     return str;
 }
 
+String utils::HostFromUrl(const String& url) noexcept
+{
+    size_t hostBegin{ url.find("://") };
+    hostBegin = hostBegin == String::npos ? 0 : hostBegin + 3;
+    size_t hostEnd{ url.find_first_of(":/?#", hostBegin) };
+
+    return ToLower(url.substr(hostBegin, hostEnd == String::npos ? String::npos : hostEnd - hostBegin));
+}
+
+uint32_t utils::crc32(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    _In_ uint32_t crc
+) noexcept
+{
+    struct Crc32Table
+    {
+        Crc32Table() noexcept
+        {
+            // Reflected CRC-32 (IEEE 802.3) polynomial
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t entry{ i };
+                for (uint32_t bit = 0; bit < 8; ++bit)
+                {
+                    entry = (entry & 1) ? (entry >> 1) ^ 0xEDB88320u : entry >> 1;
+                }
+                entries[i] = entry;
+            }
+        }
+
+        uint32_t entries[256];
+    };
+    static const Crc32Table table{};
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
 XAsyncBlock* utils::MakeAsyncBlock(XTaskQueueHandle queue, void* context, XAsyncCompletionRoutine* callback)
 {
     auto async = Make<XAsyncBlock>();
@@ -116,6 +116,19 @@ public:
 #endif 
     }
 
+    // 64-bit FNV-1a over the ASCII lowercased bytes of str. Strings that compare equal with str_icmp
+    // hash equally, so differing hashes prove two documents differ. Equal hashes don't prove they match.
+    static inline uint64_t str_ihash(const char* str)
+    {
+        uint64_t hash{ 14695981039346656037ULL };
+        for (; str && *str; ++str)
+        {
+            hash ^= static_cast<uint8_t>(tolower(static_cast<unsigned char>(*str)));
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
     static inline int char_t_cmp(const char_t* left, const char_t* right)
     {
 #if HC_PLATFORM_IS_MICROSOFT
@@ -342,6 +355,17 @@ public:
 
     static String ToLower(String str) noexcept;
 
+    // Returns the lowercase host of an absolute URL, without any port
+    static String HostFromUrl(const String& url) noexcept;
+
+    // CRC-32 (IEEE 802.3), as used by gzip. Pass a previous result as crc to continue a checksum across multiple
+    // buffers.
+    static uint32_t crc32(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        _In_ uint32_t crc = 0
+    ) noexcept;
+
 private:
     template<typename T>
     struct SmartPointerContainer
@@ -29,6 +29,8 @@ public:
 
     virtual HRESULT Begin() noexcept = 0;
     virtual HRESULT Fail(HRESULT result) noexcept = 0;
+    // Completes an operation that was never begun
+    virtual HRESULT Cancel(HRESULT result) noexcept = 0;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_CPP_BEGIN
@@ -54,6 +56,7 @@ public:
 
     virtual HRESULT Begin() noexcept override;
     virtual HRESULT Fail(HRESULT result) noexcept override;
+    virtual HRESULT Cancel(HRESULT result) noexcept override;
     virtual HRESULT Complete(ResultT args) noexcept;
 
 private:
@@ -95,6 +98,16 @@ HRESULT ClientOperation<ResultT>::Fail(
     return Complete(ResultT{ result });
 }
 
+template<typename ResultT>
+HRESULT ClientOperation<ResultT>::Cancel(
+    HRESULT result
+) noexcept
+{
+    // Take the ref that Begin would have leaked so that Complete can reclaim it
+    AddRef();
+    return Complete(ResultT{ result });
+}
+
 template<typename ResultT>
 HRESULT ClientOperation<ResultT>::Complete(
     ResultT result
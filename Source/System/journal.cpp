@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "journal.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+namespace
+{
+
+constexpr uint8_t JournalVersion{ 1 };
+
+struct Crc32Table
+{
+    Crc32Table() noexcept
+    {
+        // Reflected CRC-32 (IEEE 802.3) polynomial
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc{ i };
+            for (uint32_t bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            entries[i] = crc;
+        }
+    }
+
+    uint32_t entries[256];
+};
+
+void WriteUInt32(uint8_t* data, uint32_t value) noexcept
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+}
+
+constexpr size_t Journal::SegmentHeaderSize;
+constexpr size_t Journal::RecordHeaderSize;
+
+void Journal::AppendSegmentHeader(
+    _Inout_ Vector<uint8_t>& buffer
+) noexcept
+{
+    buffer.insert(buffer.end(), { 'X', 'B', 'J', JournalVersion });
+}
+
+void Journal::AppendRecord(
+    _Inout_ Vector<uint8_t>& buffer,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+) noexcept
+{
+    buffer.reserve(buffer.size() + RecordHeaderSize + size);
+    size_t recordOffset{ BeginRecord(buffer) };
+    buffer.insert(buffer.end(), data, data + size);
+    EndRecord(buffer, recordOffset);
+}
+
+size_t Journal::BeginRecord(
+    _Inout_ Vector<uint8_t>& buffer
+) noexcept
+{
+    size_t recordOffset{ buffer.size() };
+    buffer.resize(recordOffset + RecordHeaderSize);
+    return recordOffset;
+}
+
+void Journal::EndRecord(
+    _Inout_ Vector<uint8_t>& buffer,
+    _In_ size_t recordOffset
+) noexcept
+{
+    assert(buffer.size() >= recordOffset + RecordHeaderSize);
+
+    uint8_t* record{ buffer.data() + recordOffset };
+    size_t size{ buffer.size() - recordOffset - RecordHeaderSize };
+    assert(size <= UINT32_MAX);
+
+    WriteUInt32(record, static_cast<uint32_t>(size));
+    WriteUInt32(record + 4, Crc32(record + RecordHeaderSize, size));
+}
+
+uint32_t Journal::Crc32(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+) noexcept
+{
+    static const Crc32Table table{};
+
+    uint32_t crc{ 0xFFFFFFFFu };
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool Journal::IsValidSegmentHeader(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size
+) noexcept
+{
+    return size >= SegmentHeaderSize &&
+        data[0] == 'X' && data[1] == 'B' && data[2] == 'J' &&
+        data[3] == JournalVersion;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
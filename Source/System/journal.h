@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#pragma once
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+// Binary format for append-only journals kept in LocalStorage. A journal is a sequence of segment files, each
+// starting with a short header followed by records:
+//
+//   segment: "XBJ" version(1 byte) record*
+//   record:  length(uint32 LE) crc32(uint32 LE) payload(length bytes)
+//
+// Records are only ever appended, so after a crash at most the tail of the last segment can be torn. Replay stops
+// at the first record that is truncated or fails its checksum, bounding the loss to the segment being written.
+class Journal
+{
+public:
+    static constexpr size_t SegmentHeaderSize{ 4 };
+    static constexpr size_t RecordHeaderSize{ 8 };
+
+    // Appends a segment header to buffer. Must be the first thing written to a new segment.
+    static void AppendSegmentHeader(_Inout_ Vector<uint8_t>& buffer) noexcept;
+
+    // Appends a record to buffer
+    static void AppendRecord(
+        _Inout_ Vector<uint8_t>& buffer,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    ) noexcept;
+
+    // Begins a record whose payload the caller appends to buffer directly, avoiding a separate payload buffer.
+    // Returns the record's offset, which must be passed to EndRecord once the payload has been appended.
+    static size_t BeginRecord(_Inout_ Vector<uint8_t>& buffer) noexcept;
+    static void EndRecord(_Inout_ Vector<uint8_t>& buffer, _In_ size_t recordOffset) noexcept;
+
+    // Invokes onRecord(const uint8_t* payload, size_t size) for each valid record in a segment, in order.
+    // Returns the number of bytes of the segment that were valid. A result smaller than size means the segment's
+    // tail is torn or corrupt.
+    template<typename OnRecord>
+    static size_t Replay(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size,
+        OnRecord&& onRecord
+    ) noexcept;
+
+    static uint32_t Crc32(
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    ) noexcept;
+
+private:
+    static bool IsValidSegmentHeader(_In_reads_bytes_(size) const uint8_t* data, _In_ size_t size) noexcept;
+
+    static uint32_t ReadUInt32(_In_reads_bytes_(4) const uint8_t* data) noexcept
+    {
+        return static_cast<uint32_t>(data[0]) |
+            static_cast<uint32_t>(data[1]) << 8 |
+            static_cast<uint32_t>(data[2]) << 16 |
+            static_cast<uint32_t>(data[3]) << 24;
+    }
+};
+
+template<typename OnRecord>
+size_t Journal::Replay(
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size,
+    OnRecord&& onRecord
+) noexcept
+{
+    if (!IsValidSegmentHeader(data, size))
+    {
+        return 0;
+    }
+
+    size_t offset{ SegmentHeaderSize };
+    while (size - offset >= RecordHeaderSize)
+    {
+        const uint8_t* record{ data + offset };
+        size_t length{ ReadUInt32(record) };
+        if (length > size - offset - RecordHeaderSize)
+        {
+            break;
+        }
+
+        const uint8_t* payload{ record + RecordHeaderSize };
+        if (Crc32(payload, length) != ReadUInt32(record + 4))
+        {
+            break;
+        }
+
+        onRecord(payload, length);
+        offset += RecordHeaderSize + length;
+    }
+    return offset;
+}
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -4,6 +4,12 @@
 #include "pch.h"
 #include "local_storage.h"
 #include <iostream>
+#if XSAPI_LOCAL_STORAGE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -12,6 +18,9 @@ XblLocalStorageReadHandler g_localStorageReadHandler{ nullptr };
 XblLocalStorageClearHandler g_localStorageClearHandler{ nullptr };
 XTaskQueueHandle g_localStorageTaskQueue{ nullptr };
 void* g_localStorageClientContext{ nullptr };
+uint32_t g_localStorageMaxConcurrentOperations{ 0 };
+
+constexpr size_t LocalStorage::DefaultMaxConcurrentOperations;
 
 LocalStorage::LocalStorage(
     const TaskQueue& queue
@@ -28,11 +37,18 @@ LocalStorage::LocalStorage(
         m_readHandler = DefaultRead;
         m_clearHandler = DefaultClear;
         m_context = this;
+        m_maxConcurrentOperations = DefaultMaxConcurrentOperations;
 #if HC_PLATFORM == HC_PLATFORM_IOS || HC_PLATFORM == HC_PLATFORM_ANDROID
         m_path = GetDefaultStoragePath();
 #endif
     }
 
+    // Custom handlers are called one operation at a time unless the title has opted in to concurrent operations
+    if (g_localStorageMaxConcurrentOperations > 0)
+    {
+        m_maxConcurrentOperations = g_localStorageMaxConcurrentOperations;
+    }
+
     // If title configured a queue for local storage, use that. Otherwise use provided queue
     if (g_localStorageTaskQueue)
     {
@@ -52,16 +68,28 @@ HRESULT LocalStorage::WriteAsync(
     Callback<Result<size_t>> callback
 ) noexcept
 {
+    if (mode == XblLocalStorageWriteMode::Append && CoalesceAppend(user, key, data, callback))
+    {
+        return S_OK;
+    }
+
     auto copyUserResult{ user.Copy() };
     RETURN_HR_IF_FAILED(copyUserResult.Hresult());
 
+    auto request = MakeShared<WriteRequest>();
+    request->xuid = user.Xuid();
+    request->mode = mode;
+    request->data = std::move(data);
+    request->callbacks.push_back(std::move(callback));
+
+    uint64_t id{ ++m_lastOperationId };
+
     WriteOperation::OperationLauncher launcher{
         [
             sharedThis{ shared_from_this() },
             user = MakeShared<User>(copyUserResult.ExtractPayload()),
-            mode,
-            key{ std::move(key) },
-            data{ std::move(data) }
+            key,
+            request
         ]
     (XblClientOperationHandle op)
     {
@@ -69,10 +97,10 @@ HRESULT LocalStorage::WriteAsync(
             sharedThis->m_context,
             op,
             user->Handle(),
-            mode,
+            request->mode,
             key.data(),
-            data.size(),
-            data.data()
+            request->data.size(),
+            request->data.data()
         );
     }};
 
@@ -81,16 +109,21 @@ HRESULT LocalStorage::WriteAsync(
         AsyncContext<Result<size_t>>{ m_queue,
         [
             sharedThis{ shared_from_this() },
-            callback{ std::move(callback) }
+            key,
+            id,
+            request
         ]
     (Result<size_t> result)
     {
-        sharedThis->OperationComplete();
-        callback(std::move(result));
+        sharedThis->OperationComplete(key, id, false);
+        for (auto& callback : request->callbacks)
+        {
+            callback(result);
+        }
     }
     });
 
-    QueueOperation(op);
+    QueueOperation(key, op, id, request);
 
     return S_OK;
 }
@@ -104,11 +137,13 @@ HRESULT LocalStorage::ReadAsync(
     auto copyUserResult{ user.Copy() };
     RETURN_HR_IF_FAILED(copyUserResult.Hresult());
 
+    uint64_t id{ ++m_lastOperationId };
+
     ReadOperation::OperationLauncher launcher{
         [
             sharedThis{ shared_from_this() },
             user = MakeShared<User>(copyUserResult.ExtractPayload()),
-            key{ std::move(key) }
+            key
         ]
     (XblClientOperationHandle op)
     {
@@ -120,16 +155,18 @@ HRESULT LocalStorage::ReadAsync(
         AsyncContext<Result<Vector<uint8_t>>>{ m_queue,
         [
             sharedThis{ shared_from_this() },
+            key,
+            id,
             callback{ std::move(callback) }
         ]
     (Result<Vector<uint8_t>> result)
     {
-        sharedThis->OperationComplete();
+        sharedThis->OperationComplete(key, id, false);
         callback(std::move(result));
     }
     });
 
-    QueueOperation(op);
+    QueueOperation(key, op, id);
 
     return S_OK;
 }
@@ -143,11 +180,13 @@ HRESULT LocalStorage::ClearAsync(
     auto copyUserResult{ user.Copy() };
     RETURN_HR_IF_FAILED(copyUserResult.Hresult());
 
+    uint64_t id{ ++m_lastOperationId };
+
     ClearOperation::OperationLauncher launcher {
         [
             sharedThis{ shared_from_this() },
             user = MakeShared<User>(copyUserResult.ExtractPayload()),
-            key{ std::move(key) }
+            key
         ]
     (XblClientOperationHandle op)
     {
@@ -159,53 +198,289 @@ HRESULT LocalStorage::ClearAsync(
         AsyncContext<HRESULT>{ m_queue,
         [
             sharedThis{ shared_from_this() },
+            key,
+            id,
             callback{ std::move(callback) }
         ]
     (HRESULT result)
     {
-        sharedThis->OperationComplete();
+        sharedThis->OperationComplete(key, id, SUCCEEDED(result));
         callback(result);
     }
     });
 
-    QueueOperation(op);
+    QueueOperation(key, op, id);
 
     return S_OK;
 }
 
+HRESULT LocalStorage::ReadInPlaceAsync(
+    const User& user,
+    String key,
+    InPlaceReader reader,
+    Callback<HRESULT> callback
+) noexcept
+{
+#if XSAPI_LOCAL_STORAGE_MMAP
+    if (m_readHandler == DefaultRead)
+    {
+        uint64_t id{ ++m_lastOperationId };
+
+        ReadInPlaceOperation::OperationLauncher launcher{
+            [
+                sharedThis{ shared_from_this() },
+                key,
+                reader{ std::move(reader) }
+            ]
+        (XblClientOperationHandle op)
+        {
+            sharedThis->DefaultReadMapped(static_cast<ReadInPlaceOperation*>(op), key.data(), reader);
+        }};
+
+        auto op = MakeShared<ReadInPlaceOperation>(
+            std::move(launcher),
+            AsyncContext<HRESULT>{ m_queue,
+            [
+                sharedThis{ shared_from_this() },
+                key,
+                id,
+                callback{ std::move(callback) }
+            ]
+        (HRESULT result)
+        {
+            sharedThis->OperationComplete(key, id, false);
+            callback(result);
+        }
+        });
+
+        QueueOperation(key, op, id);
+
+        return S_OK;
+    }
+#endif
+
+    return ReadAsync(user, std::move(key),
+        [
+            reader{ std::move(reader) },
+            callback{ std::move(callback) }
+        ]
+    (Result<Vector<uint8_t>> result)
+    {
+        HRESULT hr{ result.Hresult() };
+        if (SUCCEEDED(hr))
+        {
+            hr = reader(result.Payload().data(), result.Payload().size());
+        }
+        callback(hr);
+    });
+}
+
+size_t LocalStorage::CancelPendingOperations(
+    const String& key
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto iter{ m_keys.find(key) };
+    if (iter == m_keys.end())
+    {
+        return 0;
+    }
+
+    auto& pendingOperations{ iter->second.pendingOperations };
+    size_t canceledCount{ pendingOperations.size() };
+    for (auto& pendingOperation : pendingOperations)
+    {
+        // Completion is marshalled to the queue, so callbacks won't run while the lock is held. Their ids never
+        // match a running operation, so completing them doesn't affect scheduling.
+        pendingOperation.operation->Cancel(E_ABORT);
+    }
+    pendingOperations.clear();
+
+    auto& metrics{ m_metrics[key] };
+    metrics.queueDepth = 0;
+    metrics.canceledOperations += canceledCount;
+
+    if (!iter->second.runningOperationId)
+    {
+        m_keys.erase(iter);
+    }
+
+    return canceledCount;
+}
+
+LocalStorage::KeyMetrics LocalStorage::Metrics(
+    const String& key
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto iter{ m_metrics.find(key) };
+    if (iter == m_metrics.end())
+    {
+        return KeyMetrics{};
+    }
+    return iter->second;
+}
+
+bool LocalStorage::CoalesceAppend(
+    const User& user,
+    const String& key,
+    Vector<uint8_t>& data,
+    Callback<Result<size_t>>& callback
+) noexcept
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    // When operations run one at a time, the handlers see every operation as it was queued
+    if (m_maxConcurrentOperations == 1)
+    {
+        return false;
+    }
+
+    auto iter{ m_keys.find(key) };
+    if (iter == m_keys.end() || iter->second.pendingOperations.empty())
+    {
+        return false;
+    }
+
+    // Only a write that hasn't started can be extended. Appending to a truncating write is equivalent to
+    // truncating with the combined data.
+    auto& write{ iter->second.pendingOperations.back().write };
+    if (!write || write->xuid != user.Xuid())
+    {
+        return false;
+    }
+
+    write->data.insert(write->data.end(), data.begin(), data.end());
+    write->callbacks.push_back(std::move(callback));
+    ++m_metrics[key].coalescedAppends;
+
+    return true;
+}
+
 void LocalStorage::QueueOperation(
-    std::shared_ptr<XblClientOperation> op
+    const String& key,
+    std::shared_ptr<XblClientOperation> op,
+    uint64_t id,
+    std::shared_ptr<WriteRequest> write
 ) noexcept
 {
     std::lock_guard<std::mutex> lock{ m_mutex };
-    m_operationQueue.push(op);
-    RunNextOperation();
+
+    auto& state{ m_keys[key] };
+    state.pendingOperations.push_back(PendingOperation{ std::move(op), id, chrono_clock_t::now(), std::move(write) });
+
+    auto& metrics{ m_metrics[key] };
+    metrics.maxQueueDepth = std::max(++metrics.queueDepth, metrics.maxQueueDepth);
+
+    if (!state.runningOperationId && state.pendingOperations.size() == 1)
+    {
+        m_readyKeys.push_back(key);
+    }
+    RunOperations();
 }
 
-void LocalStorage::RunNextOperation() noexcept
+void LocalStorage::RunOperations() noexcept
 {
     // m_mutex must be held when calling this function
-    if (!m_currentOperation && !m_operationQueue.empty())
+    while (m_runningCount < m_maxConcurrentOperations && !m_readyKeys.empty())
     {
-        m_currentOperation = m_operationQueue.front();
-        m_operationQueue.pop();
+        auto readyKey{ NextReadyKey() };
+        auto iter{ m_keys.find(*readyKey) };
+        m_readyKeys.erase(readyKey);
+
+        if (iter == m_keys.end() || iter->second.runningOperationId || iter->second.pendingOperations.empty())
+        {
+            continue;
+        }
+
+        auto& state{ iter->second };
+        auto pendingOperation{ std::move(state.pendingOperations.front()) };
+        state.pendingOperations.pop_front();
+        state.runningOperationId = pendingOperation.id;
+        state.runningQueueTime = pendingOperation.queueTime;
+        --m_metrics[iter->first].queueDepth;
+        ++m_runningCount;
 
         // Because operations aren't even kicked off synchronously, always raise errors through the
         // AsyncContext. If begin succeeds, client will complete operation later and the operation will
         // manage its own lifetime.
-        HRESULT hr = m_currentOperation->Begin();
+        HRESULT hr = pendingOperation.operation->Begin();
         if (FAILED(hr))
         {
-            m_currentOperation->Fail(hr);
+            pendingOperation.operation->Fail(hr);
         }
     }
 }
 
-void LocalStorage::OperationComplete() noexcept
+Deque<String>::iterator LocalStorage::NextReadyKey() noexcept
+{
+    // m_mutex must be held when calling this function
+    if (m_maxConcurrentOperations > 1)
+    {
+        return m_readyKeys.begin();
+    }
+
+    // Operations running one at a time start in the order they were queued, whichever key they are on. Ids are
+    // assigned in that order, and keys that are no longer ready sort last so they are skipped.
+    auto readyOperationId = [this](const String& key)
+    {
+        auto iter{ m_keys.find(key) };
+        if (iter == m_keys.end() || iter->second.runningOperationId || iter->second.pendingOperations.empty())
+        {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return iter->second.pendingOperations.front().id;
+    };
+
+    return std::min_element(m_readyKeys.begin(), m_readyKeys.end(), [&](const String& lhs, const String& rhs)
+    {
+        return readyOperationId(lhs) < readyOperationId(rhs);
+    });
+}
+
+void LocalStorage::OperationComplete(
+    const String& key,
+    uint64_t id,
+    bool keyCleared
+) noexcept
 {
     std::lock_guard<std::mutex> lock{ m_mutex };
-    m_currentOperation = nullptr;
-    RunNextOperation();
+
+    auto iter{ m_keys.find(key) };
+    if (iter == m_keys.end() || iter->second.runningOperationId != id)
+    {
+        // Operation was canceled before it started
+        return;
+    }
+
+    auto& state{ iter->second };
+    state.runningOperationId = 0;
+    --m_runningCount;
+
+    if (keyCleared && state.pendingOperations.empty())
+    {
+        m_metrics.erase(key);
+    }
+    else
+    {
+        auto latency{ std::chrono::duration_cast<std::chrono::microseconds>(chrono_clock_t::now() - state.runningQueueTime) };
+        auto& metrics{ m_metrics[key] };
+        ++metrics.completedOperations;
+        metrics.totalLatency += latency;
+        metrics.maxLatency = std::max(metrics.maxLatency, latency);
+    }
+
+    if (state.pendingOperations.empty())
+    {
+        m_keys.erase(iter);
+    }
+    else
+    {
+        m_readyKeys.push_back(key);
+    }
+    RunOperations();
 }
 
 void LocalStorage::DefaultWrite(
@@ -335,4 +610,53 @@ void LocalStorage::DefaultClear(
     }
 }
 
+#if XSAPI_LOCAL_STORAGE_MMAP
+void LocalStorage::DefaultReadMapped(
+    _In_ ReadInPlaceOperation* op,
+    _In_z_ const char* key,
+    _In_ const InPlaceReader& reader
+) const noexcept
+{
+    String fullPath = m_path + key;
+
+    int fd = open(fullPath.data(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOGS_DEBUG << "Failed to open file during LocalStorageService::ReadInPlaceAsync, errno = " << errno;
+        op->Complete(E_FAIL);
+        return;
+    }
+
+    HRESULT hr{ S_OK };
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0)
+    {
+        LOGS_DEBUG << "Failed to read file length during LocalStorageService::ReadInPlaceAsync, errno = " << errno;
+        hr = E_FAIL;
+    }
+    else if (fileStat.st_size == 0)
+    {
+        hr = reader(nullptr, 0);
+    }
+    else
+    {
+        auto size{ static_cast<size_t>(fileStat.st_size) };
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            LOGS_DEBUG << "Failed to map file during LocalStorageService::ReadInPlaceAsync, errno = " << errno;
+            hr = E_FAIL;
+        }
+        else
+        {
+            hr = reader(static_cast<const uint8_t*>(data), size);
+            munmap(data, size);
+        }
+    }
+
+    close(fd);
+    op->Complete(hr);
+}
+#endif
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -6,6 +6,13 @@
 #include "xsapi-c/platform_c.h"
 #include "client_operation.h"
 
+// The default storage handlers can memory map files for in place reads on POSIX platforms
+#if !HC_PLATFORM_IS_MICROSOFT && !HC_PLATFORM_IS_PLAYSTATION
+    #define XSAPI_LOCAL_STORAGE_MMAP 1
+#else
+    #define XSAPI_LOCAL_STORAGE_MMAP 0
+#endif
+
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
 extern XblLocalStorageWriteHandler g_localStorageWriteHandler;
@@ -13,7 +20,12 @@ extern XblLocalStorageReadHandler g_localStorageReadHandler;
 extern XblLocalStorageClearHandler g_localStorageClearHandler;
 extern XTaskQueueHandle g_localStorageTaskQueue;
 extern void* g_localStorageClientContext;
+extern uint32_t g_localStorageMaxConcurrentOperations;
 
+// Runs storage operations through the configured handlers. Operations on the same key run in the order they were
+// queued. With the default handlers, or custom handlers that opted in with XblLocalStorageSetMaxConcurrentOperations,
+// operations on different keys may run concurrently and appends queued behind a pending write to the same key are
+// merged into that write. Otherwise operations run one at a time in the order they were queued.
 class LocalStorage : public std::enable_shared_from_this<LocalStorage>
 {
 public:
@@ -25,6 +37,7 @@ public:
     using WriteOperation = ClientOperation<Result<size_t>>;
     using ReadOperation = ClientOperation<Result<Vector<uint8_t>>>;
     using ClearOperation = ClientOperation<HRESULT>;
+    using ReadInPlaceOperation = ClientOperation<HRESULT>;
 
     HRESULT WriteAsync(
         const User& user,
@@ -46,10 +59,84 @@ public:
         Callback<HRESULT> callback
     ) noexcept;
 
+    // Reads a file and hands its contents to reader without copying them into a Vector where possible. With the
+    // default storage handlers on POSIX platforms the file is memory mapped and reader runs on the storage queue;
+    // with custom handlers this falls back to ReadAsync. The data is only valid for the duration of the reader call.
+    using InPlaceReader = Function<HRESULT(const uint8_t* data, size_t size)>;
+
+    HRESULT ReadInPlaceAsync(
+        const User& user,
+        String key,
+        InPlaceReader reader,
+        Callback<HRESULT> callback
+    ) noexcept;
+
+    // Cancels the operations on key that haven't been handed to the storage handlers yet. Their callbacks are
+    // invoked with E_ABORT. Returns the number of operations canceled.
+    size_t CancelPendingOperations(const String& key) noexcept;
+
+    struct KeyMetrics
+    {
+        // Operations queued but not yet started
+        size_t queueDepth{ 0 };
+        size_t maxQueueDepth{ 0 };
+        uint64_t completedOperations{ 0 };
+        uint64_t coalescedAppends{ 0 };
+        uint64_t canceledOperations{ 0 };
+        // Measured from when an operation is queued until it completes
+        std::chrono::microseconds totalLatency{ 0 };
+        std::chrono::microseconds maxLatency{ 0 };
+    };
+
+    // Metrics are kept until the key is cleared
+    KeyMetrics Metrics(const String& key) noexcept;
+
+    // Limit on the number of operations, each on a different key, handed to the default storage handlers at once
+    static constexpr size_t DefaultMaxConcurrentOperations{ 4 };
+
 private:
-    void QueueOperation(std::shared_ptr<XblClientOperation> op) noexcept;
-    void RunNextOperation() noexcept;
-    void OperationComplete() noexcept;
+    struct WriteRequest
+    {
+        uint64_t xuid;
+        XblLocalStorageWriteMode mode;
+        Vector<uint8_t> data;
+        // A merged write completes the callbacks of every append it contains with the final file size
+        Vector<Callback<Result<size_t>>> callbacks;
+    };
+
+    struct PendingOperation
+    {
+        std::shared_ptr<XblClientOperation> operation;
+        uint64_t id;
+        chrono_clock_t::time_point queueTime;
+        // Set for writes. Appends to the same key are merged into it until the operation starts.
+        std::shared_ptr<WriteRequest> write;
+    };
+
+    struct KeyState
+    {
+        Deque<PendingOperation> pendingOperations;
+        // Id of the started operation, or 0 if none
+        uint64_t runningOperationId{ 0 };
+        chrono_clock_t::time_point runningQueueTime;
+    };
+
+    bool CoalesceAppend(
+        const User& user,
+        const String& key,
+        Vector<uint8_t>& data,
+        Callback<Result<size_t>>& callback
+    ) noexcept;
+
+    void QueueOperation(
+        const String& key,
+        std::shared_ptr<XblClientOperation> op,
+        uint64_t id,
+        std::shared_ptr<WriteRequest> write = nullptr
+    ) noexcept;
+    void RunOperations() noexcept;
+    Deque<String>::iterator NextReadyKey() noexcept;
+    void OperationComplete(const String& key, uint64_t id, bool keyCleared) noexcept;
 
     static void DefaultWrite(
         _In_opt_ void* context,
@@ -75,10 +162,23 @@ private:
         _In_z_ const char* key
     );
 
+#if XSAPI_LOCAL_STORAGE_MMAP
+    void DefaultReadMapped(
+        _In_ ReadInPlaceOperation* operation,
+        _In_z_ const char* key,
+        _In_ const InPlaceReader& reader
+    ) const noexcept;
+#endif
+
     std::mutex m_mutex;
     TaskQueue m_queue;
-    Queue<std::shared_ptr<XblClientOperation>> m_operationQueue;
-    std::shared_ptr<XblClientOperation> m_currentOperation;
+    UnorderedMap<String, KeyState> m_keys;
+    // Keys with pending operations waiting for a free slot. May contain stale entries, which are skipped.
+    Deque<String> m_readyKeys;
+    size_t m_runningCount{ 0 };
+    size_t m_maxConcurrentOperations{ 1 };
+    std::atomic<uint64_t> m_lastOperationId{ 0 };
+    UnorderedMap<String, KeyMetrics> m_metrics;
 
     XblLocalStorageWriteHandler m_writeHandler;
     XblLocalStorageReadHandler m_readHandler;
@@ -84,3 +84,18 @@ try
     return S_OK;
 }
 CATCH_RETURN()
+
+STDAPI XblLocalStorageSetMaxConcurrentOperations(
+    _In_ uint32_t maxConcurrentOperations
+) XBL_NOEXCEPT
+try
+{
+    if (GlobalState::Get())
+    {
+        return E_XBL_ALREADY_INITIALIZED;
+    }
+
+    g_localStorageMaxConcurrentOperations = maxConcurrentOperations;
+    return S_OK;
+}
+CATCH_RETURN()
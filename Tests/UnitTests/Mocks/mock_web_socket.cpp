@@ -42,6 +42,11 @@ HRESULT MockWebsocket::Connect(
 
 HRESULT MockWebsocket::Send(_In_ const char* message) noexcept
 {
+    if (s_sendHandler)
+    {
+        RETURN_HR_IF_FAILED(s_sendHandler(message));
+    }
+
     return m_queue.RunWork([sharedThis{ shared_from_this() }, message = std::string{ message }]
     {
         MockRealTimeActivityService::Instance().HandleClientMessage(sharedThis, message.data());
@@ -90,6 +95,12 @@ void MockWebsocket::SetConnectHandler(ConnectHandler handler) noexcept
     s_connectHandler = std::move(handler);
 }
 
+void MockWebsocket::SetSendHandler(SendHandler handler) noexcept
+{
+    s_sendHandler = std::move(handler);
+}
+
 MockWebsocket::ConnectHandler MockWebsocket::s_connectHandler{};
+MockWebsocket::SendHandler MockWebsocket::s_sendHandler{};
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
\ No newline at end of file
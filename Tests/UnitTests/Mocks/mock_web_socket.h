@@ -45,11 +45,17 @@ public:
     using ConnectHandler = std::function<WebsocketResult()>;
     static void SetConnectHandler(ConnectHandler handler) noexcept;
 
+    // By default MockWebsocket::Send delivers the message to MockRealTimeActivityService.
+    // A SendHandler can fail the send synchronously by returning a failed HRESULT.
+    using SendHandler = std::function<HRESULT(const char* message)>;
+    static void SetSendHandler(SendHandler handler) noexcept;
+
 private:
     TaskQueue m_queue{};
     User const m_user;
 
     static ConnectHandler s_connectHandler;
+    static SendHandler s_sendHandler;
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
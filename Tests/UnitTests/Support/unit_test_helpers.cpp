@@ -127,6 +127,7 @@ TestEnvironment::~TestEnvironment() noexcept
     // Clean up Mock RTA & websocket handlers
     MockRtaService().SetSubscribeHandler(nullptr);
     system::MockWebsocket::SetConnectHandler(nullptr);
+    system::MockWebsocket::SetSendHandler(nullptr);
 }
 
 std::shared_ptr<XblContext> TestEnvironment::CreateMockXboxLiveContext(
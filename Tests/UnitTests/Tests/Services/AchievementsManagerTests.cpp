@@ -2594,6 +2594,67 @@ public:
         XblAchievementsManagerResultCloseHandle(resultHandle);
     }
 
+    DEFINE_TEST_CASE(GetAchievementsForUserByState_RepeatedCalls_ShareSnapshotUntilProgressChanges)
+    {
+        TEST_LOG(L"Test starting: GetAchievementsForUserByState_RepeatedCalls_ShareSnapshotUntilProgressChanges");
+
+        AMTestEnvironment env{};
+        constexpr uint64_t xuid = 1234;
+
+        auto xblContext = env.CreateMockXboxLiveContext(xuid);
+        env.m_testContexts.push_back(xblContext);
+
+        AddLocalUserSyncHelper(xblContext->User(), firstUserUpdateAchievementsResponse);
+
+        auto findAchievement = [](XblAchievementsManagerResultHandle handle, const char* id) -> const XblAchievement*
+        {
+            const XblAchievement* achievements;
+            uint64_t achievementsCount;
+            VERIFY_SUCCEEDED(XblAchievementsManagerResultGetAchievements(handle, &achievements, &achievementsCount));
+            auto found = std::find_if(achievements, achievements + achievementsCount, [&](const XblAchievement& achievement)
+                {
+                    return utils::str_icmp(id, achievement.id) == 0;
+                });
+            return found == achievements + achievementsCount ? nullptr : found;
+        };
+
+        // Polling the same view without changes hands out the same snapshot
+        XblAchievementsManagerResultHandle notStarted;
+        XblAchievementsManagerResultHandle notStartedAgain;
+        VERIFY_SUCCEEDED(XblAchievementsManagerGetAchievementsByState(xuid, XblAchievementOrderBy::DefaultOrder, XblAchievementsManagerSortOrder::Unsorted, XblAchievementProgressState::NotStarted, &notStarted));
+        VERIFY_SUCCEEDED(XblAchievementsManagerGetAchievementsByState(xuid, XblAchievementOrderBy::DefaultOrder, XblAchievementsManagerSortOrder::Unsorted, XblAchievementProgressState::NotStarted, &notStartedAgain));
+        VERIFY_IS_TRUE(notStarted == notStartedAgain);
+        VERIFY_IS_NOT_NULL(findAchievement(notStarted, achievementId2017NotStarted));
+        XblAchievementsManagerResultCloseHandle(notStartedAgain);
+
+        bool completedBeforeTimeout = UpdateAchievementHelper(xuid, achievementId2017NotStarted, achievementInProgressStartProgress);
+        VERIFY_IS_TRUE(completedBeforeTimeout);
+
+        // The achievement moved from the NotStarted view to the InProgress view
+        XblAchievementsManagerResultHandle notStartedUpdated;
+        XblAchievementsManagerResultHandle inProgress;
+        VERIFY_SUCCEEDED(XblAchievementsManagerGetAchievementsByState(xuid, XblAchievementOrderBy::DefaultOrder, XblAchievementsManagerSortOrder::Unsorted, XblAchievementProgressState::NotStarted, &notStartedUpdated));
+        VERIFY_SUCCEEDED(XblAchievementsManagerGetAchievementsByState(xuid, XblAchievementOrderBy::DefaultOrder, XblAchievementsManagerSortOrder::Unsorted, XblAchievementProgressState::InProgress, &inProgress));
+        VERIFY_IS_TRUE(notStarted != notStartedUpdated);
+        VERIFY_IS_NULL(findAchievement(notStartedUpdated, achievementId2017NotStarted));
+
+        auto updatedAchievement = findAchievement(inProgress, achievementId2017NotStarted);
+        VERIFY_IS_NOT_NULL(updatedAchievement);
+        VERIFY_ARE_EQUAL_INT(
+            achievementInProgressStartProgress,
+            utils::internal_string_to_uint32(updatedAchievement->progression.requirements[0].currentProgressValue)
+        );
+
+        // Previously returned snapshots are not modified
+        auto staleAchievement = findAchievement(notStarted, achievementId2017NotStarted);
+        VERIFY_IS_NOT_NULL(staleAchievement);
+        VERIFY_ARE_EQUAL_INT(0, utils::internal_string_to_uint32(staleAchievement->progression.requirements[0].currentProgressValue));
+
+        XblAchievementsManagerResultCloseHandle(notStarted);
+        XblAchievementsManagerResultCloseHandle(notStartedUpdated);
+        XblAchievementsManagerResultCloseHandle(inProgress);
+    }
+
     DEFINE_TEST_CASE(UpdateAchievement_HigherProgressValue_ExpectProgressNotification)
     {
         TEST_LOG(L"Test starting: UpdateAchievement_HigherProgressValue_ExpectProgressNotification");
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "UnitTestIncludes.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+// The events service itself isn't built into the unit tests, so these cover the pieces of it that are shared
+// across the events service implementations
+DEFINE_TEST_CLASS(EventsTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(EventsTests);
+
+    DEFINE_TEST_CASE(TestIsValidEventName)
+    {
+        TEST_LOG(L"Test starting: TestIsValidEventName");
+
+        for (auto name : { "a", "Z", "EventName", "event_name_1", "a1", "A_", "abcdefghijklmnopqrstuvwxyz0123456789_ABC" })
+        {
+            VERIFY_IS_TRUE(events::IsValidEventName(name));
+        }
+
+        for (auto name : { "", "1event", "_event", "event name", "event-name", "event.name", "event$", "\xC3\xA9vent", "event\xC3\xA9" })
+        {
+            VERIFY_IS_FALSE(events::IsValidEventName(name));
+        }
+
+        VERIFY_IS_FALSE(events::IsValidEventName(nullptr));
+    }
+
+    DEFINE_TEST_CASE(TestEventSchemaRegistry)
+    {
+        TEST_LOG(L"Test starting: TestEventSchemaRegistry");
+
+        struct TestSchema
+        {
+            String eventName;
+        };
+
+        auto makeSchema = [](const char* eventName)
+        {
+            return std::shared_ptr<const TestSchema>{ MakeShared<TestSchema>(TestSchema{ eventName }) };
+        };
+
+        events::EventSchemaRegistry<TestSchema> registry;
+        VERIFY_IS_TRUE(registry.Find("PlayerDied") == nullptr);
+
+        registry.Register("PlayerDied", makeSchema("PlayerDied"));
+        registry.Register("PlayerSpawned", makeSchema("PlayerSpawned"));
+
+        // Lookups ignore case
+        auto schema{ registry.Find("playerdied") };
+        VERIFY_IS_TRUE(schema != nullptr);
+        VERIFY_ARE_EQUAL_STR("PlayerDied", schema->eventName.data());
+
+        schema = registry.Find("PLAYERSPAWNED");
+        VERIFY_IS_TRUE(schema != nullptr);
+        VERIFY_ARE_EQUAL_STR("PlayerSpawned", schema->eventName.data());
+
+        VERIFY_IS_TRUE(registry.Find("PlayerDiedAgain") == nullptr);
+
+        // Registering a name that differs only by case replaces the existing schema
+        registry.Register("PLAYERDIED", makeSchema("PLAYERDIED"));
+        schema = registry.Find("PlayerDied");
+        VERIFY_IS_TRUE(schema != nullptr);
+        VERIFY_ARE_EQUAL_STR("PLAYERDIED", schema->eventName.data());
+
+        // Many distinct names can be registered without interfering with each other
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            auto name{ "Event" + utils::uint64_to_internal_string(i) };
+            registry.Register(name.data(), makeSchema(name.data()));
+        }
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            auto name{ "event" + utils::uint64_to_internal_string(i) };
+            schema = registry.Find(name.data());
+            VERIFY_IS_TRUE(schema != nullptr);
+            VERIFY_IS_TRUE(utils::str_icmp(name.data(), schema->eventName.data()) == 0);
+        }
+    }
+
+    DEFINE_TEST_CASE(TestEventUploadSchedulerInFlightLimit)
+    {
+        TEST_LOG(L"Test starting: TestEventUploadSchedulerInFlightLimit");
+
+        events::EventUploadScheduler scheduler{ 1000 };
+        VERIFY_IS_TRUE(scheduler.TryBeginUpload(2));
+        VERIFY_IS_TRUE(scheduler.TryBeginUpload(2));
+        VERIFY_IS_FALSE(scheduler.TryBeginUpload(2));
+        VERIFY_ARE_EQUAL_UINT(2, scheduler.UploadsInFlight());
+
+        // Completing an upload frees its slot
+        scheduler.EndUpload();
+        VERIFY_ARE_EQUAL_UINT(1, scheduler.UploadsInFlight());
+        VERIFY_IS_TRUE(scheduler.TryBeginUpload(2));
+        VERIFY_IS_FALSE(scheduler.TryBeginUpload(2));
+
+        // Lowering the limit holds back new uploads until enough in flight uploads complete
+        VERIFY_IS_FALSE(scheduler.TryBeginUpload(1));
+        scheduler.EndUpload();
+        VERIFY_IS_FALSE(scheduler.TryBeginUpload(1));
+        scheduler.EndUpload();
+        VERIFY_ARE_EQUAL_UINT(0, scheduler.UploadsInFlight());
+        VERIFY_IS_TRUE(scheduler.TryBeginUpload(1));
+        scheduler.EndUpload();
+
+        // The limit holds with many threads starting and completing uploads
+        constexpr uint32_t maxUploadsInFlight{ 3 };
+        std::atomic<uint32_t> running{ 0 };
+        std::atomic<uint32_t> maxRunning{ 0 };
+        Vector<std::thread> threads;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            threads.emplace_back([&]
+            {
+                for (uint32_t j = 0; j < 1000; ++j)
+                {
+                    if (scheduler.TryBeginUpload(maxUploadsInFlight))
+                    {
+                        auto nowRunning{ ++running };
+                        auto prevMax{ maxRunning.load() };
+                        while (nowRunning > prevMax && !maxRunning.compare_exchange_weak(prevMax, nowRunning));
+                        --running;
+                        scheduler.EndUpload();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        VERIFY_IS_TRUE(maxRunning <= maxUploadsInFlight);
+        VERIFY_ARE_EQUAL_UINT(0, scheduler.UploadsInFlight());
+    }
+
+    DEFINE_TEST_CASE(TestEventUploadSchedulerBackoff)
+    {
+        TEST_LOG(L"Test starting: TestEventUploadSchedulerBackoff");
+
+        constexpr uint64_t minimumUploadIntervalInMs{ 1000 };
+        events::EventUploadScheduler scheduler{ minimumUploadIntervalInMs, 42 };
+
+        // Each failure doubles the backoff until it reaches 600 times the minimum interval. The delay is between
+        // half the backoff and the full backoff.
+        for (uint32_t failedUploadCount = 1; failedUploadCount < 64; ++failedUploadCount)
+        {
+            uint64_t backoff{ 600 * minimumUploadIntervalInMs };
+            if (failedUploadCount < 10)
+            {
+                backoff = std::min<uint64_t>(backoff, (uint64_t{ 1 } << failedUploadCount) * minimumUploadIntervalInMs);
+            }
+
+            for (uint32_t i = 0; i < 100; ++i)
+            {
+                auto delay{ scheduler.RetryDelayInMs(failedUploadCount) };
+                VERIFY_IS_TRUE(delay >= backoff / 2);
+                VERIFY_IS_TRUE(delay <= backoff);
+            }
+        }
+
+        // Payloads that failed together are spread out rather than retried together
+        Set<uint64_t> delays;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            delays.insert(scheduler.RetryDelayInMs(3));
+        }
+        VERIFY_IS_TRUE(delays.size() > 50);
+
+        // The same seed gives the same delays, and a different seed gives different ones
+        events::EventUploadScheduler sameSeed{ minimumUploadIntervalInMs, 7 };
+        events::EventUploadScheduler otherSeed{ minimumUploadIntervalInMs, 8 };
+        events::EventUploadScheduler reference{ minimumUploadIntervalInMs, 7 };
+        bool anyDifferent{ false };
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            auto expected{ reference.RetryDelayInMs(5) };
+            VERIFY_ARE_EQUAL_INT(expected, sameSeed.RetryDelayInMs(5));
+            anyDifferent |= expected != otherSeed.RetryDelayInMs(5);
+        }
+        VERIFY_IS_TRUE(anyDifferent);
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
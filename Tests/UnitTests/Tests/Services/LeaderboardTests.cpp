@@ -656,6 +656,63 @@ public:
         TestAndGetLeaderboardResult(xboxLiveContext.get(), query, defaultLeaderboardData, 1, vecColumns);
     }
 
+    DEFINE_TEST_CASE(TestGetLeaderboardLargePageAsync)
+    {
+        TEST_LOG(L"Test starting: TestGetLeaderboardLargePageAsync");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        // A 1000 row page, with two additional columns read from each row's metadata
+        const size_t rowCount{ 1000 };
+        xsapi_internal_stringstream response;
+        response << R"({ "pagingInfo": { "continuationToken": null, "totalItems": 1000 }, )";
+        response << R"("leaderboardInfo": { "totalCount": 1000, "columnDefinition": { "statName": "EnemyDefeats", "type": "Integer" } }, "userList": [)";
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            response << (i == 0 ? "" : ",");
+            response << R"({ "gamertag": "Player )" << i << R"(", "moderngamertag": "Modern Player )" << i << R"(", "moderngamertagsuffix": ")" << i;
+            response << R"(", "uniquemoderngamertag": "Modern Player )" << i << "#" << i << R"(", "xuid": ")" << 2533275015216241 + i;
+            response << R"(", "percentile": 0.5, "rank": )" << i + 1 << R"(, "globalrank": )" << i + 1 << R"(, "value": ")" << (rowCount - i) * 10;
+            response << R"(", "valuemetadata": "{\"HasSkull\": true, \"Level\": \"Level )" << i % 10 << R"(\"}" })";
+        }
+        response << "] }";
+
+        xsapi_internal_stringstream url;
+        url << server << "scids/" << scid << "/leaderboards/" << leaderboardName << "?include=valuemetadata";
+        HttpMock mock("GET", url.str(), 200);
+        mock.SetResponseBody(response.str().c_str());
+
+        std::vector<char const*> columns{ "HasSkull", "Level" };
+        XblLeaderboardQuery query{ MakeDefaultQuery() };
+        query.additionalColumnleaderboardNamesCount = columns.size();
+        query.additionalColumnleaderboardNames = columns.data();
+
+        auto start = std::chrono::steady_clock::now();
+
+        XAsyncBlock async{};
+        size_t resultSize{};
+        VERIFY_SUCCEEDED(XblLeaderboardGetLeaderboardAsync(xboxLiveContext.get(), query, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        VERIFY_SUCCEEDED(XblLeaderboardGetLeaderboardResultSize(&async, &resultSize));
+
+        XblLeaderboardResult* result{};
+        std::shared_ptr<char> buffer(new char[resultSize], std::default_delete<char[]>());
+        VERIFY_SUCCEEDED(XblLeaderboardGetLeaderboardResult(&async, resultSize, buffer.get(), &result, nullptr));
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        TEST_LOG(FormatString(L"Deserialized %llu rows in %llu us", static_cast<uint64_t>(rowCount), static_cast<uint64_t>(elapsed.count())).c_str());
+
+        VERIFY_ARE_EQUAL_UINT(rowCount, result->rowsCount);
+        VERIFY_ARE_EQUAL_UINT(3, result->columnsCount);
+        VERIFY_IS_TRUE(result->columns[1].statType == XblLeaderboardStatType::Boolean);
+        VERIFY_IS_TRUE(result->columns[2].statType == XblLeaderboardStatType::String);
+
+        JsonDocument responseJson;
+        responseJson.Parse(response.str().c_str());
+        VerifyLeadershipResult(result, responseJson, columns);
+    }
+
     DEFINE_TEST_CASE(TestGetLeaderboardAsyncInvalidArgs)
     {
         TEST_LOG(L"Test starting: TestGetLeaderboardAsyncInvalidArgs");
@@ -5659,7 +5659,7 @@ public:
 
         if (removeStaleUsers)
         {
-            for (auto context : lobbyClient->GetLocalUserMap())
+            for (auto context : *lobbyClient->GetLocalUserMap())
             {
                 auto user = context.second;
                 if (user != nullptr)
@@ -5727,7 +5727,7 @@ public:
 
         auto members = mpmInstance->GameSession()->Members();
 
-        for (auto context : lobbyClient->GetLocalUserMap())
+        for (auto context : *lobbyClient->GetLocalUserMap())
         {
             auto user = context.second;
             if (user != nullptr)
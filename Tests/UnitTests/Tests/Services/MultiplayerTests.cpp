@@ -1442,6 +1442,28 @@ public:
         session.Write(testJson["deleteCustomPropertyJson"]);
     }
 
+    DEFINE_TEST_CASE(TestWriteSessionAsyncWritesOnlyChangedCustomProperties)
+    {
+        TEST_LOG(L"Test starting: TestWriteSessionAsyncWritesOnlyChangedCustomProperties");
+
+        MPTestEnv env{};
+
+        JsonDocument sessionJson{ rapidjson::kObjectType };
+        sessionJson.CopyFrom(defaultSessionJson, sessionJson.GetAllocator());
+        JsonDocument customJson;
+        customJson.Parse("{\"PropA\":\"ValueA\",\"PropB\":{\"ValueB\":5}}");
+        sessionJson["properties"]["custom"].CopyFrom(customJson, sessionJson.GetAllocator());
+
+        auto session = MultiplayerSession::Get(env.XboxLiveContext(), defaultSessionReference, sessionJson);
+
+        // Properties already on the service aren't rewritten, only the one changed locally
+        VERIFY_SUCCEEDED(XblMultiplayerSessionSetCustomPropertyJson(session.Handle(), "PropC", "42"));
+
+        JsonDocument expectedRequest;
+        expectedRequest.Parse("{\"properties\":{\"custom\":{\"PropC\":42}}}");
+        session.Write(expectedRequest);
+    }
+
     DEFINE_TEST_CASE(TestWriteSessionAsyncWithJoin1)
     {
         TEST_LOG(L"Test starting: TestWriteSessionAsyncWithJoin1");
@@ -2415,6 +2437,69 @@ session.Write(testJson["serverConnectionStringCandidatesJson"]);
         }
     }
 
+    DEFINE_TEST_CASE(TestCompareLargeMultiplayerSessions)
+    {
+        TEST_LOG(L"Test starting: TestCompareLargeMultiplayerSessions");
+
+        MPTestEnv env{};
+
+        // Synthesize a session document with many members, each carrying a sizeable custom properties blob
+        const uint32_t memberCount{ 500 };
+        auto createSessionDocument = [&](uint32_t changedMemberIndex, const char* changedValue)
+        {
+            JsonDocument doc{ rapidjson::kObjectType };
+            auto& a{ doc.GetAllocator() };
+            doc.CopyFrom(defaultSessionJson, a);
+
+            doc["membersInfo"]["next"].SetUint(memberCount);
+            doc["membersInfo"]["count"].SetUint(memberCount);
+
+            JsonValue members{ rapidjson::kObjectType };
+            for (uint32_t i = 0; i < memberCount; ++i)
+            {
+                JsonValue member;
+                member.CopyFrom(defaultSessionJson["members"]["0"], a);
+                member["constants"]["system"]["index"].SetUint(i);
+                member["constants"]["system"]["xuid"].SetString(utils::uint64_to_internal_string(10000 + i).data(), a);
+                member["next"].SetUint(i + 1);
+
+                JsonValue custom{ rapidjson::kObjectType };
+                custom.AddMember("loadout", JsonValue{ "SWORD_SHIELD_BOW_ARROWS_POTION_POTION_POTION_MAP_COMPASS", a }.Move(), a);
+                custom.AddMember("health", i, a);
+                custom.AddMember("status", JsonValue{ i == changedMemberIndex ? changedValue : "ready", a }.Move(), a);
+                member["properties"]["custom"] = custom.Move();
+
+                members.AddMember(JsonValue{ utils::uint32_to_internal_string(i).data(), a }.Move(), member.Move(), a);
+            }
+            doc["members"] = members.Move();
+            return doc;
+        };
+
+        auto baseDoc{ createSessionDocument(0, "ready") };
+        auto sameDoc{ createSessionDocument(0, "READY") };
+        auto changedDoc{ createSessionDocument(memberCount - 1, "away") };
+
+        auto base = MultiplayerSession::Get(env.XboxLiveContext(), defaultSessionReference, baseDoc);
+        auto same = MultiplayerSession::Get(env.XboxLiveContext(), defaultSessionReference, sameDoc);
+        auto changed = MultiplayerSession::Get(env.XboxLiveContext(), defaultSessionReference, changedDoc);
+
+        // Case differences alone are not a change, consistent with the previous case insensitive comparison
+        VERIFY_IS_TRUE(XblMultiplayerSessionCompare(base.Handle(), same.Handle()) == XblMultiplayerSessionChangeTypes::None);
+        VERIFY_IS_TRUE(XblMultiplayerSessionCompare(changed.Handle(), base.Handle()) == XblMultiplayerSessionChangeTypes::MemberCustomPropertyChange);
+
+        const uint32_t iterations{ 100 };
+        auto start{ std::chrono::steady_clock::now() };
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            XblMultiplayerSessionCompare(changed.Handle(), base.Handle());
+        }
+        auto elapsed{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+
+        std::wstringstream ss;
+        ss << L"Compared sessions with " << memberCount << L" members " << iterations << L" times in " << elapsed.count() << L"us";
+        TEST_LOG(ss.str().c_str());
+    }
+
     // RAII wrapper for session changed RTA event handler
     class SessionChangedHandler
     {
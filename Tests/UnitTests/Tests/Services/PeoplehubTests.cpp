@@ -403,6 +403,57 @@ public:
         }
     }
 
+    DEFINE_TEST_CASE(TestDeserializationModes)
+    {
+        TEST_LOG(L"Test starting: TestDeserializationModes");
+
+        PeoplehubTestEnvironment env{};
+
+        JsonDocument jsonResponse;
+        jsonResponse.Parse(peoplehubResponse);
+
+        xsapi_internal_stringstream url;
+        url << "https://peoplehub.xboxlive.com/users/xuid(" << env.XboxLiveContext->Xuid() << ")/people/social/decoration/presenceDetail";
+
+        auto peoplehubMock = std::make_shared<HttpMock>(
+            "GET",
+            url.str(),
+            200,
+            jsonResponse
+            );
+
+        // Verify mode logs an error if the DOM and SAX results differ
+        for (auto mode : { JsonDeserializationMode::Dom, JsonDeserializationMode::Sax, JsonDeserializationMode::Verify })
+        {
+            AppConfig::Instance()->SetJsonDeserializationMode(mode);
+
+            Event callComplete;
+            Result<Vector<XblSocialManagerUser>> result;
+
+            env.PeoplehubService->GetSocialGraph(env.XboxLiveContext->Xuid(), XblSocialManagerExtraDetailLevel::NoExtraDetail, {
+                [&] (Result<Vector<XblSocialManagerUser>> temp)
+                {
+                    result = temp;
+                    callComplete.Set();
+                }
+                });
+
+            callComplete.Wait();
+
+            VERIFY_SUCCEEDED(result.Hresult());
+            JsonValue& userGroupArr = jsonResponse["people"];
+            VERIFY_ARE_EQUAL(result.Payload().size(), userGroupArr.Size());
+
+            uint64_t counter{ 0 };
+            for (auto& user : result.Payload())
+            {
+                VerifyXboxSocialUser(user, userGroupArr[counter++]);
+            }
+        }
+
+        AppConfig::Instance()->SetJsonDeserializationMode(JsonDeserializationMode::Dom);
+    }
+
     DEFINE_TEST_CASE(TestInvalidResponse)
     {
         TEST_LOG(L"Test starting: TestInvalidResponse");
@@ -50,6 +50,52 @@ public:
         void OnResync() noexcept {};
     };
 
+    // Consumes event payloads in place without ever asking for a DOM
+    class RawEventSubscription : public real_time_activity::Subscription
+    {
+    public:
+        RawEventSubscription(
+            String uri,
+            uint32_t expectedEventCount
+        ) noexcept
+            : m_expectedEventCount{ expectedEventCount }
+        {
+            m_resourceUri = std::move(uri);
+        }
+
+        Event SubscribeComplete;
+        Event AllEventsReceived;
+
+        std::atomic<uint32_t> EventReceivedCount{ 0 };
+        std::atomic<uint32_t> DomEventReceivedCount{ 0 };
+        String LastPayload;
+
+    private:
+        void OnSubscribe(const JsonValue& data) noexcept override
+        {
+            UNREFERENCED_PARAMETER(data);
+            SubscribeComplete.Set();
+        }
+
+        void OnEvent(const JsonValue& data) noexcept override
+        {
+            UNREFERENCED_PARAMETER(data);
+            // Should never be called since OnEventData is overridden
+            DomEventReceivedCount++;
+        }
+
+        void OnEventData(const real_time_activity::EventData& event) noexcept override
+        {
+            LastPayload.assign(event.Data(), event.Length());
+            if (++EventReceivedCount == m_expectedEventCount)
+            {
+                AllEventsReceived.Set();
+            }
+        }
+
+        uint32_t const m_expectedEventCount;
+    };
+
     struct RtaConnectionMonitor
     {
         RtaConnectionMonitor(XblContextHandle xboxLiveContext) noexcept
@@ -367,6 +413,268 @@ public:
 
         VERIFY_ARE_EQUAL_UINT(2, subscribeAttempts);
     }
+
+    DEFINE_TEST_CASE(TestSubscribeHandshakesBatched)
+    {
+        TEST_LOG(L"Test starting: TestSubscribeHandshakesBatched");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto& mockRta{ MockRealTimeActivityService::Instance() };
+        auto rtaManager{ GlobalState::Get()->RTAManager() };
+
+        constexpr uint32_t maxHandshakesInFlight{ 4 };
+        AppConfig::Instance()->SetRtaMaxHandshakesInFlight(maxHandshakesInFlight);
+
+        // Hold subscribe handshakes until the test explicitly completes them
+        std::mutex mutex;
+        Vector<uint32_t> pendingHandshakes;
+        Event handshakesReceived;
+        mockRta.SetSubscribeHandler([&](uint32_t n, xsapi_internal_string uri)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            pendingHandshakes.push_back(n);
+            if (pendingHandshakes.size() == maxHandshakesInFlight)
+            {
+                handshakesReceived.Set();
+            }
+        });
+
+        constexpr size_t subscriptionCount{ 4 * maxHandshakesInFlight };
+        Vector<std::shared_ptr<TestSubscription>> subscriptions;
+        for (size_t i = 0; i < subscriptionCount; ++i)
+        {
+            Stringstream uri;
+            uri << "https://uri" << i;
+            subscriptions.push_back(std::make_shared<TestSubscription>(uri.str()));
+            VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), subscriptions.back()));
+        }
+
+        for (size_t batch = 0; batch < subscriptionCount / maxHandshakesInFlight; ++batch)
+        {
+            handshakesReceived.Wait();
+
+            // Give the client a chance to exceed the limit before checking it
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+
+            Vector<uint32_t> handshakes;
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                VERIFY_ARE_EQUAL_UINT(maxHandshakesInFlight, pendingHandshakes.size());
+                handshakes.swap(pendingHandshakes);
+            }
+
+            for (auto n : handshakes)
+            {
+                mockRta.CompleteSubscribeHandshake(n);
+            }
+        }
+
+        for (auto& subscription : subscriptions)
+        {
+            subscription->SubscribeComplete.Wait();
+        }
+
+        // Adding and removing a subscription within the same tick should never reach the service
+        auto transientSubscription = std::make_shared<TestSubscription>("https://transient");
+        VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), transientSubscription));
+        VERIFY_SUCCEEDED(rtaManager->RemoveSubscription(xboxLiveContext->User(), transientSubscription));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            VERIFY_IS_TRUE(pendingHandshakes.empty());
+        }
+        VERIFY_ARE_EQUAL_UINT(0u, transientSubscription->SubscribeCompleteCount);
+
+        for (auto& subscription : subscriptions)
+        {
+            VERIFY_SUCCEEDED(rtaManager->RemoveSubscription(xboxLiveContext->User(), subscription));
+        }
+    }
+
+    DEFINE_TEST_CASE(TestSubscribeHandshakeSendFailure)
+    {
+        TEST_LOG(L"Test starting: TestSubscribeHandshakeSendFailure");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto& mockRta{ MockRealTimeActivityService::Instance() };
+        auto rtaManager{ GlobalState::Get()->RTAManager() };
+
+        // A single slot, so a failed send that never frees it would stall every later handshake
+        AppConfig::Instance()->SetRtaMaxHandshakesInFlight(1);
+
+        std::atomic<uint32_t> sendAttempts{ 0 };
+        MockWebsocket::SetSendHandler([&](const char*)
+        {
+            return sendAttempts++ == 0 ? E_FAIL : S_OK;
+        });
+
+        mockRta.SetSubscribeHandler([&](uint32_t n, xsapi_internal_string uri)
+        {
+            mockRta.CompleteSubscribeHandshake(n);
+        });
+
+        auto firstSubscription = std::make_shared<TestSubscription>("https://uri0");
+        auto secondSubscription = std::make_shared<TestSubscription>("https://uri1");
+        VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), firstSubscription));
+        VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), secondSubscription));
+
+        firstSubscription->SubscribeComplete.Wait();
+        secondSubscription->SubscribeComplete.Wait();
+
+        // The failed handshake is retried, so both subscriptions complete exactly once
+        VERIFY_ARE_EQUAL_UINT(3, sendAttempts);
+        VERIFY_ARE_EQUAL_UINT(1, firstSubscription->SubscribeCompleteCount);
+        VERIFY_ARE_EQUAL_UINT(1, secondSubscription->SubscribeCompleteCount);
+    }
+
+    DEFINE_TEST_CASE(TestConnectionSharding)
+    {
+        TEST_LOG(L"Test starting: TestConnectionSharding");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto& mockRta{ MockRealTimeActivityService::Instance() };
+        auto rtaManager{ GlobalState::Get()->RTAManager() };
+
+        constexpr uint32_t subscriptionsPerConnection{ 5 };
+        AppConfig::Instance()->SetRtaSubscriptionsPerConnection(subscriptionsPerConnection);
+
+        std::atomic<uint32_t> connectCount{ 0 };
+        MockWebsocket::SetConnectHandler([&]
+        {
+            ++connectCount;
+            return WebsocketResult{ S_OK };
+        });
+
+        mockRta.SetSubscribeHandler([&](uint32_t n, xsapi_internal_string uri)
+        {
+            mockRta.CompleteSubscribeHandshake(n);
+        });
+
+        RtaConnectionMonitor connectionMonitor{ xboxLiveContext.get() };
+
+        Vector<std::shared_ptr<TestSubscription>> subscriptions;
+        for (size_t i = 0; i < 12; ++i)
+        {
+            Stringstream uri;
+            uri << "https://uri" << i;
+            subscriptions.push_back(std::make_shared<TestSubscription>(uri.str()));
+            VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), subscriptions.back()));
+        }
+
+        for (auto& subscription : subscriptions)
+        {
+            subscription->SubscribeComplete.Wait();
+        }
+
+        // 12 subscriptions at 5 per connection should be spread across 3 connections
+        VERIFY_ARE_EQUAL_UINT(3u, connectCount.load());
+
+        // Events should be routed through whichever connection holds the subscription
+        for (auto& subscription : subscriptions)
+        {
+            mockRta.RaiseEvent(subscription->Uri.data(), rapidjson::Document{ rapidjson::kObjectType });
+            subscription->EventReceived.Wait();
+        }
+
+        // A second subscription to an existing resource shares the existing connection
+        auto duplicateSubscription = std::make_shared<TestSubscription>(subscriptions.front()->Uri);
+        VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), duplicateSubscription));
+        duplicateSubscription->SubscribeComplete.Wait();
+        VERIFY_ARE_EQUAL_UINT(3u, connectCount.load());
+        subscriptions.push_back(duplicateSubscription);
+
+        for (auto& subscription : subscriptions)
+        {
+            VERIFY_SUCCEEDED(rtaManager->RemoveSubscription(xboxLiveContext->User(), subscription));
+        }
+
+        // All connections are closed after the last subscription is removed
+        connectionMonitor.Disconnected.Wait();
+
+        MockWebsocket::SetConnectHandler(nullptr);
+    }
+
+    DEFINE_TEST_CASE(TestEventDispatchThroughput)
+    {
+        TEST_LOG(L"Test starting: TestEventDispatchThroughput");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto& mockRta{ MockRealTimeActivityService::Instance() };
+        auto rtaManager{ GlobalState::Get()->RTAManager() };
+
+        mockRta.SetSubscribeHandler([&](uint32_t n, xsapi_internal_string uri)
+        {
+            mockRta.CompleteSubscribeHandshake(n);
+        });
+
+        // Recorded stream of presence, stat, and title events, replayed round robin across the subscriptions
+        const char* recordedEvents[]
+        {
+            R"({"devicetype":"XboxOne","titleid":1234567890,"state":"active","richPresence":"Playing level 3"})",
+            R"({"xuid":"2814639011617876","stats":[{"name":"EnemyDefeats","type":"Integer","value":"42"}]})",
+            R"({"NotificationType":"Added","Xuids":["2814639011617876","2814639011617877","2814639011617878"]})",
+            R"([1,2,3,{"nested":{"array":[true,false,null],"string":"escaped \"]\" bracket"}}])",
+        };
+        constexpr size_t recordedEventCount{ sizeof(recordedEvents) / sizeof(recordedEvents[0]) };
+
+        constexpr size_t subscriptionCount{ 16 };
+        constexpr uint32_t eventsPerSubscription{ 250 };
+
+        Vector<std::shared_ptr<RawEventSubscription>> subscriptions;
+        for (size_t i = 0; i < subscriptionCount; ++i)
+        {
+            Stringstream uri;
+            uri << "https://uri" << i;
+            subscriptions.push_back(std::make_shared<RawEventSubscription>(uri.str(), eventsPerSubscription));
+            VERIFY_SUCCEEDED(rtaManager->AddSubscription(xboxLiveContext->User(), subscriptions.back()));
+        }
+
+        for (auto& subscription : subscriptions)
+        {
+            subscription->SubscribeComplete.Wait();
+        }
+
+        VERIFY_SUCCEEDED(XblProfilerReset());
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(true));
+
+        auto start{ std::chrono::steady_clock::now() };
+        for (uint32_t i = 0; i < eventsPerSubscription; ++i)
+        {
+            for (auto& subscription : subscriptions)
+            {
+                mockRta.RaiseEvent(subscription->ResourceUri(), recordedEvents[i % recordedEventCount]);
+            }
+        }
+
+        for (auto& subscription : subscriptions)
+        {
+            subscription->AllEventsReceived.Wait();
+        }
+        auto elapsed{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+
+        XblProfileAreaStats stats{};
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::RtaMessageDispatch, &stats));
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(false));
+
+        std::wstringstream ss;
+        ss << L"Dispatched " << stats.count << L" RTA events in " << elapsed.count() << L"us, dispatch p50="
+            << stats.p50Microseconds << L"us p99=" << stats.p99Microseconds << L"us max=" << stats.maxMicroseconds << L"us";
+        TEST_LOG(ss.str().c_str());
+
+        VERIFY_ARE_EQUAL_INT(subscriptionCount * eventsPerSubscription, stats.count);
+        for (auto& subscription : subscriptions)
+        {
+            VERIFY_ARE_EQUAL_UINT(eventsPerSubscription, subscription->EventReceivedCount.load());
+            VERIFY_ARE_EQUAL_UINT(0u, subscription->DomEventReceivedCount.load());
+            VERIFY_ARE_EQUAL_STR(recordedEvents[(eventsPerSubscription - 1) % recordedEventCount], subscription->LastPayload);
+            VERIFY_SUCCEEDED(rtaManager->RemoveSubscription(xboxLiveContext->User(), subscription));
+        }
+    }
 };
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -135,10 +135,6 @@ private:
             {
                 VERIFY_SUCCEEDED(XblSocialManagerRemoveLocalUser(users[i]));
             }
-
-#if ENABLE_PERF_PROFILING
-            TEST_LOG(Utils::StringTFromUtf8(detail::PerfTester::Instance().FormatStats().data()).data());
-#endif
         }
 
         // CPP helpers wrapping SocialManager APIs
@@ -1500,6 +1496,103 @@ public:
         VERIFY_SUCCEEDED(XblSocialManagerDestroySocialUserGroup(group));
     }
 
+    DEFINE_TEST_CASE(TestLargeGraphUpdateThroughput)
+    {
+        TEST_LOG(L"Test starting: TestLargeGraphUpdateThroughput");
+
+        SMTestEnvironment env{};
+        env.FollowedXuids.clear();
+        for (uint64_t i = 0; i < 2000; ++i)
+        {
+            env.FollowedXuids.push_back(i + 1);
+        }
+
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        env.AddLocalUser(xboxLiveContext->User());
+
+        XblSocialManagerUserGroupHandle allFriends{ nullptr };
+        VERIFY_SUCCEEDED(XblSocialManagerCreateSocialUserGroupFromFilters(
+            xboxLiveContext->User().Handle(),
+            XblPresenceFilter::All,
+            XblRelationshipFilter::Friends,
+            &allFriends
+        ));
+
+        XblSocialManagerUserGroupHandle favorites{ nullptr };
+        VERIFY_SUCCEEDED(XblSocialManagerCreateSocialUserGroupFromFilters(
+            xboxLiveContext->User().Handle(),
+            XblPresenceFilter::AllOnline,
+            XblRelationshipFilter::Favorite,
+            &favorites
+        ));
+
+        env.AwaitEvents({ {XblSocialManagerEventType::SocialUserGroupLoaded, 2} });
+        VERIFY_ARE_EQUAL_INT(env.FollowedXuids.size(), env.GetUsersCount(allFriends));
+        VERIFY_ARE_EQUAL_INT(0, env.GetUsersCount(favorites));
+
+        VERIFY_SUCCEEDED(XblProfilerReset());
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(true));
+
+        // Favorite every followed user so the whole graph changes at once
+        env.SetPeoplehubMock(true, true);
+        MockRealTimeActivityService::Instance().RaiseResync();
+
+        // Fail rather than hang if some updates never arrive
+        auto start{ std::chrono::steady_clock::now() };
+        const auto deadline{ start + std::chrono::seconds{ 30 } };
+        size_t frames{ 0 };
+        size_t relationshipChanges{ 0 };
+        while (relationshipChanges < env.FollowedXuids.size())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                std::wstringstream ss;
+                ss << L"Timed out with " << relationshipChanges << L" of " << env.FollowedXuids.size() << L" graph updates applied";
+                TEST_LOG(ss.str().c_str());
+                VERIFY_FAIL();
+            }
+
+            const XblSocialManagerEvent* events{ nullptr };
+            size_t eventCount{ 0 };
+            VERIFY_SUCCEEDED(XblSocialManagerDoWork(&events, &eventCount));
+            if (eventCount > 0)
+            {
+                ++frames;
+            }
+
+            for (size_t i = 0; i < eventCount; ++i)
+            {
+                VERIFY_IS_TRUE(events[i].eventType == XblSocialManagerEventType::SocialRelationshipsChanged);
+                for (auto affectedUser : events[i].usersAffected)
+                {
+                    if (affectedUser)
+                    {
+                        VERIFY_IS_TRUE(affectedUser->isFavorite);
+                        ++relationshipChanges;
+                    }
+                }
+            }
+        }
+        auto elapsed{ std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start) };
+
+        XblProfileAreaStats stats{};
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::SocialManagerDoWork, &stats));
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(false));
+
+        // Groups are maintained from the graph's filter indexes as updates are applied
+        VERIFY_ARE_EQUAL_INT(env.FollowedXuids.size(), env.GetUsersCount(allFriends));
+        VERIFY_ARE_EQUAL_INT(env.FollowedXuids.size(), env.GetUsersCount(favorites));
+        VERIFY_ARE_EQUAL_INT(env.FollowedXuids.size(), env.GetTrackedUsersCount(favorites));
+
+        std::wstringstream ss;
+        ss << L"Applied " << relationshipChanges << L" graph updates in " << frames << L" frames (" << elapsed.count()
+            << L"ms), DoWork p50=" << stats.p50Microseconds << L"us p99=" << stats.p99Microseconds << L"us max=" << stats.maxMicroseconds << L"us";
+        TEST_LOG(ss.str().c_str());
+
+        VERIFY_SUCCEEDED(XblSocialManagerDestroySocialUserGroup(favorites));
+        VERIFY_SUCCEEDED(XblSocialManagerDestroySocialUserGroup(allFriends));
+    }
+
     DEFINE_TEST_CASE(TestSMInvalidArgs)
     {
         TEST_LOG(L"Test starting: TestSMInvalidArgs");
@@ -394,6 +394,98 @@ public:
         VERIFY_IS_TRUE(memcmp(responseBody, retreivedBlob.data(), retreivedBlob.size() / bufferSizeMultiplier) == 0);
     }
 
+    uint64_t DownloadBlobInRanges(
+        XblContextHandle xboxLiveContext,
+        uint32_t parallelism
+    )
+    {
+        const size_t blockSize{ XBL_TITLE_STORAGE_MIN_DOWNLOAD_BLOCK_SIZE };
+        const size_t blockCount{ 2048 };
+
+        // Every range is served the same block, so the downloaded blob is that block repeated
+        std::vector<uint8_t> block(blockSize);
+        for (size_t i = 0; i < blockSize; ++i)
+        {
+            block[i] = static_cast<uint8_t>(i % 251);
+        }
+
+        std::stringstream contentRange;
+        contentRange << "bytes 0-" << blockSize - 1 << "/" << blockSize * blockCount;
+
+        auto mock = std::make_shared<HttpMock>("GET", "https://titlestorage.xboxlive.com");
+        mock->SetResponseBody(block.data(), block.size());
+        mock->SetResponseHeaders(HttpHeaders{ { "ETag", "0x52345234e3" }, { "Content-Range", contentRange.str().c_str() } });
+
+        std::atomic<size_t> requestCount{ 0 };
+        std::atomic<size_t> requestsInFlight{ 0 };
+        std::atomic<size_t> maxRequestsInFlight{ 0 };
+        mock->SetMockMatchedCallback(
+            [&](HttpMock* mock, xsapi_internal_string requestUrl, xsapi_internal_string requestBody)
+            {
+                UNREFERENCED_PARAMETER(mock);
+                UNREFERENCED_PARAMETER(requestUrl);
+                UNREFERENCED_PARAMETER(requestBody);
+
+                size_t inFlight{ ++requestsInFlight };
+                size_t maxInFlight{ maxRequestsInFlight };
+                while (inFlight > maxInFlight && !maxRequestsInFlight.compare_exchange_weak(maxInFlight, inFlight))
+                {
+                }
+
+                // Simulated service latency
+                Sleep(1);
+                ++requestCount;
+                --requestsInFlight;
+            }
+        );
+
+        XblTitleStorageBlobMetadata metadata
+        {
+            "blobPath",
+            XblTitleStorageBlobType::Binary,
+            XblTitleStorageType::GlobalStorage,
+            "Name",
+            "0x52345234e3",
+            0,
+            blockSize * blockCount,
+            MOCK_SCID,
+            xboxLiveContext->Xuid()
+        };
+
+        std::vector<uint8_t> retreivedBlob(blockSize * blockCount);
+
+        VERIFY_SUCCEEDED(XblTitleStorageSetDownloadParallelism(xboxLiveContext, parallelism));
+
+        auto start = std::chrono::steady_clock::now();
+
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(
+            xboxLiveContext,
+            metadata,
+            retreivedBlob.data(),
+            retreivedBlob.size(),
+            XblTitleStorageETagMatchCondition::NotUsed,
+            nullptr,
+            blockSize,
+            &async
+        ));
+
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobResult(&async, &metadata));
+        VERIFY_ARE_EQUAL_UINT(blockSize * blockCount, metadata.length);
+        VERIFY_ARE_EQUAL_UINT(blockCount, requestCount);
+        VERIFY_IS_TRUE(maxRequestsInFlight <= parallelism);
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            VERIFY_IS_TRUE(memcmp(block.data(), retreivedBlob.data() + i * blockSize, blockSize) == 0);
+        }
+
+        return static_cast<uint64_t>(elapsed.count());
+    }
+
     void DeleteBlob(
         XblContextHandle xboxLiveContext,
         XblTitleStorageType storageType,
@@ -599,6 +691,139 @@ public:
         DownloadBlob(xboxLiveContext.get(), XblTitleStorageType::Universal, XblTitleStorageBlobType::Binary, 2);
     }
 
+    DEFINE_TEST_CASE(DownloadBlobInParallelRangesTest)
+    {
+        TEST_LOG(L"Test starting: DownloadBlobInParallelRangesTest");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        // Compares a 2MB blob downloaded one block at a time with the same blob downloaded 8 blocks at a time. Each
+        // request waits on simulated latency, so overlapping them must finish sooner.
+        auto sequentialMs = DownloadBlobInRanges(xboxLiveContext.get(), 1);
+        auto parallelMs = DownloadBlobInRanges(xboxLiveContext.get(), 8);
+
+        TEST_LOG(FormatString(L"Sequential download: %llu ms, parallel download: %llu ms", sequentialMs, parallelMs).c_str());
+        VERIFY_IS_TRUE(parallelMs < sequentialMs);
+    }
+
+    DEFINE_TEST_CASE(DownloadBlobFromCacheTest)
+    {
+        TEST_LOG(L"Test starting: DownloadBlobFromCacheTest");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        auto mock = std::make_shared<HttpMock>("GET", "https://titlestorage.xboxlive.com");
+        mock->SetResponseBody(reinterpret_cast<const uint8_t*>(jsonBlob), sizeof(jsonBlob));
+        mock->SetResponseHeaders(HttpHeaders{ { "ETag", "0x52345234e3" } });
+
+        size_t requestCount{ 0 };
+        bool blobCached{ false };
+        mock->SetMockMatchedCallback(
+            [&](HttpMock* mock, xsapi_internal_string requestUrl, xsapi_internal_string requestBody)
+            {
+                UNREFERENCED_PARAMETER(requestUrl);
+                UNREFERENCED_PARAMETER(requestBody);
+
+                // The blob hasn't changed since it was first downloaded
+                ++requestCount;
+                if (blobCached)
+                {
+                    mock->SetResponseHttpStatus(304);
+                    mock->ClearReponseBody();
+                }
+            }
+        );
+
+        XblTitleStorageBlobMetadata metadata
+        {
+            "cachedBlobPath",
+            XblTitleStorageBlobType::Json,
+            XblTitleStorageType::GlobalStorage,
+            "Name",
+            "",
+            0,
+            sizeof(jsonBlob),
+            MOCK_SCID,
+            xboxLiveContext->Xuid()
+        };
+
+        std::vector<uint8_t> retreivedBlob(sizeof(jsonBlob));
+
+        // Clear anything an earlier run left in the cache. While the cache is disabled, the first download deletes
+        // it from storage and isn't cached itself.
+        VERIFY_SUCCEEDED(XblTitleStorageSetCacheBudget(0));
+
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(xboxLiveContext.get(), metadata, retreivedBlob.data(), retreivedBlob.size(), XblTitleStorageETagMatchCondition::NotUsed, nullptr, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        XblTitleStorageCacheStats stats{};
+        VERIFY_SUCCEEDED(XblTitleStorageGetCacheStats(&stats));
+        VERIFY_ARE_EQUAL_UINT(0, stats.bytesStored);
+
+        VERIFY_SUCCEEDED(XblTitleStorageSetCacheBudget(1024 * 1024));
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(xboxLiveContext.get(), metadata, retreivedBlob.data(), retreivedBlob.size(), XblTitleStorageETagMatchCondition::NotUsed, nullptr, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        // The blob is written to the cache after the download completes
+        for (uint32_t i = 0; i < 100 && stats.bytesStored == 0; ++i)
+        {
+            Sleep(10);
+            VERIFY_SUCCEEDED(XblTitleStorageGetCacheStats(&stats));
+        }
+        VERIFY_ARE_EQUAL_UINT(sizeof(jsonBlob), stats.bytesStored);
+
+        // The next download is revalidated and served from the cache
+        blobCached = true;
+        std::fill(retreivedBlob.begin(), retreivedBlob.end(), static_cast<uint8_t>(0));
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(xboxLiveContext.get(), metadata, retreivedBlob.data(), retreivedBlob.size(), XblTitleStorageETagMatchCondition::NotUsed, nullptr, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobResult(&async, &metadata));
+
+        VERIFY_ARE_EQUAL_UINT(3, requestCount);
+        VERIFY_ARE_EQUAL_UINT(sizeof(jsonBlob), metadata.length);
+        VERIFY_ARE_EQUAL_STR("0x52345234e3", metadata.eTag);
+        VERIFY_IS_TRUE(memcmp(jsonBlob, retreivedBlob.data(), sizeof(jsonBlob)) == 0);
+
+        VERIFY_SUCCEEDED(XblTitleStorageGetCacheStats(&stats));
+        VERIFY_ARE_EQUAL_UINT(1, stats.hits);
+        VERIFY_ARE_EQUAL_UINT(sizeof(jsonBlob), stats.bytesSaved);
+        VERIFY_ARE_EQUAL_UINT(1, stats.misses);
+        VERIFY_ARE_EQUAL_UINT(0, stats.updates);
+
+        // Disabling the cache deletes what it holds for the user the next time they use title storage
+        VERIFY_SUCCEEDED(XblTitleStorageSetCacheBudget(0));
+        blobCached = false;
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(xboxLiveContext.get(), metadata, retreivedBlob.data(), retreivedBlob.size(), XblTitleStorageETagMatchCondition::NotUsed, nullptr, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        for (uint32_t i = 0; i < 100 && stats.bytesStored != 0; ++i)
+        {
+            Sleep(10);
+            VERIFY_SUCCEEDED(XblTitleStorageGetCacheStats(&stats));
+        }
+        VERIFY_ARE_EQUAL_UINT(0, stats.bytesStored);
+
+        // Re-enabling it starts from empty
+        VERIFY_SUCCEEDED(XblTitleStorageSetCacheBudget(1024 * 1024));
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageDownloadBlobAsync(xboxLiveContext.get(), metadata, retreivedBlob.data(), retreivedBlob.size(), XblTitleStorageETagMatchCondition::NotUsed, nullptr, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        VERIFY_SUCCEEDED(XblTitleStorageGetCacheStats(&stats));
+        VERIFY_ARE_EQUAL_UINT(1, stats.hits);
+        VERIFY_ARE_EQUAL_UINT(2, stats.misses);
+    }
+
     DEFINE_TEST_CASE(UploadBlobTest)
     {
         TEST_LOG(L"Test starting: UploadBlobTest");
@@ -767,6 +992,246 @@ public:
         VERIFY_SUCCEEDED(XblTitleStorageUploadBlobResult(&async, &metadata));
     }
 
+    DEFINE_TEST_CASE(UploadBlobResumeTest)
+    {
+        TEST_LOG(L"Test starting: UploadBlobResumeTest");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        const size_t blockSize{ XBL_TITLE_STORAGE_MIN_UPLOAD_BLOCK_SIZE };
+        std::vector<uint8_t> data(blockSize * 3);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8_t>(rand() % UCHAR_MAX);
+        }
+
+        XblTitleStorageBlobMetadata metadata
+        {
+            "blobPath",
+            XblTitleStorageBlobType::Binary,
+            XblTitleStorageType::Universal,
+            "Name",
+            "0x52345234e3",
+            0,
+            0,
+            MOCK_SCID,
+            xboxLiveContext->Xuid()
+        };
+
+        JsonDocument d;
+        d.Parse(continuationTokenJson);
+        xsapi_internal_string continuationToken{ d["continuationToken"].GetString() };
+
+        auto mock = std::make_shared<HttpMock>("PUT", "https://titlestorage.xboxlive.com");
+
+        // The first attempt is interrupted after the first block
+        bool failSecondBlock{ true };
+        std::vector<std::string> requestBodies;
+        std::vector<xsapi_internal_string> requestTokens;
+        mock->SetMockMatchedCallback(
+            [&](HttpMock* mock, xsapi_internal_string requestUrl, xsapi_internal_string requestBody)
+            {
+                auto queryParams = xbox::services::uri::split_query(xbox::services::uri{ requestUrl.data() }.query());
+                requestBodies.push_back(std::string{ requestBody.begin(), requestBody.end() });
+                requestTokens.push_back(queryParams["continuationToken"]);
+
+                if (failSecondBlock && requestBodies.size() == 2)
+                {
+                    mock->SetResponseHttpStatus(400);
+                    mock->ClearReponseBody();
+                }
+                else
+                {
+                    mock->SetResponseHttpStatus(200);
+                    mock->SetResponseBody(continuationTokenJson);
+                }
+            }
+        );
+
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data.data(), data.size(), XblTitleStorageETagMatchCondition::NotUsed, blockSize, &async));
+        VERIFY_ARE_EQUAL_INT(XAsyncGetStatus(&async, true), HTTP_E_STATUS_BAD_REQUEST);
+        VERIFY_ARE_EQUAL_UINT(2, requestBodies.size());
+
+        // Retrying the upload sends only the blocks the service doesn't have yet, continuing the earlier upload
+        failSecondBlock = false;
+        requestBodies.clear();
+        requestTokens.clear();
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data.data(), data.size(), XblTitleStorageETagMatchCondition::NotUsed, blockSize, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobResult(&async, &metadata));
+
+        VERIFY_ARE_EQUAL_UINT(2, requestBodies.size());
+        for (size_t i = 0; i < requestBodies.size(); ++i)
+        {
+            VERIFY_IS_TRUE(requestTokens[i] == continuationToken);
+            VERIFY_ARE_EQUAL_UINT(blockSize, requestBodies[i].size());
+            VERIFY_IS_TRUE(memcmp(requestBodies[i].data(), data.data() + (i + 1) * blockSize, blockSize) == 0);
+        }
+
+        // A completed upload leaves nothing to resume, so the next upload starts from the beginning
+        requestBodies.clear();
+        requestTokens.clear();
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data.data(), data.size(), XblTitleStorageETagMatchCondition::NotUsed, blockSize, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        VERIFY_ARE_EQUAL_UINT(3, requestBodies.size());
+        VERIFY_IS_TRUE(requestTokens[0].empty());
+    }
+
+    DEFINE_TEST_CASE(UploadBlobResumeRequiresSameETagConditionTest)
+    {
+        TEST_LOG(L"Test starting: UploadBlobResumeRequiresSameETagConditionTest");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        const size_t blockSize{ XBL_TITLE_STORAGE_MIN_UPLOAD_BLOCK_SIZE };
+        std::vector<uint8_t> data(blockSize * 3);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<uint8_t>(rand() % UCHAR_MAX);
+        }
+
+        XblTitleStorageBlobMetadata metadata
+        {
+            "conditionalBlobPath",
+            XblTitleStorageBlobType::Binary,
+            XblTitleStorageType::Universal,
+            "Name",
+            "0x52345234e3",
+            0,
+            0,
+            MOCK_SCID,
+            xboxLiveContext->Xuid()
+        };
+
+        auto mock = std::make_shared<HttpMock>("PUT", "https://titlestorage.xboxlive.com");
+
+        // The first attempt is interrupted after the first block
+        bool failSecondBlock{ true };
+        std::vector<xsapi_internal_string> requestTokens;
+        mock->SetMockMatchedCallback(
+            [&](HttpMock* mock, xsapi_internal_string requestUrl, xsapi_internal_string requestBody)
+            {
+                UNREFERENCED_PARAMETER(requestBody);
+
+                auto queryParams = xbox::services::uri::split_query(xbox::services::uri{ requestUrl.data() }.query());
+                requestTokens.push_back(queryParams["continuationToken"]);
+
+                if (failSecondBlock && requestTokens.size() == 2)
+                {
+                    mock->SetResponseHttpStatus(400);
+                    mock->ClearReponseBody();
+                }
+                else
+                {
+                    mock->SetResponseHttpStatus(200);
+                    mock->SetResponseBody(continuationTokenJson);
+                }
+            }
+        );
+
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data.data(), data.size(), XblTitleStorageETagMatchCondition::NotUsed, blockSize, &async));
+        VERIFY_ARE_EQUAL_INT(XAsyncGetStatus(&async, true), HTTP_E_STATUS_BAD_REQUEST);
+        VERIFY_ARE_EQUAL_UINT(2, requestTokens.size());
+
+        // A retry with a different ETag condition doesn't continue the earlier upload, which wasn't made under it
+        failSecondBlock = false;
+        requestTokens.clear();
+
+        async = XAsyncBlock{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data.data(), data.size(), XblTitleStorageETagMatchCondition::IfMatch, blockSize, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        VERIFY_ARE_EQUAL_UINT(3, requestTokens.size());
+        VERIFY_IS_TRUE(requestTokens[0].empty());
+    }
+
+    DEFINE_TEST_CASE(UploadBlobClearsExpiredStateTest)
+    {
+        TEST_LOG(L"Test starting: UploadBlobClearsExpiredStateTest");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto localStorage{ GlobalState::Get()->LocalStorage() };
+        auto& user{ xboxLiveContext->User() };
+
+        auto stateKey = [&](uint32_t slot)
+        {
+            Stringstream key;
+            key << "titlestorage_upload_" << xboxLiveContext->Xuid() << "_" << slot << ".json";
+            return key.str();
+        };
+
+        auto readState = [&](uint32_t slot)
+        {
+            Event readComplete;
+            Vector<uint8_t> state;
+            VERIFY_SUCCEEDED(localStorage->ReadAsync(user, stateKey(slot), [&](Result<Vector<uint8_t>> result)
+            {
+                if (Succeeded(result))
+                {
+                    state = result.ExtractPayload();
+                }
+                readComplete.Set();
+            }));
+            readComplete.Wait();
+            return state;
+        };
+
+        // State left by uploads that were never retried, saved long ago, plus a state file that can't be read
+        const String expiredState{ R"({"blob":"0/0/scid/1/otherBlob","length":1048576,"bytesUploaded":262144,"continuationToken":"token","savedAt":1})" };
+        const String unreadableState{ "{" };
+        for (uint32_t slot = 0; slot < 8; ++slot)
+        {
+            auto& state{ slot == 0 ? unreadableState : expiredState };
+
+            Event writeComplete;
+            VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Truncate, stateKey(slot), Vector<uint8_t>{ state.begin(), state.end() }, [&](Result<size_t>)
+            {
+                writeComplete.Set();
+            }));
+            writeComplete.Wait();
+        }
+
+        XblTitleStorageBlobMetadata metadata
+        {
+            "blobPath",
+            XblTitleStorageBlobType::Binary,
+            XblTitleStorageType::Universal,
+            "Name",
+            "",
+            0,
+            0,
+            MOCK_SCID,
+            xboxLiveContext->Xuid()
+        };
+
+        auto mock = std::make_shared<HttpMock>("PUT", "https://titlestorage.xboxlive.com");
+        uint8_t data[16]{};
+
+        // The first upload through the context clears them, even though it fits in a single block
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblTitleStorageUploadBlobAsync(xboxLiveContext.get(), metadata, data, sizeof(data), XblTitleStorageETagMatchCondition::NotUsed, 0, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        for (uint32_t slot = 0; slot < 8; ++slot)
+        {
+            auto state{ readState(slot) };
+            for (uint32_t i = 0; i < 100 && !state.empty(); ++i)
+            {
+                Sleep(10);
+                state = readState(slot);
+            }
+            VERIFY_IS_TRUE(state.empty());
+        }
+    }
+
     DEFINE_TEST_CASE(TitleStorageInvalidArgsTest)
     {
         TEST_LOG(L"Test starting: TitleStorageInvalidArgsTest");
@@ -817,6 +1282,8 @@ public:
             &async
         ), E_INVALIDARG);
 
+        VERIFY_ARE_EQUAL_INT(XblTitleStorageSetDownloadParallelism(xboxLiveContext.get(), 0), E_INVALIDARG);
+
         VERIFY_ARE_EQUAL_INT(XblTitleStorageUploadBlobAsync(
             xboxLiveContext.get(),
             XblTitleStorageBlobMetadata{},
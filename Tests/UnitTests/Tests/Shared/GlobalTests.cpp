@@ -9,6 +9,7 @@ NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 size_t g_memAllocHookCalls{ 0 };
 size_t g_memFreeHookCalls{ 0 };
 std::unordered_map<void*, size_t> g_allocationMap{};
+std::atomic<size_t> g_asyncAllocCount{ 0 };
 
 const char getProfileResponse[] = R"(
 {
@@ -211,6 +212,366 @@ public:
         VERIFY_ARE_EQUAL_INT(g_memAllocHookCalls, g_memFreeHookCalls);
     }
 
+    static _Ret_maybenull_ _Post_writable_byte_size_(dwSize) void* STDAPIVCALLTYPE CountingAllocHook(
+        _In_ size_t dwSize,
+        _In_ HCMemoryType memType
+    )
+    {
+        UNREFERENCED_PARAMETER(memType);
+        ++g_asyncAllocCount;
+        return new char[dwSize];
+    }
+
+    static void STDAPIVCALLTYPE CountingFreeHook(
+        _In_ void* pAddress,
+        _In_ HCMemoryType memType
+    )
+    {
+        UNREFERENCED_PARAMETER(memType);
+        delete[] static_cast<char*>(pAddress);
+    }
+
+    DEFINE_TEST_CASE(TestAsyncPlumbingAllocations)
+    {
+        TEST_LOG(L"Test starting: TestAsyncPlumbingAllocations");
+
+        VERIFY_SUCCEEDED(XblMemSetFunctions(CountingAllocHook, CountingFreeHook));
+        {
+            auto sharedState{ std::make_shared<uint32_t>(0) };
+
+            // Typical continuation: a shared_ptr and a couple of words of state, stored inline
+            g_asyncAllocCount = 0;
+            {
+                Callback<HRESULT> callback{ [sharedState, increment = 1u](HRESULT hr)
+                {
+                    if (SUCCEEDED(hr))
+                    {
+                        *sharedState += increment;
+                    }
+                } };
+                auto callbackCopy{ callback };
+                auto callbackMoved{ std::move(callbackCopy) };
+
+                AsyncContext<HRESULT> async{ std::move(callbackMoved) };
+                auto asyncCopy{ async };
+                asyncCopy.Complete(S_OK);
+                async.Complete(S_OK);
+            }
+            VERIFY_ARE_EQUAL_UINT(2, *sharedState);
+            VERIFY_ARE_EQUAL_UINT(0, g_asyncAllocCount.load());
+
+            // Move only work owning its capture is never copied, so moving it between queues doesn't allocate
+            auto ownedState{ MakeUnique<uint32_t>(1) };
+            g_asyncAllocCount = 0;
+            {
+                AsyncWork work{ [sharedState, ownedState = std::move(ownedState)]
+                {
+                    *sharedState += *ownedState;
+                } };
+                AsyncWork workMoved{ std::move(work) };
+                workMoved();
+            }
+            VERIFY_ARE_EQUAL_UINT(3, *sharedState);
+            VERIFY_ARE_EQUAL_UINT(0, g_asyncAllocCount.load());
+
+            // Callables larger than the inline buffer take one allocation when created and one per copy
+            std::array<uint64_t, 8> largeState{};
+            static_assert(sizeof(largeState) > detail::FunctionInlineSize, "Capture must not fit inline");
+            g_asyncAllocCount = 0;
+            {
+                Callback<> large{ [sharedState, largeState]
+                {
+                    *sharedState += static_cast<uint32_t>(largeState.size());
+                } };
+                VERIFY_ARE_EQUAL_UINT(1, g_asyncAllocCount.load());
+
+                auto largeCopy{ large };
+                VERIFY_ARE_EQUAL_UINT(2, g_asyncAllocCount.load());
+
+                auto largeMoved{ std::move(large) };
+                largeMoved();
+            }
+            VERIFY_ARE_EQUAL_UINT(11, *sharedState);
+            VERIFY_ARE_EQUAL_UINT(2, g_asyncAllocCount.load());
+        }
+        VERIFY_SUCCEEDED(XblMemSetFunctions(nullptr, nullptr));
+    }
+
+#if XSAPI_COROUTINES
+    // Steps past this value fail, so that the tests can check how errors propagate out of a coroutine
+    static constexpr uint32_t c_incrementLimit{ 4 };
+
+    static HRESULT IncrementAsync(
+        const TaskQueue& queue,
+        uint32_t value,
+        AsyncContext<Result<uint32_t>> async
+    ) noexcept
+    {
+        return queue.RunWork([value, async]
+        {
+            if (value >= c_incrementLimit)
+            {
+                async.Complete(E_BOUNDS);
+            }
+            else
+            {
+                async.Complete(value + 1);
+            }
+        });
+    }
+
+    static AsyncCoroutine IncrementThreeTimesCoroutine(
+        TaskQueue queue,
+        uint32_t value,
+        AsyncContext<Result<uint32_t>> async
+    ) noexcept
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            auto result = co_await AsyncAwait<Result<uint32_t>>(queue, [&](AsyncContext<Result<uint32_t>> stepAsync)
+            {
+                return IncrementAsync(queue, value, std::move(stepAsync));
+            });
+
+            if (Failed(result))
+            {
+                async.Complete(result);
+                co_return;
+            }
+            value = result.Payload();
+        }
+
+        async.Complete(value);
+    }
+
+    DEFINE_TEST_CASE(TestAsyncCoroutine)
+    {
+        TEST_LOG(L"Test starting: TestAsyncCoroutine");
+
+        XTaskQueueHandle queueHandle{ nullptr };
+        VERIFY_SUCCEEDED(XTaskQueueCreate(XTaskQueueDispatchMode::ThreadPool, XTaskQueueDispatchMode::ThreadPool, &queueHandle));
+        TaskQueue queue{ queueHandle };
+        XTaskQueueCloseHandle(queueHandle);
+
+        auto run = [&queue](uint32_t start)
+        {
+            Event complete{};
+            Result<uint32_t> result{ E_FAIL };
+
+            VERIFY_SUCCEEDED(IncrementThreeTimesCoroutine(queue, start, AsyncContext<Result<uint32_t>>{ [&](Result<uint32_t> stepResult)
+            {
+                result = stepResult;
+                complete.Set();
+            } }).Hresult());
+            complete.Wait();
+
+            return result;
+        };
+
+        // Each step resumes the coroutine from the queue with the result of the previous one
+        auto result{ run(0) };
+        VERIFY_SUCCEEDED(result.Hresult());
+        VERIFY_ARE_EQUAL_UINT(3, result.Payload());
+
+        // A failed step completes the coroutine with its error and the remaining steps don't run
+        result = run(c_incrementLimit - 1);
+        VERIFY_ARE_EQUAL(E_BOUNDS, result.Hresult());
+
+        queue.Terminate(true);
+    }
+
+    DEFINE_TEST_CASE(TestAsyncCoroutineAllocations)
+    {
+        TEST_LOG(L"Test starting: TestAsyncCoroutineAllocations");
+
+        VERIFY_SUCCEEDED(XblMemSetFunctions(CountingAllocHook, CountingFreeHook));
+        {
+            XTaskQueueHandle queueHandle{ nullptr };
+            VERIFY_SUCCEEDED(XTaskQueueCreate(XTaskQueueDispatchMode::ThreadPool, XTaskQueueDispatchMode::ThreadPool, &queueHandle));
+            TaskQueue queue{ queueHandle };
+            XTaskQueueCloseHandle(queueHandle);
+
+            // Same three step flow, once as chained continuations and once as a coroutine
+            auto runContinuations = [queue](AsyncContext<Result<uint32_t>> async)
+            {
+                return IncrementAsync(queue, 0, { [queue, async](Result<uint32_t> first)
+                {
+                    IncrementAsync(queue, first.Payload(), { [queue, async](Result<uint32_t> second)
+                    {
+                        IncrementAsync(queue, second.Payload(), async);
+                    } });
+                } });
+            };
+
+            auto runCoroutine = [queue](AsyncContext<Result<uint32_t>> async)
+            {
+                return IncrementThreeTimesCoroutine(queue, 0, std::move(async)).Hresult();
+            };
+
+            auto measure = [](Function<HRESULT(AsyncContext<Result<uint32_t>>)> run)
+            {
+                Event complete{};
+                uint32_t value{ 0 };
+
+                g_asyncAllocCount = 0;
+                VERIFY_SUCCEEDED(run(AsyncContext<Result<uint32_t>>{ [&](Result<uint32_t> result)
+                {
+                    VERIFY_SUCCEEDED(result.Hresult());
+                    value = result.Payload();
+                    complete.Set();
+                } }));
+                complete.Wait();
+
+                VERIFY_ARE_EQUAL_UINT(3, value);
+                return g_asyncAllocCount.load();
+            };
+
+            size_t continuationAllocs{ measure(runContinuations) };
+            size_t coroutineAllocs{ measure(runCoroutine) };
+
+            std::wstringstream ss;
+            ss << L"Allocations for three async steps: continuations=" << continuationAllocs << L", coroutine=" << coroutineAllocs;
+            TEST_LOG(ss.str().c_str());
+
+            VERIFY_IS_TRUE(coroutineAllocs <= continuationAllocs);
+            queue.Terminate(true);
+        }
+        VERIFY_SUCCEEDED(XblMemSetFunctions(nullptr, nullptr));
+    }
+
+    struct SetOnDestroy
+    {
+        Event& destroyed;
+
+        ~SetOnDestroy()
+        {
+            destroyed.Set();
+        }
+    };
+
+    static AsyncCoroutine DelayCoroutine(
+        TaskQueue queue,
+        Event& destroyed,
+        bool& resumed
+    ) noexcept
+    {
+        SetOnDestroy setOnDestroy{ destroyed };
+        co_await AsyncDelay(queue, 60 * 1000);
+        resumed = true;
+    }
+
+    DEFINE_TEST_CASE(TestAsyncDelayTerminatedQueue)
+    {
+        TEST_LOG(L"Test starting: TestAsyncDelayTerminatedQueue");
+
+        XTaskQueueHandle queueHandle{ nullptr };
+        VERIFY_SUCCEEDED(XTaskQueueCreate(XTaskQueueDispatchMode::ThreadPool, XTaskQueueDispatchMode::ThreadPool, &queueHandle));
+        TaskQueue queue{ queueHandle };
+        XTaskQueueCloseHandle(queueHandle);
+
+        Event destroyed{};
+        bool resumed{ false };
+        VERIFY_SUCCEEDED(DelayCoroutine(queue, destroyed, resumed).Hresult());
+
+        // Terminating the queue drops the delayed resume, which must destroy the frame rather than leak it
+        queue.Terminate(true);
+        destroyed.Wait();
+        VERIFY_IS_FALSE(resumed);
+    }
+#endif
+
+    DEFINE_TEST_CASE(TestMemArenaPolicy)
+    {
+        TEST_LOG(L"Test starting: TestMemArenaPolicy");
+
+        VERIFY_SUCCEEDED(XblMemSetArenaPolicy(XblMemSubsystem::SocialManager, XblMemArenaPolicy::SizeClassPool));
+
+        XblMemSubsystemStats initialStats{};
+        VERIFY_SUCCEEDED(XblMemGetSubsystemStats(XblMemSubsystem::SocialManager, &initialStats));
+
+        {
+            TestEnvironment env{};
+
+            // Policy can't be changed while XSAPI is initialized
+            VERIFY_ARE_EQUAL(E_XBL_ALREADY_INITIALIZED, XblMemSetArenaPolicy(XblMemSubsystem::SocialManager, XblMemArenaPolicy::Default));
+
+            {
+                ArenaUnorderedMap<XblMemSubsystem::SocialManager, uint64_t, uint64_t> map;
+                for (uint64_t i = 0; i < 1000; ++i)
+                {
+                    map[i] = i;
+                }
+                auto ptr = ArenaMakeShared<XblMemSubsystem::SocialManager, uint64_t>(0ull);
+
+                XblMemSubsystemStats stats{};
+                VERIFY_SUCCEEDED(XblMemGetSubsystemStats(XblMemSubsystem::SocialManager, &stats));
+                VERIFY_IS_TRUE(stats.bytesInUse > initialStats.bytesInUse);
+                VERIFY_IS_TRUE(stats.bytesReserved > 0);
+                VERIFY_IS_TRUE(stats.pooledAllocationCount - initialStats.pooledAllocationCount >= 1001);
+                VERIFY_IS_TRUE(stats.peakBytesInUse >= stats.bytesInUse);
+            }
+
+            XblMemSubsystemStats stats{};
+            VERIFY_SUCCEEDED(XblMemGetSubsystemStats(XblMemSubsystem::SocialManager, &stats));
+            VERIFY_ARE_EQUAL_INT(stats.allocationCount - initialStats.allocationCount, stats.freeCount - initialStats.freeCount);
+        }
+
+        // Pooled memory is returned to the memhooks during cleanup
+        XblMemSubsystemStats finalStats{};
+        VERIFY_SUCCEEDED(XblMemGetSubsystemStats(XblMemSubsystem::SocialManager, &finalStats));
+        VERIFY_ARE_EQUAL_INT(0, finalStats.bytesInUse);
+        VERIFY_ARE_EQUAL_INT(0, finalStats.bytesReserved);
+
+        VERIFY_SUCCEEDED(XblMemSetArenaPolicy(XblMemSubsystem::SocialManager, XblMemArenaPolicy::Default));
+    }
+
+    DEFINE_TEST_CASE(TestProfiler)
+    {
+        TEST_LOG(L"Test starting: TestProfiler");
+
+        VERIFY_SUCCEEDED(XblProfilerReset());
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(true));
+
+        for (uint64_t i = 1; i <= 100; ++i)
+        {
+            Profiler::Record(XblProfileArea::RtaMessageDispatch, i);
+        }
+
+        XblProfileAreaStats stats{};
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::RtaMessageDispatch, &stats));
+        VERIFY_ARE_EQUAL_INT(100, stats.count);
+        VERIFY_ARE_EQUAL_INT(5050, stats.totalMicroseconds);
+        VERIFY_ARE_EQUAL_INT(100, stats.maxMicroseconds);
+        // Percentiles are reported as bucket upper bounds, which are within 25% of the true value
+        VERIFY_IS_TRUE(stats.p50Microseconds >= 50 && stats.p50Microseconds <= 63);
+        VERIFY_IS_TRUE(stats.p99Microseconds >= 99 && stats.p99Microseconds <= 100);
+
+        {
+            TestEnvironment env{};
+            auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+            JsonDocument getProfileResponseJson;
+            getProfileResponseJson.Parse(getProfileResponse);
+            HttpMock mock{ "POST", "https://profile.xboxlive.com", 200, getProfileResponseJson };
+
+            XAsyncBlock async{};
+            VERIFY_SUCCEEDED(XblProfileGetUserProfileAsync(xboxLiveContext.get(), xboxLiveContext->Xuid(), &async));
+            VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+        }
+
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::HttpPerform, &stats));
+        VERIFY_ARE_EQUAL_INT(1, stats.count);
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::JsonParse, &stats));
+        VERIFY_IS_TRUE(stats.count >= 1);
+
+        VERIFY_SUCCEEDED(XblProfilerReset());
+        VERIFY_SUCCEEDED(XblProfilerGetStats(XblProfileArea::HttpPerform, &stats));
+        VERIFY_ARE_EQUAL_INT(0, stats.count);
+        VERIFY_ARE_EQUAL_INT(0, stats.maxMicroseconds);
+
+        VERIFY_SUCCEEDED(XblProfilerSetEnabled(false));
+    }
+
     struct CancellableOperation
     {
     public:
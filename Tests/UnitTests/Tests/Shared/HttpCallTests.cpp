@@ -3,6 +3,9 @@
 
 #include "pch.h"
 #include "UnitTestIncludes.h"
+#include "http_call_governor.h"
+#include "http_compression.h"
+#include "token_cache.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -86,6 +89,493 @@ public:
         VERIFY_ARE_EQUAL_UINT(bufferSize, bufferUsed);
     }
 
+    DEFINE_TEST_CASE(TestRequestCompression)
+    {
+        TEST_LOG(L"Test starting: TestRequestCompression");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        // Presence style batch request, typical of the large JSON bodies sent to services
+        JsonDocument batchRequest{ rapidjson::kObjectType };
+        JsonValue users{ rapidjson::kArrayType };
+        for (uint64_t xuid = 2814600000000000; xuid < 2814600000001100; ++xuid)
+        {
+            users.PushBack(JsonValue{ utils::uint64_to_internal_string(xuid).data(), batchRequest.GetAllocator() }, batchRequest.GetAllocator());
+        }
+        batchRequest.AddMember("users", users, batchRequest.GetAllocator());
+        batchRequest.AddMember("level", "all", batchRequest.GetAllocator());
+        String largeBody{ JsonUtils::SerializeJson(batchRequest) };
+
+        const char* hosts[]{ "xboxlive.com" };
+        VERIFY_SUCCEEDED(XblContextSettingsSetRequestCompression(xboxLiveContext.get(), 1024, hosts, 1));
+
+        size_t threshold{};
+        VERIFY_SUCCEEDED(XblContextSettingsGetRequestCompressionThreshold(xboxLiveContext.get(), &threshold));
+        VERIFY_ARE_EQUAL_UINT(1024u, threshold);
+
+        String responseBody{ JsonUtils::SerializeJson(batchRequest) };
+        auto compressedResponse{ HttpCompression::Compress(HttpContentEncoding::Deflate, reinterpret_cast<const uint8_t*>(responseBody.data()), responseBody.size()) };
+        VERIFY_SUCCEEDED(compressedResponse.Hresult());
+
+        HttpMock mock{ "POST", "https://userpresence.xboxlive.com/users/batch", 200 };
+        mock.SetResponseBody(compressedResponse.Payload().data(), compressedResponse.Payload().size());
+        mock.SetResponseHeaders(HttpHeaders{ { CONTENT_ENCODING_HEADER, "deflate" } });
+
+        String sentBody;
+        mock.SetMockMatchedCallback([&](HttpMock*, String, String requestBody)
+        {
+            sentBody = std::move(requestBody);
+        });
+
+        auto performCall = [&](const char* url, const String& body)
+        {
+            XblHttpCallHandle callHandle{};
+            VERIFY_SUCCEEDED(XblHttpCallCreate(xboxLiveContext.get(), "POST", url, &callHandle));
+            VERIFY_SUCCEEDED(XblHttpCallRequestSetRequestBodyString(callHandle, body.data()));
+
+            XAsyncBlock async{};
+            VERIFY_SUCCEEDED(XblHttpCallPerformAsync(callHandle, XblHttpCallResponseBodyType::String, &async));
+            VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+            const char* actualResponseBody{ nullptr };
+            VERIFY_SUCCEEDED(XblHttpCallGetResponseString(callHandle, &actualResponseBody));
+            VERIFY_IS_TRUE(responseBody == actualResponseBody);
+            VERIFY_SUCCEEDED(XblHttpCallCloseHandle(callHandle));
+        };
+
+        // Large bodies to an allowed host are gzip compressed, and the compressed response is decoded
+        performCall("https://userpresence.xboxlive.com/users/batch", largeBody);
+        auto sentBytes{ reinterpret_cast<const uint8_t*>(sentBody.data()) };
+        VERIFY_IS_TRUE(sentBody.size() < largeBody.size());
+
+        auto decompressedBody{ HttpCompression::Decompress(HttpContentEncoding::Gzip, sentBytes, sentBody.size()) };
+        VERIFY_SUCCEEDED(decompressedBody.Hresult());
+        VERIFY_IS_TRUE(largeBody == String(decompressedBody.Payload().begin(), decompressedBody.Payload().end()));
+
+        // Bodies under the threshold are sent as is
+        String smallBody{ "{\"users\":[\"2814600000000000\"]}" };
+        performCall("https://userpresence.xboxlive.com/users/batch", smallBody);
+        VERIFY_IS_TRUE(sentBody == smallBody);
+
+        // Hosts that aren't allowed never see compressed bodies
+        HttpMock otherMock{ "POST", "https://vortex.data.microsoft.com/collect/v1", 200 };
+        otherMock.SetResponseBody(responseBody);
+        otherMock.SetMockMatchedCallback([&](HttpMock*, String, String requestBody)
+        {
+            sentBody = std::move(requestBody);
+        });
+        performCall("https://vortex.data.microsoft.com/collect/v1", largeBody);
+        VERIFY_IS_TRUE(sentBody == largeBody);
+
+        // Corrupt compressed responses fail the call rather than returning garbage
+        auto corruptResponse{ compressedResponse.Payload() };
+        corruptResponse[corruptResponse.size() / 2] ^= 0xFF;
+        mock.SetResponseBody(corruptResponse.data(), corruptResponse.size());
+
+        XblHttpCallHandle callHandle{};
+        VERIFY_SUCCEEDED(XblHttpCallCreate(xboxLiveContext.get(), "POST", "https://userpresence.xboxlive.com/users/batch", &callHandle));
+        XAsyncBlock async{};
+        VERIFY_SUCCEEDED(XblHttpCallPerformAsync(callHandle, XblHttpCallResponseBodyType::String, &async));
+        VERIFY_FAILED(XAsyncGetStatus(&async, true));
+        VERIFY_SUCCEEDED(XblHttpCallCloseHandle(callHandle));
+
+        // Bodies are only decoded when Content-Encoding says so, even if they look compressed
+        auto gzipBody{ HttpCompression::Compress(HttpContentEncoding::Gzip, reinterpret_cast<const uint8_t*>(responseBody.data()), responseBody.size()) };
+        VERIFY_SUCCEEDED(gzipBody.Hresult());
+
+        HttpMock binaryMock{ "GET", "https://userpresence.xboxlive.com/users/binary", 200 };
+        binaryMock.SetResponseBody(gzipBody.Payload().data(), gzipBody.Payload().size());
+
+        VERIFY_SUCCEEDED(XblHttpCallCreate(xboxLiveContext.get(), "GET", "https://userpresence.xboxlive.com/users/binary", &callHandle));
+        async = {};
+        VERIFY_SUCCEEDED(XblHttpCallPerformAsync(callHandle, XblHttpCallResponseBodyType::Vector, &async));
+        VERIFY_SUCCEEDED(XAsyncGetStatus(&async, true));
+
+        size_t bodySize{ 0 };
+        VERIFY_SUCCEEDED(XblHttpCallGetResponseBodyBytesSize(callHandle, &bodySize));
+        Vector<uint8_t> actualBody(bodySize);
+        VERIFY_SUCCEEDED(XblHttpCallGetResponseBodyBytes(callHandle, bodySize, actualBody.data(), nullptr));
+        VERIFY_IS_TRUE(actualBody == gzipBody.Payload());
+        VERIFY_SUCCEEDED(XblHttpCallCloseHandle(callHandle));
+    }
+
+    DEFINE_TEST_CASE(TestResponseCache)
+    {
+        TEST_LOG(L"Test starting: TestResponseCache");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        const char* hosts[]{ "privacy.xboxlive.com" };
+        VERIFY_SUCCEEDED(XblContextSettingsSetHttpResponseCache(xboxLiveContext.get(), 64 * 1024, hosts, 1));
+
+        const char avoidListUrl[]{ "https://privacy.xboxlive.com/users/xuid(101010101)/people/avoid" };
+        const char muteListUrl[]{ "https://privacy.xboxlive.com/users/xuid(101010101)/people/mute" };
+        String responseBody{ "{\"users\":[{\"xuid\":\"2814600000000000\"},{\"xuid\":\"2814600000000001\"}]}" };
+
+        std::atomic<uint32_t> requestCount{ 0 };
+        auto countRequests = [&](HttpMock*, String, String)
+        {
+            ++requestCount;
+        };
+
+        HttpMock avoidListMock{ "GET", avoidListUrl, 200 };
+        avoidListMock.SetResponseBody(responseBody);
+        avoidListMock.SetResponseHeaders(HttpHeaders{ { "ETag", "\"v1\"" }, { "Cache-Control", "max-age=3600" } });
+        avoidListMock.SetMockMatchedCallback(countRequests);
+
+        HttpMock muteListMock{ "GET", muteListUrl, 200 };
+        muteListMock.SetResponseBody(responseBody);
+        muteListMock.SetResponseHeaders(HttpHeaders{ { "ETag", "\"v1\"" }, { "Cache-Control", "no-cache" } });
+        muteListMock.SetMockMatchedCallback(countRequests);
+
+        auto performCalls = [&](const char* url, size_t count)
+        {
+            Vector<XblHttpCallHandle> callHandles(count);
+            Vector<XAsyncBlock> asyncs(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                VERIFY_SUCCEEDED(XblHttpCallCreate(xboxLiveContext.get(), "GET", url, &callHandles[i]));
+                VERIFY_SUCCEEDED(XblHttpCallPerformAsync(callHandles[i], XblHttpCallResponseBodyType::String, &asyncs[i]));
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                VERIFY_SUCCEEDED(XAsyncGetStatus(&asyncs[i], true));
+
+                uint32_t statusCode{ 0 };
+                VERIFY_SUCCEEDED(XblHttpCallGetStatusCode(callHandles[i], &statusCode));
+                VERIFY_ARE_EQUAL_UINT(200u, statusCode);
+
+                const char* actualResponseBody{ nullptr };
+                VERIFY_SUCCEEDED(XblHttpCallGetResponseString(callHandles[i], &actualResponseBody));
+                VERIFY_IS_TRUE(responseBody == actualResponseBody);
+                VERIFY_SUCCEEDED(XblHttpCallCloseHandle(callHandles[i]));
+            }
+        };
+
+        // Identical requests made while the first is in flight wait for it, and later ones are served from the cache
+        constexpr size_t burstSize{ 8 };
+        performCalls(avoidListUrl, burstSize);
+        VERIFY_ARE_EQUAL_UINT(1u, requestCount.load());
+
+        // no-cache responses are revalidated every time, and a 304 returns the stored body
+        performCalls(muteListUrl, 1);
+        VERIFY_ARE_EQUAL_UINT(2u, requestCount.load());
+
+        muteListMock.SetResponseHttpStatus(304);
+        muteListMock.ClearReponseBody();
+        muteListMock.SetResponseHeaders(HttpHeaders{ { "ETag", "\"v1\"" }, { "Cache-Control", "max-age=3600" } });
+        performCalls(muteListUrl, 1);
+        VERIFY_ARE_EQUAL_UINT(3u, requestCount.load());
+
+        // The 304 made the response fresh again, so it is served without a request
+        performCalls(muteListUrl, 1);
+        VERIFY_ARE_EQUAL_UINT(3u, requestCount.load());
+
+        XblHttpResponseCacheStats stats{};
+        VERIFY_SUCCEEDED(XblContextSettingsGetHttpResponseCacheStats(xboxLiveContext.get(), &stats));
+        VERIFY_ARE_EQUAL_UINT(2u, stats.misses);
+        VERIFY_ARE_EQUAL_UINT(1u, stats.revalidations);
+        VERIFY_ARE_EQUAL_UINT(burstSize, stats.hits + stats.coalescedRequests);
+        VERIFY_ARE_EQUAL_UINT((burstSize + 1) * responseBody.size(), stats.bytesSaved);
+        VERIFY_IS_TRUE(stats.bytesStored > responseBody.size());
+
+        // Disabling the cache drops the stored responses
+        VERIFY_SUCCEEDED(XblContextSettingsSetHttpResponseCache(xboxLiveContext.get(), 0, nullptr, 0));
+        VERIFY_SUCCEEDED(XblContextSettingsGetHttpResponseCacheStats(xboxLiveContext.get(), &stats));
+        VERIFY_ARE_EQUAL_UINT(0u, stats.bytesStored);
+    }
+
+    DEFINE_TEST_CASE(TestTokenCache)
+    {
+        TEST_LOG(L"Test starting: TestTokenCache");
+
+        TokenCache cache{};
+        auto unsignedKey{ TokenCache::MakeKey(1, 1, false, "https://Social.XboxLive.com/users/xuid(1)/people") };
+        VERIFY_IS_TRUE(unsignedKey.audience == "https://social.xboxlive.com");
+
+        size_t completedCount{ 0 };
+        size_t retryCount{ 0 };
+        auto makeWaiter = [&]()
+        {
+            return TokenCache::Waiter{
+                AsyncContext<Result<TokenAndSignature>>{ [&](Result<TokenAndSignature> result)
+                {
+                    VERIFY_SUCCEEDED(result.Hresult());
+                    VERIFY_IS_TRUE(result.Payload().token == "SharedToken");
+                    ++completedCount;
+                } },
+                [&](AsyncContext<Result<TokenAndSignature>>)
+                {
+                    ++retryCount;
+                }
+            };
+        };
+
+        // Concurrent requests for the same audience share a single token request
+        auto lookup{ cache.Acquire(unsignedKey, false, nullptr) };
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::Request);
+        auto generation{ lookup.generation };
+
+        constexpr size_t burstSize{ 10 };
+        for (size_t i = 0; i < burstSize; ++i)
+        {
+            VERIFY_IS_TRUE(cache.Acquire(unsignedKey, false, nullptr).action == TokenCache::Action::Join);
+            auto waiter{ makeWaiter() };
+            VERIFY_IS_TRUE(cache.Acquire(unsignedKey, false, &waiter).action == TokenCache::Action::Joined);
+        }
+
+        cache.Complete(unsignedKey, generation, TokenAndSignature{ "SharedToken", "" });
+        VERIFY_ARE_EQUAL_UINT(burstSize, completedCount);
+        VERIFY_ARE_EQUAL_UINT(0u, retryCount);
+
+        // Later requests are served from the cache until the token is invalidated
+        lookup = cache.Acquire(unsignedKey, false, nullptr);
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::UseCached);
+        VERIFY_IS_TRUE(lookup.token == "SharedToken");
+        VERIFY_IS_TRUE(!lookup.refresh);
+
+        cache.Invalidate(1);
+        lookup = cache.Acquire(unsignedKey, false, nullptr);
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::Request);
+
+        // A token that was in flight when it was invalidated isn't cached
+        cache.Invalidate(1);
+        cache.Complete(unsignedKey, lookup.generation, TokenAndSignature{ "StaleToken", "" });
+        VERIFY_IS_TRUE(cache.Acquire(unsignedKey, false, nullptr).action == TokenCache::Action::Request);
+        cache.Complete(unsignedKey, lookup.generation, E_FAIL);
+
+        // Forced refreshes bypass the cached token
+        lookup = cache.Acquire(unsignedKey, false, nullptr);
+        cache.Complete(unsignedKey, lookup.generation, TokenAndSignature{ "SharedToken", "" });
+        VERIFY_IS_TRUE(cache.Acquire(unsignedKey, true, nullptr).action == TokenCache::Action::Request);
+
+        // Audiences that sign requests get a token and signature per request. Requests that were waiting on the
+        // first one make their own.
+        auto signedKey{ TokenCache::MakeKey(1, 1, false, "https://userpresence.xboxlive.com/users/batch") };
+        lookup = cache.Acquire(signedKey, false, nullptr);
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::Request);
+        auto waiter{ makeWaiter() };
+        VERIFY_IS_TRUE(cache.Acquire(signedKey, false, &waiter).action == TokenCache::Action::Joined);
+
+        cache.Complete(signedKey, lookup.generation, TokenAndSignature{ "Token", "Signature" });
+        VERIFY_ARE_EQUAL_UINT(1u, retryCount);
+        VERIFY_IS_TRUE(cache.Acquire(signedKey, false, nullptr).action == TokenCache::Action::Bypass);
+
+        // Failed requests release their waiters to retry
+        auto otherUserKey{ TokenCache::MakeKey(2, 2, false, "https://social.xboxlive.com") };
+        lookup = cache.Acquire(otherUserKey, false, nullptr);
+        waiter = makeWaiter();
+        VERIFY_IS_TRUE(cache.Acquire(otherUserKey, false, &waiter).action == TokenCache::Action::Joined);
+        cache.Complete(otherUserKey, lookup.generation, E_FAIL);
+        VERIFY_ARE_EQUAL_UINT(2u, retryCount);
+
+        auto stats{ cache.GetStats() };
+        VERIFY_ARE_EQUAL_UINT(1u, stats.hits);
+        VERIFY_ARE_EQUAL_UINT(burstSize + 2, stats.joinedRequests);
+        VERIFY_ARE_EQUAL_UINT(1u, stats.bypassedRequests);
+    }
+
+    DEFINE_TEST_CASE(TestTokenCacheEntryLifetime)
+    {
+        TEST_LOG(L"Test starting: TestTokenCacheEntryLifetime");
+
+        TokenCache cache{};
+        size_t retryCount{ 0 };
+        auto requestToken = [&](const TokenCache::Key& key, const String& token)
+        {
+            auto lookup{ cache.Acquire(key, false, nullptr) };
+            VERIFY_IS_TRUE(lookup.action == TokenCache::Action::Request);
+            cache.Complete(key, lookup.generation, TokenAndSignature{ token, "" });
+        };
+
+        // URLs that don't need a token get an empty one. Every waiter shares it rather than making its own request.
+        auto noTokenKey{ TokenCache::MakeKey(1, 1, false, "https://titlestorage.xboxlive.com") };
+        auto lookup{ cache.Acquire(noTokenKey, false, nullptr) };
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::Request);
+
+        size_t completedCount{ 0 };
+        for (size_t i = 0; i < 5; ++i)
+        {
+            TokenCache::Waiter waiter{
+                AsyncContext<Result<TokenAndSignature>>{ [&](Result<TokenAndSignature> result)
+                {
+                    VERIFY_SUCCEEDED(result.Hresult());
+                    VERIFY_IS_TRUE(result.Payload().token.empty());
+                    VERIFY_IS_TRUE(result.Payload().signature.empty());
+                    ++completedCount;
+                } },
+                [&](AsyncContext<Result<TokenAndSignature>>)
+                {
+                    ++retryCount;
+                }
+            };
+            VERIFY_IS_TRUE(cache.Acquire(noTokenKey, false, &waiter).action == TokenCache::Action::Joined);
+        }
+
+        cache.Complete(noTokenKey, lookup.generation, TokenAndSignature{});
+        VERIFY_ARE_EQUAL_UINT(5u, completedCount);
+        VERIFY_ARE_EQUAL_UINT(0u, retryCount);
+
+        lookup = cache.Acquire(noTokenKey, false, nullptr);
+        VERIFY_IS_TRUE(lookup.action == TokenCache::Action::UseCached);
+        VERIFY_IS_TRUE(lookup.token.empty());
+
+        // Signing out removes all of the user's entries, and only theirs
+        requestToken(TokenCache::MakeKey(1, 1, true, "https://social.xboxlive.com"), "User1Token");
+        requestToken(TokenCache::MakeKey(2, 2, false, "https://social.xboxlive.com"), "User2Token");
+        auto inFlightKey{ TokenCache::MakeKey(1, 1, false, "https://profile.xboxlive.com") };
+        lookup = cache.Acquire(inFlightKey, false, nullptr);
+        VERIFY_ARE_EQUAL_UINT(4u, cache.EntryCount());
+
+        cache.RemoveUser(1);
+        VERIFY_ARE_EQUAL_UINT(2u, cache.EntryCount());
+        VERIFY_IS_TRUE(cache.Acquire(TokenCache::MakeKey(2, 2, false, "https://social.xboxlive.com"), false, nullptr).action == TokenCache::Action::UseCached);
+
+        // A token that was in flight when its user signed out isn't cached
+        cache.Complete(inFlightKey, lookup.generation, TokenAndSignature{ "StaleToken", "" });
+        VERIFY_IS_TRUE(cache.Acquire(inFlightKey, false, nullptr).action == TokenCache::Action::Request);
+        cache.Complete(inFlightKey, lookup.generation, E_FAIL);
+
+        // Entries whose tokens have expired and that haven't been used since are removed, so the cache doesn't grow
+        // with every audience and user seen
+        for (uint64_t xuid = 10; xuid < 20; ++xuid)
+        {
+            requestToken(TokenCache::MakeKey(xuid, xuid, false, "https://social.xboxlive.com"), "Token");
+        }
+        VERIFY_ARE_EQUAL_UINT(12u, cache.EntryCount());
+
+        cache.RemoveExpiredEntries(chrono_clock_t::now());
+        VERIFY_ARE_EQUAL_UINT(12u, cache.EntryCount());
+
+        auto idleKey{ TokenCache::MakeKey(30, 30, false, "https://social.xboxlive.com") };
+        lookup = cache.Acquire(idleKey, false, nullptr);
+        cache.RemoveExpiredEntries(chrono_clock_t::now() + TokenCache::TokenLifetime + std::chrono::seconds{ 1 });
+        VERIFY_ARE_EQUAL_UINT(1u, cache.EntryCount()); // only the entry with a request in flight
+
+        cache.Complete(idleKey, lookup.generation, E_FAIL);
+        cache.RemoveExpiredEntries(chrono_clock_t::now() + TokenCache::TokenLifetime + std::chrono::seconds{ 1 });
+        VERIFY_ARE_EQUAL_UINT(0u, cache.EntryCount());
+    }
+
+    DEFINE_TEST_CASE(TestHttpCallGovernor)
+    {
+        TEST_LOG(L"Test starting: TestHttpCallGovernor");
+
+        HttpCallGovernor governor{};
+        const String url{ "https://Social.XboxLive.com:443/users/xuid(1)/people" };
+
+        // Endpoints without a budget aren't held back
+        VERIFY_IS_TRUE(governor.Acquire(1, url, HttpCallPriority::Background).count() == 0);
+        VERIFY_IS_TRUE(!governor.GetHeadroom(1, "social.xboxlive.com").isLimited);
+
+        HttpCallGovernor::Budget budget{ 4, std::chrono::seconds{ 60 }, 8, std::chrono::seconds{ 300 } };
+        governor.SetBudget("social.xboxlive.com", &budget);
+
+        // Background calls leave a quarter of the burst budget for interactive calls
+        for (size_t i = 0; i < 3; ++i)
+        {
+            VERIFY_IS_TRUE(governor.Acquire(1, url, HttpCallPriority::Background).count() == 0);
+        }
+        VERIFY_IS_TRUE(governor.Acquire(1, url, HttpCallPriority::Background).count() > 0);
+        VERIFY_IS_TRUE(governor.Acquire(1, url, HttpCallPriority::Interactive).count() == 0);
+
+        // Once the budget is spent, calls wait for it to refill rather than being sent
+        auto delay{ governor.Acquire(1, url, HttpCallPriority::Interactive) };
+        VERIFY_IS_TRUE(delay > std::chrono::seconds{ 14 } && delay <= std::chrono::seconds{ 16 });
+
+        auto headroom{ governor.GetHeadroom(1, "Social.XboxLive.com") };
+        VERIFY_IS_TRUE(headroom.isLimited);
+        VERIFY_ARE_EQUAL_UINT(0u, headroom.burstCallsRemaining);
+        VERIFY_ARE_EQUAL_UINT(4u, headroom.sustainedCallsRemaining);
+        VERIFY_ARE_EQUAL_UINT(2u, headroom.deferredCallCount);
+
+        // Each user has their own budget
+        VERIFY_IS_TRUE(governor.Acquire(2, url, HttpCallPriority::Interactive).count() == 0);
+
+        // A 429 holds calls until its Retry-After has passed, whether or not the endpoint has a budget
+        const String presenceUrl{ "https://userpresence.xboxlive.com/users/batch" };
+        governor.OnThrottled(2, presenceUrl, std::chrono::seconds{ 30 });
+        delay = governor.Acquire(2, presenceUrl, HttpCallPriority::Interactive);
+        VERIFY_IS_TRUE(delay > std::chrono::seconds{ 29 } && delay <= std::chrono::seconds{ 31 });
+        VERIFY_IS_TRUE(governor.Acquire(1, presenceUrl, HttpCallPriority::Interactive).count() == 0);
+
+        headroom = governor.GetHeadroom(2, "userpresence.xboxlive.com");
+        VERIFY_IS_TRUE(!headroom.isLimited);
+        VERIFY_ARE_EQUAL_UINT(1u, headroom.deferredCallCount);
+        VERIFY_ARE_EQUAL_UINT(1u, headroom.throttledCallCount);
+
+        // Removing the budget stops governing the endpoint
+        governor.SetBudget("social.xboxlive.com", nullptr);
+        VERIFY_IS_TRUE(governor.Acquire(1, url, HttpCallPriority::Interactive).count() == 0);
+    }
+
+    DEFINE_TEST_CASE(TestRetryAfterPastTimeoutWindow)
+    {
+        TEST_LOG(L"Test starting: TestRetryAfterPastTimeoutWindow");
+
+        TestEnvironment env{};
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+
+        const String url{ "https://userpresence.xboxlive.com/users/batch" };
+        HttpMock mock{ "GET", url.data(), 429 };
+        mock.SetResponseHeaders(HttpHeaders{ { "Retry-After", "3600" } });
+
+        uint32_t requestCount{ 0 };
+        mock.SetMockMatchedCallback([&](HttpMock*, String, String)
+        {
+            ++requestCount;
+        });
+
+        auto perform = [&]
+        {
+            XblHttpCallHandle callHandle{};
+            VERIFY_SUCCEEDED(XblHttpCallCreate(xboxLiveContext.get(), "GET", url.data(), &callHandle));
+            VERIFY_SUCCEEDED(XblHttpCallRequestSetRetryAllowed(callHandle, false));
+
+            XAsyncBlock async{};
+            VERIFY_SUCCEEDED(XblHttpCallPerformAsync(callHandle, XblHttpCallResponseBodyType::String, &async));
+            HRESULT hr = XAsyncGetStatus(&async, true);
+            VERIFY_SUCCEEDED(XblHttpCallCloseHandle(callHandle));
+            return hr;
+        };
+
+        VERIFY_ARE_EQUAL(MAKE_HTTP_HRESULT(429), perform());
+        VERIFY_ARE_EQUAL_UINT(1u, requestCount);
+
+        // The Retry-After is longer than the call's timeout window, so the call fails now instead of waiting for it
+        VERIFY_ARE_EQUAL(MAKE_HTTP_HRESULT(429), perform());
+        VERIFY_ARE_EQUAL_UINT(1u, requestCount);
+    }
+
+    DEFINE_TEST_CASE(TestParseRetryAfter)
+    {
+        TEST_LOG(L"Test starting: TestParseRetryAfter");
+
+        const String responseDate{ "Wed, 21 Oct 2015 07:28:00 GMT" };
+
+        // Delay in seconds
+        VERIFY_ARE_EQUAL_INT(120, HttpCallGovernor::ParseRetryAfter("120", responseDate).count());
+        VERIFY_ARE_EQUAL_INT(5, HttpCallGovernor::ParseRetryAfter(" 5 ", "").count());
+
+        // HTTP-date, measured from the response's Date header
+        VERIFY_ARE_EQUAL_INT(30, HttpCallGovernor::ParseRetryAfter("Wed, 21 Oct 2015 07:28:30 GMT", responseDate).count());
+        VERIFY_ARE_EQUAL_INT(3600, HttpCallGovernor::ParseRetryAfter("Wed, 21 Oct 2015 08:28:00 GMT", responseDate).count());
+        VERIFY_ARE_EQUAL_INT(0, HttpCallGovernor::ParseRetryAfter("Wed, 21 Oct 2015 07:27:00 GMT", responseDate).count());
+
+        // Without a Date header an HTTP-date is measured from the current time
+        auto inOneMinute{ (datetime::utc_now() + datetime::from_seconds(60)).to_string(datetime::RFC_1123) };
+        auto wait{ HttpCallGovernor::ParseRetryAfter(inOneMinute, "") };
+        VERIFY_IS_TRUE(wait.count() >= 58 && wait.count() <= 60);
+
+        // Missing or malformed values don't hold calls
+        VERIFY_ARE_EQUAL_INT(0, HttpCallGovernor::ParseRetryAfter("", responseDate).count());
+        VERIFY_ARE_EQUAL_INT(0, HttpCallGovernor::ParseRetryAfter("soon", responseDate).count());
+        VERIFY_ARE_EQUAL_INT(0, HttpCallGovernor::ParseRetryAfter("-5", responseDate).count());
+    }
+
     DEFINE_TEST_CASE(CppTestHttpCall)
     {
         TEST_LOG(L"Test starting: CppTestHttpCall");
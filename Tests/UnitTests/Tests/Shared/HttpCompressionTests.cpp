@@ -0,0 +1,477 @@
+// Copyright (c) Microsoft Corporation
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "pch.h"
+#include "UnitTestIncludes.h"
+#include "http_compression.h"
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
+
+DEFINE_TEST_CLASS(HttpCompressionTests)
+{
+public:
+    DEFINE_TEST_CLASS_PROPS(HttpCompressionTests);
+
+private:
+    struct TestVector
+    {
+        HttpContentEncoding encoding;
+        Vector<uint8_t> data;
+    };
+
+    // Presence style JSON, the input to each of the zlib generated vectors below
+    static String TestJson(uint64_t count)
+    {
+        const char* states[]{ "Online", "Away", "Offline", "Busy", "InGame" };
+
+        std::stringstream json;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            json << "{\"xuid\":\"" << 2814600000000000 + i * 7919 << "\",\"state\":\"" << states[(i * i) % 5] <<
+                "\",\"titleId\":" << 1000 + (i * 37) % 97 << "},";
+        }
+        return String{ json.str().data() };
+    }
+
+    // Streams produced by zlib 1.2 from TestJson(40). Each uses dynamic Huffman codes, which XSAPI never emits
+    // itself. zlibMultiBlock has a full flush part way through, so it has several blocks including an empty stored
+    // block. gzipAllHeaderFields sets the extra, name, comment and header CRC fields.
+    static Vector<TestVector> ZlibVectors()
+    {
+        const uint8_t zlibDynamic[]
+        {
+            0x78, 0xDA, 0x85, 0x95, 0xBB, 0x4E, 0x03, 0x31, 0x10, 0x00, 0xFF, 0xE5, 0xEA, 0x14, 0xDE, 0xF7,
+            0x9A, 0x8E, 0x0A, 0xA5, 0xE2, 0x1B, 0x22, 0x91, 0x22, 0x52, 0x48, 0x43, 0x10, 0x20, 0xC4, 0xBF,
+            0xB3, 0x54, 0x04, 0xB4, 0xEB, 0xBD, 0xF2, 0xCE, 0x23, 0x9F, 0x7D, 0x33, 0xE7, 0xCF, 0xED, 0xFD,
+            0xF5, 0xF4, 0xB4, 0xDD, 0x6D, 0xE8, 0xC0, 0x3A, 0x7E, 0xAF, 0x6D, 0xB7, 0xBD, 0x5C, 0x0F, 0xD7,
+            0x63, 0x3C, 0x7A, 0xBC, 0x9C, 0x4F, 0x97, 0x63, 0xDC, 0xB8, 0x9E, 0xAE, 0xE7, 0xE3, 0x3E, 0x46,
+            0x43, 0x0C, 0xF8, 0xDA, 0x7D, 0x66, 0xAC, 0x4D, 0x98, 0x37, 0xEC, 0xFD, 0xDB, 0xE1, 0xE3, 0x2F,
+            0x49, 0x96, 0x93, 0x20, 0x4E, 0x7E, 0x43, 0xEE, 0x2F, 0x0F, 0x87, 0xE7, 0x7F, 0xB3, 0x1A, 0xE7,
+            0x2C, 0x92, 0x89, 0x35, 0x2C, 0x14, 0x2C, 0x81, 0x9A, 0x2E, 0xDF, 0x58, 0xA0, 0x20, 0xA7, 0x4C,
+            0x69, 0xF6, 0xC9, 0x3D, 0x67, 0xD9, 0x04, 0x78, 0x39, 0x2B, 0x16, 0xA4, 0x08, 0x13, 0x35, 0x6B,
+            0x55, 0xC9, 0x59, 0x25, 0x12, 0x6C, 0xD8, 0x51, 0xB0, 0x06, 0x68, 0xB0, 0x7C, 0x63, 0xC6, 0x82,
+            0x0C, 0x25, 0x3A, 0x9F, 0x6C, 0xE6, 0xAC, 0x1B, 0x8C, 0xB5, 0x4F, 0x50, 0x90, 0x53, 0x62, 0x0B,
+            0x9B, 0xB5, 0x8A, 0xA6, 0x6C, 0x6C, 0xFE, 0xE4, 0xCE, 0xA7, 0x49, 0x39, 0x1B, 0xDF, 0x5C, 0xD7,
+            0x3E, 0x51, 0x45, 0xBA, 0x79, 0xE7, 0x93, 0xE5, 0xDD, 0x01, 0xAA, 0x8D, 0xB5, 0x4F, 0x50, 0x90,
+            0xC4, 0x8A, 0x9D, 0x4F, 0x9C, 0x37, 0x0B, 0x8C, 0xC2, 0x9D, 0x4F, 0x9E, 0x77, 0x07, 0x32, 0x58,
+            0xD7, 0x3E, 0x61, 0x45, 0xC6, 0x8F, 0xA2, 0xF3, 0x49, 0xF3, 0x66, 0x41, 0x15, 0xE7, 0xDA, 0xA7,
+            0x51, 0x90, 0xC6, 0x08, 0x9D, 0x4F, 0x94, 0x37, 0x0B, 0x8E, 0x40, 0x9D, 0x4F, 0x96, 0x77, 0x17,
+            0xE9, 0x84, 0xA6, 0xEB, 0x2F, 0x5B, 0x91, 0x36, 0xAD, 0xF3, 0x49, 0xF2, 0x66, 0x71, 0x88, 0xCF,
+            0xB5, 0x4F, 0x9E, 0x77, 0x17, 0x2B, 0x75, 0xE8, 0x7C, 0xC2, 0x82, 0x45, 0x30, 0xEA, 0x7C, 0x52,
+            0x2D, 0xD8, 0xA9, 0xB2, 0xF6, 0x69, 0x14, 0xE4, 0xCF, 0xE1, 0xD1, 0xF9, 0xC4, 0x79, 0xB3, 0xC8,
+            0xC2, 0xBE, 0xF6, 0xC9, 0xF3, 0xEE, 0x50, 0x88, 0x47, 0xE7, 0x13, 0x16, 0xAC, 0x02, 0x61, 0xE7,
+            0x93, 0x58, 0xC1, 0x4E, 0xE4, 0xB5, 0x4F, 0x33, 0xEF, 0x0E, 0xCD, 0x40, 0x3B, 0x9F, 0xA8, 0x60,
+            0x5D, 0xE2, 0x47, 0xB0, 0x9C, 0xD5, 0xF2, 0xEE, 0x70, 0x52, 0x9C, 0xB4, 0xDD, 0xD9, 0x9E, 0xB3,
+            0x41, 0x4E, 0xEC, 0x7C, 0x62, 0x2F, 0x58, 0x77, 0x5E, 0xFB, 0xE4, 0xD1, 0xDD, 0x37, 0xFF, 0x32,
+            0x84, 0x1A,
+        };
+        const uint8_t zlibMultiBlock[]
+        {
+            0x78, 0xDA, 0x84, 0xD3, 0xC1, 0x0E, 0xC2, 0x20, 0x0C, 0x06, 0xE0, 0x77, 0xE1, 0xBC, 0xC3, 0x4A,
+            0x29, 0x2D, 0xDE, 0x3C, 0x99, 0x9D, 0x7C, 0x86, 0x25, 0xEE, 0xB0, 0x64, 0xEE, 0x22, 0x46, 0xCD,
+            0xE2, 0xBB, 0xCB, 0xCD, 0x69, 0x0A, 0xE5, 0x08, 0x7C, 0x81, 0x96, 0x9F, 0xCD, 0x3D, 0xEF, 0xF3,
+            0xC5, 0x1D, 0x9C, 0x17, 0x08, 0xB1, 0xFF, 0x0E, 0xD7, 0xB9, 0x5B, 0x1E, 0xF3, 0x54, 0x96, 0xCE,
+            0xEB, 0x32, 0xAF, 0x53, 0x99, 0xC8, 0x73, 0x5E, 0xA6, 0xA1, 0xEC, 0x86, 0xB2, 0xE1, 0xDD, 0x6D,
+            0x9A, 0xE5, 0x04, 0x69, 0x67, 0x8F, 0x8F, 0xF1, 0xF5, 0x2B, 0x91, 0x75, 0x09, 0x24, 0x28, 0x3B,
+            0x39, 0xAC, 0xA7, 0xF1, 0xFA, 0x77, 0x2A, 0x07, 0xDD, 0x7A, 0x64, 0x62, 0xC3, 0x42, 0xC5, 0x22,
+            0x44, 0x8E, 0xCD, 0x1B, 0x13, 0x54, 0x64, 0xA2, 0x44, 0x46, 0x9F, 0x44, 0x74, 0x1B, 0x98, 0x20,
+            0x34, 0x4F, 0xF5, 0x15, 0x49, 0x14, 0x10, 0x8D, 0x5A, 0x23, 0xE9, 0x36, 0x22, 0x92, 0x37, 0x6C,
+            0x5F, 0xB1, 0x0C, 0x9E, 0xA1, 0x79, 0xE3, 0xE0, 0x2B, 0xB2, 0x44, 0xC2, 0xCA, 0x13, 0x27, 0xDD,
+            0x0A, 0x43, 0xDF, 0xCE, 0x13, 0x54, 0x64, 0xA2, 0xD2, 0x42, 0xA3, 0x56, 0x8A, 0xAA, 0x2D, 0xCD,
+            0x4F, 0xC1, 0xCA, 0x53, 0x42, 0xDD, 0x96, 0x37, 0x8F, 0xED, 0x3C, 0x61, 0x4D, 0x0A, 0x8B, 0x95,
+            0x27, 0xD6, 0xFF, 0x1D, 0xF8, 0xC8, 0x7D, 0x2B, 0x4F, 0x1F, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x85,
+            0xD4, 0x3B, 0x4E, 0xC4, 0x40, 0x0C, 0x80, 0xE1, 0xBB, 0xA4, 0xDE, 0xC2, 0x6F, 0x7B, 0xE8, 0xA8,
+            0xD0, 0x56, 0x9C, 0x21, 0x12, 0x29, 0x22, 0x2D, 0xDB, 0x10, 0x04, 0x08, 0xED, 0xDD, 0x19, 0xBA,
+            0x05, 0x79, 0xC6, 0x29, 0x93, 0x7C, 0x72, 0x12, 0xFD, 0x0E, 0x02, 0xC2, 0xED, 0xF4, 0xBD, 0x7C,
+            0xBE, 0xEF, 0x2F, 0xCB, 0xC3, 0x42, 0x81, 0x62, 0xF0, 0x7B, 0x20, 0x8B, 0x11, 0x2F, 0xA7, 0xE5,
+            0xED, 0x58, 0x8F, 0xAD, 0x5F, 0x3A, 0x5F, 0x9F, 0xD6, 0xD7, 0xAD, 0x9F, 0x38, 0xF6, 0xE3, 0xB2,
+            0x9D, 0xFB, 0xDD, 0x08, 0xE2, 0xB9, 0x15, 0x52, 0xA1, 0xC2, 0x86, 0xE4, 0x56, 0x41, 0x0C, 0xEF,
+            0xEC, 0xE3, 0xC7, 0xFA, 0xF5, 0x57, 0xD2, 0x48, 0x06, 0x07, 0xDC, 0xC9, 0xE7, 0xEB, 0x65, 0xBF,
+            0xFE, 0x9B, 0x6A, 0x98, 0x5B, 0x33, 0x6A, 0x6D, 0x3A, 0x15, 0x06, 0xD2, 0x85, 0x30, 0x8A, 0x77,
+            0xE5, 0xC8, 0x6D, 0x10, 0xB2, 0x17, 0xD6, 0x35, 0xB7, 0x0D, 0x40, 0x6D, 0xFA, 0xC4, 0x38, 0x92,
+            0xDE, 0x5C, 0x8B, 0xEF, 0xA4, 0x94, 0x5A, 0x02, 0x8D, 0x26, 0xD3, 0xA9, 0xD1, 0x72, 0x89, 0x1C,
+            0x58, 0xF5, 0x44, 0x03, 0x4B, 0xE8, 0x5C, 0xF5, 0x64, 0x36, 0xB0, 0xCD, 0x74, 0xDE, 0x13, 0x0C,
+            0x24, 0xBB, 0x7A, 0xD5, 0x93, 0x70, 0x6E, 0x45, 0x25, 0xE6, 0x3D, 0x45, 0xBE, 0x77, 0xA4, 0x2C,
+            0x50, 0xF5, 0x44, 0x03, 0x6B, 0xC8, 0x54, 0xF5, 0xA4, 0x3E, 0xB0, 0x8D, 0x64, 0xDE, 0x53, 0xCB,
+            0xF7, 0x8E, 0xDC, 0xD1, 0xAA, 0x9E, 0x78, 0x60, 0x43, 0xFB, 0x8F, 0x60, 0x3A, 0xD5, 0xF3, 0xBD,
+            0xA3, 0xC6, 0x00, 0x55, 0x4F, 0x98, 0xDB, 0x2E, 0x1B, 0x55, 0x3D, 0x49, 0x0C, 0x6C, 0x84, 0xCC,
+            0x7B, 0x8A, 0xBE, 0x77, 0x3F, 0xFF, 0x32, 0x84, 0x1A,
+        };
+        const uint8_t gzipAllHeaderFields[]
+        {
+            0x1F, 0x8B, 0x08, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x04, 0x00, 0x58, 0x53, 0x41, 0x50,
+            0x65, 0x76, 0x65, 0x6E, 0x74, 0x73, 0x2E, 0x6A, 0x73, 0x6F, 0x6E, 0x00, 0x7A, 0x6C, 0x69, 0x62,
+            0x20, 0x76, 0x65, 0x63, 0x74, 0x6F, 0x72, 0x00, 0x56, 0x17, 0x85, 0x95, 0xBB, 0x4E, 0x03, 0x31,
+            0x10, 0x00, 0xFF, 0xE5, 0xEA, 0x14, 0xDE, 0xF7, 0x9A, 0x8E, 0x0A, 0xA5, 0xE2, 0x1B, 0x22, 0x91,
+            0x22, 0x52, 0x48, 0x43, 0x10, 0x20, 0xC4, 0xBF, 0xB3, 0x54, 0x04, 0xB4, 0xEB, 0xBD, 0xF2, 0xCE,
+            0x23, 0x9F, 0x7D, 0x33, 0xE7, 0xCF, 0xED, 0xFD, 0xF5, 0xF4, 0xB4, 0xDD, 0x6D, 0xE8, 0xC0, 0x3A,
+            0x7E, 0xAF, 0x6D, 0xB7, 0xBD, 0x5C, 0x0F, 0xD7, 0x63, 0x3C, 0x7A, 0xBC, 0x9C, 0x4F, 0x97, 0x63,
+            0xDC, 0xB8, 0x9E, 0xAE, 0xE7, 0xE3, 0x3E, 0x46, 0x43, 0x0C, 0xF8, 0xDA, 0x7D, 0x66, 0xAC, 0x4D,
+            0x98, 0x37, 0xEC, 0xFD, 0xDB, 0xE1, 0xE3, 0x2F, 0x49, 0x96, 0x93, 0x20, 0x4E, 0x7E, 0x43, 0xEE,
+            0x2F, 0x0F, 0x87, 0xE7, 0x7F, 0xB3, 0x1A, 0xE7, 0x2C, 0x92, 0x89, 0x35, 0x2C, 0x14, 0x2C, 0x81,
+            0x9A, 0x2E, 0xDF, 0x58, 0xA0, 0x20, 0xA7, 0x4C, 0x69, 0xF6, 0xC9, 0x3D, 0x67, 0xD9, 0x04, 0x78,
+            0x39, 0x2B, 0x16, 0xA4, 0x08, 0x13, 0x35, 0x6B, 0x55, 0xC9, 0x59, 0x25, 0x12, 0x6C, 0xD8, 0x51,
+            0xB0, 0x06, 0x68, 0xB0, 0x7C, 0x63, 0xC6, 0x82, 0x0C, 0x25, 0x3A, 0x9F, 0x6C, 0xE6, 0xAC, 0x1B,
+            0x8C, 0xB5, 0x4F, 0x50, 0x90, 0x53, 0x62, 0x0B, 0x9B, 0xB5, 0x8A, 0xA6, 0x6C, 0x6C, 0xFE, 0xE4,
+            0xCE, 0xA7, 0x49, 0x39, 0x1B, 0xDF, 0x5C, 0xD7, 0x3E, 0x51, 0x45, 0xBA, 0x79, 0xE7, 0x93, 0xE5,
+            0xDD, 0x01, 0xAA, 0x8D, 0xB5, 0x4F, 0x50, 0x90, 0xC4, 0x8A, 0x9D, 0x4F, 0x9C, 0x37, 0x0B, 0x8C,
+            0xC2, 0x9D, 0x4F, 0x9E, 0x77, 0x07, 0x32, 0x58, 0xD7, 0x3E, 0x61, 0x45, 0xC6, 0x8F, 0xA2, 0xF3,
+            0x49, 0xF3, 0x66, 0x41, 0x15, 0xE7, 0xDA, 0xA7, 0x51, 0x90, 0xC6, 0x08, 0x9D, 0x4F, 0x94, 0x37,
+            0x0B, 0x8E, 0x40, 0x9D, 0x4F, 0x96, 0x77, 0x17, 0xE9, 0x84, 0xA6, 0xEB, 0x2F, 0x5B, 0x91, 0x36,
+            0xAD, 0xF3, 0x49, 0xF2, 0x66, 0x71, 0x88, 0xCF, 0xB5, 0x4F, 0x9E, 0x77, 0x17, 0x2B, 0x75, 0xE8,
+            0x7C, 0xC2, 0x82, 0x45, 0x30, 0xEA, 0x7C, 0x52, 0x2D, 0xD8, 0xA9, 0xB2, 0xF6, 0x69, 0x14, 0xE4,
+            0xCF, 0xE1, 0xD1, 0xF9, 0xC4, 0x79, 0xB3, 0xC8, 0xC2, 0xBE, 0xF6, 0xC9, 0xF3, 0xEE, 0x50, 0x88,
+            0x47, 0xE7, 0x13, 0x16, 0xAC, 0x02, 0x61, 0xE7, 0x93, 0x58, 0xC1, 0x4E, 0xE4, 0xB5, 0x4F, 0x33,
+            0xEF, 0x0E, 0xCD, 0x40, 0x3B, 0x9F, 0xA8, 0x60, 0x5D, 0xE2, 0x47, 0xB0, 0x9C, 0xD5, 0xF2, 0xEE,
+            0x70, 0x52, 0x9C, 0xB4, 0xDD, 0xD9, 0x9E, 0xB3, 0x41, 0x4E, 0xEC, 0x7C, 0x62, 0x2F, 0x58, 0x77,
+            0x5E, 0xFB, 0xE4, 0xD1, 0xDD, 0x37, 0xE3, 0xDB, 0x71, 0x35, 0x40, 0x09, 0x00, 0x00,
+        };
+        return Vector<TestVector>{
+            { HttpContentEncoding::Deflate, Vector<uint8_t>(std::begin(zlibDynamic), std::end(zlibDynamic)) },
+            { HttpContentEncoding::Deflate, Vector<uint8_t>(std::begin(zlibMultiBlock), std::end(zlibMultiBlock)) },
+            { HttpContentEncoding::Gzip, Vector<uint8_t>(std::begin(gzipAllHeaderFields), std::end(gzipAllHeaderFields)) }
+        };
+    }
+
+    // Builds zlib streams bit by bit, for blocks zlib itself would never produce
+    struct DeflateWriter
+    {
+        Vector<uint8_t> data{ 0x78, 0x01 };
+        uint32_t bits{ 0 };
+        uint32_t bitCount{ 0 };
+
+        void WriteBits(uint32_t value, uint32_t count)
+        {
+            bits |= value << bitCount;
+            for (bitCount += count; bitCount >= 8; bitCount -= 8)
+            {
+                data.push_back(static_cast<uint8_t>(bits));
+                bits >>= 8;
+            }
+        }
+
+        void WriteCode(uint32_t code, uint32_t length)
+        {
+            // Huffman codes are packed starting with their most significant bit
+            while (length-- > 0)
+            {
+                WriteBits((code >> length) & 1, 1);
+            }
+        }
+
+        void WriteBytes(std::initializer_list<uint8_t> bytes)
+        {
+            if (bitCount > 0)
+            {
+                WriteBits(0, 8 - bitCount);
+            }
+            data.insert(data.end(), bytes);
+        }
+
+        // Pads the final block and appends the Adler-32 of the data it should decode to
+        Vector<uint8_t> Finish(const String& decoded)
+        {
+            uint32_t a{ 1 };
+            uint32_t b{ 0 };
+            for (char c : decoded)
+            {
+                a = (a + static_cast<uint8_t>(c)) % 65521;
+                b = (b + a) % 65521;
+            }
+            uint32_t adler{ b << 16 | a };
+
+            WriteBytes({ static_cast<uint8_t>(adler >> 24), static_cast<uint8_t>(adler >> 16), static_cast<uint8_t>(adler >> 8), static_cast<uint8_t>(adler) });
+            return data;
+        }
+    };
+
+    static HRESULT DecompressResult(const Vector<uint8_t>& data)
+    {
+        return HttpCompression::Decompress(HttpContentEncoding::Deflate, data.data(), data.size()).Hresult();
+    }
+
+    static bool DecompressesTo(HttpContentEncoding encoding, const Vector<uint8_t>& data, const String& expected)
+    {
+        auto result{ HttpCompression::Decompress(encoding, data.data(), data.size()) };
+        return Succeeded(result) && String(result.Payload().begin(), result.Payload().end()) == expected;
+    }
+
+public:
+    DEFINE_TEST_CASE(TestDecompressZlibStreams)
+    {
+        TEST_LOG(L"Test starting: TestDecompressZlibStreams");
+
+        String expected{ TestJson(40) };
+        for (const auto& vector : ZlibVectors())
+        {
+            VERIFY_IS_TRUE(DecompressesTo(vector.encoding, vector.data, expected));
+        }
+
+        // A gzip body may contain several members, which decode to their concatenation
+        auto vectors{ ZlibVectors() };
+        auto gzip{ vectors[2].data };
+        gzip.insert(gzip.end(), vectors[2].data.begin(), vectors[2].data.end());
+        VERIFY_IS_TRUE(DecompressesTo(HttpContentEncoding::Gzip, gzip, expected + expected));
+
+        // Streams XSAPI produces round trip, including empty ones
+        for (auto encoding : { HttpContentEncoding::Gzip, HttpContentEncoding::Deflate })
+        {
+            for (const auto& input : { String{}, String{ "a" }, expected, TestJson(2000) })
+            {
+                auto compressed{ HttpCompression::Compress(encoding, reinterpret_cast<const uint8_t*>(input.data()), input.size()) };
+                VERIFY_SUCCEEDED(compressed.Hresult());
+                VERIFY_IS_TRUE(DecompressesTo(encoding, compressed.Payload(), input));
+            }
+        }
+    }
+
+    DEFINE_TEST_CASE(TestDecompressTruncatedStreams)
+    {
+        TEST_LOG(L"Test starting: TestDecompressTruncatedStreams");
+
+        for (const auto& vector : ZlibVectors())
+        {
+            for (size_t size = 0; size < vector.data.size(); ++size)
+            {
+                auto result{ HttpCompression::Decompress(vector.encoding, vector.data.data(), size) };
+                VERIFY_ARE_EQUAL(E_UNEXPECTED, result.Hresult());
+            }
+        }
+    }
+
+    DEFINE_TEST_CASE(TestDecompressCorruptStreams)
+    {
+        TEST_LOG(L"Test starting: TestDecompressCorruptStreams");
+
+        // Flipping any single bit either fails or, for bits the format ignores, still gives the original data
+        String expected{ TestJson(40) };
+        for (const auto& vector : ZlibVectors())
+        {
+            size_t ignoredBits{ 0 };
+            for (size_t i = 0; i < vector.data.size() * 8; ++i)
+            {
+                auto corrupt{ vector.data };
+                corrupt[i / 8] ^= static_cast<uint8_t>(1 << (i % 8));
+
+                auto result{ HttpCompression::Decompress(vector.encoding, corrupt.data(), corrupt.size()) };
+                if (Succeeded(result))
+                {
+                    VERIFY_IS_TRUE(String(result.Payload().begin(), result.Payload().end()) == expected);
+                    ++ignoredBits;
+                }
+            }
+
+            // Only padding bits before stored blocks and after the final block are unchecked
+            VERIFY_IS_TRUE(ignoredBits < 16);
+        }
+
+        auto gzip{ ZlibVectors()[2].data };
+        auto withHeaderByte = [&](size_t offset, uint8_t value)
+        {
+            auto corrupt{ gzip };
+            corrupt[offset] = value;
+            return HttpCompression::Decompress(HttpContentEncoding::Gzip, corrupt.data(), corrupt.size()).Hresult();
+        };
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, withHeaderByte(2, 7));           // compression method other than DEFLATE
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, withHeaderByte(3, gzip[3] | 0x20)); // reserved flag
+
+        // Trailing bytes after a gzip member must be another member
+        gzip.push_back(0);
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, HttpCompression::Decompress(HttpContentEncoding::Gzip, gzip.data(), gzip.size()).Hresult());
+
+        // zlib streams with a preset dictionary aren't used in HTTP
+        const uint8_t presetDictionary[]{ 0x78, 0xBB, 0x00, 0x00, 0x00, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01 };
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, HttpCompression::Decompress(HttpContentEncoding::Deflate, presetDictionary, sizeof(presetDictionary)).Hresult());
+    }
+
+    DEFINE_TEST_CASE(TestDecompressSizeLimit)
+    {
+        TEST_LOG(L"Test starting: TestDecompressSizeLimit");
+
+        // A single fixed Huffman block with a literal followed by maximum length matches, which expands to just over
+        // MaxDecompressedSize
+        DeflateWriter bomb;
+        bomb.WriteBits(1, 1); // final block
+        bomb.WriteBits(1, 2); // fixed Huffman codes
+        bomb.WriteCode(0x30, 8); // literal 0
+        for (size_t size = 1; size <= HttpCompression::MaxDecompressedSize; size += 258)
+        {
+            bomb.WriteCode(0xC5, 8); // length 258
+            bomb.WriteCode(0, 5); // distance 1
+        }
+        bomb.WriteCode(0, 7); // end of block
+        bomb.WriteBytes({ 0, 0, 0, 0 });
+
+        VERIFY_ARE_EQUAL(E_BOUNDS, DecompressResult(bomb.data));
+
+        // A stored block over the limit is rejected before it is copied
+        DeflateWriter stored;
+        for (size_t size = 0; size <= HttpCompression::MaxDecompressedSize; size += 0xFFFF)
+        {
+            stored.WriteBits(0, 1);
+            stored.WriteBits(0, 2); // stored
+            stored.WriteBytes({ 0xFF, 0xFF, 0x00, 0x00 });
+            stored.data.resize(stored.data.size() + 0xFFFF, 'x');
+        }
+        stored.WriteBits(1, 1);
+        stored.WriteBits(1, 2);
+        stored.WriteCode(0, 7);
+        stored.WriteBytes({ 0, 0, 0, 0 });
+
+        VERIFY_ARE_EQUAL(E_BOUNDS, DecompressResult(stored.data));
+    }
+
+    DEFINE_TEST_CASE(TestDecompressMalformedBlocks)
+    {
+        TEST_LOG(L"Test starting: TestDecompressMalformedBlocks");
+
+        // Each case is a fixed Huffman block with literal 'a' followed by one length 3 match. The valid form, distance 1,
+        // decodes to "aaaa" so the failures below are due to the malformed field alone.
+        auto fixedMatch = [](uint32_t lengthCode, uint32_t distanceCode, const String& decoded)
+        {
+            DeflateWriter writer;
+            writer.WriteBits(1, 1);
+            writer.WriteBits(1, 2);
+            writer.WriteCode(0x30 + 'a', 8);
+            writer.WriteCode(lengthCode, lengthCode < 0xC0 ? 7 : 8);
+            writer.WriteCode(distanceCode, 5);
+            writer.WriteCode(0, 7);
+            return writer.Finish(decoded);
+        };
+        VERIFY_IS_TRUE(DecompressesTo(HttpContentEncoding::Deflate, fixedMatch(1, 0, "aaaa"), "aaaa"));
+
+        // Distance 2 reaches before the start of the output
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(fixedMatch(1, 1, "aaaa")));
+        // Distance codes 30 and 31 and length codes 286 and 287 are reserved
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(fixedMatch(1, 30, "aaaa")));
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(fixedMatch(1, 31, "aaaa")));
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(fixedMatch(0xC6, 0, "aaaa")));
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(fixedMatch(0xC7, 0, "aaaa")));
+
+        // Matches may refer back across block boundaries, but never before the start of the stream
+        DeflateWriter acrossBlocks;
+        acrossBlocks.WriteBits(0, 1);
+        acrossBlocks.WriteBits(0, 2);
+        acrossBlocks.WriteBytes({ 0x02, 0x00, 0xFD, 0xFF, 'a', 'b' });
+        acrossBlocks.WriteBits(1, 1);
+        acrossBlocks.WriteBits(1, 2);
+        acrossBlocks.WriteCode(1, 7); // length 3
+        acrossBlocks.WriteCode(1, 5); // distance 2
+        acrossBlocks.WriteCode(0, 7);
+        VERIFY_IS_TRUE(DecompressesTo(HttpContentEncoding::Deflate, acrossBlocks.Finish("ababa"), "ababa"));
+
+        // Reserved block type 3
+        DeflateWriter reservedType;
+        reservedType.WriteBits(1, 1);
+        reservedType.WriteBits(3, 2);
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(reservedType.Finish("")));
+
+        // Stored block whose length complement doesn't match
+        DeflateWriter storedLength;
+        storedLength.WriteBits(1, 1);
+        storedLength.WriteBits(0, 2);
+        storedLength.WriteBytes({ 0x01, 0x00, 0xFF, 0xFF, 'a' });
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(storedLength.Finish("a")));
+
+        // Dynamic block header declaring 287 literal/length codes
+        DeflateWriter tooManyCodes;
+        tooManyCodes.WriteBits(1, 1);
+        tooManyCodes.WriteBits(2, 2);
+        tooManyCodes.WriteBits(30, 5);
+        tooManyCodes.WriteBits(0, 5);
+        tooManyCodes.WriteBits(15, 4);
+        for (uint32_t i = 0; i < 19; ++i)
+        {
+            tooManyCodes.WriteBits(4, 3);
+        }
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(tooManyCodes.Finish("")));
+
+        // Dynamic block whose code length code is over-subscribed: three codes of length one
+        DeflateWriter overSubscribed;
+        overSubscribed.WriteBits(1, 1);
+        overSubscribed.WriteBits(2, 2);
+        overSubscribed.WriteBits(0, 5);
+        overSubscribed.WriteBits(0, 5);
+        overSubscribed.WriteBits(0, 4);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            overSubscribed.WriteBits(i < 3 ? 1 : 0, 3);
+        }
+        overSubscribed.WriteBytes({ 0, 0, 0, 0, 0, 0, 0, 0 });
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(overSubscribed.Finish("")));
+
+        // A repeat of the previous code length with no previous length
+        DeflateWriter repeatFirst;
+        repeatFirst.WriteBits(1, 1);
+        repeatFirst.WriteBits(2, 2);
+        repeatFirst.WriteBits(0, 5);
+        repeatFirst.WriteBits(0, 5);
+        repeatFirst.WriteBits(0, 4);
+        repeatFirst.WriteBits(1, 3); // code length symbol 16 has a 1 bit code
+        repeatFirst.WriteBits(0, 3); // 17 is unused
+        repeatFirst.WriteBits(0, 3); // 18 is unused
+        repeatFirst.WriteBits(1, 3); // 0 has a 1 bit code
+        repeatFirst.WriteCode(1, 1); // 16: repeat previous
+        repeatFirst.WriteBits(0, 2);
+        repeatFirst.WriteBytes({ 0, 0, 0, 0, 0, 0, 0, 0 });
+        VERIFY_ARE_EQUAL(E_UNEXPECTED, DecompressResult(repeatFirst.Finish("")));
+    }
+
+    DEFINE_TEST_CASE(TestDecompressFuzz)
+    {
+        TEST_LOG(L"Test starting: TestDecompressFuzz");
+
+        // Randomly mutated streams must be rejected or decode to the original data. The seed is fixed so failures
+        // reproduce.
+        String expected{ TestJson(40) };
+        auto vectors{ ZlibVectors() };
+        std::mt19937 random{ 20240131 };
+
+        for (uint32_t iteration = 0; iteration < 5000; ++iteration)
+        {
+            const auto& vector{ vectors[iteration % vectors.size()] };
+            auto data{ vector.data };
+
+            auto mutationCount{ 1 + random() % 4 };
+            for (decltype(mutationCount) i = 0; i < mutationCount && !data.empty(); ++i)
+            {
+                size_t offset{ random() % data.size() };
+                switch (random() % 5)
+                {
+                case 0: data[offset] ^= static_cast<uint8_t>(1 << (random() % 8)); break;
+                case 1: data[offset] = static_cast<uint8_t>(random()); break;
+                case 2: data.insert(data.begin() + offset, static_cast<uint8_t>(random())); break;
+                case 3: data.erase(data.begin() + offset); break;
+                case 4: data.resize(offset); break;
+                }
+            }
+
+            auto result{ HttpCompression::Decompress(vector.encoding, data.data(), data.size()) };
+            if (Succeeded(result))
+            {
+                VERIFY_IS_TRUE(String(result.Payload().begin(), result.Payload().end()) == expected);
+            }
+        }
+
+        // Random bytes behind a valid header
+        for (uint32_t iteration = 0; iteration < 5000; ++iteration)
+        {
+            Vector<uint8_t> data{ 0x78, 0x9C };
+            if (iteration % 2)
+            {
+                data = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+            }
+            size_t size{ random() % 64 };
+            for (size_t i = 0; i < size; ++i)
+            {
+                data.push_back(static_cast<uint8_t>(random()));
+            }
+
+            auto encoding{ iteration % 2 ? HttpContentEncoding::Gzip : HttpContentEncoding::Deflate };
+            auto result{ HttpCompression::Decompress(encoding, data.data(), data.size()) };
+            VERIFY_IS_TRUE(Failed(result) || result.Payload().size() <= HttpCompression::MaxDecompressedSize);
+        }
+    }
+};
+
+NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_END
@@ -139,6 +139,80 @@ public:
         VERIFY_ARE_EQUAL_INT(loopCount*loopCount, testOutput->m_logOutput.size());
     }
 
+    DEFINE_TEST_CASE(WriteLogQueued)
+    {
+        TEST_LOG(L"Test starting: WriteLogQueued");
+
+        VERIFY_SUCCEEDED(HCSettingsSetTraceLevel(HCTraceLevel::Error));
+
+        XTaskQueueHandle queueHandle{ nullptr };
+        VERIFY_SUCCEEDED(XTaskQueueCreate(XTaskQueueDispatchMode::ThreadPool, XTaskQueueDispatchMode::ThreadPool, &queueHandle));
+
+        {
+            auto testLogger = std::make_shared<logger>(TaskQueue{ queueHandle });
+            auto testOutput = std::make_shared<TestLogOutput>();
+            testLogger->add_log_output(testOutput);
+
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                threads.emplace_back([testLogger]
+                {
+                    for (size_t j = 0; j < 100; ++j)
+                    {
+                        testLogger->add_log(log_entry(HCTraceLevel::Error, "test") << j);
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            // Not queued since the level is disabled
+            testLogger->add_log(log_entry(HCTraceLevel::Verbose, "test", "test"));
+
+            XTaskQueueTerminate(queueHandle, true, nullptr, nullptr);
+            testLogger->flush();
+
+            VERIFY_ARE_EQUAL_INT(400, testOutput->m_logOutput.size());
+        }
+
+        XTaskQueueCloseHandle(queueHandle);
+    }
+
+    DEFINE_TEST_CASE(DisabledLogsNotEvaluated)
+    {
+        TEST_LOG(L"Test starting: DisabledLogsNotEvaluated");
+
+        TestEnvironment env{};
+
+        HCTraceLevel previousLevel{ HCTraceLevel::Off };
+        VERIFY_SUCCEEDED(HCSettingsGetTraceLevel(&previousLevel));
+        VERIFY_SUCCEEDED(HCSettingsSetTraceLevel(HCTraceLevel::Error));
+
+        size_t evaluationCount{ 0 };
+        auto evaluate = [&]()
+        {
+            return ++evaluationCount;
+        };
+
+        LOGS_DEBUG << "Not evaluated " << evaluate();
+        LOGS_ERROR << "Evaluated " << evaluate();
+
+        bool elseTaken{ false };
+        if (evaluationCount == 0)
+            LOGS_DEBUG << evaluate();
+        else
+            elseTaken = true;
+
+        VERIFY_ARE_EQUAL_INT(1, evaluationCount);
+        VERIFY_IS_TRUE(elseTaken);
+
+        VERIFY_SUCCEEDED(HCSettingsSetTraceLevel(previousLevel));
+    }
+
     DEFINE_TEST_CASE(HCLogging)
     {
         TEST_LOG(L"Test starting: HCLogging");
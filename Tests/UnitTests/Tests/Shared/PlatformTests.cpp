@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "UnitTestIncludes.h"
+#include "journal.h"
 
 NAMESPACE_MICROSOFT_XBOX_SERVICES_SYSTEM_CPP_BEGIN
 
@@ -124,6 +125,116 @@ private:
         std::mutex m_mutex;
     };
 
+    // Storage handlers that may be invoked for several keys at once. Writes take ~2 seconds each.
+    struct ConcurrentLocalStorageManager
+    {
+    public:
+        ConcurrentLocalStorageManager() noexcept
+        {
+            VERIFY_SUCCEEDED(XblLocalStorageSetHandlers(nullptr, WriteHandler, ReadHandler, ClearHandler, this));
+            VERIFY_SUCCEEDED(XblLocalStorageSetMaxConcurrentOperations(4));
+        }
+
+        ~ConcurrentLocalStorageManager() noexcept
+        {
+            VERIFY_SUCCEEDED(XblLocalStorageSetMaxConcurrentOperations(0));
+            VERIFY_SUCCEEDED(XblLocalStorageSetHandlers(nullptr, nullptr, nullptr, nullptr, nullptr));
+        }
+
+        size_t MaxConcurrentWrites() const noexcept
+        {
+            return m_maxConcurrentWrites;
+        }
+
+    private:
+        static void WriteHandler(
+            _In_opt_ void* context,
+            _In_ XblClientOperationHandle operation,
+            _In_ XblUserHandle user,
+            _In_ XblLocalStorageWriteMode mode,
+            _In_z_ char const* key,
+            _In_ size_t dataSize,
+            _In_reads_bytes_(dataSize) void const* data
+        )
+        {
+            UNREFERENCED_PARAMETER(user);
+            assert(context);
+
+            auto pThis{ static_cast<ConcurrentLocalStorageManager*>(context) };
+            {
+                std::lock_guard<std::mutex> lock{ pThis->m_mutex };
+                pThis->m_maxConcurrentWrites = std::max(pThis->m_maxConcurrentWrites, ++pThis->m_writesInProgress);
+            }
+
+            Sleep(2000);
+
+            std::unique_lock<std::mutex> lock{ pThis->m_mutex };
+            --pThis->m_writesInProgress;
+
+            auto& vec{ pThis->m_data[key] };
+            auto bytes{ static_cast<const uint8_t*>(data) };
+
+            switch (mode)
+            {
+            case XblLocalStorageWriteMode::Append:
+            {
+                vec.insert(vec.end(), bytes, bytes + dataSize);
+                break;
+            }
+            case XblLocalStorageWriteMode::Truncate:
+            {
+                vec = std::vector<uint8_t>(bytes, bytes + dataSize);
+                break;
+            }
+            }
+            size_t size{ vec.size() };
+            lock.unlock();
+
+            XblLocalStorageWriteComplete(operation, XblClientOperationResult::Success, size);
+        }
+
+        static void ReadHandler(
+            _In_opt_ void* context,
+            _In_ XblClientOperationHandle operation,
+            _In_ XblUserHandle user,
+            _In_z_ const char* key
+        )
+        {
+            UNREFERENCED_PARAMETER(user);
+            assert(context);
+
+            auto pThis{ static_cast<ConcurrentLocalStorageManager*>(context) };
+
+            std::lock_guard<std::mutex> lock{ pThis->m_mutex };
+            auto& vec{ pThis->m_data[key] };
+            XblLocalStorageReadComplete(operation, XblClientOperationResult::Success, vec.size(), vec.data());
+        }
+
+        static void ClearHandler(
+            _In_opt_ void* context,
+            _In_ XblClientOperationHandle operation,
+            _In_ XblUserHandle user,
+            _In_z_ const char* key
+        )
+        {
+            UNREFERENCED_PARAMETER(user);
+            assert(context);
+
+            auto pThis{ static_cast<ConcurrentLocalStorageManager*>(context) };
+
+            std::unique_lock<std::mutex> lock{ pThis->m_mutex };
+            pThis->m_data.erase(key);
+            lock.unlock();
+
+            XblLocalStorageClearComplete(operation, XblClientOperationResult::Success);
+        }
+
+        std::unordered_map<std::string, std::vector<uint8_t>> m_data;
+        size_t m_writesInProgress{ 0 };
+        size_t m_maxConcurrentWrites{ 0 };
+        std::mutex m_mutex;
+    };
+
 public:
     DEFINE_TEST_CASE(TestCustomLocalStorageHandlers)
     {
@@ -167,6 +278,227 @@ public:
         VERIFY_IS_TRUE(writeData == readData);
     }
 
+    DEFINE_TEST_CASE(TestLocalStorageScheduling)
+    {
+        TEST_LOG(L"Test starting: TestLocalStorageScheduling");
+        ConcurrentLocalStorageManager storageManager{};
+        TestEnvironment env{};
+
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto localStorage{ GlobalState::Get()->LocalStorage() };
+        auto& user{ xboxLiveContext->User() };
+
+        auto bytes = [](const char* s)
+        {
+            return Vector<uint8_t>(s, s + strlen(s));
+        };
+
+        // The first write to each key starts immediately, the appends queued behind it on "a" are merged into a single
+        // write, and the clear on "c" is canceled before it starts.
+        Event writesComplete;
+        std::atomic<size_t> writeCount{ 0 };
+        std::atomic<size_t> failedWriteCount{ 0 };
+        auto onWrite = [&](Result<size_t> result)
+        {
+            if (Failed(result))
+            {
+                ++failedWriteCount;
+            }
+            if (++writeCount == 5)
+            {
+                writesComplete.Set();
+            }
+        };
+
+        VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Truncate, "a", bytes("1"), onWrite));
+        VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Append, "a", bytes("2"), onWrite));
+        VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Append, "a", bytes("3"), onWrite));
+        VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Truncate, "b", bytes("b"), onWrite));
+        VERIFY_SUCCEEDED(localStorage->WriteAsync(user, XblLocalStorageWriteMode::Truncate, "c", bytes("c"), onWrite));
+
+        auto metrics{ localStorage->Metrics("a") };
+        VERIFY_ARE_EQUAL_UINT(1, metrics.queueDepth);
+        VERIFY_ARE_EQUAL_UINT(1, metrics.coalescedAppends);
+
+        Event clearComplete;
+        HRESULT clearResult{ S_OK };
+        VERIFY_SUCCEEDED(localStorage->ClearAsync(user, "c", [&](HRESULT hr)
+        {
+            clearResult = hr;
+            clearComplete.Set();
+        }));
+        VERIFY_ARE_EQUAL_UINT(1, localStorage->CancelPendingOperations("c"));
+        clearComplete.Wait();
+        VERIFY_ARE_EQUAL(E_ABORT, clearResult);
+        VERIFY_ARE_EQUAL_UINT(1, localStorage->Metrics("c").canceledOperations);
+
+        writesComplete.Wait();
+        VERIFY_ARE_EQUAL_UINT(0, failedWriteCount);
+
+        // Writes to different keys overlapped, but never more than one per key
+        VERIFY_IS_TRUE(storageManager.MaxConcurrentWrites() > 1);
+        VERIFY_IS_TRUE(storageManager.MaxConcurrentWrites() <= 3);
+
+        metrics = localStorage->Metrics("a");
+        VERIFY_ARE_EQUAL_UINT(0, metrics.queueDepth);
+        VERIFY_ARE_EQUAL_UINT(1, metrics.maxQueueDepth);
+        VERIFY_ARE_EQUAL_UINT(2, metrics.completedOperations);
+        VERIFY_IS_TRUE(metrics.maxLatency.count() > 0);
+
+        Event readComplete;
+        std::string readData;
+        VERIFY_SUCCEEDED(localStorage->ReadAsync(user, "a", [&](Result<Vector<uint8_t>> result)
+        {
+            if (Succeeded(result))
+            {
+                readData.assign(result.Payload().begin(), result.Payload().end());
+            }
+            readComplete.Set();
+        }));
+        readComplete.Wait();
+        VERIFY_ARE_EQUAL_STR("123", readData);
+    }
+
+    DEFINE_TEST_CASE(TestReadInPlace)
+    {
+        TEST_LOG(L"Test starting: TestReadInPlace");
+        LocalStorageManager storageManager{};
+        TestEnvironment env{};
+
+        auto xboxLiveContext = env.CreateMockXboxLiveContext();
+        auto localStorage{ GlobalState::Get()->LocalStorage() };
+
+        Vector<uint8_t> segment;
+        Journal::AppendSegmentHeader(segment);
+        std::string record{ "record" };
+        Journal::AppendRecord(segment, reinterpret_cast<const uint8_t*>(record.data()), record.size());
+
+        localStorage->WriteAsync(xboxLiveContext->User(), XblLocalStorageWriteMode::Truncate, "segment", Vector<uint8_t>{ segment }, nullptr);
+
+        // Custom handlers don't support mapping, so this exercises the ReadAsync fallback
+        Event readComplete;
+        HRESULT readResult{ E_FAIL };
+        size_t readSize{ 0 };
+
+        localStorage->ReadInPlaceAsync(
+            xboxLiveContext->User(),
+            "segment",
+            [&](const uint8_t* data, size_t size)
+            {
+                readSize = size;
+                return Journal::Replay(data, size, [](const uint8_t*, size_t) {}) == size ? S_OK : E_FAIL;
+            },
+            [&](HRESULT hr)
+            {
+                readResult = hr;
+                readComplete.Set();
+            }
+        );
+
+        readComplete.Wait();
+        VERIFY_SUCCEEDED(readResult);
+        VERIFY_ARE_EQUAL_UINT(segment.size(), readSize);
+    }
+
+    DEFINE_TEST_CASE(TestJournalReplayStopsAtCorruptRecord)
+    {
+        TEST_LOG(L"Test starting: TestJournalReplayStopsAtCorruptRecord");
+
+        Vector<uint8_t> segment;
+        Journal::AppendSegmentHeader(segment);
+        for (uint8_t i = 0; i < 3; ++i)
+        {
+            Vector<uint8_t> record(16, i);
+            Journal::AppendRecord(segment, record.data(), record.size());
+        }
+        size_t recordSize{ Journal::RecordHeaderSize + 16 };
+
+        auto countRecords = [](const Vector<uint8_t>& data, size_t size)
+        {
+            size_t count{ 0 };
+            Journal::Replay(data.data(), size, [&](const uint8_t* payload, size_t payloadSize)
+            {
+                VERIFY_ARE_EQUAL_UINT(16, payloadSize);
+                VERIFY_ARE_EQUAL_UINT(count, payload[0]);
+                ++count;
+            });
+            return count;
+        };
+
+        VERIFY_ARE_EQUAL_UINT(3, countRecords(segment, segment.size()));
+
+        // Torn tail, as if the title exited while the last record was being appended
+        VERIFY_ARE_EQUAL_UINT(2, countRecords(segment, segment.size() - 1));
+        VERIFY_ARE_EQUAL_UINT(Journal::SegmentHeaderSize + 2 * recordSize, Journal::Replay(segment.data(), segment.size() - 1, [](const uint8_t*, size_t) {}));
+
+        // Checksum mismatch in the second record stops replay before it
+        segment[Journal::SegmentHeaderSize + recordSize + Journal::RecordHeaderSize] ^= 0xFF;
+        VERIFY_ARE_EQUAL_UINT(1, countRecords(segment, segment.size()));
+
+        // Segments without a valid header are ignored entirely
+        segment[0] = 0;
+        VERIFY_ARE_EQUAL_UINT(0, countRecords(segment, segment.size()));
+    }
+
+    DEFINE_TEST_CASE(TestJournalWriteAndReplayPerformance)
+    {
+        TEST_LOG(L"Test starting: TestJournalWriteAndReplayPerformance");
+
+        // Writes and replays 1M records in segments the size the events service uses by default. Records are
+        // roughly the size of a small in-game event.
+        constexpr size_t recordCount{ 1000000 };
+        constexpr size_t segmentSize{ 128000 };
+
+        Vector<uint8_t> record(160, 'e');
+        Vector<uint8_t> segment;
+        segment.reserve(segmentSize + Journal::RecordHeaderSize + record.size());
+
+        using Clock = std::chrono::high_resolution_clock;
+        Clock::duration writeTime{};
+        Clock::duration replayTime{};
+        size_t recordsWritten{ 0 };
+        size_t recordsReplayed{ 0 };
+        size_t segmentCount{ 0 };
+
+        while (recordsWritten < recordCount)
+        {
+            auto writeStart{ Clock::now() };
+            segment.clear();
+            Journal::AppendSegmentHeader(segment);
+            while (segment.size() < segmentSize && recordsWritten < recordCount)
+            {
+                memcpy(record.data(), &recordsWritten, sizeof(recordsWritten));
+                Journal::AppendRecord(segment, record.data(), record.size());
+                ++recordsWritten;
+            }
+
+            auto replayStart{ Clock::now() };
+            size_t validSize = Journal::Replay(segment.data(), segment.size(), [&](const uint8_t* payload, size_t size)
+            {
+                size_t sequence{ 0 };
+                memcpy(&sequence, payload, sizeof(sequence));
+                if (size == record.size() && sequence == recordsReplayed)
+                {
+                    ++recordsReplayed;
+                }
+            });
+            auto replayEnd{ Clock::now() };
+
+            VERIFY_ARE_EQUAL_UINT(segment.size(), validSize);
+            writeTime += replayStart - writeStart;
+            replayTime += replayEnd - replayStart;
+            ++segmentCount;
+        }
+
+        VERIFY_ARE_EQUAL_UINT(recordCount, recordsReplayed);
+
+        std::wstringstream ss;
+        ss << L"Journaled " << recordCount << L" records in " << segmentCount << L" segments. Write: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(writeTime).count() << L"ms, replay: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(replayTime).count() << L"ms";
+        TEST_LOG(ss.str().c_str());
+    }
+
     enum TestEnum : uint32_t
     {
         ValueDefault = 0,